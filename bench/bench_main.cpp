@@ -0,0 +1,49 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "bench_suites.h"
+
+using namespace Razix::Tool::AssetPacker;
+
+static const BenchSuite kSuites[] = {
+    {"vertex_simd", "[vertices] Bulk vertex conversion, AABB and tangent handedness vs the per-vertex import loop", RunVertexSimdBench},
+    {"importers", "<model files...> Import time and peak heap of the Assimp path vs the native backends on the same files", RunImporterBench},
+    {"scenes", "[scale] [--runs N] [--json file] [--keep] Import, process, LODs, meshlets, BVHs and export of generated glTF/OBJ scenes", RunSceneBench},
+};
+
+static void PrintUsage()
+{
+    std::cout << "Usage: RazixAssetPacker_Bench <suite | all> [suite args]\n";
+    for (const auto& suite: kSuites)
+        std::cout << "  " << suite.name << " " << suite.description << "\n";
+    std::cout << std::flush;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || !strcmp(argv[1], "-h") || !strcmp(argv[1], "--help")) {
+        PrintUsage();
+        return argc < 2 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    bool runAll = !strcmp(argv[1], "all");
+    bool found  = false;
+    int  result = EXIT_SUCCESS;
+    for (const auto& suite: kSuites) {
+        if (!runAll && strcmp(argv[1], suite.name) != 0)
+            continue;
+
+        found = true;
+        std::cout << "=== " << suite.name << " ===" << std::endl;
+        if (suite.run(argc - 2, argv + 2) != EXIT_SUCCESS)
+            result = EXIT_FAILURE;
+    }
+
+    if (!found) {
+        std::cout << "[ERROR!] Unknown suite : " << argv[1] << std::endl;
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+    return result;
+}
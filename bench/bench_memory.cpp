@@ -0,0 +1,96 @@
+#include "bench_memory.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "common/process_memory.h"
+
+// Every allocation carries it's size in a header in front of the returned pointer, aligned for any type
+static constexpr size_t kHeaderSize = alignof(std::max_align_t) > sizeof(size_t) ? alignof(std::max_align_t) : sizeof(size_t);
+
+static std::atomic<size_t> s_CurrentBytes = 0;
+static std::atomic<size_t> s_PeakBytes    = 0;
+
+static void* TrackedAlloc(size_t size)
+{
+    uint8_t* block = static_cast<uint8_t*>(malloc(size + kHeaderSize));
+    if (!block)
+        return nullptr;
+    *reinterpret_cast<size_t*>(block) = size;
+
+    size_t current = s_CurrentBytes.fetch_add(size) + size;
+    size_t peak    = s_PeakBytes.load();
+    while (current > peak && !s_PeakBytes.compare_exchange_weak(peak, current)) {}
+
+    return block + kHeaderSize;
+}
+
+static void TrackedFree(void* ptr)
+{
+    if (!ptr)
+        return;
+    uint8_t* block = static_cast<uint8_t*>(ptr) - kHeaderSize;
+    s_CurrentBytes.fetch_sub(*reinterpret_cast<size_t*>(block));
+    free(block);
+}
+
+void* operator new(size_t size)
+{
+    if (void* ptr = TrackedAlloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if (void* ptr = TrackedAlloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAlloc(size); }
+void  operator delete(void* ptr) noexcept { TrackedFree(ptr); }
+void  operator delete[](void* ptr) noexcept { TrackedFree(ptr); }
+void  operator delete(void* ptr, size_t) noexcept { TrackedFree(ptr); }
+void  operator delete[](void* ptr, size_t) noexcept { TrackedFree(ptr); }
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+            namespace BenchMemory {
+
+                size_t getCurrentBytes()
+                {
+                    return s_CurrentBytes.load();
+                }
+
+                size_t getPeakBytes()
+                {
+                    return s_PeakBytes.load();
+                }
+
+                size_t getPeakResidentBytes()
+                {
+                    return static_cast<size_t>(GetPeakResidentBytes());
+                }
+
+                void resetPeak()
+                {
+                    s_PeakBytes.store(s_CurrentBytes.load());
+
+#ifdef __linux__
+                    // Resets the high water mark of the resident set to the current one
+                    if (FILE* clearRefs = fopen("/proc/self/clear_refs", "w")) {
+                        fputs("5", clearRefs);
+                        fclose(clearRefs);
+                    }
+#endif
+                }
+            }    // namespace BenchMemory
+        }        // namespace AssetPacker
+    }            // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Heap usage of the bench process, tracked by the global operator new/delete replacements in bench_memory.cpp
+             * Only allocations that go through operator new are counted, malloc calls from C libraries aren't. The peak resident set
+             * size is reported next to it, it also sees those, the allocator overhead and the memory mapped files
+             */
+            namespace BenchMemory {
+                size_t getCurrentBytes();
+                size_t getPeakBytes();
+                /* Peak resident set size since resetPeak on Linux, since the process started on the other platforms */
+                size_t getPeakResidentBytes();
+                /* Restarts the peaks from the current usage, the resident one only where the OS can reset it */
+                void resetPeak();
+            }    // namespace BenchMemory
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
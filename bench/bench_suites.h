@@ -0,0 +1,24 @@
+#pragma once
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * A benchmark suite of RazixAssetPacker_Bench, run by name from the command line
+             * args are the command line arguments after the suite name
+             */
+            struct BenchSuite
+            {
+                const char* name;
+                const char* description;
+                int (*run)(int argc, char** argv);
+            };
+
+            int RunVertexSimdBench(int argc, char** argv);
+            int RunImporterBench(int argc, char** argv);
+            int RunSceneBench(int argc, char** argv);
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
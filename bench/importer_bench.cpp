@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench_memory.h"
+#include "bench_suites.h"
+
+#include "common/job_system.h"
+#include "common/log.h"
+#include "importer/MeshImporter.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            struct ImportMeasure
+            {
+                bool     success       = false;
+                double   bestMs        = 1e30;
+                size_t   peakBytes     = 0; /* Above what was allocated before the import */
+                size_t   peakRSS       = 0; /* Whole process, see BenchMemory::getPeakResidentBytes */
+                uint32_t submeshCount  = 0;
+                uint32_t vertexCount   = 0;
+                uint32_t triangleCount = 0;
+            };
+
+            static ImportMeasure MeasureImport(const std::string& filePath, MeshImportOptions options, uint32_t runs)
+            {
+                // The importers are chatty, their logs would dominate the output, only the errors go through
+                LogLevel logLevel = GetLogLevel();
+                SetLogLevel(LogLevel::Error);
+
+                ImportMeasure measure;
+                for (uint32_t i = 0; i < runs; i++) {
+                    size_t baseBytes = BenchMemory::getCurrentBytes();
+                    BenchMemory::resetPeak();
+                    auto start = std::chrono::high_resolution_clock::now();
+
+                    MeshImportResult result;
+                    MeshImporter     importer;
+                    measure.success = importer.importMesh(filePath, result, options);
+
+                    auto finish = std::chrono::high_resolution_clock::now();
+
+                    measure.bestMs    = std::min(measure.bestMs, std::chrono::duration<double, std::milli>(finish - start).count());
+                    measure.peakBytes = std::max(measure.peakBytes, BenchMemory::getPeakBytes() - baseBytes);
+                    measure.peakRSS   = std::max(measure.peakRSS, BenchMemory::getPeakResidentBytes());
+                    if (!measure.success)
+                        break;
+
+                    measure.submeshCount  = static_cast<uint32_t>(result.submeshes.size());
+                    measure.vertexCount   = static_cast<uint32_t>(result.vertices.Position.size());
+                    measure.triangleCount = static_cast<uint32_t>(result.indices.size() / 3);
+                }
+
+                SetLogLevel(logLevel);
+                return measure;
+            }
+
+            int RunImporterBench(int argc, char** argv)
+            {
+                if (argc < 1) {
+                    std::cout << "[ERROR!] importers needs at least one model file" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                uint32_t  runs = 3;
+                JobSystem jobSystem;
+
+                bool valid = true;
+                for (int i = 0; i < argc; i++) {
+                    std::string filePath  = argv[i];
+                    std::string extension = filePath.substr(filePath.find_last_of('.') + 1);
+                    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+                    std::cout << filePath << ", best of " << runs << " runs\n";
+
+                    ImportMeasure assimpMeasure;
+                    for (MeshImporterBackendType type: {MeshImporterBackendType::Assimp, MeshImporterBackendType::OpenFBX, MeshImporterBackendType::GlTF}) {
+                        if (type != MeshImporterBackendType::Assimp && !CreateMeshImporterBackend(type, extension))
+                            continue;
+
+                        MeshImportOptions options;
+                        options.backend   = type;
+                        options.jobSystem = &jobSystem;
+
+                        ImportMeasure measure = MeasureImport(filePath, options, runs);
+                        if (type == MeshImporterBackendType::Assimp)
+                            assimpMeasure = measure;
+
+                        std::string name = GetMeshImporterBackendName(type);
+                        name.resize(8, ' ');
+                        if (!measure.success) {
+                            std::cout << "  " << name << " : [ERROR!] Import failed\n";
+                            valid = false;
+                            continue;
+                        }
+
+                        std::cout << "  " << name << " : " << measure.bestMs << " ms";
+                        if (type != MeshImporterBackendType::Assimp && assimpMeasure.success)
+                            std::cout << " (" << assimpMeasure.bestMs / measure.bestMs << "x)";
+                        std::cout << ", peak heap " << measure.peakBytes / (1024.0 * 1024.0) << " MiB, peak RSS " << measure.peakRSS / (1024.0 * 1024.0) << " MiB, " << measure.submeshCount << " submeshes, "
+                                  << measure.vertexCount << " vertices, " << measure.triangleCount << " triangles\n";
+                    }
+                }
+
+                std::cout << std::flush;
+                return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,338 @@
+#include "procedural_scenes.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            static constexpr float kPi = 3.14159265358979f;
+
+            uint64_t ProceduralScene::getTrianglesCount() const
+            {
+                uint64_t triangles = 0;
+                for (const auto& node: nodes) {
+                    if (node.mesh >= 0)
+                        triangles += meshes[node.mesh].indices.size() / 3;
+                }
+                return triangles;
+            }
+
+            // Box centered on the origin, 4 vertices per face so the faces keep their normals and UVs
+            static ProceduralMesh GenerateBox(const std::string& name, float halfSize, uint32_t material)
+            {
+                static const glm::vec3 kNormals[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+
+                ProceduralMesh mesh;
+                mesh.name     = name;
+                mesh.material = material;
+                for (const glm::vec3& n: kNormals) {
+                    // Tangent frame of the face, u x v = n so the triangles wind counter clockwise seen from outside
+                    glm::vec3 u = std::abs(n.y) > 0.5f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+                    glm::vec3 v = glm::cross(n, u);
+                    u           = glm::cross(v, n);
+
+                    uint32_t base = static_cast<uint32_t>(mesh.positions.size());
+                    for (uint32_t corner = 0; corner < 4; corner++) {
+                        float     s = (corner == 1 || corner == 2) ? 1.0f : -1.0f;
+                        float     t = (corner >= 2) ? 1.0f : -1.0f;
+                        glm::vec3 p = (n + u * s + v * t) * halfSize;
+                        mesh.positions.push_back(p);
+                        mesh.normals.push_back(n);
+                        mesh.uvs.push_back(glm::vec2(s * 0.5f + 0.5f, t * 0.5f + 0.5f));
+                    }
+                    mesh.indices.insert(mesh.indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+                }
+                return mesh;
+            }
+
+            ProceduralScene GenerateGridScene(uint32_t quadsPerSide)
+            {
+                ProceduralScene scene;
+                scene.name = "grid_" + std::to_string(quadsPerSide);
+
+                // A gentle height field, flat grids are simplified to two triangles and say nothing about the LODs
+                constexpr float kHeight    = 0.25f;
+                constexpr float kFrequency = 0.35f;
+
+                ProceduralMesh mesh;
+                mesh.name         = "grid";
+                uint32_t vertices = quadsPerSide + 1;
+                float    offset   = quadsPerSide * 0.5f;
+                mesh.positions.reserve(size_t(vertices) * vertices);
+                mesh.normals.reserve(size_t(vertices) * vertices);
+                mesh.uvs.reserve(size_t(vertices) * vertices);
+                for (uint32_t z = 0; z < vertices; z++) {
+                    for (uint32_t x = 0; x < vertices; x++) {
+                        float px = x - offset;
+                        float pz = z - offset;
+                        float py = kHeight * std::sin(px * kFrequency) * std::cos(pz * kFrequency);
+                        float dx = kHeight * kFrequency * std::cos(px * kFrequency) * std::cos(pz * kFrequency);
+                        float dz = -kHeight * kFrequency * std::sin(px * kFrequency) * std::sin(pz * kFrequency);
+                        mesh.positions.push_back(glm::vec3(px, py, pz));
+                        mesh.normals.push_back(glm::normalize(glm::vec3(-dx, 1.0f, -dz)));
+                        mesh.uvs.push_back(glm::vec2(float(x) / quadsPerSide, float(z) / quadsPerSide));
+                    }
+                }
+
+                mesh.indices.reserve(size_t(quadsPerSide) * quadsPerSide * 6);
+                for (uint32_t z = 0; z < quadsPerSide; z++) {
+                    for (uint32_t x = 0; x < quadsPerSide; x++) {
+                        uint32_t i0 = z * vertices + x;
+                        uint32_t i1 = i0 + 1;
+                        uint32_t i2 = i0 + vertices;
+                        uint32_t i3 = i2 + 1;
+                        mesh.indices.insert(mesh.indices.end(), {i0, i2, i1, i1, i2, i3});
+                    }
+                }
+
+                scene.meshes.push_back(std::move(mesh));
+                scene.nodes.push_back({"grid", -1, glm::vec3(0.0f), 0});
+                return scene;
+            }
+
+            ProceduralScene GenerateSphereScene(uint32_t subdivisions)
+            {
+                ProceduralScene scene;
+                scene.name = "sphere_" + std::to_string(subdivisions);
+
+                ProceduralMesh mesh;
+                mesh.name = "sphere";
+
+                const float t = (1.0f + std::sqrt(5.0f)) * 0.5f;
+                for (const glm::vec3& p: {glm::vec3(-1, t, 0), glm::vec3(1, t, 0), glm::vec3(-1, -t, 0), glm::vec3(1, -t, 0), glm::vec3(0, -1, t), glm::vec3(0, 1, t), glm::vec3(0, -1, -t), glm::vec3(0, 1, -t), glm::vec3(t, 0, -1), glm::vec3(t, 0, 1), glm::vec3(-t, 0, -1), glm::vec3(-t, 0, 1)})
+                    mesh.positions.push_back(glm::normalize(p));
+                mesh.indices = {0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11, 1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8, 3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9, 4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1};
+
+                // Every edge is split once, the midpoints are shared by the two triangles of the edge
+                for (uint32_t level = 0; level < subdivisions; level++) {
+                    std::unordered_map<uint64_t, uint32_t> midpoints;
+                    auto                                   midpoint = [&](uint32_t a, uint32_t b) {
+                        uint64_t key = (uint64_t(std::min(a, b)) << 32) | std::max(a, b);
+                        auto     it  = midpoints.find(key);
+                        if (it != midpoints.end())
+                            return it->second;
+                        uint32_t index = static_cast<uint32_t>(mesh.positions.size());
+                        mesh.positions.push_back(glm::normalize(mesh.positions[a] + mesh.positions[b]));
+                        midpoints.emplace(key, index);
+                        return index;
+                    };
+
+                    std::vector<uint32_t> indices;
+                    indices.reserve(mesh.indices.size() * 4);
+                    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+                        uint32_t a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+                        uint32_t ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+                        indices.insert(indices.end(), {a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca});
+                    }
+                    mesh.indices = std::move(indices);
+                }
+
+                // Spherical mapping, the seam is wrapped and not split, it's a benchmark mesh
+                mesh.uvs.reserve(mesh.positions.size());
+                for (const glm::vec3& p: mesh.positions)
+                    mesh.uvs.push_back(glm::vec2(0.5f + std::atan2(p.z, p.x) / (2.0f * kPi), 0.5f - std::asin(glm::clamp(p.y, -1.0f, 1.0f)) / kPi));
+
+                scene.meshes.push_back(std::move(mesh));
+                scene.nodes.push_back({"sphere", -1, glm::vec3(0.0f), 0});
+                return scene;
+            }
+
+            ProceduralScene GenerateManySubMeshesScene(uint32_t submeshesCount)
+            {
+                ProceduralScene scene;
+                scene.name           = "submeshes_" + std::to_string(submeshesCount);
+                scene.materialsCount = 16;
+
+                uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(double(submeshesCount))));
+                scene.nodes.push_back({"root", -1, glm::vec3(0.0f), -1});
+                for (uint32_t i = 0; i < submeshesCount; i++) {
+                    // Slightly different sizes, so the boxes aren't all the same geometry
+                    std::string name = "box_" + std::to_string(i);
+                    scene.meshes.push_back(GenerateBox(name, 0.3f + 0.1f * float(i % 7) / 7.0f, i % scene.materialsCount));
+                    scene.nodes.push_back({name, 0, glm::vec3(float(i % side), 0.0f, float(i / side)), static_cast<int32_t>(i)});
+                }
+                return scene;
+            }
+
+            ProceduralScene GenerateDeepHierarchyScene(uint32_t depth)
+            {
+                ProceduralScene scene;
+                scene.name = "hierarchy_" + std::to_string(depth);
+
+                scene.meshes.push_back(GenerateBox("box", 0.2f, 0));
+                for (uint32_t i = 0; i < depth; i++)
+                    scene.nodes.push_back({"node_" + std::to_string(i), static_cast<int32_t>(i) - 1, i ? glm::vec3(0.5f, 0.1f, 0.0f) : glm::vec3(0.0f), 0});
+                return scene;
+            }
+
+            // Distinct colors for the materials, deterministic
+            static glm::vec3 GetMaterialColor(uint32_t material)
+            {
+                float hue = std::fmod(material * 0.618034f, 1.0f) * 2.0f * kPi;
+                return glm::vec3(0.5f + 0.5f * std::cos(hue), 0.5f + 0.5f * std::cos(hue - 2.094f), 0.5f + 0.5f * std::cos(hue + 2.094f));
+            }
+
+            bool WriteSceneGlTF(const ProceduralScene& scene, const std::string& directory, std::string& filePath)
+            {
+                constexpr uint32_t kFloat        = 5126;
+                constexpr uint32_t kUnsignedInt  = 5125;
+                constexpr uint32_t kArrayBuffer  = 34962;
+                constexpr uint32_t kElementArray = 34963;
+
+                std::vector<char> buffer;
+                std::string       views, accessors, meshes;
+                uint32_t          viewsCount = 0;
+
+                // Every stream is it's own view and accessor, streams are 4 byte types so the offsets stay aligned
+                auto addStream = [&](const void* data, size_t elementSize, size_t count, uint32_t componentType, const char* type, uint32_t target, const std::string& bounds) {
+                    size_t offset = buffer.size();
+                    buffer.insert(buffer.end(), static_cast<const char*>(data), static_cast<const char*>(data) + elementSize * count);
+
+                    views += std::string(viewsCount ? "," : "") + "{\"buffer\":0,\"byteOffset\":" + std::to_string(offset) + ",\"byteLength\":" + std::to_string(elementSize * count) + ",\"target\":" + std::to_string(target) + "}";
+                    accessors += std::string(viewsCount ? "," : "") + "{\"bufferView\":" + std::to_string(viewsCount) + ",\"componentType\":" + std::to_string(componentType) + ",\"count\":" + std::to_string(count) + ",\"type\":\"" + type + "\"" + bounds + "}";
+                    return viewsCount++;
+                };
+
+                for (size_t m = 0; m < scene.meshes.size(); m++) {
+                    const ProceduralMesh& mesh = scene.meshes[m];
+
+                    // POSITION needs it's bounds
+                    glm::vec3 minimum = mesh.positions[0], maximum = mesh.positions[0];
+                    for (const glm::vec3& p: mesh.positions) {
+                        minimum = glm::min(minimum, p);
+                        maximum = glm::max(maximum, p);
+                    }
+                    char bounds[256];
+                    snprintf(bounds, sizeof(bounds), ",\"min\":[%g,%g,%g],\"max\":[%g,%g,%g]", minimum.x, minimum.y, minimum.z, maximum.x, maximum.y, maximum.z);
+
+                    std::string attributes = "\"POSITION\":" + std::to_string(addStream(mesh.positions.data(), sizeof(glm::vec3), mesh.positions.size(), kFloat, "VEC3", kArrayBuffer, bounds));
+                    if (!mesh.normals.empty())
+                        attributes += ",\"NORMAL\":" + std::to_string(addStream(mesh.normals.data(), sizeof(glm::vec3), mesh.normals.size(), kFloat, "VEC3", kArrayBuffer, ""));
+                    if (!mesh.uvs.empty())
+                        attributes += ",\"TEXCOORD_0\":" + std::to_string(addStream(mesh.uvs.data(), sizeof(glm::vec2), mesh.uvs.size(), kFloat, "VEC2", kArrayBuffer, ""));
+                    uint32_t indices = addStream(mesh.indices.data(), sizeof(uint32_t), mesh.indices.size(), kUnsignedInt, "SCALAR", kElementArray, "");
+
+                    meshes += std::string(m ? "," : "") + "{\"name\":\"" + mesh.name + "\",\"primitives\":[{\"attributes\":{" + attributes + "},\"indices\":" + std::to_string(indices) + ",\"material\":" + std::to_string(mesh.material) + ",\"mode\":4}]}";
+                }
+
+                std::string materials;
+                for (uint32_t i = 0; i < scene.materialsCount; i++) {
+                    glm::vec3 color = GetMaterialColor(i);
+                    char      material[256];
+                    snprintf(material, sizeof(material), "%s{\"name\":\"Material_%u\",\"pbrMetallicRoughness\":{\"baseColorFactor\":[%g,%g,%g,1],\"metallicFactor\":0,\"roughnessFactor\":0.5}}", i ? "," : "", i, color.x, color.y, color.z);
+                    materials += material;
+                }
+
+                std::vector<std::vector<uint32_t>> children(scene.nodes.size());
+                std::string                        roots;
+                for (size_t i = 0; i < scene.nodes.size(); i++) {
+                    if (scene.nodes[i].parent >= 0)
+                        children[scene.nodes[i].parent].push_back(static_cast<uint32_t>(i));
+                    else
+                        roots += std::string(roots.empty() ? "" : ",") + std::to_string(i);
+                }
+
+                std::string nodes;
+                for (size_t i = 0; i < scene.nodes.size(); i++) {
+                    const ProceduralNode& node = scene.nodes[i];
+                    char                  translation[128];
+                    snprintf(translation, sizeof(translation), ",\"translation\":[%g,%g,%g]", node.translation.x, node.translation.y, node.translation.z);
+
+                    nodes += std::string(i ? "," : "") + "{\"name\":\"" + node.name + "\"" + translation;
+                    if (node.mesh >= 0)
+                        nodes += ",\"mesh\":" + std::to_string(node.mesh);
+                    if (!children[i].empty()) {
+                        nodes += ",\"children\":[";
+                        for (size_t c = 0; c < children[i].size(); c++)
+                            nodes += std::string(c ? "," : "") + std::to_string(children[i][c]);
+                        nodes += "]";
+                    }
+                    nodes += "}";
+                }
+
+                std::string binPath = directory + scene.name + ".bin";
+                filePath            = directory + scene.name + ".gltf";
+
+                std::ofstream bin(binPath, std::ios::binary | std::ios::trunc);
+                if (!bin || !bin.write(buffer.data(), static_cast<std::streamsize>(buffer.size())))
+                    return false;
+
+                std::ofstream gltf(filePath, std::ios::trunc);
+                if (!gltf)
+                    return false;
+                gltf << "{\"asset\":{\"version\":\"2.0\",\"generator\":\"RazixAssetPacker_Bench\"},\"scene\":0,\"scenes\":[{\"nodes\":[" << roots << "]}],\"nodes\":[" << nodes << "],\"meshes\":[" << meshes << "],\"materials\":[" << materials
+                     << "],\"accessors\":[" << accessors << "],\"bufferViews\":[" << views << "],\"buffers\":[{\"uri\":\"" << scene.name << ".bin\",\"byteLength\":" << buffer.size() << "}]}\n";
+                return static_cast<bool>(gltf);
+            }
+
+            bool WriteSceneOBJ(const ProceduralScene& scene, const std::string& directory, std::string& filePath)
+            {
+                std::string mtlName = scene.name + ".mtl";
+                filePath            = directory + scene.name + ".obj";
+
+                std::ofstream mtl(directory + mtlName, std::ios::trunc);
+                if (!mtl)
+                    return false;
+                for (uint32_t i = 0; i < scene.materialsCount; i++) {
+                    glm::vec3 color = GetMaterialColor(i);
+                    mtl << "newmtl Material_" << i << "\nKd " << color.x << " " << color.y << " " << color.z << "\n";
+                }
+
+                // Parents are before their children, so the world translations are a single pass
+                std::vector<glm::vec3> world(scene.nodes.size());
+                for (size_t i = 0; i < scene.nodes.size(); i++)
+                    world[i] = scene.nodes[i].translation + (scene.nodes[i].parent >= 0 ? world[scene.nodes[i].parent] : glm::vec3(0.0f));
+
+                std::ofstream obj(filePath, std::ios::trunc);
+                if (!obj)
+                    return false;
+                obj << "mtllib " << mtlName << "\n";
+
+                // Formatted into a single string per mesh, streaming every float is slower than the importers being measured
+                std::string text;
+                char        line[128];
+                uint32_t    base = 1;
+                for (size_t i = 0; i < scene.nodes.size(); i++) {
+                    const ProceduralNode& node = scene.nodes[i];
+                    if (node.mesh < 0)
+                        continue;
+
+                    const ProceduralMesh& mesh = scene.meshes[node.mesh];
+                    text.clear();
+                    text += "o " + node.name + "\nusemtl Material_" + std::to_string(mesh.material) + "\n";
+                    for (const glm::vec3& p: mesh.positions) {
+                        snprintf(line, sizeof(line), "v %g %g %g\n", p.x + world[i].x, p.y + world[i].y, p.z + world[i].z);
+                        text += line;
+                    }
+                    for (const glm::vec2& uv: mesh.uvs) {
+                        snprintf(line, sizeof(line), "vt %g %g\n", uv.x, uv.y);
+                        text += line;
+                    }
+                    for (const glm::vec3& n: mesh.normals) {
+                        snprintf(line, sizeof(line), "vn %g %g %g\n", n.x, n.y, n.z);
+                        text += line;
+                    }
+
+                    // Positions, UVs and normals share the indices
+                    for (size_t k = 0; k < mesh.indices.size(); k += 3) {
+                        uint32_t a = mesh.indices[k] + base, b = mesh.indices[k + 1] + base, c = mesh.indices[k + 2] + base;
+                        if (mesh.normals.empty())
+                            snprintf(line, sizeof(line), "f %u/%u %u/%u %u/%u\n", a, a, b, b, c, c);
+                        else
+                            snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c);
+                        text += line;
+                    }
+                    base += static_cast<uint32_t>(mesh.positions.size());
+
+                    obj.write(text.data(), static_cast<std::streamsize>(text.size()));
+                }
+                return static_cast<bool>(obj);
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            struct ProceduralMesh
+            {
+                std::string            name;
+                std::vector<glm::vec3> positions;
+                std::vector<glm::vec3> normals; /* Empty for the meshes that exercise the normal generation of the importers */
+                std::vector<glm::vec2> uvs;
+                std::vector<uint32_t>  indices;
+                uint32_t               material = 0;
+            };
+
+            struct ProceduralNode
+            {
+                std::string name;
+                int32_t     parent      = -1; /* Always before it's children, -1 for the roots */
+                glm::vec3   translation = glm::vec3(0.0f);
+                int32_t     mesh        = -1;
+            };
+
+            /**
+             * A scene of controlled size generated in memory, written as glTF or OBJ so the benchmarks don't need any asset
+             * Nodes only translate, so the OBJ writer can flatten the hierarchy. The generation is deterministic, the same size
+             * always gives the same files
+             */
+            struct ProceduralScene
+            {
+                std::string                 name;
+                std::vector<ProceduralMesh> meshes;
+                std::vector<ProceduralNode> nodes;
+                uint32_t                    materialsCount = 1;
+
+                uint64_t getTrianglesCount() const;
+            };
+
+            /* A single submesh plane of quadsPerSide x quadsPerSide quads */
+            ProceduralScene GenerateGridScene(uint32_t quadsPerSide);
+            /* Icosphere subdivided subdivisions times, 20 * 4^subdivisions triangles, no normals */
+            ProceduralScene GenerateSphereScene(uint32_t subdivisions);
+            /* submeshesCount small boxes, each with it's own mesh and one of 16 materials */
+            ProceduralScene GenerateManySubMeshesScene(uint32_t submeshesCount);
+            /* A chain of depth nodes, each child of the previous one, all drawing the same box */
+            ProceduralScene GenerateDeepHierarchyScene(uint32_t depth);
+
+            /* Writes <directory>/<name>.gltf and it's .bin buffer, filePath is the .gltf */
+            bool WriteSceneGlTF(const ProceduralScene& scene, const std::string& directory, std::string& filePath);
+            /* Writes <directory>/<name>.obj and it's .mtl, instanced meshes are written once per node with their world translation */
+            bool WriteSceneOBJ(const ProceduralScene& scene, const std::string& directory, std::string& filePath);
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
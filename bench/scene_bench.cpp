@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench_memory.h"
+#include "bench_suites.h"
+#include "procedural_scenes.h"
+
+#include "common/job_system.h"
+#include "common/log.h"
+#include "exporter/MeshExporter.h"
+#include "importer/MeshImporter.h"
+#include "processor/BVHBuilder.h"
+#include "processor/LODGenerator.h"
+#include "processor/MeshProcessor.h"
+#include "processor/MeshletGenerator.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            enum SceneBenchStage : uint32_t
+            {
+                STAGE_IMPORT,
+                STAGE_PROCESS,
+                STAGE_LODS,
+                STAGE_MESHLETS,
+                STAGE_BVH,
+                STAGE_EXPORT,
+                STAGE_COUNT
+            };
+
+            static const char* kStageNames[STAGE_COUNT] = {"import", "process", "lods", "meshlets", "bvh", "export"};
+
+            struct StageMeasure
+            {
+                double bestMs    = 1e30;
+                size_t peakBytes = 0; /* Above what was allocated before the stage            */
+                size_t peakRSS   = 0; /* Whole process, see BenchMemory::getPeakResidentBytes */
+            };
+
+            struct SceneMeasure
+            {
+                std::string  scene;
+                std::string  format;
+                bool         success       = false;
+                uint64_t     triangleCount = 0; /* Drawn by the nodes of the generated scene */
+                uint32_t     submeshCount  = 0; /* After the import                          */
+                uint32_t     vertexCount   = 0;
+                uint64_t     bytesWritten  = 0;
+                StageMeasure stages[STAGE_COUNT];
+            };
+
+            // Times a stage and records the heap it needed on top of what was already allocated, and the peak RSS of the process
+            template<typename Stage>
+            static bool MeasureStage(StageMeasure& measure, Stage stage)
+            {
+                size_t baseBytes = BenchMemory::getCurrentBytes();
+                BenchMemory::resetPeak();
+                auto start = std::chrono::high_resolution_clock::now();
+
+                bool success = stage();
+
+                auto finish       = std::chrono::high_resolution_clock::now();
+                measure.bestMs    = std::min(measure.bestMs, std::chrono::duration<double, std::milli>(finish - start).count());
+                measure.peakBytes = std::max(measure.peakBytes, BenchMemory::getPeakBytes() - baseBytes);
+                measure.peakRSS   = std::max(measure.peakRSS, BenchMemory::getPeakResidentBytes());
+                return success;
+            }
+
+            // Every run goes through the whole pipeline on a fresh import, each stage keeps it's best time
+            static void MeasureScene(SceneMeasure& measure, const std::string& filePath, const std::string& outputDirectory, uint32_t runs, JobSystem& jobSystem)
+            {
+                for (uint32_t i = 0; i < runs; i++) {
+                    MeshImportResult result;
+
+                    MeshImportOptions importOptions;
+                    importOptions.jobSystem = &jobSystem;
+
+                    MeshProcessingOptions processingOptions;
+                    processingOptions.printStatistics = false;
+
+                    MeshExportOptions exportOptions;
+                    exportOptions.assetsOutputDirectory = outputDirectory;
+                    exportOptions.jobSystem             = &jobSystem;
+
+                    MeshImporter     importer;
+                    MeshProcessor    processor;
+                    LODGenerator     lodGenerator;
+                    MeshletGenerator meshletGenerator;
+                    BVHBuilder       bvhBuilder;
+                    MeshExporter     exporter;
+
+                    measure.success = MeasureStage(measure.stages[STAGE_IMPORT], [&]() { return importer.importMesh(filePath, result, importOptions); }) &&
+                                      MeasureStage(measure.stages[STAGE_PROCESS], [&]() { return processor.processMesh(result, processingOptions, &jobSystem); }) &&
+                                      MeasureStage(measure.stages[STAGE_LODS], [&]() { return lodGenerator.generateLODs(result, LODGenerationOptions(), &jobSystem); }) &&
+                                      MeasureStage(measure.stages[STAGE_MESHLETS], [&]() { return meshletGenerator.generateMeshlets(result, MeshletGenerationOptions(), &jobSystem); }) &&
+                                      MeasureStage(measure.stages[STAGE_BVH], [&]() { return bvhBuilder.buildBVHs(result, BVHBuildOptions(), &jobSystem); }) &&
+                                      MeasureStage(measure.stages[STAGE_EXPORT], [&]() { return exporter.exportMesh(result, exportOptions); });
+                    if (!measure.success)
+                        return;
+
+                    measure.submeshCount = static_cast<uint32_t>(result.submeshes.size());
+                    measure.vertexCount  = static_cast<uint32_t>(result.vertices.Position.size());
+                    measure.bytesWritten = exporter.getBytesWritten();
+                }
+            }
+
+            static bool WriteSceneBenchJSON(const std::string& jsonPath, const std::vector<SceneMeasure>& measures, uint32_t scale, uint32_t runs)
+            {
+                std::ofstream json(jsonPath, std::ios::trunc);
+                if (!json)
+                    return false;
+
+                json << "{\n  \"scale\": " << scale << ",\n  \"runs\": " << runs << ",\n  \"results\": [";
+                for (size_t i = 0; i < measures.size(); i++) {
+                    const SceneMeasure& measure = measures[i];
+                    json << (i ? "," : "") << "\n    {\"scene\": \"" << measure.scene << "\", \"format\": \"" << measure.format << "\", \"success\": " << (measure.success ? "true" : "false")
+                         << ", \"triangles\": " << measure.triangleCount << ", \"submeshes\": " << measure.submeshCount << ", \"vertices\": " << measure.vertexCount
+                         << ", \"bytes_written\": " << measure.bytesWritten << ", \"stages\": {";
+                    for (uint32_t s = 0; s < STAGE_COUNT; s++) {
+                        double ms = measure.stages[s].bestMs < 1e30 ? measure.stages[s].bestMs : 0.0;
+                        json << (s ? ", " : "") << "\"" << kStageNames[s] << "\": {\"ms\": " << ms << ", \"peak_bytes\": " << measure.stages[s].peakBytes << ", \"peak_rss_bytes\": " << measure.stages[s].peakRSS << "}";
+                    }
+                    json << "}}";
+                }
+                json << "\n  ]\n}\n";
+                return static_cast<bool>(json);
+            }
+
+            int RunSceneBench(int argc, char** argv)
+            {
+                uint32_t    scale = 1;
+                uint32_t    runs  = 3;
+                std::string jsonPath;
+                bool        keep = false;
+                for (int i = 0; i < argc; i++) {
+                    if (!strcmp(argv[i], "--runs") && i + 1 < argc)
+                        runs = std::max(1, atoi(argv[++i]));
+                    else if (!strcmp(argv[i], "--json") && i + 1 < argc)
+                        jsonPath = argv[++i];
+                    else if (!strcmp(argv[i], "--keep"))
+                        keep = true;
+                    else if (atoi(argv[i]) > 0)
+                        scale = static_cast<uint32_t>(atoi(argv[i]));
+                    else {
+                        std::cout << "[ERROR!] Unknown scenes argument : " << argv[i] << std::endl;
+                        return EXIT_FAILURE;
+                    }
+                }
+
+                // Scenes are generated in the temp directory, the bench never depends on assets being around
+                std::filesystem::path benchDirectory = std::filesystem::temp_directory_path() / "razix_asset_packer_bench";
+                std::string           sceneDirectory = (benchDirectory / "scenes").string() + "/";
+                std::string           outputDirectory = (benchDirectory / "out").string() + "/";
+                std::error_code       error;
+                std::filesystem::create_directories(sceneDirectory, error);
+                std::filesystem::create_directories(outputDirectory + "Cache/Meshes/", error);
+                if (error) {
+                    std::cout << "[ERROR!] Can't create the bench directory " << benchDirectory.string() << " : " << error.message() << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                // The sphere quadruples it's triangles per subdivision, the cap keeps it around a million triangles
+                std::vector<ProceduralScene> scenes;
+                scenes.push_back(GenerateGridScene(256 * scale));
+                scenes.push_back(GenerateSphereScene(std::min(5 + scale, 8u)));
+                scenes.push_back(GenerateManySubMeshesScene(512 * scale));
+                scenes.push_back(GenerateDeepHierarchyScene(256 * scale));
+
+                JobSystem jobSystem;
+
+                // The pipeline logs would dominate the output, only the errors go through
+                LogLevel logLevel = GetLogLevel();
+
+                std::vector<SceneMeasure> measures;
+                bool                      valid = true;
+                for (const ProceduralScene& scene: scenes) {
+                    std::cout << scene.name << ", " << scene.getTrianglesCount() << " triangles, best of " << runs << " runs\n";
+
+                    for (const char* format: {"gltf", "obj"}) {
+                        SceneMeasure measure;
+                        measure.scene         = scene.name;
+                        measure.format        = format;
+                        measure.triangleCount = scene.getTrianglesCount();
+
+                        std::string filePath;
+                        bool        written = !strcmp(format, "gltf") ? WriteSceneGlTF(scene, sceneDirectory, filePath) : WriteSceneOBJ(scene, sceneDirectory, filePath);
+
+                        std::string name = format;
+                        name.resize(4, ' ');
+                        if (!written) {
+                            std::cout << "  " << name << " : [ERROR!] Can't write " << filePath << "\n";
+                            measures.push_back(measure);
+                            valid = false;
+                            continue;
+                        }
+
+                        SetLogLevel(LogLevel::Error);
+                        MeasureScene(measure, filePath, outputDirectory, runs, jobSystem);
+                        SetLogLevel(logLevel);
+                        measures.push_back(measure);
+
+                        if (!measure.success) {
+                            std::cout << "  " << name << " : [ERROR!] Pipeline failed\n";
+                            valid = false;
+                            continue;
+                        }
+
+                        size_t peakBytes = 0, peakRSS = 0;
+                        std::cout << "  " << name << " :";
+                        for (uint32_t s = 0; s < STAGE_COUNT; s++) {
+                            std::cout << " " << kStageNames[s] << " " << measure.stages[s].bestMs << " ms" << (s + 1 < STAGE_COUNT ? "," : "");
+                            peakBytes = std::max(peakBytes, measure.stages[s].peakBytes);
+                            peakRSS   = std::max(peakRSS, measure.stages[s].peakRSS);
+                        }
+                        std::cout << "\n         peak heap " << peakBytes / (1024.0 * 1024.0) << " MiB, peak RSS " << peakRSS / (1024.0 * 1024.0) << " MiB, " << measure.submeshCount << " submeshes, " << measure.vertexCount << " vertices, "
+                                  << measure.bytesWritten / 1024 << " KiB written\n";
+                    }
+                }
+
+                if (!jsonPath.empty()) {
+                    if (WriteSceneBenchJSON(jsonPath, measures, scale, runs))
+                        std::cout << "Results written to " << jsonPath << "\n";
+                    else {
+                        std::cout << "[ERROR!] Can't write " << jsonPath << "\n";
+                        valid = false;
+                    }
+                }
+
+                if (!keep)
+                    std::filesystem::remove_all(benchDirectory, error);
+                else
+                    std::cout << "Scenes and exported files kept in " << benchDirectory.string() << "\n";
+
+                std::cout << std::flush;
+                return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
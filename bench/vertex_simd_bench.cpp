@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "bench_suites.h"
+
+#include "common/vertex_simd.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            // Source streams laid out like an aiMesh, packed xyz floats
+            struct SourceMesh
+            {
+                std::vector<glm::vec3> positions;
+                std::vector<glm::vec3> normals;
+                std::vector<glm::vec3> tangents;
+                std::vector<glm::vec3> bitangents;
+            };
+
+            struct ImportedStreams
+            {
+                std::vector<glm::vec3> positions;
+                std::vector<glm::vec3> normals;
+                std::vector<glm::vec3> tangents;
+                std::vector<float>     signs;
+                glm::vec3              min_extents;
+                glm::vec3              max_extents;
+            };
+
+            // Best of a few runs, the first one also pays for the page faults of the destination
+            template<typename Func>
+            static double MeasureMs(uint32_t runs, Func&& func)
+            {
+                double best = 1e30;
+                for (uint32_t i = 0; i < runs; i++) {
+                    auto start  = std::chrono::high_resolution_clock::now();
+                    func();
+                    auto finish = std::chrono::high_resolution_clock::now();
+                    best        = std::min(best, std::chrono::duration<double, std::milli>(finish - start).count());
+                }
+                return best;
+            }
+
+            // The per-vertex loop MeshImporter::importMesh used before the bulk path
+            static void ImportPerVertex(const SourceMesh& src, ImportedStreams& dst)
+            {
+                dst.max_extents = src.positions[0];
+                dst.min_extents = src.positions[0];
+
+                for (size_t k = 0; k < src.positions.size(); k++) {
+                    dst.positions[k] = glm::vec3(src.positions[k].x, src.positions[k].y, src.positions[k].z);
+                    glm::vec3 n      = glm::vec3(src.normals[k].x, src.normals[k].y, src.normals[k].z);
+                    dst.normals[k]   = n;
+
+                    glm::vec3 t = glm::vec3(src.tangents[k].x, src.tangents[k].y, src.tangents[k].z);
+                    glm::vec3 b = glm::vec3(src.bitangents[k].x, src.bitangents[k].y, src.bitangents[k].z);
+                    dst.tangents[k] = t;
+                    dst.signs[k]    = glm::dot(glm::cross(n, t), b) < 0.0f ? -1.0f : 1.0f;
+
+                    if (dst.positions[k].x > dst.max_extents.x)
+                        dst.max_extents.x = dst.positions[k].x;
+                    if (dst.positions[k].y > dst.max_extents.y)
+                        dst.max_extents.y = dst.positions[k].y;
+                    if (dst.positions[k].z > dst.max_extents.z)
+                        dst.max_extents.z = dst.positions[k].z;
+
+                    if (dst.positions[k].x < dst.min_extents.x)
+                        dst.min_extents.x = dst.positions[k].x;
+                    if (dst.positions[k].y < dst.min_extents.y)
+                        dst.min_extents.y = dst.positions[k].y;
+                    if (dst.positions[k].z < dst.min_extents.z)
+                        dst.min_extents.z = dst.positions[k].z;
+                }
+            }
+
+            static void ImportBulk(const SourceMesh& src, ImportedStreams& dst, SimdLevel level)
+            {
+                uint32_t count = static_cast<uint32_t>(src.positions.size());
+                memcpy(static_cast<void*>(dst.positions.data()), src.positions.data(), count * sizeof(glm::vec3));
+                memcpy(static_cast<void*>(dst.normals.data()), src.normals.data(), count * sizeof(glm::vec3));
+                memcpy(static_cast<void*>(dst.tangents.data()), src.tangents.data(), count * sizeof(glm::vec3));
+                ComputeTangentSigns(dst.normals.data(), src.bitangents.data(), dst.tangents.data(), dst.signs.data(), count, level);
+                ComputeBounds(dst.positions.data(), count, dst.min_extents, dst.max_extents, level);
+            }
+
+            static bool SameStreams(const ImportedStreams& a, const ImportedStreams& b)
+            {
+                auto sameBits = [](const std::vector<glm::vec3>& x, const std::vector<glm::vec3>& y) {
+                    return memcmp(x.data(), y.data(), x.size() * sizeof(glm::vec3)) == 0;
+                };
+                return sameBits(a.positions, b.positions) && sameBits(a.normals, b.normals) && sameBits(a.tangents, b.tangents) && a.signs == b.signs &&
+                       a.min_extents.x == b.min_extents.x && a.min_extents.y == b.min_extents.y && a.min_extents.z == b.min_extents.z &&
+                       a.max_extents.x == b.max_extents.x && a.max_extents.y == b.max_extents.y && a.max_extents.z == b.max_extents.z;
+            }
+
+            int RunVertexSimdBench(int argc, char** argv)
+            {
+                uint32_t count = argc > 0 ? static_cast<uint32_t>(std::stoul(argv[0])) : 4000000;
+                uint32_t runs  = 5;
+
+                // Random frames, about half of them left handed
+                SourceMesh                            src;
+                std::mt19937                          rng(1234);
+                std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+                std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+                auto                                  randomDirection = [&]() {
+                    return glm::normalize(glm::vec3(direction(rng), direction(rng), direction(rng)) + glm::vec3(1e-3f));
+                };
+                src.positions.resize(count);
+                src.normals.resize(count);
+                src.tangents.resize(count);
+                src.bitangents.resize(count);
+                for (uint32_t i = 0; i < count; i++) {
+                    src.positions[i]  = glm::vec3(position(rng), position(rng), position(rng));
+                    src.normals[i]    = randomDirection();
+                    src.tangents[i]   = randomDirection();
+                    src.bitangents[i] = randomDirection();
+                }
+
+                auto allocate = [count](ImportedStreams& streams) {
+                    streams.positions.resize(count);
+                    streams.normals.resize(count);
+                    streams.tangents.resize(count);
+                    streams.signs.resize(count);
+                };
+
+                ImportedStreams reference;
+                allocate(reference);
+                double referenceMs = MeasureMs(runs, [&]() { ImportPerVertex(src, reference); });
+
+                std::cout << count << " vertices, best of " << runs << " runs, detected " << GetSimdLevelName(ResolveSimdLevel()) << "\n";
+                std::cout << "  per-vertex loop     : " << referenceMs << " ms (" << count / (referenceMs * 1e3) << " Mverts/s)\n";
+
+                bool valid = true;
+                for (SimdLevel level: {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+                    if (ResolveSimdLevel(level) != level) {
+                        std::cout << "  " << GetSimdLevelName(level) << " : not supported\n";
+                        continue;
+                    }
+
+                    ImportedStreams streams;
+                    allocate(streams);
+                    double bulkMs = MeasureMs(runs, [&]() { ImportBulk(src, streams, level); });
+
+                    glm::vec3 min_extents, max_extents;
+                    double    boundsMs   = MeasureMs(runs, [&]() { ComputeBounds(streams.positions.data(), count, min_extents, max_extents, level); });
+                    double    tangentsMs = MeasureMs(runs, [&]() { ComputeTangentSigns(streams.normals.data(), src.bitangents.data(), streams.tangents.data(), streams.signs.data(), count, level); });
+
+                    bool same = SameStreams(reference, streams);
+                    valid     = valid && same;
+
+                    std::string name = GetSimdLevelName(level);
+                    name.resize(6, ' ');
+                    std::cout << "  bulk " << name << "         : " << bulkMs << " ms (" << referenceMs / bulkMs << "x), bounds " << boundsMs << " ms, tangent signs " << tangentsMs << " ms" << (same ? "" : " [ERROR!] Results differ") << "\n";
+                }
+
+                std::cout << std::flush;
+                return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
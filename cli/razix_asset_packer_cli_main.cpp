@@ -1,39 +1,452 @@
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <new>
 
-#include "exporter/MeshExporter.h"
-#include "importer/MeshImporter.h"
+#include "common/job_system.h"
+#include "common/log.h"
+#include "common/profiler.h"
+#include "loader/MaterialLibraryReader.h"
+#include "loader/MeshFileReader.h"
+#include "loader/ModelFileReader.h"
+#include "loader/PackFileReader.h"
+#include "pipeline/AssetPipeline.h"
+#include "pipeline/AssetWatcher.h"
+
+// The CLI owns the process, so it counts every allocation for the stats and the trace (see CountAllocation)
+void* operator new(size_t size)
+{
+    Razix::Tool::AssetPacker::CountAllocation(size);
+    if (void* ptr = malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+// Prints and decodes every blob, the views are only valid while their reader is open
+static bool CheckBlobs(const std::vector<Razix::Tool::AssetPacker::BlobView>& blobs)
+{
+    bool                 valid = true;
+    std::vector<uint8_t> decoded;
+    for (const auto& blob: blobs) {
+        std::cout << "  " << blob.typeName << " : offset " << blob.offset << ", " << blob.encoding.element_count << " x " << blob.stride << " bytes";
+        if (!blob.isRaw())
+            std::cout << " (" << blob.encoding.encoded_size << " bytes encoded)";
+        if (!Razix::Tool::AssetPacker::DecodeBlobView(blob, decoded)) {
+            std::cout << " [ERROR!] Failed to decode";
+            valid = false;
+        }
+        std::cout << "\n";
+    }
+    return valid;
+}
+
+static int InspectFile(const std::string& filePath)
+{
+    bool valid = false;
+    if (filePath.size() > 7 && filePath.compare(filePath.size() - 7, 7, ".rzpack") == 0) {
+        Razix::Tool::AssetPacker::PackFileReader reader;
+        if (!reader.open(filePath)) {
+            std::cout << "[ERROR!] Invalid pack : " << reader.getError() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const auto& header = reader.getHeader();
+        std::cout << filePath << " : " << header.submesh_count << " submeshes, " << header.material_count << " materials, " << header.node_count << " nodes, sections aligned to " << header.alignment << " bytes\n";
+        valid = CheckBlobs(reader.getSections());
+    } else if (filePath.size() > 8 && filePath.compare(filePath.size() - 8, 8, ".rzmodel") == 0) {
+        Razix::Tool::AssetPacker::ModelFileReader reader;
+        if (!reader.open(filePath)) {
+            std::cout << "[ERROR!] Invalid model : " << reader.getError() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const auto& header   = reader.getHeader();
+        const char* packPath = reader.getString(header.pack_path_offset);
+        std::cout << filePath << " : " << reader.getString(header.name_offset) << ", " << header.node_count << " nodes, " << header.submesh_count << " submeshes, " << header.material_count << " materials";
+        if (packPath)
+            std::cout << ", packed in " << packPath;
+        std::cout << "\n";
+        valid = true;
+    } else if (filePath.size() > 9 && filePath.compare(filePath.size() - 9, 9, ".rzmatlib") == 0) {
+        Razix::Tool::AssetPacker::MaterialLibraryReader reader;
+        if (!reader.open(filePath)) {
+            std::cout << "[ERROR!] Invalid material library : " << reader.getError() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const auto& header = reader.getHeader();
+        std::cout << filePath << " : " << header.material_count << " materials, " << header.string_table_size << " bytes of strings\n";
+        for (uint32_t i = 0; i < header.material_count; i++) {
+            const auto& material = reader.getMaterials()[i];
+            std::cout << "  " << reader.getString(material.name_offset) << " : workflow " << material.workflow;
+            for (uint32_t t = 0; t < Razix::Tool::AssetPacker::MATERIAL_TEXTURE_COUNT; t++) {
+                if (const char* texture = reader.getString(material.textures[t]))
+                    std::cout << ", " << texture;
+            }
+            std::cout << "\n";
+        }
+        valid = true;
+    } else {
+        Razix::Tool::AssetPacker::MeshFileReader reader;
+        if (!reader.open(filePath)) {
+            std::cout << "[ERROR!] Invalid mesh : " << reader.getError() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::cout << filePath << " : V" << reader.getFileHeader().version << ", " << reader.getMeshHeader().vertex_count << " vertices, " << reader.getMeshHeader().index_count << " indices";
+        if (reader.isAligned())
+            std::cout << ", blobs aligned to " << reader.getExtHeader().blob_alignment << " bytes";
+        std::cout << "\n";
+        valid = CheckBlobs(reader.getBlobs());
+    }
+
+    std::cout << std::flush;
+    return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Set by Ctrl+C, the watch loop finishes the current repack and returns
+static std::atomic<bool> s_StopWatching = false;
+
+static void StopWatching(int)
+{
+    s_StopWatching = true;
+}
+
+static void PrintUsage()
+{
+    std::cout << "Usage: RazixAssetPacker_CLI [options] <model file | directory | manifest.txt>\n"
+              << "  -o, --output <dir>  Assets output directory\n"
+              << "  -j, --jobs <N>      Number of worker threads (default: all hardware threads)\n"
+              << "  --encode            Encode vertex and index blobs with the meshopt codecs\n"
+              << "  --compress          Deflate every blob\n"
+              << "  --quantize          Quantize the vertex attributes (unorm16 positions, octahedral normals/tangents, 16-bit UVs, unorm8 colors)\n"
+              << "  --weld [distance]   Weld near duplicate vertices within distance (default: 0.05), keeping hard edges and UV seams\n"
+              << "  --lods <N>          Generate a chain of up to N LODs per submesh\n"
+              << "  --meshlets [V] [T]  Split submeshes into meshlets of at most V vertices and T triangles (default: 64 124)\n"
+              << "  --bvh [N]           Build a SAH BVH of every submesh with at most N triangles per leaf (default: 4)\n"
+              << "  --pack              Export a single .rzpack file per model instead of a .rzmesh per submesh\n"
+              << "  --dedup             Write identical submeshes once to Cache/Meshes/Shared/, across all the models (not with --pack)\n"
+              << "  --align <N>         Align every blob/section payload to N bytes (ex. 4096) so files can be memory mapped\n"
+              << "  --importer <name>   Importer backend: auto (native backend when the format has one), assimp, openfbx, gltf\n"
+              << "  --preset <name>     Assimp post processing: fast, balanced (default) or full (+ cache locality and validation)\n"
+              << "  --textures          Compress the material textures to .dds with mips (BC7 color, BC5 normals)\n"
+              << "  --fast-textures     Like --textures with BC1/BC3 instead of BC7, a lot faster to encode\n"
+              << "  --max-texture <N>   Drop the texture mips bigger than N pixels\n"
+              << "  --skinning          Import bone weights, the skeleton and the animation clips (Assimp importer), see Cache/Animations/\n"
+              << "  --stream [depth]    Import (with Assimp), process and export a submesh at a time to bound the memory of huge models (not with --pack)\n"
+              << "  --force             Rebuild every model even if the build cache says it's up to date\n"
+              << "  --no-cache          Don't read or write the build cache (<output>/Cache/build_cache.txt)\n"
+              << "  --material-json     Also write every unique material to a JSON .rzmaterial for debugging\n"
+              << "  --log <level>       Console output: error, warning, info (default) or verbose (every submesh, material and texture)\n"
+              << "  --trace <file>      Write a Chrome trace (chrome://tracing, ui.perfetto.dev) of every stage on every thread\n"
+              << "  --watch [ms]        Stay resident after packing and repack the models whose sources change, once they are quiet for ms (default: 100)\n"
+              << "  --notify <port>     With --watch, send the repacked files to the engine as \"reload <path>\" UDP lines on 127.0.0.1:port\n"
+              << "  --inspect <file>    Validate a .rzmesh/.rzpack/.rzmodel/.rzmatlib file and print it's blobs\n"
+              << "  -h, --help          Show this message\n"
+              << "A directory is searched recursively for models, a manifest lists a model path per line" << std::endl;
+}
+
+// The whole string has to be a number, std::stoul would throw on garbage and accept trailing characters
+static bool ParseUnsigned(const char* str, uint32_t& value)
+{
+    char*         end    = nullptr;
+    errno                = 0;
+    unsigned long parsed = strtoul(str, &end, 10);
+    if (!isdigit(str[0]) || *end != '\0' || errno == ERANGE || parsed > UINT32_MAX)
+        return false;
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+static bool ParseFloat(const char* str, float& value)
+{
+    char* end    = nullptr;
+    errno        = 0;
+    float parsed = strtof(str, &end);
+    if (end == str || *end != '\0' || errno == ERANGE || !(parsed >= 0.0f))
+        return false;
+    value = parsed;
+    return true;
+}
+
+static int InvalidValue(const char* option, const char* value)
+{
+    std::cout << "[ERROR!] Invalid value for " << option << " : " << value << std::endl;
+    PrintUsage();
+    return EXIT_FAILURE;
+}
 
 int main(int argc, char* argv[])
 {
-    // TODO: Use command line args
+    std::string inputPath        = "X:/Game Engines/Razix/Sandbox/Assets/Models/Sponza/Sponza.gltf";
+    std::string outputDirectory  = "X:/Game Engines/Razix/Sandbox/Assets/";
+    uint32_t    workersCount     = 0;
+    bool        encode           = false;
+    bool        compress         = false;
+    bool        quantize         = false;
+    uint32_t    lodsCount        = 0;
+    bool        meshlets         = false;
+    uint32_t    meshletVertices  = 64;
+    uint32_t    meshletTriangles = 124;
+    bool        bvh              = false;
+    uint32_t    bvhLeafTriangles = 4;
+    bool        pack             = false;
+    bool        dedup            = false;
+    bool        materialJSON     = false;
+    uint32_t    alignment        = 0;
+    bool        force            = false;
+    bool        useCache         = true;
+    bool        stream           = false;
+    bool        skinning         = false;
+    bool        textures         = false;
+    bool        fastTextures     = false;
+    uint32_t    maxTextureSize   = 0;
+    uint32_t    streamDepth      = 0;
+    bool        weld             = false;
+    float       weldDistance     = 0.05f;
+    bool        watch            = false;
+    uint32_t    watchDebounceMs  = 100;
+    uint32_t    notifyPort       = 0;
 
-    // Results of the mesh import
-    Razix::Tool::AssetPacker::MeshImportResult import_result;
-    // Mesh import options
-    Razix::Tool::AssetPacker::MeshImportOptions import_options{};
+    Razix::Tool::AssetPacker::MeshImporterBackendType importerBackend = Razix::Tool::AssetPacker::MeshImporterBackendType::Auto;
+    Razix::Tool::AssetPacker::MeshImportPreset        importPreset    = Razix::Tool::AssetPacker::MeshImportPreset::Balanced;
+    std::string                                       tracePath;
 
-    // Importer
-    Razix::Tool::AssetPacker::MeshImporter* importer = new Razix::Tool::AssetPacker::MeshImporter;
-    bool                                    result   = importer->importMesh("X:/Game Engines/Razix/Sandbox/Assets/Models/Sponza/Sponza.gltf", import_result, import_options);
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if ((!strcmp(arg, "-o") || !strcmp(arg, "--output")) && i + 1 < argc)
+            outputDirectory = argv[++i];
+        else if ((!strcmp(arg, "-j") || !strcmp(arg, "--jobs")) && i + 1 < argc) {
+            if (!ParseUnsigned(argv[++i], workersCount))
+                return InvalidValue(arg, argv[i]);
+        } else if (!strcmp(arg, "--encode"))
+            encode = true;
+        else if (!strcmp(arg, "--compress"))
+            compress = true;
+        else if (!strcmp(arg, "--quantize"))
+            quantize = true;
+        else if (!strcmp(arg, "--weld")) {
+            weld = true;
+            // The distance is optional
+            if (i + 1 < argc && (isdigit(argv[i + 1][0]) || argv[i + 1][0] == '.'))
+                if (!ParseFloat(argv[++i], weldDistance))
+                    return InvalidValue(arg, argv[i]);
+        } else if (!strcmp(arg, "--lods") && i + 1 < argc) {
+            if (!ParseUnsigned(argv[++i], lodsCount))
+                return InvalidValue(arg, argv[i]);
+        } else if (!strcmp(arg, "--pack"))
+            pack = true;
+        else if (!strcmp(arg, "--dedup"))
+            dedup = true;
+        else if (!strcmp(arg, "--material-json"))
+            materialJSON = true;
+        else if (!strcmp(arg, "--align") && i + 1 < argc) {
+            if (!ParseUnsigned(argv[++i], alignment))
+                return InvalidValue(arg, argv[i]);
+        } else if (!strcmp(arg, "--importer") && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (!strcmp(name, "auto"))
+                importerBackend = Razix::Tool::AssetPacker::MeshImporterBackendType::Auto;
+            else if (!strcmp(name, "assimp"))
+                importerBackend = Razix::Tool::AssetPacker::MeshImporterBackendType::Assimp;
+            else if (!strcmp(name, "openfbx"))
+                importerBackend = Razix::Tool::AssetPacker::MeshImporterBackendType::OpenFBX;
+            else if (!strcmp(name, "gltf"))
+                importerBackend = Razix::Tool::AssetPacker::MeshImporterBackendType::GlTF;
+            else {
+                std::cout << "[ERROR!] Unknown importer : " << name << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (!strcmp(arg, "--preset") && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (!strcmp(name, "fast"))
+                importPreset = Razix::Tool::AssetPacker::MeshImportPreset::Fast;
+            else if (!strcmp(name, "balanced"))
+                importPreset = Razix::Tool::AssetPacker::MeshImportPreset::Balanced;
+            else if (!strcmp(name, "full"))
+                importPreset = Razix::Tool::AssetPacker::MeshImportPreset::Full;
+            else {
+                std::cout << "[ERROR!] Unknown import preset : " << name << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (!strcmp(arg, "--textures"))
+            textures = true;
+        else if (!strcmp(arg, "--fast-textures"))
+            textures = fastTextures = true;
+        else if (!strcmp(arg, "--max-texture") && i + 1 < argc) {
+            if (!ParseUnsigned(argv[++i], maxTextureSize))
+                return InvalidValue(arg, argv[i]);
+        } else if (!strcmp(arg, "--stream")) {
+            stream = true;
+            // The queue depth is optional
+            if (i + 1 < argc && isdigit(argv[i + 1][0]) && !ParseUnsigned(argv[++i], streamDepth))
+                return InvalidValue(arg, argv[i]);
+        } else if (!strcmp(arg, "--skinning"))
+            skinning = true;
+        else if (!strcmp(arg, "--force"))
+            force = true;
+        else if (!strcmp(arg, "--no-cache"))
+            useCache = false;
+        else if (!strcmp(arg, "--log") && i + 1 < argc) {
+            Razix::Tool::AssetPacker::LogLevel level;
+            if (!Razix::Tool::AssetPacker::ParseLogLevel(argv[++i], level)) {
+                std::cout << "[ERROR!] Unknown log level : " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+            Razix::Tool::AssetPacker::SetLogLevel(level);
+        } else if (!strcmp(arg, "--trace") && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (!strcmp(arg, "--watch")) {
+            watch = true;
+            // The debounce time is optional
+            if (i + 1 < argc && isdigit(argv[i + 1][0]) && !ParseUnsigned(argv[++i], watchDebounceMs))
+                return InvalidValue(arg, argv[i]);
+        } else if (!strcmp(arg, "--notify") && i + 1 < argc) {
+            if (!ParseUnsigned(argv[++i], notifyPort) || notifyPort == 0 || notifyPort > 65535)
+                return InvalidValue(arg, argv[i]);
+        } else if (!strcmp(arg, "--inspect") && i + 1 < argc)
+            return InspectFile(argv[++i]);
+        else if (!strcmp(arg, "--meshlets")) {
+            meshlets = true;
+            // Both limits are optional
+            if (i + 2 < argc && isdigit(argv[i + 1][0]) && isdigit(argv[i + 2][0])) {
+                if (!ParseUnsigned(argv[++i], meshletVertices))
+                    return InvalidValue(arg, argv[i]);
+                if (!ParseUnsigned(argv[++i], meshletTriangles))
+                    return InvalidValue(arg, argv[i]);
+            }
+        } else if (!strcmp(arg, "--bvh")) {
+            bvh = true;
+            if (i + 1 < argc && isdigit(argv[i + 1][0]) && !ParseUnsigned(argv[++i], bvhLeafTriangles))
+                return InvalidValue(arg, argv[i]);
+        } else if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+            PrintUsage();
+            return EXIT_SUCCESS;
+        } else if (arg[0] == '-') {
+            std::cout << "[ERROR!] Unknown option : " << arg << std::endl;
+            PrintUsage();
+            return EXIT_FAILURE;
+        } else
+            inputPath = arg;
+    }
 
-    if (!result) {
-        std::cout << "[ERROR!] Mesh Importing Failed" << std::endl;
+    if (!outputDirectory.empty() && outputDirectory.back() != '/' && outputDirectory.back() != '\\')
+        outputDirectory += '/';
+
+    std::vector<std::string> modelFilePaths = Razix::Tool::AssetPacker::AssetPipeline::collectModelPaths(inputPath);
+    if (modelFilePaths.empty()) {
+        std::cout << "[ERROR!] No models found at : " << inputPath << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Import, Export Options
+    Razix::Tool::AssetPacker::AssetPipelineOptions options{};
+    options.importOptions.encodeVertices        = encode;
+    options.importOptions.encodeIndices         = encode;
+    options.importOptions.backend               = importerBackend;
+    options.importOptions.preset                = importPreset;
+    options.importOptions.importSkinning        = skinning;
+    options.importOptions.mergeDistance         = weldDistance;
+    options.importOptions.keepInstances         = dedup;
+    options.processingOptions.weldVertices      = weld;
+    options.generateLODs                        = lodsCount > 0;
+    options.lodOptions.maxLODs                  = lodsCount;
+    options.generateMeshlets                    = meshlets;
+    options.meshletOptions.maxVertices          = meshletVertices;
+    options.meshletOptions.maxTriangles         = meshletTriangles;
+    options.generateBVH                         = bvh;
+    options.bvhOptions.maxLeafTriangles         = bvhLeafTriangles;
+    options.exportOptions.assetsOutputDirectory = outputDirectory;
+    options.exportOptions.useCompression        = compress;
+    options.exportOptions.packModel             = pack;
+    options.exportOptions.deduplicate           = dedup;
+    options.exportOptions.materialJSON          = materialJSON;
+    options.exportOptions.blobAlignment         = alignment;
+    options.useBuildCache                       = useCache;
+    options.forceRebuild                        = force;
+    options.processTextures                     = textures;
+    options.textureOptions.highQuality          = !fastTextures;
+    options.textureOptions.maxSize              = maxTextureSize;
+    options.streaming                           = stream;
+    options.streamQueueDepth                    = streamDepth;
+    if (alignment > 0)
+        options.exportOptions.packAlignment = alignment;
+    if (stream && !pack && (importerBackend == Razix::Tool::AssetPacker::MeshImporterBackendType::OpenFBX || importerBackend == Razix::Tool::AssetPacker::MeshImporterBackendType::GlTF)) {
+        std::cout << "[ERROR!] The native importers read the whole model, --stream needs --importer auto or assimp" << std::endl;
         return EXIT_FAILURE;
     }
+    if (stream && pack)
+        std::cout << "[WARNING!] .rzpack files need the whole model, --stream is ignored with --pack" << std::endl;
+    if (dedup && pack)
+        std::cout << "[WARNING!] .rzpack files are self contained, --dedup is ignored with --pack" << std::endl;
+    if (notifyPort && !watch)
+        std::cout << "[WARNING!] Only repacks are notified, --notify is ignored without --watch" << std::endl;
+    if (quantize) {
+        options.exportOptions.vertexFormat.position = Razix::Tool::AssetPacker::PositionFormat::UNorm16;
+        options.exportOptions.vertexFormat.normal   = Razix::Tool::AssetPacker::NormalFormat::Octahedral16;
+        options.exportOptions.vertexFormat.uv       = Razix::Tool::AssetPacker::UVFormat::UNorm16;
+        options.exportOptions.vertexFormat.color    = Razix::Tool::AssetPacker::ColorFormat::UNorm8;
+    }
+
+    if (!tracePath.empty()) {
+        Razix::Tool::AssetPacker::EnableProfiling(true);
+        Razix::Tool::AssetPacker::SetProfilerThreadName("Main");
+    }
+
+    Razix::Tool::AssetPacker::JobSystem     jobSystem(workersCount);
+    Razix::Tool::AssetPacker::AssetPipeline pipeline(jobSystem);
+
+    auto start  = std::chrono::high_resolution_clock::now();
+    bool result = pipeline.packBatch(modelFilePaths, options);
+    auto finish = std::chrono::high_resolution_clock::now();
 
-    delete importer;
+    std::chrono::duration<double> time = finish - start;
+    pipeline.printStats(time.count());
 
-    // Export Options
-    Razix::Tool::AssetPacker::MeshExportOptions export_options{};
-    export_options.assetsOutputDirectory = "X:/Game Engines/Razix/Sandbox/Assets/";
-    // Exporter
-    Razix::Tool::AssetPacker::MeshExporter exporter;
-    result = exporter.exportMesh(import_result, export_options);
+    // Failed models are reported and stay watched, the exit code only tells if watching worked
+    if (watch) {
+        Razix::Tool::AssetPacker::AssetWatchOptions watchOptions;
+        watchOptions.debounceMs = watchDebounceMs;
+        watchOptions.notifyPort = static_cast<uint16_t>(notifyPort);
+
+        Razix::Tool::AssetPacker::AssetWatcher watcher(pipeline, options, watchOptions);
+        std::signal(SIGINT, StopWatching);
+
+        result = watcher.watch(inputPath, modelFilePaths);
+        if (result) {
+            std::cout << "Watching for changes, Ctrl+C to stop" << std::endl;
+            result = watcher.run(s_StopWatching);
+        }
+    }
+
+    // In watch mode the trace covers the repacks too
+    if (!tracePath.empty()) {
+        if (Razix::Tool::AssetPacker::WriteChromeTrace(tracePath))
+            std::cout << "Trace written to : " << tracePath << std::endl;
+        else
+            std::cout << "[ERROR!] Failed to write the trace : " << tracePath << std::endl;
+    }
 
     if (!result) {
-        std::cout << "[ERROR!] Mesh Export Failed" << std::endl;
+        std::cout << (watch ? "[ERROR!] Watching Failed" : "[ERROR!] Packing Failed") << std::endl;
         return EXIT_FAILURE;
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
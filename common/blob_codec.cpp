@@ -0,0 +1,123 @@
+#include "blob_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <meshoptimizer.h>
+#include <miniz.h>
+
+#include "common/scratch_arena.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            bool EncodeBlob(const void* data, uint32_t elementCount, uint32_t stride, uint32_t encodingFlags, std::vector<uint8_t>& encoded, BINBlobEncoding& encoding)
+            {
+                encoding               = {};
+                encoding.element_count = elementCount;
+                encoding.decoded_size  = elementCount * stride;
+
+                // Without deflate the codec output is the final payload and is written straight to encoded,
+                // otherwise it goes to a scratch buffer that is reused by the next blobs of this thread
+                ScratchScope          scope(GetThreadScratchArena());
+                bool                  deflate     = (encodingFlags & BLOB_ENCODING_DEFLATE) && encoding.decoded_size > 0;
+                std::vector<uint8_t>& codec       = deflate ? GetThreadScratchArena().acquireBuffer() : encoded;
+                const uint8_t*        payload     = static_cast<const uint8_t*>(data);
+                size_t                payloadSize = encoding.decoded_size;
+
+                // The vertex codec works on 4 byte aligned vertices up to 256 bytes, the index codec on triangle lists
+                if ((encodingFlags & BLOB_ENCODING_MESHOPT_VERTEX) && stride % 4 == 0 && stride <= 256 && elementCount > 0) {
+                    codec.resize(meshopt_encodeVertexBufferBound(elementCount, stride));
+                    codec.resize(meshopt_encodeVertexBuffer(codec.data(), codec.size(), data, elementCount, stride));
+                    if (codec.empty())
+                        return false;
+
+                    encoding.flags |= BLOB_ENCODING_MESHOPT_VERTEX;
+                } else if ((encodingFlags & BLOB_ENCODING_MESHOPT_INDEX) && stride == sizeof(uint32_t) && elementCount % 3 == 0 && elementCount > 0) {
+                    const uint32_t* indices      = static_cast<const uint32_t*>(data);
+                    size_t          vertex_count = *std::max_element(indices, indices + elementCount) + 1;
+
+                    codec.resize(meshopt_encodeIndexBufferBound(elementCount, vertex_count));
+                    codec.resize(meshopt_encodeIndexBuffer(codec.data(), codec.size(), indices, elementCount));
+                    if (codec.empty())
+                        return false;
+
+                    encoding.flags |= BLOB_ENCODING_MESHOPT_INDEX;
+                }
+
+                if (encoding.flags) {
+                    payload     = codec.data();
+                    payloadSize = codec.size();
+                }
+                encoding.codec_size = static_cast<uint32_t>(payloadSize);
+
+                if (deflate && payloadSize > 0) {
+                    mz_ulong deflatedSize = mz_compressBound(static_cast<mz_ulong>(payloadSize));
+                    encoded.resize(deflatedSize);
+                    if (mz_compress2(encoded.data(), &deflatedSize, payload, static_cast<mz_ulong>(payloadSize), MZ_DEFAULT_LEVEL) != MZ_OK)
+                        return false;
+                    encoded.resize(deflatedSize);
+
+                    encoding.flags |= BLOB_ENCODING_DEFLATE;
+                } else if (!encoding.flags)
+                    encoded.assign(payload, payload + payloadSize);
+
+                encoding.encoded_size = static_cast<uint32_t>(encoded.size());
+                return true;
+            }
+
+            bool DecodeBlob(const void* encoded, const BINBlobEncoding& encoding, uint32_t stride, void* decoded)
+            {
+                const uint8_t*       payload     = static_cast<const uint8_t*>(encoded);
+                size_t               payloadSize = encoding.encoded_size;
+                bool                 hasCodec    = encoding.flags & (BLOB_ENCODING_MESHOPT_VERTEX | BLOB_ENCODING_MESHOPT_INDEX);
+                std::vector<uint8_t> inflated;
+
+                // The encoding comes from the file, the codecs assert on anything EncodeBlob wouldn't have produced
+                if (encoding.flags & BLOB_ENCODING_MESHOPT_VERTEX) {
+                    if ((encoding.flags & BLOB_ENCODING_MESHOPT_INDEX) || stride == 0 || stride % 4 != 0 || stride > 256)
+                        return false;
+                    if (encoding.codec_size > meshopt_encodeVertexBufferBound(encoding.element_count, stride))
+                        return false;
+                } else if (encoding.flags & BLOB_ENCODING_MESHOPT_INDEX) {
+                    if (stride != sizeof(uint32_t) || encoding.element_count % 3 != 0)
+                        return false;
+                    if (encoding.codec_size > meshopt_encodeIndexBufferBound(encoding.element_count, ~0u))
+                        return false;
+                }
+
+                if (encoding.flags & BLOB_ENCODING_DEFLATE) {
+                    // Without a codec the inflated data is the final data, so inflate straight into the destination
+                    mz_ulong inflatedSize = hasCodec ? encoding.codec_size : encoding.decoded_size;
+                    uint8_t* destination  = static_cast<uint8_t*>(decoded);
+                    if (hasCodec) {
+                        inflated.resize(inflatedSize);
+                        destination = inflated.data();
+                    }
+
+                    if (mz_uncompress(destination, &inflatedSize, payload, static_cast<mz_ulong>(payloadSize)) != MZ_OK)
+                        return false;
+
+                    if (!hasCodec)
+                        return inflatedSize == encoding.decoded_size;
+
+                    payload     = inflated.data();
+                    payloadSize = inflatedSize;
+                }
+
+                if (encoding.flags & BLOB_ENCODING_MESHOPT_VERTEX)
+                    return meshopt_decodeVertexBuffer(decoded, encoding.element_count, stride, payload, payloadSize) == 0;
+
+                if (encoding.flags & BLOB_ENCODING_MESHOPT_INDEX)
+                    return meshopt_decodeIndexBuffer(decoded, encoding.element_count, sizeof(uint32_t), payload, payloadSize) == 0;
+
+                if (payloadSize != encoding.decoded_size)
+                    return false;
+
+                memcpy(decoded, payload, payloadSize);
+                return true;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/rzmesh_format.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Encodes elementCount elements of stride bytes with the codecs requested in encodingFlags (BlobEncodingFlags)
+             * The meshopt codec runs first and deflate on top of it, encoding describes the result for the BINBlobEncoding
+             * Codecs that can't be applied (ex. vertex codec on a stride that is not a multiple of 4) are dropped from the flags
+             */
+            bool EncodeBlob(const void* data, uint32_t elementCount, uint32_t stride, uint32_t encodingFlags, std::vector<uint8_t>& encoded, BINBlobEncoding& encoding);
+
+            /**
+             * Decodes a blob payload into decoded, which must be encoding.decoded_size bytes big
+             * This is the reference for the engine side loader
+             */
+            bool DecodeBlob(const void* encoded, const BINBlobEncoding& encoding, uint32_t stride, void* decoded);
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Fixed capacity multi producer/multi consumer FIFO, used to hand work from a producer to the job system
+             *
+             * It never blocks: tryPush fails when the queue is full and tryPop when it's empty, the caller decides what to do
+             * meanwhile. Blocking inside a job could starve the pool, so the streaming pipeline makes a producer facing a full
+             * queue consume an item itself, which bounds how far ahead of the consumers it can get.
+             */
+            template<typename T>
+            class BoundedQueue
+            {
+            public:
+                explicit BoundedQueue(uint32_t capacity)
+                    : m_Capacity(capacity ? capacity : 1)
+                {
+                }
+
+                BoundedQueue(const BoundedQueue&)            = delete;
+                BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+                /* item is only moved from when it's queued */
+                bool tryPush(T& item)
+                {
+                    std::lock_guard<std::mutex> lock(m_Lock);
+                    if (m_Items.size() >= m_Capacity)
+                        return false;
+
+                    m_Items.push_back(std::move(item));
+                    return true;
+                }
+
+                bool tryPop(T& item)
+                {
+                    std::lock_guard<std::mutex> lock(m_Lock);
+                    if (m_Items.empty())
+                        return false;
+
+                    item = std::move(m_Items.front());
+                    m_Items.pop_front();
+                    return true;
+                }
+
+                uint32_t getCapacity() const { return m_Capacity; }
+
+            private:
+                std::mutex    m_Lock;
+                std::deque<T> m_Items;
+                uint32_t      m_Capacity;
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
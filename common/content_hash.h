@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * 64-bit content hash (XXH64), fast enough to hash whole model files on every run
+             * It's stored in the build cache, so the output must never change across platforms or versions
+             */
+            uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0);
+
+            inline uint64_t HashString(const std::string& str, uint64_t seed = 0)
+            {
+                return HashBytes(str.data(), str.size(), seed);
+            }
+
+            /* Order dependent, use it to fold several hashes into a single key */
+            inline uint64_t HashCombine(uint64_t seed, uint64_t value)
+            {
+                return HashBytes(&value, sizeof(value), seed);
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * DirectDraw Surface container used for the processed textures, always with the DX10 extension header so BC7 and the
+             * sRGB formats can be described. Layout: "DDS " | DDSHeader | DDSHeaderDX10 | mip 0 ... mip N, blocks in row order
+             * Every graphics API and texture tool reads it, the engine can upload the levels as they are
+             */
+
+            constexpr uint32_t DDS_MAGIC = 0x20534444; /* "DDS " */
+
+            constexpr uint32_t DDSD_CAPS        = 0x1;
+            constexpr uint32_t DDSD_HEIGHT      = 0x2;
+            constexpr uint32_t DDSD_WIDTH       = 0x4;
+            constexpr uint32_t DDSD_PIXELFORMAT = 0x1000;
+            constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+            constexpr uint32_t DDSD_LINEARSIZE  = 0x80000;
+
+            constexpr uint32_t DDPF_FOURCC     = 0x4;
+            constexpr uint32_t DDS_FOURCC_DX10 = 0x30315844; /* "DX10" */
+
+            constexpr uint32_t DDSCAPS_COMPLEX = 0x8;
+            constexpr uint32_t DDSCAPS_TEXTURE = 0x1000;
+            constexpr uint32_t DDSCAPS_MIPMAP  = 0x400000;
+
+            constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+
+            enum DXGIFormat : uint32_t
+            {
+                DXGI_FORMAT_BC1_UNORM      = 71,
+                DXGI_FORMAT_BC1_UNORM_SRGB = 72,
+                DXGI_FORMAT_BC3_UNORM      = 77,
+                DXGI_FORMAT_BC3_UNORM_SRGB = 78,
+                DXGI_FORMAT_BC5_UNORM      = 83,
+                DXGI_FORMAT_BC7_UNORM      = 98,
+                DXGI_FORMAT_BC7_UNORM_SRGB = 99
+            };
+
+            struct DDSPixelFormat
+            {
+                uint32_t size = 32;
+                uint32_t flags;
+                uint32_t fourCC;
+                uint32_t rgbBitCount;
+                uint32_t rBitMask;
+                uint32_t gBitMask;
+                uint32_t bBitMask;
+                uint32_t aBitMask;
+            };
+
+            struct DDSHeader
+            {
+                uint32_t       size = 124;
+                uint32_t       flags;
+                uint32_t       height;
+                uint32_t       width;
+                uint32_t       pitchOrLinearSize;
+                uint32_t       depth;
+                uint32_t       mipMapCount;
+                uint32_t       reserved1[11];
+                DDSPixelFormat pixelFormat;
+                uint32_t       caps;
+                uint32_t       caps2;
+                uint32_t       caps3;
+                uint32_t       caps4;
+                uint32_t       reserved2;
+            };
+
+            struct DDSHeaderDX10
+            {
+                uint32_t dxgiFormat;
+                uint32_t resourceDimension;
+                uint32_t miscFlag;
+                uint32_t arraySize;
+                uint32_t miscFlags2;
+            };
+
+            static_assert(sizeof(DDSPixelFormat) == 32, "DDS pixel format is 32 bytes");
+            static_assert(sizeof(DDSHeader) == 124, "DDS header is 124 bytes");
+            static_assert(sizeof(DDSHeaderDX10) == 20, "DDS DX10 header is 20 bytes");
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -14,6 +14,8 @@
 #include "Razix/Graphics/Materials/RZMaterialData.h"
 #include "Razix/Graphics/RZVertexFormat.h"
 
+#include "common/mesh_hierarchy.h"
+
 namespace Razix {
     namespace Graphics {
         class RZMaterial;
@@ -30,15 +32,115 @@ namespace Razix {
              */
             struct SubMesh
             {
-                uint32_t    material_index; /* The index of the material that this submesh will use to render */
-                std::string materialName;   /* Name of the material */
-                uint32_t    index_count;    /* Total indices count in the sub mesh */
-                uint32_t    vertex_count;   /* Total vertices count in the sub mesh */
-                uint32_t    base_vertex;    /* vertex offset into the Vertex Buffer of the parent mesh  */
-                uint32_t    base_index;     /* index offset into the index buffer of the parent mesh */
-                glm::vec3   max_extents;    /* Maximum extents of the sub mesh */
-                glm::vec3   min_extents;    /* Minimum extents of the sub mesh */
-                char        name[150];      /* Name of the sub-mesh */
+                uint32_t    material_index;         /* The index of the material that this submesh will use to render */
+                std::string materialName;           /* Name of the material */
+                uint32_t    index_count;            /* Total indices count in the sub mesh */
+                uint32_t    vertex_count;           /* Total vertices count in the sub mesh */
+                uint32_t    base_vertex;            /* vertex offset into the Vertex Buffer of the parent mesh  */
+                uint32_t    base_index;             /* index offset into the index buffer of the parent mesh */
+                glm::vec3   max_extents;            /* Maximum extents of the sub mesh */
+                glm::vec3   min_extents;            /* Minimum extents of the sub mesh */
+                char        name[150];              /* Name of the sub-mesh */
+                uint32_t    lod_offset     = 0;     /* Index of the first LOD of the sub mesh in MeshImportResult::lods */
+                uint32_t    lod_count      = 0;     /* Number of generated LODs, LOD 0 is the sub mesh itself and is not counted */
+                uint32_t    meshlet_offset = 0;     /* Index of the first meshlet of the sub mesh in MeshImportResult::meshlets */
+                uint32_t    meshlet_count  = 0;     /* Number of meshlets LOD 0 of the sub mesh was split into */
+                uint32_t    bvh_offset     = 0;     /* Index of the root of the BVH of the sub mesh in MeshImportResult::bvh_nodes */
+                uint32_t    bvh_node_count = 0;     /* Nodes of the BVH, 0 when it wasn't built */
+                bool        skinned        = false; /* Has bone weights in MeshImportResult::bone_indices/bone_weights */
+            };
+
+            /**
+             * A simplified version of a submesh, it uses the same vertices as the submesh (indices are relative to base_vertex)
+             */
+            struct SubMeshLOD
+            {
+                uint32_t base_index  = 0;    /* index offset into MeshImportResult::lod_indices */
+                uint32_t index_count = 0;    /* Total indices count in the LOD */
+                float    error       = 0.0f; /* Geometric deviation from LOD 0 in object space units */
+            };
+
+            /**
+             * A cluster of a submesh, small enough to be processed by a single mesh shader workgroup
+             * Vertices go through MeshImportResult::meshlet_vertices (relative to base_vertex of the submesh) and triangles are
+             * 3 bytes each in MeshImportResult::meshlet_triangles, indexing the meshlet vertices
+             * Offsets are global here, the exporter rebases them to the submesh when writing the blobs
+             */
+            struct Meshlet
+            {
+                uint32_t  vertex_offset   = 0; /* offset into MeshImportResult::meshlet_vertices */
+                uint32_t  triangle_offset = 0; /* offset in bytes into MeshImportResult::meshlet_triangles, 4 byte aligned */
+                uint32_t  vertex_count    = 0; /* Vertices used by the meshlet */
+                uint32_t  triangle_count  = 0; /* Triangles in the meshlet */
+                glm::vec3 center;              /* Bounding sphere center */
+                float     radius = 0.0f;       /* Bounding sphere radius */
+                glm::vec3 cone_apex;           /* Normal cone, the meshlet is backfacing when dot(normalize(apex - camera), axis) >= cutoff */
+                glm::vec3 cone_axis;           /* Normal cone axis */
+                float     cone_cutoff = 0.0f;  /* cos of half the cone angle */
+            };
+
+            /**
+             * A node of the BVH of a submesh, 32 bytes so a pair of siblings fills a 64 byte cache line
+             * Interior nodes have triangle_count 0 and their children at first and first + 1, leaves hold triangle_count triangles
+             * starting at triangle first of the submesh in MeshImportResult::bvh_indices. Node indices are relative to the root of the
+             * submesh BVH, so the nodes are exported as they are
+             */
+            struct BVHNode
+            {
+                glm::vec3 min_extents;
+                uint32_t  first = 0;
+                glm::vec3 max_extents;
+                uint32_t  triangle_count = 0;
+            };
+
+            //--------------------------------------------------------------------------------
+            // Skinning
+            //--------------------------------------------------------------------------------
+
+            /* Max bones influencing a vertex, the rest are dropped and the weights renormalized */
+            constexpr uint32_t MAX_BONE_INFLUENCES = 4;
+
+            /**
+             * A joint of the skeleton, the local transform is the bind pose relative to the parent bone
+             */
+            struct Bone
+            {
+                std::string name;
+                int32_t     parent      = -1;                                /* Index of the parent bone, always before this bone, -1 for roots */
+                glm::mat4   inverseBind = glm::mat4(1.0f);                   /* Model space -> bone space in the bind pose                      */
+                glm::vec3   translation = glm::vec3(0.0f);
+                glm::quat   rotation    = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+                glm::vec3   scale       = glm::vec3(1.0f);
+            };
+
+            /**
+             * Bones in depth first order of the scene hierarchy, so parents are always resolved before their children
+             * Holds the skinning bones, the animated nodes and all their ancestors
+             */
+            struct Skeleton
+            {
+                std::vector<Bone> bones;
+            };
+
+            /**
+             * Keys of a single bone, times are in seconds and every channel has it's own key times
+             */
+            struct AnimationTrack
+            {
+                uint32_t               bone = 0; /* Index into Skeleton::bones */
+                std::vector<float>     positionTimes;
+                std::vector<glm::vec3> positions;
+                std::vector<float>     rotationTimes;
+                std::vector<glm::quat> rotations;
+                std::vector<float>     scaleTimes;
+                std::vector<glm::vec3> scales;
+            };
+
+            struct AnimationClip
+            {
+                std::string                 name;
+                float                       duration = 0.0f; /* Seconds */
+                std::vector<AnimationTrack> tracks;
             };
 
             //--------------------------------------------------------------------------------
@@ -49,31 +151,53 @@ namespace Razix {
             {
                 std::string                         name;
                 Razix::Graphics::RZVertex           vertices;
-                Razix::Graphics::RZSkeletalVertex   skeletal_vertices;
+                std::vector<float>                  tangent_signs;     /* Per vertex, bitangent = sign * cross(normal, tangent), +1 or -1, parallel to the vertex streams */
+                Razix::Graphics::RZSkeletalVertex   skeletal_vertices; /* V1 only, the packer fills bone_indices/bone_weights */
                 std::vector<uint32_t>               indices;
                 std::vector<SubMesh>                submeshes;
+                std::vector<SubMeshLOD>             lods;
+                std::vector<uint32_t>               lod_indices;
+                std::vector<Meshlet>                meshlets;
+                std::vector<uint32_t>               meshlet_vertices;
+                std::vector<uint8_t>                meshlet_triangles;
+                std::vector<BVHNode>                bvh_nodes;
+                std::vector<uint32_t>               bvh_indices; /* LOD 0 triangles in BVH leaf order, parallel to indices (same base_index and index_count) */
                 std::vector<Graphics::MaterialData> materials;
+                std::vector<glm::uvec4>             bone_indices; /* Per vertex, parallel to the vertex streams, empty if no submesh is skinned */
+                std::vector<glm::vec4>              bone_weights; /* Per vertex, sorted from the biggest weight and summing to 1               */
+                Skeleton                            skeleton;
+                std::vector<AnimationClip>          animations;
+                MeshHierarchy                       hierarchy;
                 glm::vec3                           max_extents;
                 glm::vec3                           min_extents;
+                bool                                encodeVertices = false; /* Export the vertex streams with the meshopt vertex codec */
+                bool                                encodeIndices  = false; /* Export the index buffer with the meshopt index codec    */
+                uint32_t                            chunkIndex     = 0;     /* Streamed chunks only, index of their submesh in the model */
             };
 
-            //--------------------------------------------------------------------------------
-            // Hierarchy
-            //--------------------------------------------------------------------------------
+            /**
+             * Calls func on every SoA attribute stream of the vertices, func receives the std::vector of the stream
+             * Useful for operations that needs to be applied on all the attributes (ex. remapping or compacting vertices)
+             */
+            template<typename Func>
+            inline void ForEachVertexStream(Razix::Graphics::RZVertex& vertices, Func&& func)
+            {
+                func(vertices.Position);
+                func(vertices.Color);
+                func(vertices.UV);
+                func(vertices.Normal);
+                func(vertices.Tangent);
+            }
 
-            // TODO: Export this to a .rzmodel file for hierarchy info
-            struct Node
+            /* Same as above plus the skinning streams, they have to stay in sync with the vertices */
+            template<typename Func>
+            inline void ForEachVertexStream(MeshImportResult& import_result, Func&& func)
             {
-                Node*     children    = nullptr;
-                uint32_t  numChildren = 0;
-                glm::vec3 translation = glm::vec3(0.0f);
-                glm::quat rotation /*= glm::quat(0.0f)*/;
-                glm::vec3 scale = glm::vec3(1.0f);
-                //char      name[250];
-                //char*     nodeType;
-                std::string name;
-                std::string nodeType;    // $MESH, $TRANSFORM, $MATERIAL
-            };
+                ForEachVertexStream(import_result.vertices, func);
+                func(import_result.tangent_signs);
+                func(import_result.bone_indices);
+                func(import_result.bone_weights);
+            }
 
         }    // namespace AssetPacker
     }        // namespace Tool
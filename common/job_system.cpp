@@ -0,0 +1,174 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <string>
+
+#include "log.h"
+#include "profiler.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            // Worker identity of the current thread, external threads have no owner
+            static thread_local const JobSystem* s_OwnerSystem = nullptr;
+            static thread_local uint32_t         s_WorkerIndex = 0;
+
+            JobSystem::JobSystem(uint32_t workersCount)
+            {
+                if (workersCount == 0)
+                    workersCount = std::max(1u, std::thread::hardware_concurrency());
+
+                // +1 for the queue shared by the external threads
+                for (uint32_t i = 0; i < workersCount + 1; i++)
+                    m_Queues.push_back(std::make_unique<JobQueue>());
+
+                m_Workers.reserve(workersCount);
+                for (uint32_t i = 0; i < workersCount; i++)
+                    m_Workers.emplace_back(&JobSystem::workerLoop, this, i);
+            }
+
+            JobSystem::~JobSystem()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_SleepLock);
+                    m_Running = false;
+                }
+                m_SleepCV.notify_all();
+
+                for (auto& worker: m_Workers)
+                    worker.join();
+            }
+
+            void JobSystem::submit(Job job, JobCounter* counter)
+            {
+                if (counter)
+                    counter->pending.fetch_add(1);
+
+                // Counted before it's published, a worker popping it right away must never decrement below zero
+                {
+                    // Taking the sleep lock makes sure a worker can't miss the wake up between checking and sleeping
+                    std::lock_guard<std::mutex> lock(m_SleepLock);
+                    m_QueuedJobs.fetch_add(1);
+                }
+
+                auto& queue = *m_Queues[getCurrentQueueIndex()];
+                {
+                    std::lock_guard<std::mutex> lock(queue.lock);
+                    queue.jobs.push_back({std::move(job), counter});
+                }
+                m_SleepCV.notify_one();
+            }
+
+            void JobSystem::wait(JobCounter& counter)
+            {
+                uint32_t queueIndex = getCurrentQueueIndex();
+                while (counter.pending.load() > 0) {
+                    if (!runPendingJob(queueIndex))
+                        std::this_thread::yield();
+                }
+
+                // Nested waits rethrow into their own job, so the exception travels up to the thread that started the work
+                if (counter.failed.load())
+                    std::rethrow_exception(counter.exception);
+            }
+
+            void JobSystem::parallelFor(uint32_t count, const std::function<void(uint32_t)>& func)
+            {
+                if (count == 0)
+                    return;
+
+                // Don't bother the pool for a single item
+                if (count == 1) {
+                    func(0);
+                    return;
+                }
+
+                JobCounter counter;
+                for (uint32_t i = 0; i < count; i++)
+                    submit([&func, i]() { func(i); }, &counter);
+
+                wait(counter);
+            }
+
+            void JobSystem::workerLoop(uint32_t workerIndex)
+            {
+                s_OwnerSystem = this;
+                s_WorkerIndex = workerIndex;
+                SetProfilerThreadName("Worker " + std::to_string(workerIndex));
+
+                while (true) {
+                    if (runPendingJob(workerIndex))
+                        continue;
+
+                    std::unique_lock<std::mutex> lock(m_SleepLock);
+                    m_SleepCV.wait(lock, [this]() { return !m_Running || m_QueuedJobs.load() > 0; });
+
+                    if (!m_Running && m_QueuedJobs.load() == 0)
+                        break;
+                }
+            }
+
+            bool JobSystem::runPendingJob(uint32_t queueIndex)
+            {
+                JobEntry entry;
+                if (!popJob(queueIndex, entry) && !stealJob(queueIndex, entry))
+                    return false;
+
+                m_QueuedJobs.fetch_sub(1);
+
+                // A throwing job (ex. std::bad_alloc) still has to release it's counter, otherwise wait() spins forever
+                try {
+                    entry.job();
+                } catch (...) {
+                    if (!entry.counter)
+                        RAZIX_PACKER_LOG_ERROR("A job without a counter threw, the exception is lost");
+                    else if (!entry.counter->failed.exchange(true))
+                        entry.counter->exception = std::current_exception();
+                }
+
+                if (entry.counter)
+                    entry.counter->pending.fetch_sub(1);
+
+                return true;
+            }
+
+            bool JobSystem::popJob(uint32_t queueIndex, JobEntry& entry)
+            {
+                auto&                       queue = *m_Queues[queueIndex];
+                std::lock_guard<std::mutex> lock(queue.lock);
+                if (queue.jobs.empty())
+                    return false;
+
+                entry = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                return true;
+            }
+
+            bool JobSystem::stealJob(uint32_t thiefIndex, JobEntry& entry)
+            {
+                uint32_t queuesCount = static_cast<uint32_t>(m_Queues.size());
+                for (uint32_t i = 1; i < queuesCount; i++) {
+                    auto& victim = *m_Queues[(thiefIndex + i) % queuesCount];
+
+                    std::lock_guard<std::mutex> lock(victim.lock);
+                    if (victim.jobs.empty())
+                        continue;
+
+                    // Steal the oldest job, it's usually the biggest chunk of work (ex. a whole model)
+                    entry = std::move(victim.jobs.front());
+                    victim.jobs.pop_front();
+                    return true;
+                }
+                return false;
+            }
+
+            uint32_t JobSystem::getCurrentQueueIndex() const
+            {
+                if (s_OwnerSystem == this)
+                    return s_WorkerIndex;
+                return static_cast<uint32_t>(m_Queues.size() - 1);
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Tracks a group of jobs, every job submitted with a counter decrements it once it finishes (or throws)
+             * Use JobSystem::wait to block until all of them are done, it rethrows the first exception of the group
+             */
+            struct JobCounter
+            {
+                std::atomic<uint32_t> pending = 0;
+                std::atomic<bool>     failed  = false;
+                std::exception_ptr    exception; /* Written once by the job that set failed, read after pending reaches zero */
+            };
+
+            //--------------------------------------------------------------------------------
+            // Job System
+            //--------------------------------------------------------------------------------
+
+            /**
+             * Work-stealing thread pool used to pack models and their submeshes in parallel
+             *
+             * Every worker owns a deque, it pops it's own jobs from the back (LIFO, cache friendly for nested jobs)
+             * and steals from the front of other workers deques when it runs dry. Threads that are not workers
+             * (ex. the main thread) push into a shared external queue. Waiting threads help execute jobs instead
+             * of blocking, so jobs can safely submit and wait on nested jobs (model -> submeshes).
+             */
+            class JobSystem
+            {
+            public:
+                using Job = std::function<void()>;
+
+                /* workersCount = 0 uses all the hardware threads available */
+                explicit JobSystem(uint32_t workersCount = 0);
+                ~JobSystem();
+
+                JobSystem(const JobSystem&)            = delete;
+                JobSystem& operator=(const JobSystem&) = delete;
+
+                void submit(Job job, JobCounter* counter = nullptr);
+                /* Blocks until the counter reaches zero, the calling thread keeps executing jobs meanwhile. Rethrows if a job threw */
+                void wait(JobCounter& counter);
+                /* Runs func(i) for i in [0, count) on the pool and waits for all of them */
+                void parallelFor(uint32_t count, const std::function<void(uint32_t)>& func);
+
+                uint32_t getWorkersCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+            private:
+                struct JobEntry
+                {
+                    Job         job;
+                    JobCounter* counter = nullptr;
+                };
+
+                struct JobQueue
+                {
+                    std::mutex           lock;
+                    std::deque<JobEntry> jobs;
+                };
+
+            private:
+                void workerLoop(uint32_t workerIndex);
+                bool runPendingJob(uint32_t queueIndex);
+                bool popJob(uint32_t queueIndex, JobEntry& entry);
+                bool stealJob(uint32_t thiefIndex, JobEntry& entry);
+                uint32_t getCurrentQueueIndex() const;
+
+            private:
+                std::vector<std::thread>               m_Workers;
+                std::vector<std::unique_ptr<JobQueue>> m_Queues;    // one per worker + 1 external queue at the end
+                std::mutex                             m_SleepLock;
+                std::condition_variable                m_SleepCV;
+                std::atomic<uint32_t>                  m_QueuedJobs = 0;
+                std::atomic<bool>                      m_Running    = true;
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,87 @@
+#include "log.h"
+
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            namespace Detail {
+                std::atomic<uint32_t> g_LogLevel = static_cast<uint32_t>(LogLevel::Info);
+            }
+
+            // Flushed when it gets bigger than this, a line per write to the console is a measurable cost on big batches
+            static constexpr size_t kLogBufferSize = 16 << 10;
+
+            struct LogBuffer
+            {
+                std::mutex  lock;
+                std::string lines;
+
+                ~LogBuffer() { flush(); }
+
+                void flush()
+                {
+                    if (lines.empty())
+                        return;
+                    std::cout.write(lines.data(), static_cast<std::streamsize>(lines.size()));
+                    std::cout.flush();
+                    lines.clear();
+                }
+            };
+
+            static LogBuffer& GetLogBuffer()
+            {
+                static LogBuffer buffer;
+                return buffer;
+            }
+
+            void SetLogLevel(LogLevel level)
+            {
+                Detail::g_LogLevel.store(static_cast<uint32_t>(level), std::memory_order_relaxed);
+            }
+
+            bool ParseLogLevel(const char* name, LogLevel& level)
+            {
+                if (!strcmp(name, "error"))
+                    level = LogLevel::Error;
+                else if (!strcmp(name, "warning"))
+                    level = LogLevel::Warning;
+                else if (!strcmp(name, "info"))
+                    level = LogLevel::Info;
+                else if (!strcmp(name, "verbose"))
+                    level = LogLevel::Verbose;
+                else
+                    return false;
+                return true;
+            }
+
+            void WriteLog(LogLevel level, const std::string& line)
+            {
+                LogBuffer&                  buffer = GetLogBuffer();
+                std::lock_guard<std::mutex> lock(buffer.lock);
+
+                if (level == LogLevel::Error)
+                    buffer.lines += "[ERROR!] ";
+                else if (level == LogLevel::Warning)
+                    buffer.lines += "[WARNING!] ";
+                buffer.lines += line;
+                buffer.lines += '\n';
+
+                // Problems show up right away and in order with the lines before them
+                if (level <= LogLevel::Warning || buffer.lines.size() >= kLogBufferSize)
+                    buffer.flush();
+            }
+
+            void FlushLog()
+            {
+                LogBuffer&                  buffer = GetLogBuffer();
+                std::lock_guard<std::mutex> lock(buffer.lock);
+                buffer.flush();
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            enum class LogLevel : uint32_t
+            {
+                Error,      /* Prefixed with [ERROR!], flushed right away                  */
+                Warning,    /* Prefixed with [WARNING!], flushed right away                */
+                Info,       /* A line per model and per stage, the default                 */
+                Verbose     /* Per submesh, material and texture details, and the hierarchy */
+            };
+
+            namespace Detail {
+                extern std::atomic<uint32_t> g_LogLevel;
+            }
+
+            void SetLogLevel(LogLevel level);
+            inline LogLevel GetLogLevel() { return static_cast<LogLevel>(Detail::g_LogLevel.load(std::memory_order_relaxed)); }
+            /* Parses error, warning, info or verbose, returns false for anything else */
+            bool ParseLogLevel(const char* name, LogLevel& level);
+
+            inline bool IsLogEnabled(LogLevel level) { return static_cast<uint32_t>(level) <= Detail::g_LogLevel.load(std::memory_order_relaxed); }
+
+            /**
+             * Appends a line to the log buffer, it's written to stdout once it's big enough, on errors and warnings and by FlushLog
+             * Lines from different threads are never interleaved. Use the RAZIX_PACKER_LOG_* macros, they skip the formatting of the
+             * disabled levels
+             */
+            void WriteLog(LogLevel level, const std::string& line);
+            /* Writes the buffered lines, call it before printing to std::cout directly */
+            void FlushLog();
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
+
+// expression is streamed, ex. RAZIX_PACKER_LOG_INFO("Exported : " << path)
+#define RAZIX_PACKER_LOG(level, expression)                                                 \
+    do {                                                                                    \
+        if (Razix::Tool::AssetPacker::IsLogEnabled(level)) {                                \
+            std::ostringstream razixLogStream;                                              \
+            razixLogStream << expression;                                                   \
+            Razix::Tool::AssetPacker::WriteLog(level, razixLogStream.str());                \
+        }                                                                                   \
+    } while (0)
+
+#define RAZIX_PACKER_LOG_ERROR(expression)   RAZIX_PACKER_LOG(Razix::Tool::AssetPacker::LogLevel::Error, expression)
+#define RAZIX_PACKER_LOG_WARNING(expression) RAZIX_PACKER_LOG(Razix::Tool::AssetPacker::LogLevel::Warning, expression)
+#define RAZIX_PACKER_LOG_INFO(expression)    RAZIX_PACKER_LOG(Razix::Tool::AssetPacker::LogLevel::Info, expression)
+#define RAZIX_PACKER_LOG_VERBOSE(expression) RAZIX_PACKER_LOG(Razix::Tool::AssetPacker::LogLevel::Verbose, expression)
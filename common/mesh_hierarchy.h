@@ -1,11 +1,74 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
 namespace Razix {
     namespace Tool {
         namespace AssetPacker {
 
-            // TODO: Implement a method to resolve Hierarchy
+            constexpr uint32_t MESH_HIERARCHY_NO_PARENT = ~0u;
+
+            /**
+             * Node hierarchy of a model, flat and SoA so it's exported (see common/rzmodel_format.h) without any conversion
+             *
+             * Nodes are in depth first order, a parent is always before it's children so world transforms are a single linear pass:
+             * world[i] = world[parents[i]] * local[i]. Names go to a single string table and the submeshes drawn by every node to a
+             * single array, so building the hierarchy doesn't allocate per node. The first node is the root, named after the model
+             */
+            struct MeshHierarchy
+            {
+                std::vector<uint32_t>  parents;      /* MESH_HIERARCHY_NO_PARENT for the root          */
+                std::vector<glm::vec3> translations; /* Local TRS, relative to the parent              */
+                std::vector<glm::quat> rotations;
+                std::vector<glm::vec3> scales;
+                std::vector<uint32_t>  nameOffsets;  /* Into strings                                   */
+                std::vector<uint32_t>  meshOffsets;  /* Into meshes                                    */
+                std::vector<uint32_t>  meshCounts;
+                std::vector<uint32_t>  meshes;       /* Indices into MeshImportResult::submeshes       */
+                std::vector<char>      strings;      /* Null terminated node names                     */
+
+                uint32_t size() const { return static_cast<uint32_t>(parents.size()); }
+                bool     empty() const { return parents.empty(); }
+
+                const char* getName(uint32_t node) const { return strings.data() + nameOffsets[node]; }
+
+                /* Appends a node with an identity transform, parent has to be added already. Returns the index of the node */
+                uint32_t addNode(const std::string& name, uint32_t parent, const uint32_t* nodeMeshes = nullptr, uint32_t nodeMeshCount = 0)
+                {
+                    uint32_t index = size();
+                    parents.push_back(parent);
+                    translations.push_back(glm::vec3(0.0f));
+                    rotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+                    scales.push_back(glm::vec3(1.0f));
+
+                    nameOffsets.push_back(static_cast<uint32_t>(strings.size()));
+                    strings.insert(strings.end(), name.begin(), name.end());
+                    strings.push_back('\0');
+
+                    meshOffsets.push_back(static_cast<uint32_t>(meshes.size()));
+                    meshCounts.push_back(nodeMeshCount);
+                    if (nodeMeshCount)
+                        meshes.insert(meshes.end(), nodeMeshes, nodeMeshes + nodeMeshCount);
+                    return index;
+                }
+
+                void reserve(uint32_t nodeCount)
+                {
+                    parents.reserve(nodeCount);
+                    translations.reserve(nodeCount);
+                    rotations.reserve(nodeCount);
+                    scales.reserve(nodeCount);
+                    nameOffsets.reserve(nodeCount);
+                    meshOffsets.reserve(nodeCount);
+                    meshCounts.reserve(nodeCount);
+                }
+            };
 
-        }
-    }    // namespace Tool
-}    // namespace Razix
\ No newline at end of file
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
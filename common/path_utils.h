@@ -0,0 +1,25 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Absolute, lexically normal path with '/' separators and no trailing separator
+             * Build cache keys, watched directories and changed files are all in this form, so they compare as strings
+             */
+            inline std::string NormalizePath(const std::string& path)
+            {
+                std::error_code       ec;
+                std::filesystem::path normalized = std::filesystem::absolute(path, ec).lexically_normal();
+                if (!normalized.has_filename())
+                    normalized = normalized.parent_path();
+                return normalized.generic_string();
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,68 @@
+#include "process_memory.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+    #include <unistd.h>
+
+    #include <cstdio>
+#endif
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+#ifdef _WIN32
+            uint64_t GetPeakResidentBytes()
+            {
+                PROCESS_MEMORY_COUNTERS counters{};
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+                    return 0;
+                return counters.PeakWorkingSetSize;
+            }
+
+            uint64_t GetCurrentResidentBytes()
+            {
+                PROCESS_MEMORY_COUNTERS counters{};
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+                    return 0;
+                return counters.WorkingSetSize;
+            }
+#else
+            uint64_t GetPeakResidentBytes()
+            {
+                struct rusage usage;
+                if (getrusage(RUSAGE_SELF, &usage) != 0)
+                    return 0;
+    #ifdef __APPLE__
+                return static_cast<uint64_t>(usage.ru_maxrss);
+    #else
+                // Linux reports kilobytes
+                return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+    #endif
+            }
+
+            uint64_t GetCurrentResidentBytes()
+            {
+    #ifdef __linux__
+                // Second field of statm is the resident pages
+                FILE* statm = fopen("/proc/self/statm", "r");
+                if (!statm)
+                    return 0;
+
+                unsigned long long size = 0, resident = 0;
+                int                fields = fscanf(statm, "%llu %llu", &size, &resident);
+                fclose(statm);
+                return fields == 2 ? resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) : 0;
+    #else
+                return 0;
+    #endif
+            }
+#endif
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /* Peak resident set size of the process in bytes, 0 if the platform doesn't report it */
+            uint64_t GetPeakResidentBytes();
+
+            /* Current resident set size of the process in bytes, 0 if the platform doesn't report it */
+            uint64_t GetCurrentResidentBytes();
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
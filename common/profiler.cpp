@@ -0,0 +1,199 @@
+#include "profiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            namespace Detail {
+                std::atomic<bool>     g_ProfilingEnabled = false;
+                std::atomic<uint64_t> g_Allocations      = 0;
+                std::atomic<uint64_t> g_AllocatedBytes   = 0;
+                thread_local uint64_t t_Allocations      = 0;
+                thread_local uint64_t t_AllocatedBytes   = 0;
+            }    // namespace Detail
+
+            struct ProfileEvent
+            {
+                const char* name    = nullptr;
+                std::string detail;
+                uint64_t    startNs = 0;
+                uint64_t    endNs   = 0;
+                uint64_t    value   = 0; /* Allocations of a zone, value of a counter */
+                uint64_t    bytes   = 0; /* Bytes allocated by a zone                 */
+                bool        counter = false;
+            };
+
+            struct ThreadTrace
+            {
+                std::mutex                lock; /* Only contended while the trace is written or cleared */
+                std::vector<ProfileEvent> events;
+                std::string               name;
+                uint32_t                  id = 0;
+            };
+
+            struct ProfilerState
+            {
+                std::mutex                                lock;
+                std::vector<std::unique_ptr<ThreadTrace>> threads; /* Never removed, the thread_local pointers stay valid */
+                std::chrono::steady_clock::time_point     epoch = std::chrono::steady_clock::now();
+            };
+
+            static ProfilerState& GetProfilerState()
+            {
+                static ProfilerState state;
+                return state;
+            }
+
+            static ThreadTrace& GetThreadTrace()
+            {
+                thread_local ThreadTrace* trace = nullptr;
+                if (!trace) {
+                    ProfilerState&              state = GetProfilerState();
+                    std::lock_guard<std::mutex> lock(state.lock);
+                    state.threads.push_back(std::make_unique<ThreadTrace>());
+                    trace     = state.threads.back().get();
+                    trace->id = static_cast<uint32_t>(state.threads.size());
+                }
+                return *trace;
+            }
+
+            // Names and paths, only quotes, back slashes and control characters need escaping
+            static void WriteJSONString(std::ofstream& file, const char* str)
+            {
+                file << '"';
+                for (; *str; str++) {
+                    char c = *str;
+                    if (c == '"' || c == '\\')
+                        file << '\\' << c;
+                    else if (static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[8];
+                        snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                        file << escaped;
+                    } else
+                        file << c;
+                }
+                file << '"';
+            }
+
+            void EnableProfiling(bool enabled)
+            {
+                if (enabled) {
+                    ProfilerState&              state = GetProfilerState();
+                    std::lock_guard<std::mutex> lock(state.lock);
+                    for (auto& thread: state.threads) {
+                        std::lock_guard<std::mutex> threadLock(thread->lock);
+                        thread->events.clear();
+                    }
+                }
+                Detail::g_ProfilingEnabled.store(enabled, std::memory_order_relaxed);
+            }
+
+            void SetProfilerThreadName(const std::string& name)
+            {
+                ThreadTrace&                trace = GetThreadTrace();
+                std::lock_guard<std::mutex> lock(trace.lock);
+                trace.name = name;
+            }
+
+            uint64_t GetProfilerTimeNs()
+            {
+                auto elapsed = std::chrono::steady_clock::now() - GetProfilerState().epoch;
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            }
+
+            void RecordProfileZone(const char* name, const char* detail, uint64_t startNs, uint64_t endNs, uint64_t allocations, uint64_t allocatedBytes)
+            {
+                ThreadTrace&                trace = GetThreadTrace();
+                std::lock_guard<std::mutex> lock(trace.lock);
+
+                ProfileEvent& event = trace.events.emplace_back();
+                event.name          = name;
+                event.startNs       = startNs;
+                event.endNs         = endNs;
+                event.value         = allocations;
+                event.bytes         = allocatedBytes;
+                if (detail)
+                    event.detail = detail;
+            }
+
+            void RecordProfileCounter(const char* name, uint64_t value)
+            {
+                if (!IsProfilingEnabled())
+                    return;
+
+                uint64_t                    now   = GetProfilerTimeNs();
+                ThreadTrace&                trace = GetThreadTrace();
+                std::lock_guard<std::mutex> lock(trace.lock);
+
+                ProfileEvent& event = trace.events.emplace_back();
+                event.name          = name;
+                event.startNs       = now;
+                event.endNs         = now;
+                event.value         = value;
+                event.counter       = true;
+            }
+
+            bool WriteChromeTrace(const std::string& filePath)
+            {
+                std::ofstream file(filePath, std::ios::trunc);
+                if (!file)
+                    return false;
+
+                // Timestamps are in microseconds, fractional ones keep the nanoseconds
+                auto toUs = [](uint64_t ns) { return static_cast<double>(ns) * 1e-3; };
+
+                ProfilerState&              state = GetProfilerState();
+                std::lock_guard<std::mutex> lock(state.lock);
+
+                file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+                bool first = true;
+                auto next  = [&]() {
+                    if (!first)
+                        file << ",\n";
+                    first = false;
+                };
+
+                for (auto& thread: state.threads) {
+                    std::lock_guard<std::mutex> threadLock(thread->lock);
+
+                    if (!thread->name.empty()) {
+                        next();
+                        file << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << thread->id << ",\"args\":{\"name\":";
+                        WriteJSONString(file, thread->name.c_str());
+                        file << "}}";
+                    }
+
+                    for (const ProfileEvent& event: thread->events) {
+                        next();
+                        if (event.counter) {
+                            file << "{\"ph\":\"C\",\"pid\":1,\"tid\":" << thread->id << ",\"ts\":" << toUs(event.startNs) << ",\"name\":";
+                            WriteJSONString(file, event.name);
+                            file << ",\"args\":{\"value\":" << event.value << "}}";
+                            continue;
+                        }
+
+                        file << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->id << ",\"ts\":" << toUs(event.startNs) << ",\"dur\":" << toUs(event.endNs - event.startNs) << ",\"name\":";
+                        WriteJSONString(file, event.name);
+                        file << ",\"args\":{\"allocations\":" << event.value << ",\"allocated_bytes\":" << event.bytes;
+                        if (!event.detail.empty()) {
+                            file << ",\"detail\":";
+                            WriteJSONString(file, event.detail.c_str());
+                        }
+                        file << "}}";
+                    }
+                }
+
+                file << "\n]}\n";
+                return static_cast<bool>(file);
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
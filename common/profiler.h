@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            //--------------------------------------------------------------------------------
+            // Profiler
+            //--------------------------------------------------------------------------------
+
+            /**
+             * Scoped zones and counters of the packer, written as a Chrome trace (chrome://tracing, ui.perfetto.dev)
+             *
+             * Every thread appends to it's own buffer, so the threads of the job system are separate tracks and recording a zone only
+             * takes the uncontended lock of that buffer. When profiling is disabled a zone is a relaxed atomic load and nothing else,
+             * so the zones stay in release builds. Zone names have to be string literals, the optional detail (ex. the model path)
+             * is copied. Zones also record the allocations their own thread made while they were open when the executable counts them,
+             * see CountAllocation. Work a zone hands to other workers (ex. parallelFor) is counted by the zones of those workers
+             */
+
+            namespace Detail {
+                extern std::atomic<bool>     g_ProfilingEnabled;
+                extern std::atomic<uint64_t> g_Allocations;
+                extern std::atomic<uint64_t> g_AllocatedBytes;
+                extern thread_local uint64_t t_Allocations;
+                extern thread_local uint64_t t_AllocatedBytes;
+            }
+
+            inline bool IsProfilingEnabled() { return Detail::g_ProfilingEnabled.load(std::memory_order_relaxed); }
+
+            /* Drops everything recorded so far when enabling */
+            void EnableProfiling(bool enabled);
+            /* Name of the track of the calling thread, the job system names it's workers */
+            void SetProfilerThreadName(const std::string& name);
+            /* Nanoseconds since the profiler clock started */
+            uint64_t GetProfilerTimeNs();
+
+            void RecordProfileZone(const char* name, const char* detail, uint64_t startNs, uint64_t endNs, uint64_t allocations, uint64_t allocatedBytes);
+            /* Value of a counter track at the current time (bytes written, resident memory...) */
+            void RecordProfileCounter(const char* name, uint64_t value);
+
+            /**
+             * Writes everything recorded as Chrome trace JSON, returns false if the file can't be written
+             * Zones still open aren't written, call it once the batch is done
+             */
+            bool WriteChromeTrace(const std::string& filePath);
+
+            /**
+             * Called by the global operator new of an executable that counts it's allocations (the CLI does), the library itself
+             * doesn't replace operator new. Relaxed atomics for the process totals and thread locals for the zones, cheap enough for
+             * every allocation
+             */
+            inline void CountAllocation(size_t size)
+            {
+                Detail::g_Allocations.fetch_add(1, std::memory_order_relaxed);
+                Detail::g_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+                Detail::t_Allocations++;
+                Detail::t_AllocatedBytes += size;
+            }
+
+            inline uint64_t GetAllocationCount() { return Detail::g_Allocations.load(std::memory_order_relaxed); }
+            inline uint64_t GetAllocatedBytes() { return Detail::g_AllocatedBytes.load(std::memory_order_relaxed); }
+            /* Same as above for the calling thread only */
+            inline uint64_t GetThreadAllocationCount() { return Detail::t_Allocations; }
+            inline uint64_t GetThreadAllocatedBytes() { return Detail::t_AllocatedBytes; }
+
+            /* Records a zone from it's construction to it's destruction, see RAZIX_PACKER_PROFILE_ZONE */
+            class ProfileZone
+            {
+            public:
+                explicit ProfileZone(const char* name, const char* detail = nullptr)
+                {
+                    if (!IsProfilingEnabled())
+                        return;
+                    m_Name           = name;
+                    m_Detail         = detail;
+                    m_Allocations    = GetThreadAllocationCount();
+                    m_AllocatedBytes = GetThreadAllocatedBytes();
+                    m_StartNs        = GetProfilerTimeNs();
+                }
+
+                ~ProfileZone()
+                {
+                    if (m_Name)
+                        RecordProfileZone(m_Name, m_Detail, m_StartNs, GetProfilerTimeNs(), GetThreadAllocationCount() - m_Allocations, GetThreadAllocatedBytes() - m_AllocatedBytes);
+                }
+
+                ProfileZone(const ProfileZone&)            = delete;
+                ProfileZone& operator=(const ProfileZone&) = delete;
+
+            private:
+                const char* m_Name           = nullptr; /* Not recording when null */
+                const char* m_Detail         = nullptr;
+                uint64_t    m_StartNs        = 0;
+                uint64_t    m_Allocations    = 0;
+                uint64_t    m_AllocatedBytes = 0;
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
+
+#define RAZIX_PACKER_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RAZIX_PACKER_PROFILE_CONCAT(a, b)      RAZIX_PACKER_PROFILE_CONCAT_IMPL(a, b)
+
+// RAZIX_PACKER_PROFILE_ZONE("Export") or RAZIX_PACKER_PROFILE_ZONE("Export", path.c_str()), until the end of the scope
+#define RAZIX_PACKER_PROFILE_ZONE(...) Razix::Tool::AssetPacker::ProfileZone RAZIX_PACKER_PROFILE_CONCAT(razixProfileZone, __LINE__)(__VA_ARGS__)
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * .rzskel and .rzanim, the skeleton of a model and it's compressed animation clips
+ *
+ * .rzskel layout:
+ *  - BINSkeletonHeader
+ *  - BINSkeletonBone x bone_count, depth first so a parent is always before it's children
+ *  - string table, string_table_size bytes of null terminated bone names
+ *
+ * .rzanim layout, a file per clip:
+ *  - BINAnimHeader
+ *  - BINAnimTrack x track_count, bones without a track stay in their bind pose
+ *  - key data, data_size bytes of uint16_t referenced by the tracks
+ *
+ * Every channel (position, rotation, scale) of a track has it's own keys, at it's offset in the key data there are count
+ * uint16_t key times followed by count x 3 uint16_t values. A channel with 0 keys uses the bind pose, a single key is constant
+ *  - time     : time / duration * 65535
+ *  - position : min + value / 65535 * extent, per component with the range of the track
+ *  - scale    : same as the position with it's own range
+ *  - rotation : smallest three, the biggest component is dropped and rebuilt as sqrt(1 - x^2 - y^2 - z^2)
+ *               the 15 high bits of every value are one of the 3 kept components in x, y, z, w order without the dropped one,
+ *               mapped from [-1/sqrt(2), 1/sqrt(2)] to [0, 32767]. The low bits of the first two values are the index of the
+ *               dropped component (bit 0 and bit 1), the low bit of the third one is 0
+ * Sample by finding the keys around the time and lerp (slerp for rotations) between them, the removed keys are within the
+ * tolerances the clip was compressed with
+ */
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            constexpr uint32_t RAZIX_SKELETON_FOURCC = 0x4B535A52; /* 'RZSK' */
+            constexpr uint32_t RAZIX_ANIM_FOURCC     = 0x4E415A52; /* 'RZAN' */
+            constexpr uint32_t RAZIX_ANIM_VERSION    = 0x1;
+
+            struct BINSkeletonHeader
+            {
+                uint32_t fourcc            = RAZIX_SKELETON_FOURCC;
+                uint32_t version           = RAZIX_ANIM_VERSION;
+                uint32_t bone_count        = 0;
+                uint32_t string_table_size = 0;
+            };
+
+            struct BINSkeletonBone
+            {
+                uint32_t name_offset      = 0;  /* Into the string table                              */
+                int32_t  parent           = -1; /* Index of the parent bone, -1 for the roots         */
+                float    translation[3]   = {}; /* Bind pose relative to the parent                   */
+                float    rotation[4]      = {0.0f, 0.0f, 0.0f, 1.0f}; /* x, y, z, w */
+                float    scale[3]         = {1.0f, 1.0f, 1.0f};
+                float    inverse_bind[16] = {}; /* Model space -> bone space in the bind pose, column major */
+            };
+
+            struct BINAnimHeader
+            {
+                uint32_t fourcc      = RAZIX_ANIM_FOURCC;
+                uint32_t version     = RAZIX_ANIM_VERSION;
+                char     name[64]    = {};
+                float    duration    = 0.0f; /* Seconds                                                     */
+                uint32_t bone_count  = 0;    /* Bones of the skeleton the clip animates, matches the .rzskel */
+                uint32_t track_count = 0;
+                uint32_t data_size   = 0;    /* Bytes of key data after the tracks                          */
+            };
+
+            struct BINAnimChannel
+            {
+                uint32_t offset = 0; /* Bytes into the key data, 2 byte aligned */
+                uint32_t count  = 0; /* Keys, 0 keeps the bind pose             */
+            };
+
+            struct BINAnimTrack
+            {
+                uint32_t       bone = 0; /* Index into the .rzskel bones */
+                BINAnimChannel position;
+                BINAnimChannel rotation;
+                BINAnimChannel scale;
+                float          position_min[3]    = {};
+                float          position_extent[3] = {};
+                float          scale_min[3]       = {};
+                float          scale_extent[3]    = {};
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * .rzmatlib, every unique material of a model in a single binary file
+ *
+ * Layout:
+ *  - BINMaterialLibraryHeader
+ *  - BINMaterial x material_count at materials_offset
+ *  - string table of string_table_size bytes at strings_offset, null terminated material names and texture paths
+ *
+ * Materials with the same properties and textures are stored once whatever their name, the .rzmodel/.rzpack material tables map
+ * every material of the model to it's entry with library_index. A texture path used by several materials is in the string
+ * table once. Texture paths are the ones the material had after the texture processing (the .dds files with --textures)
+ */
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            constexpr uint32_t RAZIX_MATERIAL_LIBRARY_FOURCC  = 0x4C4D5A52; /* 'RZML' */
+            constexpr uint32_t RAZIX_MATERIAL_LIBRARY_VERSION = 0x1;
+            constexpr uint32_t RAZIX_MATERIAL_NO_TEXTURE      = ~0u;
+
+            enum BINMaterialTexture : uint32_t
+            {
+                MATERIAL_TEXTURE_ALBEDO,
+                MATERIAL_TEXTURE_NORMAL,
+                MATERIAL_TEXTURE_METALLIC,
+                MATERIAL_TEXTURE_ROUGHNESS,
+                MATERIAL_TEXTURE_SPECULAR,
+                MATERIAL_TEXTURE_EMISSIVE,
+                MATERIAL_TEXTURE_AO,
+                MATERIAL_TEXTURE_METALLIC_ROUGHNESS_AO, /* Packed map of WORLFLOW_PBR_METAL_ROUGHNESS_AO_COMBINED */
+                MATERIAL_TEXTURE_COUNT
+            };
+
+            struct BINMaterialLibraryHeader
+            {
+                uint32_t fourcc            = RAZIX_MATERIAL_LIBRARY_FOURCC;
+                uint32_t version           = RAZIX_MATERIAL_LIBRARY_VERSION;
+                uint32_t material_count    = 0;
+                uint32_t string_table_size = 0;
+                uint32_t materials_offset  = 0; /* From the start of the file */
+                uint32_t strings_offset    = 0;
+                uint32_t file_size         = 0;
+                uint32_t reserved          = 0;
+            };
+
+            struct BINMaterial
+            {
+                uint32_t name_offset                      = 0; /* Name of the first material of the model with these properties */
+                uint32_t workflow                         = 0; /* Razix::Graphics::WorkFlow                                     */
+                float    albedo_color[4]                  = {};
+                float    roughness                        = 0.0f;
+                float    metallic                         = 0.0f;
+                uint32_t textures[MATERIAL_TEXTURE_COUNT] = {}; /* Offsets into the string table, RAZIX_MATERIAL_NO_TEXTURE when not set */
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Razix/AssetSystem/RZAssetFileSpec.h"
+
+/**
+ * Packer side extensions to the .rzmesh file format
+ *
+ * V3 keeps the V2 layout (BINFileHeader -> BINMeshFileHeader -> blobs) and adds:
+ *  - a BINMeshExtHeader right after the BINMeshFileHeader
+ *  - a BINBlobEncoding right after every BINBlobHeader, it describes how the blob payload is stored
+ *  - the index buffer is stored as a blob ("INDEX:R32_UINT") as the first blob, so it can be encoded like the rest
+ *  - optional skinning streams (MESH_EXT_SKINNED) right after the vertex attributes: "BONE_INDEX:R16G16B16A16_UINT" (indices
+ *    into the bones of the model's .rzskel) and "BONE_WEIGHT:R8G8B8A8_UNORM" (sorted from the biggest, summing up to 255)
+ *  - optional LOD chain (MESH_EXT_LODS) after the attribute blobs: a "LOD:TABLE" blob of BINMeshLOD entries and a
+ *    "LOD:INDEX_R32_UINT" blob with the index buffers of all the LODs, they index the same vertex blobs as LOD 0
+ *  - optional meshlets of LOD 0 (MESH_EXT_MESHLETS) after the LOD blobs: "MESHLET:DESC" (BINMeshlet), "MESHLET:VERTEX_R32_UINT"
+ *    (meshlet vertex -> submesh vertex), "MESHLET:TRIANGLE_R8_UINT" (3 meshlet vertex indices per triangle, every meshlet
+ *    starts 4 byte aligned) and "MESHLET:BOUNDS" (BINMeshletBounds)
+ *  - optional SAH BVH of LOD 0 (MESH_EXT_BVH) after the meshlets: "BVH:NODE" (BINMeshBVHNode) and "BVH:INDEX_R32_UINT", the LOD 0
+ *    triangles reordered so every leaf is a contiguous range. The render index buffer keeps it's vertex cache order
+ *
+ * Aligned layout (MESH_EXT_ALIGNED_BLOBS), for loading through a memory mapped file:
+ *  - the headers stay at fixed offsets: BINFileHeader at 0, then BINMeshFileHeader, BINMeshExtHeader and a BINBlobEntry per blob
+ *  - every blob payload starts at a multiple of BINMeshExtHeader::blob_alignment (ex. 4096) from the start of the file,
+ *    raw payloads can be handed to a staging allocator straight from the mapping
+ *
+ * The exporter only writes V3 when one of the extensions is enabled, otherwise the files stay plain V2
+ */
+#ifndef RAZIX_ASSET_VERSION_V3
+    #define RAZIX_ASSET_VERSION_V3 0x3
+#endif
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /* BINFileHeader::magic, only the characters are stored, a bigger magic field is left zero filled */
+            constexpr char     RAZIX_ASSET_MAGIC[]    = "razix_engine_asset";
+            constexpr uint32_t RAZIX_ASSET_MAGIC_SIZE = sizeof(RAZIX_ASSET_MAGIC) - 1;
+            static_assert(sizeof(Razix::AssetSystem::BINFileHeader::magic) >= RAZIX_ASSET_MAGIC_SIZE, "The magic doesn't fit in BINFileHeader");
+
+            enum MeshExtFlags : uint32_t
+            {
+                MESH_EXT_NONE            = 0,
+                MESH_EXT_ENCODED_STREAMS = 1 << 0, /* At least one blob is not stored raw, check the BINBlobEncoding of each blob */
+                MESH_EXT_LODS            = 1 << 1, /* LOD:TABLE and LOD:INDEX_R32_UINT blobs follow the attributes, see lod_count   */
+                MESH_EXT_MESHLETS        = 1 << 2, /* MESHLET:* blobs follow the LODs, see meshlet_count                            */
+                MESH_EXT_ALIGNED_BLOBS   = 1 << 3, /* Blob headers are in a BINBlobEntry table, payloads aligned to blob_alignment  */
+                MESH_EXT_SKINNED         = 1 << 4, /* BONE_INDEX/BONE_WEIGHT blobs follow the vertex attributes                     */
+                MESH_EXT_BVH             = 1 << 5, /* BVH:* blobs follow the meshlets, see bvh_node_count                           */
+            };
+
+            /**
+             * How a blob payload is stored, decode in the reverse order (deflate first and then the meshopt codec)
+             */
+            enum BlobEncodingFlags : uint32_t
+            {
+                BLOB_ENCODING_RAW            = 0,
+                BLOB_ENCODING_MESHOPT_VERTEX = 1 << 0, /* meshopt_decodeVertexBuffer(dst, element_count, stride, ...)            */
+                BLOB_ENCODING_MESHOPT_INDEX  = 1 << 1, /* meshopt_decodeIndexBuffer(dst, element_count, sizeof(uint32_t), ...)   */
+                                                       /* triangles keep their order and winding, but may be rotated            */
+                BLOB_ENCODING_DEFLATE        = 1 << 2, /* zlib stream (RFC 1950), applied on top of the meshopt codec if present */
+            };
+
+            struct BINMeshExtHeader
+            {
+                uint32_t flags          = MESH_EXT_NONE; /* MeshExtFlags                                                            */
+                uint32_t lod_count      = 0;             /* Number of LODs after LOD 0, entries in the LOD:TABLE blob               */
+                uint32_t meshlet_count  = 0;             /* Number of meshlets, entries in the MESHLET:DESC/BOUNDS blobs            */
+                uint32_t blob_alignment = 0;             /* Alignment of the blob payloads with MESH_EXT_ALIGNED_BLOBS, 0 otherwise */
+                uint32_t bvh_node_count = 0;             /* Entries in the BVH:NODE blob                                            */
+                uint32_t reserved[3]{};
+            };
+
+            struct BINBlobEncoding
+            {
+                uint32_t flags         = BLOB_ENCODING_RAW; /* BlobEncodingFlags                                                 */
+                uint32_t element_count = 0;                 /* Number of elements (vertices/indices) after decoding                */
+                uint32_t decoded_size  = 0;                 /* Size in bytes after decoding = element_count * stride               */
+                uint32_t encoded_size  = 0;                 /* Size in bytes stored in the file, same as BINBlobHeader::size       */
+                uint32_t codec_size    = 0;                 /* Size of the meshopt codec payload, i.e. the size after inflating it */
+            };
+
+            /**
+             * Blob table of the aligned layout, blobs_count entries right after the BINMeshExtHeader
+             */
+            struct BINBlobEntry
+            {
+                Razix::AssetSystem::BINBlobHeader header   = {}; /* header.size is the size of the payload stored in the file */
+                BINBlobEncoding                   encoding = {};
+                uint32_t                          reserved = 0;
+                uint64_t                          offset   = 0; /* From the start of the file, multiple of blob_alignment   */
+            };
+
+            /**
+             * An entry of the LOD:TABLE blob, ordered from the most to the least detailed LOD
+             * The error is the object space deviation from LOD 0, project it to get the screen space error for LOD selection
+             */
+            struct BINMeshLOD
+            {
+                uint32_t index_offset = 0;    /* First index of the LOD in the LOD:INDEX_R32_UINT blob */
+                uint32_t index_count  = 0;
+                float    error        = 0.0f; /* Object space units                                    */
+                uint32_t reserved     = 0;
+            };
+
+            /**
+             * An entry of the MESHLET:DESC blob, the layout matches meshopt_Meshlet so it can be uploaded as is
+             */
+            struct BINMeshlet
+            {
+                uint32_t vertex_offset   = 0; /* First vertex of the meshlet in the MESHLET:VERTEX_R32_UINT blob                 */
+                uint32_t triangle_offset = 0; /* First byte of the meshlet in the MESHLET:TRIANGLE_R8_UINT blob, 4 byte aligned */
+                uint32_t vertex_count    = 0;
+                uint32_t triangle_count  = 0;
+            };
+
+            /**
+             * An entry of the MESHLET:BOUNDS blob, object space
+             * Frustum/occlusion cull with the sphere, backface cull the whole meshlet when dot(normalize(cone_apex - camera), cone_axis) >= cone_cutoff
+             */
+            struct BINMeshletBounds
+            {
+                float    center[3]    = {};
+                float    radius       = 0.0f;
+                float    cone_apex[3] = {};
+                float    cone_cutoff  = 0.0f; /* cos(angle / 2) of the normal cone, 1 disables cone culling */
+                float    cone_axis[3] = {};
+                uint32_t reserved     = 0;
+            };
+
+            /**
+             * An entry of the BVH:NODE blob, object space, the root is the first node and the blob is used as is at runtime
+             * Interior nodes have triangle_count 0 and their children at first and first + 1, node 1 is unused so every pair of siblings
+             * shares a cache line when the blob is 64 byte aligned (always the case with MESH_EXT_ALIGNED_BLOBS, which every file with a BVH
+             * sets). Leaves hold triangle_count triangles starting at triangle first of the BVH:INDEX_R32_UINT blob
+             */
+            struct BINMeshBVHNode
+            {
+                float    min_extents[3] = {};
+                uint32_t first          = 0;
+                float    max_extents[3] = {};
+                uint32_t triangle_count = 0;
+            };
+            static_assert(sizeof(BINMeshBVHNode) == 32, "Two BVH nodes per cache line");
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * .rzmodel, the node hierarchy of a model and what every node draws
+ *
+ * Layout:
+ *  - BINModelHeader
+ *  - arrays, each at offsets[MODEL_ARRAY_*] from the start of the file, aligned to BINModelHeader::alignment
+ *
+ * Nodes are stored as SoA arrays of node_count elements in depth first order, a parent is always before it's children and the
+ * root is the first node. World transforms are a single linear pass without any pointer chasing:
+ *     world[0] = local[0], world[i] = world[parents[i]] * local[i]
+ * with local = T * R * S. Every node draws the submeshes at mesh_ranges[i] in the meshes array, submeshes reference their material.
+ * Materials are entries of the .rzmatlib of the model (see common/rzmaterial_format.h), several can share the same entry.
+ * When pack_path_offset is set the submeshes are the ones of the .rzpack in the same order, else every submesh has it's own .rzmesh
+ *
+ * Paths are relative to the assets directory, all the names and paths are null terminated strings in the string table
+ */
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            constexpr uint32_t RAZIX_MODEL_FOURCC    = 0x444D5A52; /* 'RZMD' */
+            constexpr uint32_t RAZIX_MODEL_VERSION   = 0x2;
+            constexpr uint32_t RAZIX_MODEL_NULL_NODE = ~0u;
+            constexpr uint32_t RAZIX_MODEL_NO_STRING = ~0u;
+
+            enum BINModelArray : uint32_t
+            {
+                MODEL_ARRAY_PARENTS,      /* uint32_t x node_count, RAZIX_MODEL_NULL_NODE for the root  */
+                MODEL_ARRAY_TRANSLATIONS, /* float[3] x node_count                                      */
+                MODEL_ARRAY_ROTATIONS,    /* float[4] x node_count, x y z w                             */
+                MODEL_ARRAY_SCALES,       /* float[3] x node_count                                      */
+                MODEL_ARRAY_NAMES,        /* uint32_t x node_count, offsets into the string table       */
+                MODEL_ARRAY_MESH_RANGES,  /* BINModelMeshRange x node_count                             */
+                MODEL_ARRAY_MESHES,       /* uint32_t x node_mesh_count, submesh indices                */
+                MODEL_ARRAY_SUBMESHES,    /* BINModelSubMesh x submesh_count                            */
+                MODEL_ARRAY_MATERIALS,    /* BINModelMaterial x material_count                          */
+                MODEL_ARRAY_STRINGS,      /* string_table_size bytes                                    */
+                MODEL_ARRAY_COUNT
+            };
+
+            struct BINModelHeader
+            {
+                uint32_t fourcc            = RAZIX_MODEL_FOURCC;
+                uint32_t version           = RAZIX_MODEL_VERSION;
+                uint32_t alignment         = 16;                    /* Of every array, power of 2                   */
+                uint32_t file_size         = 0;
+                uint32_t node_count        = 0;
+                uint32_t node_mesh_count   = 0;                     /* Elements of MODEL_ARRAY_MESHES               */
+                uint32_t submesh_count     = 0;
+                uint32_t material_count    = 0;
+                uint32_t string_table_size = 0;
+                uint32_t name_offset       = 0;                     /* Name of the model                            */
+                uint32_t pack_path_offset  = RAZIX_MODEL_NO_STRING; /* .rzpack holding the submeshes, if packed     */
+                float    min_extents[3]    = {};
+                float    max_extents[3]    = {};
+
+                uint32_t offsets[MODEL_ARRAY_COUNT] = {}; /* Indexed by BINModelArray */
+            };
+
+            struct BINModelMeshRange
+            {
+                uint32_t offset = 0; /* Into MODEL_ARRAY_MESHES */
+                uint32_t count  = 0;
+            };
+
+            struct BINModelSubMesh
+            {
+                uint32_t name_offset    = 0;
+                uint32_t material_index = 0;                     /* Into MODEL_ARRAY_MATERIALS                           */
+                uint32_t path_offset    = RAZIX_MODEL_NO_STRING; /* .rzmesh of the submesh, not set when the model is packed */
+                float    min_extents[3] = {};
+                float    max_extents[3] = {};
+            };
+
+            struct BINModelMaterial
+            {
+                uint32_t name_offset   = 0;
+                uint32_t path_offset   = 0; /* .rzmatlib holding the material           */
+                uint32_t library_index = 0; /* Into the BINMaterial array of the library */
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/rzmesh_format.h"
+
+/**
+ * .rzpack, all the submeshes of a model in a single file
+ *
+ * Layout:
+ *  - BINFileHeader (version RAZIX_ASSET_VERSION_V3, type ASSET_MESH)
+ *  - BINPackHeader
+ *  - BINPackSection x section_count, the table of contents
+ *  - section payloads, every payload starts at a multiple of BINPackHeader::alignment from the start of the file
+ *
+ * Sections are looked up by name and use the same names and formats as the .rzmesh blobs ("INDEX:R32_UINT",
+ * "POSITION:R16G16B16A16_UNORM", "LOD:TABLE", ...), but hold the data of all the submeshes back to back:
+ *  - "SUBMESH:TABLE"         BINPackSubMesh per submesh, locates the submesh in the other sections
+ *  - "INDEX:R32_UINT"        indices of all the submeshes, relative to the base_vertex of their submesh
+ *  - vertex attributes       one section per attribute for all the vertices, quantized positions use the model AABB
+ *  - "BONE_INDEX:*"          optional, R16G16B16A16_UINT indices into the .rzskel bones for all the vertices of skinned models
+ *  - "BONE_WEIGHT:*"         optional, R8G8B8A8_UNORM weights, the vertices of unskinned submeshes are bound to bone 0
+ *  - "LOD:TABLE"             optional, BINMeshLOD with index_offset into "LOD:INDEX_R32_UINT"
+ *  - "MESHLET:*"             optional, same as .rzmesh with offsets into the whole sections
+ *  - "BVH:NODE"              optional, BINMeshBVHNode, the BVH of every submesh starts at it's bvh_offset and indexes it's own nodes,
+ *                            offsets are even (odd ranges get an unused node) so every root starts a 64 byte cache line
+ *  - "BVH:INDEX_R32_UINT"    optional, parallel to INDEX:R32_UINT, the triangles of every submesh in the leaf order of it's BVH
+ *  - "MATERIAL:TABLE"        BINPackMaterial per material, an entry of the .rzmatlib of the model
+ *  - "NODE:TABLE"            BINPackNode per node in depth first order, the root is the first node
+ *  - "NODE:MESHES_R32_UINT"  submesh indices referenced by the nodes
+ *  - "STRING:TABLE"          null terminated names and paths referenced by the other sections
+ */
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            constexpr uint32_t RAZIX_PACK_FOURCC    = 0x4B505A52; /* 'RZPK' */
+            constexpr uint32_t RAZIX_PACK_VERSION   = 0x3;
+            constexpr uint32_t RAZIX_PACK_NULL_NODE = ~0u;
+
+            struct BINPackHeader
+            {
+                uint32_t fourcc         = RAZIX_PACK_FOURCC;
+                uint32_t version        = RAZIX_PACK_VERSION;
+                uint32_t alignment      = 16; /* Alignment of every section payload in the file                 */
+                uint32_t section_count  = 0;  /* Entries in the table of contents right after this header       */
+                uint32_t submesh_count  = 0;
+                uint32_t material_count = 0;
+                uint32_t node_count     = 0;
+                uint32_t reserved       = 0;
+                float    min_extents[3] = {}; /* AABB of the whole model, also the range of quantized positions */
+                float    max_extents[3] = {};
+                uint64_t file_size      = 0;
+            };
+
+            /**
+             * An entry of the table of contents, the payload is stored like a .rzmesh V3 blob
+             */
+            struct BINPackSection
+            {
+                char            name[48] = {};
+                uint64_t        offset   = 0; /* From the start of the file, encoding.encoded_size bytes */
+                uint32_t        stride   = 0; /* Size of an element after decoding                       */
+                BINBlobEncoding encoding = {};
+            };
+
+            struct BINPackSubMesh
+            {
+                uint32_t name_offset    = 0; /* Into STRING:TABLE                                 */
+                uint32_t material_index = 0; /* Into MATERIAL:TABLE                               */
+                uint32_t base_index     = 0; /* Into INDEX:R32_UINT                               */
+                uint32_t index_count    = 0;
+                uint32_t base_vertex    = 0; /* Into the vertex attribute sections                */
+                uint32_t vertex_count   = 0;
+                uint32_t lod_offset     = 0; /* Into LOD:TABLE, LOD 0 is the submesh and not listed */
+                uint32_t lod_count      = 0;
+                uint32_t meshlet_offset = 0; /* Into MESHLET:DESC and MESHLET:BOUNDS              */
+                uint32_t meshlet_count  = 0;
+                uint32_t bvh_offset     = 0; /* Into BVH:NODE, the root of the submesh BVH        */
+                uint32_t bvh_node_count = 0;
+                float    min_extents[3] = {};
+                float    max_extents[3] = {};
+            };
+
+            struct BINPackMaterial
+            {
+                uint32_t name_offset   = 0; /* Into STRING:TABLE                                                  */
+                uint32_t path_offset   = 0; /* Into STRING:TABLE, .rzmatlib file relative to the assets directory */
+                uint32_t library_index = 0; /* Into the BINMaterial array of the library                          */
+            };
+
+            struct BINPackNode
+            {
+                uint32_t name_offset    = 0;                    /* Into STRING:TABLE                   */
+                uint32_t parent         = RAZIX_PACK_NULL_NODE; /* Always before the node in the table */
+                uint32_t mesh_offset    = 0;                    /* Into NODE:MESHES_R32_UINT           */
+                uint32_t mesh_count     = 0;
+                float    translation[3] = {};
+                float    rotation[4]    = {0.0f, 0.0f, 0.0f, 1.0f}; /* x, y, z, w */
+                float    scale[3]       = {1.0f, 1.0f, 1.0f};
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,106 @@
+#include "scratch_arena.h"
+
+#include <algorithm>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            static size_t AlignUp(size_t offset, size_t alignment)
+            {
+                return (offset + alignment - 1) & ~(alignment - 1);
+            }
+
+            void* ScratchArena::allocateBytes(size_t size, size_t alignment)
+            {
+                if (size == 0)
+                    return nullptr;
+
+                // Current block first, then the next ones left over from a previous scope
+                while (m_CurrentBlock < m_Blocks.size()) {
+                    size_t offset = AlignUp(m_Offset, alignment);
+                    if (offset + size <= m_Blocks[m_CurrentBlock].size) {
+                        m_Offset = offset + size;
+                        return m_Blocks[m_CurrentBlock].data.get() + offset;
+                    }
+                    if (m_CurrentBlock + 1 == m_Blocks.size())
+                        break;
+                    m_CurrentBlock++;
+                    m_Offset = 0;
+                }
+
+                // new[] is aligned for any fundamental type, bigger alignments get some slack
+                Block block;
+                block.size = std::max(kDefaultBlockSize, size + alignment);
+                block.data = std::make_unique<uint8_t[]>(block.size);
+                m_Blocks.push_back(std::move(block));
+
+                m_CurrentBlock = m_Blocks.size() - 1;
+                m_Offset       = AlignUp(reinterpret_cast<uintptr_t>(m_Blocks.back().data.get()), alignment) - reinterpret_cast<uintptr_t>(m_Blocks.back().data.get());
+                void* data     = m_Blocks.back().data.get() + m_Offset;
+                m_Offset += size;
+                return data;
+            }
+
+            std::vector<uint8_t>& ScratchArena::acquireBuffer()
+            {
+                if (m_BuffersUsed == m_Buffers.size())
+                    m_Buffers.push_back(std::make_unique<std::vector<uint8_t>>());
+
+                auto& buffer = *m_Buffers[m_BuffersUsed++];
+                buffer.clear();
+                return buffer;
+            }
+
+            void ScratchArena::rewind(const Marker& marker)
+            {
+                m_CurrentBlock = marker.block;
+                m_Offset       = marker.offset;
+                m_BuffersUsed  = marker.buffers;
+
+                if (m_CurrentBlock == 0 && m_Offset == 0 && m_BuffersUsed == 0)
+                    trim();
+            }
+
+            void ScratchArena::trim()
+            {
+                // Several blocks mean the last scope needed more than the first one, a single block of the total size fits it next time
+                size_t totalSize = 0;
+                for (const auto& block: m_Blocks)
+                    totalSize += block.size;
+                totalSize = std::min(totalSize, kMaxRetainedBytes);
+
+                if (m_Blocks.size() > 1 || (m_Blocks.size() == 1 && m_Blocks[0].size > totalSize)) {
+                    m_Blocks.clear();
+                    Block block;
+                    block.size = totalSize;
+                    block.data = std::make_unique<uint8_t[]>(block.size);
+                    m_Blocks.push_back(std::move(block));
+                }
+
+                size_t retainedBytes = totalSize;
+                for (auto& buffer: m_Buffers) {
+                    if (retainedBytes + buffer->capacity() > kMaxRetainedBytes)
+                        std::vector<uint8_t>().swap(*buffer);
+                    retainedBytes += buffer->capacity();
+                }
+            }
+
+            size_t ScratchArena::getReservedBytes() const
+            {
+                size_t reserved = 0;
+                for (const auto& block: m_Blocks)
+                    reserved += block.size;
+                for (const auto& buffer: m_Buffers)
+                    reserved += buffer->capacity();
+                return reserved;
+            }
+
+            ScratchArena& GetThreadScratchArena()
+            {
+                static thread_local ScratchArena arena;
+                return arena;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "common/span.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            //--------------------------------------------------------------------------------
+            // Scratch Arena
+            //--------------------------------------------------------------------------------
+
+            /**
+             * Bump allocator for the temporary tables and encode buffers of an export
+             *
+             * Allocations are released in LIFO order by ScratchScope. Once the outermost scope closes the blocks are merged into
+             * one, so after the first few submeshes a worker finds everything it needs in a single block and stops allocating.
+             * Memory above kMaxRetainedBytes is given back at that point, a huge model doesn't pin memory on every worker.
+             * Not thread safe, every thread uses it's own (GetThreadScratchArena)
+             */
+            class ScratchArena
+            {
+            public:
+                static constexpr size_t kDefaultBlockSize = 1 << 20;
+                static constexpr size_t kMaxRetainedBytes = 64 << 20;
+
+                /* Position of the arena, restored by rewind */
+                struct Marker
+                {
+                    size_t block   = 0;
+                    size_t offset  = 0;
+                    size_t buffers = 0;
+                };
+
+            public:
+                ScratchArena() = default;
+
+                ScratchArena(const ScratchArena&)            = delete;
+                ScratchArena& operator=(const ScratchArena&) = delete;
+
+                /* Zero filled, the tables end up in files and their padding has to be deterministic */
+                template<typename T>
+                Span<T> allocate(size_t count)
+                {
+                    Span<T> span = allocateUninitialized<T>(count);
+                    if (span.sizeBytes())
+                        memset(static_cast<void*>(span.data()), 0, span.sizeBytes());
+                    return span;
+                }
+
+                /* For streams that are entirely written right after */
+                template<typename T>
+                Span<T> allocateUninitialized(size_t count)
+                {
+                    static_assert(std::is_trivially_copyable<T>::value, "Scratch memory is never constructed nor destroyed");
+                    return Span<T>(static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T))), count);
+                }
+
+                /* A cleared byte buffer for outputs whose size isn't known upfront (ex. codecs), it keeps it's capacity across scopes */
+                std::vector<uint8_t>& acquireBuffer();
+
+                Marker getMarker() const { return {m_CurrentBlock, m_Offset, m_BuffersUsed}; }
+                void   rewind(const Marker& marker);
+
+                /* Bytes reserved by the blocks and the buffers */
+                size_t getReservedBytes() const;
+
+            private:
+                struct Block
+                {
+                    std::unique_ptr<uint8_t[]> data;
+                    size_t                     size = 0;
+                };
+
+            private:
+                void* allocateBytes(size_t size, size_t alignment);
+                void  trim();
+
+            private:
+                std::vector<Block>                                 m_Blocks;
+                size_t                                             m_CurrentBlock = 0;
+                size_t                                             m_Offset       = 0;
+                std::vector<std::unique_ptr<std::vector<uint8_t>>> m_Buffers;
+                size_t                                             m_BuffersUsed = 0;
+            };
+
+            /* Releases everything allocated from the arena during it's lifetime */
+            class ScratchScope
+            {
+            public:
+                explicit ScratchScope(ScratchArena& arena)
+                    : m_Arena(arena), m_Marker(arena.getMarker()) {}
+                ~ScratchScope() { m_Arena.rewind(m_Marker); }
+
+                ScratchScope(const ScratchScope&)            = delete;
+                ScratchScope& operator=(const ScratchScope&) = delete;
+
+            private:
+                ScratchArena&        m_Arena;
+                ScratchArena::Marker m_Marker;
+            };
+
+            /* Arena of the calling thread, job system workers keep theirs for the whole batch */
+            ScratchArena& GetThreadScratchArena();
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Non-owning view of a contiguous range, the exporter passes sub ranges of the import result streams around with it
+             * instead of copying them (std::span is C++20)
+             */
+            template<typename T>
+            class Span
+            {
+            public:
+                Span() = default;
+                Span(T* data, size_t size)
+                    : m_Data(data), m_Size(size) {}
+
+                T*     data() const { return m_Data; }
+                size_t size() const { return m_Size; }
+                size_t sizeBytes() const { return m_Size * sizeof(T); }
+                bool   empty() const { return m_Size == 0; }
+
+                T* begin() const { return m_Data; }
+                T* end() const { return m_Data + m_Size; }
+
+                T& operator[](size_t index) const
+                {
+                    assert(index < m_Size);
+                    return m_Data[index];
+                }
+
+                Span subspan(size_t offset, size_t count) const
+                {
+                    assert(offset + count <= m_Size);
+                    return Span(m_Data + offset, count);
+                }
+
+                operator Span<const T>() const { return Span<const T>(m_Data, m_Size); }
+
+            private:
+                T*     m_Data = nullptr;
+                size_t m_Size = 0;
+            };
+
+            /* [offset, offset + count) of a stream, empty if the stream doesn't cover it (ex. an attribute that wasn't imported) */
+            template<typename T>
+            Span<const T> MakeSpan(const std::vector<T>& stream, size_t offset, size_t count)
+            {
+                if (count == 0 || stream.size() < offset + count)
+                    return Span<const T>();
+                return Span<const T>(stream.data() + offset, count);
+            }
+
+            template<typename T>
+            Span<const T> MakeSpan(const std::vector<T>& stream)
+            {
+                return Span<const T>(stream.data(), stream.size());
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
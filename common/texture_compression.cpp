@@ -0,0 +1,458 @@
+#include "texture_compression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            // Principal axis of the first N channels of the block, power iteration on the covariance matrix
+            template<uint32_t N>
+            static void ComputePrincipalAxis(const uint8_t pixels[64], float mean[N], float axis[N])
+            {
+                float minValue[N], maxValue[N];
+                for (uint32_t c = 0; c < N; c++) {
+                    mean[c]     = 0.0f;
+                    minValue[c] = 255.0f;
+                    maxValue[c] = 0.0f;
+                }
+                for (uint32_t i = 0; i < 16; i++) {
+                    for (uint32_t c = 0; c < N; c++) {
+                        float value = pixels[i * 4 + c];
+                        mean[c] += value;
+                        minValue[c] = std::min(minValue[c], value);
+                        maxValue[c] = std::max(maxValue[c], value);
+                    }
+                }
+                for (uint32_t c = 0; c < N; c++)
+                    mean[c] /= 16.0f;
+
+                float covariance[N][N] = {};
+                for (uint32_t i = 0; i < 16; i++) {
+                    float d[N];
+                    for (uint32_t c = 0; c < N; c++)
+                        d[c] = pixels[i * 4 + c] - mean[c];
+                    for (uint32_t a = 0; a < N; a++) {
+                        for (uint32_t b = 0; b < N; b++)
+                            covariance[a][b] += d[a] * d[b];
+                    }
+                }
+
+                // The bounding box diagonal is a good first guess and converges in a few iterations
+                for (uint32_t c = 0; c < N; c++)
+                    axis[c] = maxValue[c] - minValue[c];
+
+                for (uint32_t iteration = 0; iteration < 8; iteration++) {
+                    float next[N] = {};
+                    for (uint32_t a = 0; a < N; a++) {
+                        for (uint32_t b = 0; b < N; b++)
+                            next[a] += covariance[a][b] * axis[b];
+                    }
+
+                    float length = 0.0f;
+                    for (uint32_t c = 0; c < N; c++)
+                        length = std::max(length, std::fabs(next[c]));
+                    if (length < 1e-6f)
+                        break;
+                    for (uint32_t c = 0; c < N; c++)
+                        axis[c] = next[c] / length;
+                }
+
+                float length = 0.0f;
+                for (uint32_t c = 0; c < N; c++)
+                    length += axis[c] * axis[c];
+                length = std::sqrt(length);
+                if (length < 1e-6f) {
+                    // Flat block, any axis works
+                    for (uint32_t c = 0; c < N; c++)
+                        axis[c] = 1.0f / std::sqrt(float(N));
+                } else {
+                    for (uint32_t c = 0; c < N; c++)
+                        axis[c] /= length;
+                }
+            }
+
+            // Extremes of the block along the axis
+            template<uint32_t N>
+            static void ComputeAxisEndpoints(const uint8_t pixels[64], const float mean[N], const float axis[N], float start[N], float end[N])
+            {
+                float minT = 0.0f, maxT = 0.0f;
+                for (uint32_t i = 0; i < 16; i++) {
+                    float t = 0.0f;
+                    for (uint32_t c = 0; c < N; c++)
+                        t += (pixels[i * 4 + c] - mean[c]) * axis[c];
+                    minT = std::min(minT, t);
+                    maxT = std::max(maxT, t);
+                }
+
+                for (uint32_t c = 0; c < N; c++) {
+                    start[c] = std::min(std::max(mean[c] + axis[c] * minT, 0.0f), 255.0f);
+                    end[c]   = std::min(std::max(mean[c] + axis[c] * maxT, 0.0f), 255.0f);
+                }
+            }
+
+            /**
+             * Least squares endpoints for fixed indices, weights[i] is how much of end texel i takes (0 = start, 1 = end)
+             * Returns false when every texel uses the same weight and the system can't be solved
+             */
+            template<uint32_t N>
+            static bool FitEndpoints(const uint8_t pixels[64], const float weights[16], float start[N], float end[N])
+            {
+                float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+                float ap[N] = {}, bp[N] = {};
+                for (uint32_t i = 0; i < 16; i++) {
+                    float b = weights[i];
+                    float a = 1.0f - b;
+                    aa += a * a;
+                    ab += a * b;
+                    bb += b * b;
+                    for (uint32_t c = 0; c < N; c++) {
+                        ap[c] += a * pixels[i * 4 + c];
+                        bp[c] += b * pixels[i * 4 + c];
+                    }
+                }
+
+                float det = aa * bb - ab * ab;
+                if (std::fabs(det) < 1e-6f)
+                    return false;
+
+                for (uint32_t c = 0; c < N; c++) {
+                    start[c] = std::min(std::max((ap[c] * bb - bp[c] * ab) / det, 0.0f), 255.0f);
+                    end[c]   = std::min(std::max((bp[c] * aa - ap[c] * ab) / det, 0.0f), 255.0f);
+                }
+                return true;
+            }
+
+            //--------------------------------------------------------------------------------
+            // BC1
+            //--------------------------------------------------------------------------------
+
+            static uint16_t PackRGB565(const float color[3])
+            {
+                uint32_t r = static_cast<uint32_t>(color[0] * 31.0f / 255.0f + 0.5f);
+                uint32_t g = static_cast<uint32_t>(color[1] * 63.0f / 255.0f + 0.5f);
+                uint32_t b = static_cast<uint32_t>(color[2] * 31.0f / 255.0f + 0.5f);
+                return static_cast<uint16_t>((std::min(r, 31u) << 11) | (std::min(g, 63u) << 5) | std::min(b, 31u));
+            }
+
+            static void UnpackRGB565(uint16_t packed, int color[3])
+            {
+                int r    = (packed >> 11) & 31;
+                int g    = (packed >> 5) & 63;
+                int b    = packed & 31;
+                color[0] = (r << 3) | (r >> 2);
+                color[1] = (g << 2) | (g >> 4);
+                color[2] = (b << 3) | (b >> 2);
+            }
+
+            // 4 color mode palette indices and their squared error, c0 > c1 is up to the caller
+            static uint32_t ComputeBC1Indices(const uint8_t pixels[64], uint16_t c0, uint16_t c1, uint32_t& indices)
+            {
+                int palette[4][3];
+                UnpackRGB565(c0, palette[0]);
+                UnpackRGB565(c1, palette[1]);
+                for (uint32_t c = 0; c < 3; c++) {
+                    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+                }
+
+                uint32_t error = 0;
+                indices        = 0;
+                for (uint32_t i = 0; i < 16; i++) {
+                    uint32_t best      = 0;
+                    uint32_t bestError = ~0u;
+                    for (uint32_t p = 0; p < 4; p++) {
+                        int      dr = pixels[i * 4 + 0] - palette[p][0];
+                        int      dg = pixels[i * 4 + 1] - palette[p][1];
+                        int      db = pixels[i * 4 + 2] - palette[p][2];
+                        uint32_t e  = static_cast<uint32_t>(dr * dr + dg * dg + db * db);
+                        if (e < bestError) {
+                            bestError = e;
+                            best      = p;
+                        }
+                    }
+                    indices |= best << (i * 2);
+                    error += bestError;
+                }
+                return error;
+            }
+
+            // Keeps the block in 4 color mode, equal endpoints fall back to a single color
+            static uint32_t EncodeBC1Endpoints(const uint8_t pixels[64], const float start[3], const float end[3], uint16_t& c0, uint16_t& c1, uint32_t& indices)
+            {
+                c0 = PackRGB565(end);
+                c1 = PackRGB565(start);
+                if (c0 < c1)
+                    std::swap(c0, c1);
+                if (c0 == c1) {
+                    indices = 0;
+                    uint32_t unused;
+                    return ComputeBC1Indices(pixels, c0, c1, unused);
+                }
+                return ComputeBC1Indices(pixels, c0, c1, indices);
+            }
+
+            static void EncodeColorBlock(const uint8_t pixels[64], uint8_t* block)
+            {
+                float mean[3], axis[3], start[3], end[3];
+                ComputePrincipalAxis<3>(pixels, mean, axis);
+                ComputeAxisEndpoints<3>(pixels, mean, axis, start, end);
+
+                uint16_t c0, c1;
+                uint32_t indices;
+                uint32_t error = EncodeBC1Endpoints(pixels, start, end, c0, c1, indices);
+
+                // One least squares pass on the chosen indices usually gets a good part of the way to a full cluster fit
+                if (error > 0 && c0 != c1) {
+                    static const float kWeights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+                    float              weights[16];
+                    for (uint32_t i = 0; i < 16; i++)
+                        weights[i] = kWeights[(indices >> (i * 2)) & 3];
+
+                    // Index 0 is c0, the end that was packed first
+                    float fitStart[3], fitEnd[3];
+                    if (FitEndpoints<3>(pixels, weights, fitEnd, fitStart)) {
+                        uint16_t fitC0, fitC1;
+                        uint32_t fitIndices;
+                        uint32_t fitError = EncodeBC1Endpoints(pixels, fitStart, fitEnd, fitC0, fitC1, fitIndices);
+                        if (fitError < error) {
+                            c0      = fitC0;
+                            c1      = fitC1;
+                            indices = fitIndices;
+                        }
+                    }
+                }
+
+                memcpy(block + 0, &c0, sizeof(uint16_t));
+                memcpy(block + 2, &c1, sizeof(uint16_t));
+                memcpy(block + 4, &indices, sizeof(uint32_t));
+            }
+
+            void EncodeBlockBC1(const uint8_t pixels[64], uint8_t* block)
+            {
+                EncodeColorBlock(pixels, block);
+            }
+
+            //--------------------------------------------------------------------------------
+            // BC4 (BC3 alpha, BC5 channels)
+            //--------------------------------------------------------------------------------
+
+            static void EncodeChannelBlock(const uint8_t pixels[64], uint32_t channel, uint8_t* block)
+            {
+                uint32_t minValue = 255, maxValue = 0;
+                for (uint32_t i = 0; i < 16; i++) {
+                    minValue = std::min<uint32_t>(minValue, pixels[i * 4 + channel]);
+                    maxValue = std::max<uint32_t>(maxValue, pixels[i * 4 + channel]);
+                }
+
+                // a0 > a1 selects the 8 value mode, equal endpoints decode to a0 with index 0
+                uint32_t palette[8];
+                palette[0] = maxValue;
+                palette[1] = minValue;
+                for (uint32_t i = 2; i < 8; i++)
+                    palette[i] = ((8 - i) * maxValue + (i - 1) * minValue + 3) / 7;
+
+                uint64_t indices = 0;
+                if (maxValue != minValue) {
+                    for (uint32_t i = 0; i < 16; i++) {
+                        int      value     = pixels[i * 4 + channel];
+                        uint32_t best      = 0;
+                        int      bestError = 256;
+                        for (uint32_t p = 0; p < 8; p++) {
+                            int e = std::abs(value - int(palette[p]));
+                            if (e < bestError) {
+                                bestError = e;
+                                best      = p;
+                            }
+                        }
+                        indices |= uint64_t(best) << (i * 3);
+                    }
+                }
+
+                block[0] = static_cast<uint8_t>(maxValue);
+                block[1] = static_cast<uint8_t>(minValue);
+                for (uint32_t i = 0; i < 6; i++)
+                    block[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+            }
+
+            void EncodeBlockBC3(const uint8_t pixels[64], uint8_t* block)
+            {
+                EncodeChannelBlock(pixels, 3, block);
+                EncodeColorBlock(pixels, block + 8);
+            }
+
+            void EncodeBlockBC5(const uint8_t pixels[64], uint8_t* block)
+            {
+                EncodeChannelBlock(pixels, 0, block);
+                EncodeChannelBlock(pixels, 1, block + 8);
+            }
+
+            //--------------------------------------------------------------------------------
+            // BC7 (mode 6)
+            //--------------------------------------------------------------------------------
+
+            static const uint32_t kBC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+            struct BC7Endpoints
+            {
+                uint32_t quantized[2][4]; /* 7 bits per channel */
+                uint32_t pbits[2];
+                uint32_t values[2][4];    /* Unquantized 8 bit values, (quantized << 1) | pbit */
+            };
+
+            // Every endpoint picks the p-bit that gets it closer to the requested color
+            static void QuantizeBC7Endpoint(const float color[4], BC7Endpoints& endpoints, uint32_t index)
+            {
+                float bestError = 1e30f;
+                for (uint32_t p = 0; p < 2; p++) {
+                    uint32_t quantized[4];
+                    float    error = 0.0f;
+                    for (uint32_t c = 0; c < 4; c++) {
+                        int q        = static_cast<int>(std::floor((color[c] - float(p)) / 2.0f + 0.5f));
+                        quantized[c] = static_cast<uint32_t>(std::min(std::max(q, 0), 127));
+                        float d      = float((quantized[c] << 1) | p) - color[c];
+                        error += d * d;
+                    }
+                    if (error < bestError) {
+                        bestError              = error;
+                        endpoints.pbits[index] = p;
+                        for (uint32_t c = 0; c < 4; c++) {
+                            endpoints.quantized[index][c] = quantized[c];
+                            endpoints.values[index][c]    = (quantized[c] << 1) | p;
+                        }
+                    }
+                }
+            }
+
+            static uint32_t ComputeBC7Indices(const uint8_t pixels[64], const BC7Endpoints& endpoints, uint8_t indices[16])
+            {
+                int palette[16][4];
+                for (uint32_t w = 0; w < 16; w++) {
+                    for (uint32_t c = 0; c < 4; c++)
+                        palette[w][c] = static_cast<int>(((64 - kBC7Weights4[w]) * endpoints.values[0][c] + kBC7Weights4[w] * endpoints.values[1][c] + 32) >> 6);
+                }
+
+                uint32_t error = 0;
+                for (uint32_t i = 0; i < 16; i++) {
+                    uint32_t best      = 0;
+                    uint32_t bestError = ~0u;
+                    for (uint32_t w = 0; w < 16; w++) {
+                        uint32_t e = 0;
+                        for (uint32_t c = 0; c < 4; c++) {
+                            int d = pixels[i * 4 + c] - palette[w][c];
+                            e += static_cast<uint32_t>(d * d);
+                        }
+                        if (e < bestError) {
+                            bestError = e;
+                            best      = w;
+                        }
+                    }
+                    indices[i] = static_cast<uint8_t>(best);
+                    error += bestError;
+                }
+                return error;
+            }
+
+            // Bits are stored LSB first across the 16 bytes
+            struct BitWriter
+            {
+                uint8_t* data;
+                uint32_t position = 0;
+
+                void write(uint32_t value, uint32_t bitsCount)
+                {
+                    for (uint32_t i = 0; i < bitsCount; i++, position++) {
+                        if ((value >> i) & 1)
+                            data[position >> 3] |= static_cast<uint8_t>(1u << (position & 7));
+                    }
+                }
+            };
+
+            void EncodeBlockBC7(const uint8_t pixels[64], uint8_t* block)
+            {
+                float mean[4], axis[4], start[4], end[4];
+                ComputePrincipalAxis<4>(pixels, mean, axis);
+                ComputeAxisEndpoints<4>(pixels, mean, axis, start, end);
+
+                BC7Endpoints endpoints;
+                uint8_t      indices[16];
+                QuantizeBC7Endpoint(start, endpoints, 0);
+                QuantizeBC7Endpoint(end, endpoints, 1);
+                uint32_t error = ComputeBC7Indices(pixels, endpoints, indices);
+
+                if (error > 0) {
+                    float weights[16];
+                    for (uint32_t i = 0; i < 16; i++)
+                        weights[i] = kBC7Weights4[indices[i]] / 64.0f;
+
+                    float fitStart[4], fitEnd[4];
+                    if (FitEndpoints<4>(pixels, weights, fitStart, fitEnd)) {
+                        BC7Endpoints fitEndpoints;
+                        uint8_t      fitIndices[16];
+                        QuantizeBC7Endpoint(fitStart, fitEndpoints, 0);
+                        QuantizeBC7Endpoint(fitEnd, fitEndpoints, 1);
+                        if (ComputeBC7Indices(pixels, fitEndpoints, fitIndices) < error) {
+                            endpoints = fitEndpoints;
+                            memcpy(indices, fitIndices, sizeof(indices));
+                        }
+                    }
+                }
+
+                // The anchor index is stored with 3 bits, so it's most significant bit has to be 0
+                if (indices[0] & 8) {
+                    std::swap(endpoints.quantized[0], endpoints.quantized[1]);
+                    std::swap(endpoints.pbits[0], endpoints.pbits[1]);
+                    for (uint32_t i = 0; i < 16; i++)
+                        indices[i] = static_cast<uint8_t>(15 - indices[i]);
+                }
+
+                memset(block, 0, 16);
+                BitWriter writer{block};
+                writer.write(1u << 6, 7);
+                for (uint32_t c = 0; c < 4; c++) {
+                    writer.write(endpoints.quantized[0][c], 7);
+                    writer.write(endpoints.quantized[1][c], 7);
+                }
+                writer.write(endpoints.pbits[0], 1);
+                writer.write(endpoints.pbits[1], 1);
+                writer.write(indices[0], 3);
+                for (uint32_t i = 1; i < 16; i++)
+                    writer.write(indices[i], 4);
+            }
+
+            //--------------------------------------------------------------------------------
+            // Images
+            //--------------------------------------------------------------------------------
+
+            void CompressBlockRows(BlockFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t firstRow, uint32_t rowsCount, uint8_t* output)
+            {
+                uint32_t blocksX   = (width + 3) / 4;
+                uint32_t blockSize = GetBlockSize(format);
+
+                uint8_t pixels[64];
+                for (uint32_t by = firstRow; by < firstRow + rowsCount; by++) {
+                    for (uint32_t bx = 0; bx < blocksX; bx++) {
+                        for (uint32_t y = 0; y < 4; y++) {
+                            uint32_t sy = std::min(by * 4 + y, height - 1);
+                            for (uint32_t x = 0; x < 4; x++) {
+                                uint32_t sx = std::min(bx * 4 + x, width - 1);
+                                memcpy(&pixels[(y * 4 + x) * 4], &rgba[(size_t(sy) * width + sx) * 4], 4);
+                            }
+                        }
+
+                        uint8_t* block = output + (size_t(by) * blocksX + bx) * blockSize;
+                        switch (format) {
+                            case BlockFormat::BC1: EncodeBlockBC1(pixels, block); break;
+                            case BlockFormat::BC3: EncodeBlockBC3(pixels, block); break;
+                            case BlockFormat::BC5: EncodeBlockBC5(pixels, block); break;
+                            case BlockFormat::BC7: EncodeBlockBC7(pixels, block); break;
+                        }
+                    }
+                }
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            enum class BlockFormat
+            {
+                BC1, /* RGB 5:6:5 endpoints, 4 bpp, no alpha                                   */
+                BC3, /* BC1 color + BC4 alpha, 8 bpp                                           */
+                BC5, /* Two BC4 channels (R, G), 8 bpp, normal maps with Z rebuilt in shaders  */
+                BC7  /* RGBA, 8 bpp, mode 6 only: RGBA 7.7.7.7 endpoints + p-bits, 4 bit indices */
+            };
+
+            /* Bytes of a 4x4 block */
+            inline uint32_t GetBlockSize(BlockFormat format)
+            {
+                return format == BlockFormat::BC1 ? 8 : 16;
+            }
+
+            /* Size of a whole level, partial blocks at the right/bottom edges count as full blocks */
+            inline uint64_t GetCompressedSize(BlockFormat format, uint32_t width, uint32_t height)
+            {
+                return uint64_t((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+            }
+
+            /**
+             * Encoders of a single 4x4 block, pixels are 16 RGBA8 texels in row order
+             * The endpoints come from the principal axis of the block and every texel picks the closest palette entry,
+             * good enough for offline packing without pulling in a full blown encoder
+             */
+            void EncodeBlockBC1(const uint8_t pixels[64], uint8_t* block);
+            void EncodeBlockBC3(const uint8_t pixels[64], uint8_t* block);
+            void EncodeBlockBC5(const uint8_t pixels[64], uint8_t* block);
+            void EncodeBlockBC7(const uint8_t pixels[64], uint8_t* block);
+
+            /**
+             * Compresses block rows [firstRow, firstRow + rowsCount) of an RGBA8 image into their place in output, the whole level
+             * Texels past the edges are clamped, so images of any size can be encoded. Rows are independent and can be encoded in parallel
+             */
+            void CompressBlockRows(BlockFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t firstRow, uint32_t rowsCount, uint8_t* output);
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
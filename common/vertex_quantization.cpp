@@ -0,0 +1,263 @@
+#include "vertex_quantization.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <meshoptimizer.h>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            template<typename T>
+            static const T* GetSubMeshStream(const std::vector<T>& stream, const SubMesh& submesh)
+            {
+                return stream.size() >= submesh.base_vertex + submesh.vertex_count && submesh.vertex_count > 0 ? &stream[submesh.base_vertex] : nullptr;
+            }
+
+            template<typename T>
+            static T* AllocateStorage(VertexStreamBlob& blob, ScratchArena& arena, uint32_t count, uint32_t stride)
+            {
+                // Every format fully writes it's storage, the UV fallback reuses the one of the failed attempt
+                if (blob.storage.size() < size_t(count) * stride) {
+                    Span<T> storage = arena.allocateUninitialized<T>(size_t(count) * stride / sizeof(T));
+                    blob.storage    = Span<uint8_t>(reinterpret_cast<uint8_t*>(storage.data()), storage.sizeBytes());
+                }
+                blob.stride = stride;
+                blob.data   = blob.storage.data();
+                return reinterpret_cast<T*>(blob.storage.data());
+            }
+
+            void BuildVertexStreamBlobs(const MeshImportResult& import_result, const SubMesh& submesh, const VertexFormatOptions& format, ScratchArena& arena, VertexStreamBlobs& blobs)
+            {
+                const Razix::Graphics::RZVertex& vertices = import_result.vertices;
+                uint32_t                         count    = submesh.vertex_count;
+
+                // Position
+                {
+                    auto& blob      = blobs[0];
+                    auto* positions = GetSubMeshStream(vertices.Position, submesh);
+                    if (positions && format.position == PositionFormat::UNorm16) {
+                        blob.typeName = "POSITION:R16G16B16A16_UNORM";
+                        QuantizePositionsUNorm16(positions, count, submesh.min_extents, submesh.max_extents, AllocateStorage<uint16_t>(blob, arena, count, sizeof(uint16_t) * 4));
+                    } else {
+                        blob.typeName = "POSITION:R32G32B32";
+                        blob.stride   = sizeof(glm::vec3);
+                        blob.data     = positions;
+                    }
+                }
+
+                // Color
+                {
+                    auto& blob   = blobs[1];
+                    auto* colors = GetSubMeshStream(vertices.Color, submesh);
+                    if (colors && format.color == ColorFormat::UNorm8) {
+                        blob.typeName = "COLOR:R8G8B8A8_UNORM";
+                        QuantizeColorsUNorm8(colors, count, AllocateStorage<uint8_t>(blob, arena, count, sizeof(uint8_t) * 4));
+                    } else {
+                        blob.typeName = "COLOR:R32G32B32A32";
+                        blob.stride   = sizeof(glm::vec4);
+                        blob.data     = colors;
+                    }
+                }
+
+                // UV
+                {
+                    auto& blob = blobs[2];
+                    auto* uvs  = GetSubMeshStream(vertices.UV, submesh);
+                    bool  done = false;
+                    if (uvs && format.uv == UVFormat::UNorm16) {
+                        // Nothing is written for out of range UVs, the same storage is then reused for the half fallback
+                        if (QuantizeUVsUNorm16(uvs, count, AllocateStorage<uint16_t>(blob, arena, count, sizeof(uint16_t) * 2))) {
+                            blob.typeName = "TEXCOORD:R16G16_UNORM";
+                            done          = true;
+                        }
+                    }
+                    if (!done && uvs && format.uv != UVFormat::Float) {
+                        blob.typeName = "TEXCOORD:R16G16_FLOAT";
+                        QuantizeUVsHalf(uvs, count, AllocateStorage<uint16_t>(blob, arena, count, sizeof(uint16_t) * 2));
+                        done = true;
+                    }
+                    if (!done) {
+                        blob.typeName = "TEXCOORD:R32G32";
+                        blob.stride   = sizeof(glm::vec2);
+                        blob.data     = uvs;
+                    }
+                }
+
+                // Normal
+                {
+                    auto& blob    = blobs[3];
+                    auto* normals = GetSubMeshStream(vertices.Normal, submesh);
+                    if (normals && format.normal == NormalFormat::Octahedral16) {
+                        blob.typeName = "NORMAL:R16G16_SNORM_OCT";
+                        EncodeOctahedralSNorm16(normals, count, AllocateStorage<int16_t>(blob, arena, count, sizeof(int16_t) * 2));
+                    } else {
+                        blob.typeName = "NORMAL:R32G32B32";
+                        blob.stride   = sizeof(glm::vec3);
+                        blob.data     = normals;
+                    }
+                }
+
+                // Tangent, the signed formats are always copied since the handedness sign is interleaved with the direction
+                // Vertices without a sign (ex. an importer that doesn't fill the stream) are right handed
+                {
+                    auto& blob     = blobs[4];
+                    auto* tangents = GetSubMeshStream(vertices.Tangent, submesh);
+                    auto* signs    = GetSubMeshStream(import_result.tangent_signs, submesh);
+                    if (tangents && format.normal == NormalFormat::Octahedral16) {
+                        blob.typeName    = "TANGENT:R16G16_SNORM_OCT_SIGN";
+                        int16_t* encoded = AllocateStorage<int16_t>(blob, arena, count, sizeof(int16_t) * 2);
+                        EncodeOctahedralSNorm16(tangents, count, encoded);
+                        // Costs the last bit of precision of y, which is far below what a normal map can show
+                        for (uint32_t i = 0; i < count; i++) {
+                            uint16_t y         = static_cast<uint16_t>(encoded[i * 2 + 1]) & ~uint16_t(1);
+                            encoded[i * 2 + 1] = static_cast<int16_t>(signs && signs[i] < 0.0f ? y | 1u : y);
+                        }
+                    } else if (tangents && format.normal == NormalFormat::FloatSigned) {
+                        blob.typeName  = "TANGENT:R32G32B32A32";
+                        glm::vec4* dst = AllocateStorage<glm::vec4>(blob, arena, count, sizeof(glm::vec4));
+                        for (uint32_t i = 0; i < count; i++)
+                            dst[i] = glm::vec4(tangents[i], signs && signs[i] < 0.0f ? -1.0f : 1.0f);
+                    } else {
+                        blob.typeName = "TANGENT:R32G32B32";
+                        blob.stride   = sizeof(glm::vec3);
+                        blob.data     = tangents;
+                    }
+                }
+            }
+
+            void QuantizePositionsUNorm16(const glm::vec3* positions, uint32_t count, const glm::vec3& min_extents, const glm::vec3& max_extents, uint16_t* quantized)
+            {
+                glm::vec3 extents = max_extents - min_extents;
+                glm::vec3 scale   = glm::vec3(extents.x > 0.0f ? 1.0f / extents.x : 0.0f, extents.y > 0.0f ? 1.0f / extents.y : 0.0f, extents.z > 0.0f ? 1.0f / extents.z : 0.0f);
+
+                for (uint32_t i = 0; i < count; i++) {
+                    glm::vec3 n          = (positions[i] - min_extents) * scale;
+                    quantized[i * 4 + 0] = static_cast<uint16_t>(meshopt_quantizeUnorm(n.x, 16));
+                    quantized[i * 4 + 1] = static_cast<uint16_t>(meshopt_quantizeUnorm(n.y, 16));
+                    quantized[i * 4 + 2] = static_cast<uint16_t>(meshopt_quantizeUnorm(n.z, 16));
+                    quantized[i * 4 + 3] = 0;
+                }
+            }
+
+            void EncodeOctahedralSNorm16(const glm::vec3* directions, uint32_t count, int16_t* encoded)
+            {
+                for (uint32_t i = 0; i < count; i++) {
+                    glm::vec3 d = directions[i];
+                    float     l = std::abs(d.x) + std::abs(d.y) + std::abs(d.z);
+                    if (l == 0.0f) {
+                        encoded[i * 2 + 0] = 0;
+                        encoded[i * 2 + 1] = 0;
+                        continue;
+                    }
+
+                    float x = d.x / l;
+                    float y = d.y / l;
+
+                    // Fold the lower hemisphere over the diagonals
+                    if (d.z < 0.0f) {
+                        float fx = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                        float fy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+                        x        = fx;
+                        y        = fy;
+                    }
+
+                    encoded[i * 2 + 0] = static_cast<int16_t>(meshopt_quantizeSnorm(x, 16));
+                    encoded[i * 2 + 1] = static_cast<int16_t>(meshopt_quantizeSnorm(y, 16));
+                }
+            }
+
+            void QuantizeUVsHalf(const glm::vec2* uvs, uint32_t count, uint16_t* quantized)
+            {
+                for (uint32_t i = 0; i < count; i++) {
+                    quantized[i * 2 + 0] = meshopt_quantizeHalf(uvs[i].x);
+                    quantized[i * 2 + 1] = meshopt_quantizeHalf(uvs[i].y);
+                }
+            }
+
+            bool QuantizeUVsUNorm16(const glm::vec2* uvs, uint32_t count, uint16_t* quantized)
+            {
+                for (uint32_t i = 0; i < count; i++) {
+                    if (uvs[i].x < 0.0f || uvs[i].x > 1.0f || uvs[i].y < 0.0f || uvs[i].y > 1.0f)
+                        return false;
+                }
+
+                for (uint32_t i = 0; i < count; i++) {
+                    quantized[i * 2 + 0] = static_cast<uint16_t>(meshopt_quantizeUnorm(uvs[i].x, 16));
+                    quantized[i * 2 + 1] = static_cast<uint16_t>(meshopt_quantizeUnorm(uvs[i].y, 16));
+                }
+                return true;
+            }
+
+            void QuantizeColorsUNorm8(const glm::vec4* colors, uint32_t count, uint8_t* quantized)
+            {
+                for (uint32_t i = 0; i < count; i++) {
+                    for (uint32_t c = 0; c < 4; c++)
+                        quantized[i * 4 + c] = static_cast<uint8_t>(meshopt_quantizeUnorm(colors[i][c], 8));
+                }
+            }
+
+            void BuildSkinStreamBlobs(const MeshImportResult& import_result, const SubMesh& submesh, ScratchArena& arena, VertexStreamBlob& indexBlob, VertexStreamBlob& weightBlob)
+            {
+                uint32_t count = submesh.vertex_count;
+
+                indexBlob.typeName = "BONE_INDEX:R16G16B16A16_UINT";
+                if (const glm::uvec4* indices = GetSubMeshStream(import_result.bone_indices, submesh)) {
+                    uint16_t* quantized = AllocateStorage<uint16_t>(indexBlob, arena, count, sizeof(uint16_t) * 4);
+                    for (uint32_t i = 0; i < count; i++) {
+                        for (uint32_t c = 0; c < 4; c++)
+                            quantized[i * 4 + c] = static_cast<uint16_t>(indices[i][c]);
+                    }
+                } else {
+                    indexBlob.stride = sizeof(uint16_t) * 4;
+                    indexBlob.data   = nullptr;
+                }
+
+                weightBlob.typeName = "BONE_WEIGHT:R8G8B8A8_UNORM";
+                if (const glm::vec4* weights = GetSubMeshStream(import_result.bone_weights, submesh))
+                    QuantizeBoneWeightsUNorm8(weights, count, AllocateStorage<uint8_t>(weightBlob, arena, count, sizeof(uint8_t) * 4));
+                else {
+                    weightBlob.stride = sizeof(uint8_t) * 4;
+                    weightBlob.data   = nullptr;
+                }
+            }
+
+            void QuantizeBoneWeightsUNorm8(const glm::vec4* weights, uint32_t count, uint8_t* quantized)
+            {
+                for (uint32_t i = 0; i < count; i++) {
+                    int32_t  sum     = 0;
+                    uint32_t biggest = 0;
+                    for (uint32_t c = 0; c < 4; c++) {
+                        quantized[i * 4 + c] = static_cast<uint8_t>(meshopt_quantizeUnorm(weights[i][c], 8));
+                        sum += quantized[i * 4 + c];
+                        if (weights[i][c] > weights[i][biggest])
+                            biggest = c;
+                    }
+
+                    // Rounding can leave the sum off by a couple of units, the skinned vertex would then scale
+                    int32_t fixed              = quantized[i * 4 + biggest] + 255 - sum;
+                    quantized[i * 4 + biggest] = static_cast<uint8_t>(fixed < 0 ? 0 : (fixed > 255 ? 255 : fixed));
+                }
+            }
+
+            glm::vec3 DecodeOctahedral(float x, float y)
+            {
+                glm::vec3 d = glm::vec3(x, y, 1.0f - std::abs(x) - std::abs(y));
+                if (d.z < 0.0f) {
+                    float fx = (1.0f - std::abs(d.y)) * (d.x >= 0.0f ? 1.0f : -1.0f);
+                    float fy = (1.0f - std::abs(d.x)) * (d.y >= 0.0f ? 1.0f : -1.0f);
+                    d.x      = fx;
+                    d.y      = fy;
+                }
+                return glm::normalize(d);
+            }
+
+            float DecodeOctahedralSign(int16_t x, int16_t y, glm::vec3& tangent)
+            {
+                tangent = DecodeOctahedral(std::max(x / 32767.0f, -1.0f), std::max(y / 32767.0f, -1.0f));
+                return (y & 1) ? -1.0f : 1.0f;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
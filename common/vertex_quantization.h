@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/intermediate_types.h"
+#include "common/scratch_arena.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            enum class PositionFormat
+            {
+                Float,  /* POSITION:R32G32B32                                                                   */
+                UNorm16 /* POSITION:R16G16B16A16_UNORM, relative to the submesh AABB: min + v * (max - min), w = 0 */
+            };
+
+            enum class NormalFormat
+            {
+                Float,        /* NORMAL/TANGENT:R32G32B32, the baseline layout, tangents have no handedness sign            */
+                Octahedral16, /* NORMAL:R16G16_SNORM_OCT, TANGENT:R16G16_SNORM_OCT_SIGN with the LSB of y set for a -1 sign */
+                FloatSigned   /* NORMAL:R32G32B32, TANGENT:R32G32B32A32 with the handedness sign in w                       */
+            };
+
+            enum class UVFormat
+            {
+                Float,  /* TEXCOORD:R32G32                                                */
+                Half,   /* TEXCOORD:R16G16_FLOAT                                          */
+                UNorm16 /* TEXCOORD:R16G16_UNORM, falls back to Half for UVs outside [0, 1] */
+            };
+
+            enum class ColorFormat
+            {
+                Float, /* COLOR:R32G32B32A32  */
+                UNorm8 /* COLOR:R8G8B8A8_UNORM */
+            };
+
+            /**
+             * Storage format of every vertex attribute blob, the chosen format is recorded in the blob typeName and stride
+             * Tangents use the normal format, the opt-in ones add the handedness sign of MeshImportResult::tangent_signs, bitangent = sign * cross(normal, tangent)
+             */
+            struct VertexFormatOptions
+            {
+                PositionFormat position = PositionFormat::Float;
+                NormalFormat   normal   = NormalFormat::Float;
+                UVFormat       uv       = UVFormat::Float;
+                ColorFormat    color    = ColorFormat::Float;
+            };
+
+            /**
+             * A vertex attribute stream of a submesh ready to be written as a blob
+             * data either points into the import result (float formats) or into storage (quantized formats), allocated from the scratch arena
+             */
+            struct VertexStreamBlob
+            {
+                std::string   typeName;
+                uint32_t      stride = 0;
+                const void*   data   = nullptr;
+                Span<uint8_t> storage;
+            };
+
+            /* Blobs in the order they are written: POSITION, COLOR, TEXCOORD, NORMAL, TANGENT */
+            using VertexStreamBlobs = std::array<VertexStreamBlob, 5>;
+
+            /* Quantized streams live in arena until the caller's ScratchScope closes */
+            void BuildVertexStreamBlobs(const MeshImportResult& import_result, const SubMesh& submesh, const VertexFormatOptions& format, ScratchArena& arena, VertexStreamBlobs& blobs);
+
+            void QuantizePositionsUNorm16(const glm::vec3* positions, uint32_t count, const glm::vec3& min_extents, const glm::vec3& max_extents, uint16_t* quantized);
+            void EncodeOctahedralSNorm16(const glm::vec3* directions, uint32_t count, int16_t* encoded);
+            void QuantizeUVsHalf(const glm::vec2* uvs, uint32_t count, uint16_t* quantized);
+            /* Returns false without writing anything if any of the UVs is outside [0, 1] */
+            bool QuantizeUVsUNorm16(const glm::vec2* uvs, uint32_t count, uint16_t* quantized);
+            void QuantizeColorsUNorm8(const glm::vec4* colors, uint32_t count, uint8_t* quantized);
+
+            /**
+             * Skinning streams of a skinned submesh: BONE_INDEX:R16G16B16A16_UINT and BONE_WEIGHT:R8G8B8A8_UNORM
+             * Both are always quantized, the importer already limits the skeleton to 16 bit bone indices
+             */
+            void BuildSkinStreamBlobs(const MeshImportResult& import_result, const SubMesh& submesh, ScratchArena& arena, VertexStreamBlob& indexBlob, VertexStreamBlob& weightBlob);
+            /* Rounded so the 4 weights of a vertex still sum up to exactly 255, the error goes to the biggest weight */
+            void QuantizeBoneWeightsUNorm8(const glm::vec4* weights, uint32_t count, uint8_t* quantized);
+
+            /* Reference decode for R16G16_SNORM_OCT, the shaders do the same */
+            glm::vec3 DecodeOctahedral(float x, float y);
+            /* Reference decode for R16G16_SNORM_OCT_SIGN, returns the handedness sign and writes the tangent direction */
+            float DecodeOctahedralSign(int16_t x, int16_t y, glm::vec3& tangent);
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,273 @@
+#include "vertex_simd.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define RAZIX_ASSET_PACKER_X86 1
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        // MSVC allows any intrinsic without changing the target of the whole translation unit
+        #define RAZIX_TARGET_AVX2
+    #else
+        #include <immintrin.h>
+        #define RAZIX_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            static_assert(sizeof(glm::vec3) == sizeof(float) * 3, "Position streams are reduced as packed floats");
+
+            //--------------------------------------------------------------------------------
+            // CPU Detection
+            //--------------------------------------------------------------------------------
+
+            static bool IsAVX2Supported()
+            {
+#if defined(RAZIX_ASSET_PACKER_X86) && defined(_MSC_VER)
+                int info[4];
+                __cpuid(info, 0);
+                if (info[0] < 7)
+                    return false;
+
+                // The OS has to save the YMM registers (OSXSAVE + XCR0) on top of the CPU supporting AVX/AVX2
+                __cpuid(info, 1);
+                bool osxsave = (info[2] & (1 << 27)) != 0;
+                bool avx     = (info[2] & (1 << 28)) != 0;
+                if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+                    return false;
+
+                __cpuidex(info, 7, 0);
+                return (info[1] & (1 << 5)) != 0;
+#elif defined(RAZIX_ASSET_PACKER_X86)
+                // Also checks the OS support
+                return __builtin_cpu_supports("avx2");
+#else
+                return false;
+#endif
+            }
+
+            SimdLevel ResolveSimdLevel(SimdLevel level)
+            {
+#if defined(RAZIX_ASSET_PACKER_X86)
+                static const bool avx2 = IsAVX2Supported();
+                if (level == SimdLevel::Auto)
+                    return avx2 ? SimdLevel::AVX2 : SimdLevel::SSE;
+                if (level == SimdLevel::AVX2 && !avx2)
+                    return SimdLevel::SSE;
+                return level;
+#else
+                return SimdLevel::Scalar;
+#endif
+            }
+
+            const char* GetSimdLevelName(SimdLevel level)
+            {
+                switch (level) {
+                    case SimdLevel::Auto: return "Auto";
+                    case SimdLevel::Scalar: return "Scalar";
+                    case SimdLevel::SSE: return "SSE";
+                    case SimdLevel::AVX2: return "AVX2";
+                }
+                return "Unknown";
+            }
+
+            //--------------------------------------------------------------------------------
+            // Bounds
+            //--------------------------------------------------------------------------------
+
+            // xyz floats are reduced as a flat stream, float i of the stream belongs to component i % 3
+            // Every vector loop consumes a multiple of 3 floats, so it's accumulators keep the same component per lane
+            static void ReduceBoundsScalar(const float* data, uint32_t floatsCount, float* mins, float* maxs)
+            {
+                for (uint32_t i = 0; i < floatsCount; i += 3) {
+                    for (uint32_t c = 0; c < 3; c++) {
+                        mins[c] = std::min(mins[c], data[i + c]);
+                        maxs[c] = std::max(maxs[c], data[i + c]);
+                    }
+                }
+            }
+
+            // Lane i of the accumulators starts from component i % 3 of the first vertex
+            static void InitBoundsLanes(const float* mins, const float* maxs, uint32_t lanesCount, float* laneMins, float* laneMaxs)
+            {
+                for (uint32_t i = 0; i < lanesCount; i++) {
+                    laneMins[i] = mins[i % 3];
+                    laneMaxs[i] = maxs[i % 3];
+                }
+            }
+
+            static void FoldBoundsLanes(const float* laneMins, const float* laneMaxs, uint32_t lanesCount, float* mins, float* maxs)
+            {
+                for (uint32_t i = 0; i < lanesCount; i++) {
+                    mins[i % 3] = std::min(mins[i % 3], laneMins[i]);
+                    maxs[i % 3] = std::max(maxs[i % 3], laneMaxs[i]);
+                }
+            }
+
+#if defined(RAZIX_ASSET_PACKER_X86)
+            // 4 vertices (12 floats, 3 registers) per iteration
+            static uint32_t ReduceBoundsSSE(const float* data, uint32_t floatsCount, float* mins, float* maxs)
+            {
+                alignas(16) float laneMins[12], laneMaxs[12];
+                InitBoundsLanes(mins, maxs, 12, laneMins, laneMaxs);
+
+                __m128 min0 = _mm_load_ps(laneMins), min1 = _mm_load_ps(laneMins + 4), min2 = _mm_load_ps(laneMins + 8);
+                __m128 max0 = _mm_load_ps(laneMaxs), max1 = _mm_load_ps(laneMaxs + 4), max2 = _mm_load_ps(laneMaxs + 8);
+
+                uint32_t i = 0;
+                for (; i + 12 <= floatsCount; i += 12) {
+                    __m128 a = _mm_loadu_ps(data + i);
+                    __m128 b = _mm_loadu_ps(data + i + 4);
+                    __m128 c = _mm_loadu_ps(data + i + 8);
+                    min0     = _mm_min_ps(min0, a);
+                    min1     = _mm_min_ps(min1, b);
+                    min2     = _mm_min_ps(min2, c);
+                    max0     = _mm_max_ps(max0, a);
+                    max1     = _mm_max_ps(max1, b);
+                    max2     = _mm_max_ps(max2, c);
+                }
+
+                _mm_store_ps(laneMins, min0);
+                _mm_store_ps(laneMins + 4, min1);
+                _mm_store_ps(laneMins + 8, min2);
+                _mm_store_ps(laneMaxs, max0);
+                _mm_store_ps(laneMaxs + 4, max1);
+                _mm_store_ps(laneMaxs + 8, max2);
+                FoldBoundsLanes(laneMins, laneMaxs, 12, mins, maxs);
+                return i;
+            }
+
+            // 8 vertices (24 floats, 3 registers) per iteration
+            RAZIX_TARGET_AVX2 static uint32_t ReduceBoundsAVX2(const float* data, uint32_t floatsCount, float* mins, float* maxs)
+            {
+                alignas(32) float laneMins[24], laneMaxs[24];
+                InitBoundsLanes(mins, maxs, 24, laneMins, laneMaxs);
+
+                __m256 min0 = _mm256_load_ps(laneMins), min1 = _mm256_load_ps(laneMins + 8), min2 = _mm256_load_ps(laneMins + 16);
+                __m256 max0 = _mm256_load_ps(laneMaxs), max1 = _mm256_load_ps(laneMaxs + 8), max2 = _mm256_load_ps(laneMaxs + 16);
+
+                uint32_t i = 0;
+                for (; i + 24 <= floatsCount; i += 24) {
+                    __m256 a = _mm256_loadu_ps(data + i);
+                    __m256 b = _mm256_loadu_ps(data + i + 8);
+                    __m256 c = _mm256_loadu_ps(data + i + 16);
+                    min0     = _mm256_min_ps(min0, a);
+                    min1     = _mm256_min_ps(min1, b);
+                    min2     = _mm256_min_ps(min2, c);
+                    max0     = _mm256_max_ps(max0, a);
+                    max1     = _mm256_max_ps(max1, b);
+                    max2     = _mm256_max_ps(max2, c);
+                }
+
+                _mm256_store_ps(laneMins, min0);
+                _mm256_store_ps(laneMins + 8, min1);
+                _mm256_store_ps(laneMins + 16, min2);
+                _mm256_store_ps(laneMaxs, max0);
+                _mm256_store_ps(laneMaxs + 8, max1);
+                _mm256_store_ps(laneMaxs + 16, max2);
+                FoldBoundsLanes(laneMins, laneMaxs, 24, mins, maxs);
+                return i;
+            }
+#endif
+
+            void ComputeBounds(const glm::vec3* positions, uint32_t count, glm::vec3& min_extents, glm::vec3& max_extents, SimdLevel level)
+            {
+                if (count == 0) {
+                    min_extents = glm::vec3(0.0f);
+                    max_extents = glm::vec3(0.0f);
+                    return;
+                }
+
+                const float* data        = &positions[0].x;
+                uint32_t     floatsCount = count * 3;
+
+                // Start from the first vertex, so the accumulators never leak infinities into the extents
+                float    mins[3] = {data[0], data[1], data[2]};
+                float    maxs[3] = {data[0], data[1], data[2]};
+                uint32_t done    = 0;
+
+                level = ResolveSimdLevel(level);
+#if defined(RAZIX_ASSET_PACKER_X86)
+                if (level == SimdLevel::AVX2)
+                    done = ReduceBoundsAVX2(data, floatsCount, mins, maxs);
+                else if (level == SimdLevel::SSE)
+                    done = ReduceBoundsSSE(data, floatsCount, mins, maxs);
+#endif
+                ReduceBoundsScalar(data + done, floatsCount - done, mins, maxs);
+
+                min_extents = glm::vec3(mins[0], mins[1], mins[2]);
+                max_extents = glm::vec3(maxs[0], maxs[1], maxs[2]);
+            }
+
+            //--------------------------------------------------------------------------------
+            // Tangent Handedness
+            //--------------------------------------------------------------------------------
+
+            static void ComputeTangentSignsScalar(const glm::vec3* normals, const glm::vec3* bitangents, const glm::vec3* tangents, float* signs, uint32_t count)
+            {
+                for (uint32_t i = 0; i < count; i++)
+                    signs[i] = glm::dot(glm::cross(normals[i], tangents[i]), bitangents[i]) < 0.0f ? -1.0f : 1.0f;
+            }
+
+#if defined(RAZIX_ASSET_PACKER_X86)
+            // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3 -> x = x0 x1 x2 x3, y = y0 y1 y2 y3, z = z0 z1 z2 z3
+            static inline void TransposeToSoA(__m128 a, __m128 b, __m128 c, __m128& x, __m128& y, __m128& z)
+            {
+                __m128 xy23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2)); /* x2 y2 x3 y3 */
+                __m128 yz01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1)); /* y0 z0 y1 z1 */
+                x           = _mm_shuffle_ps(a, xy23, _MM_SHUFFLE(2, 0, 3, 0));
+                y           = _mm_shuffle_ps(yz01, xy23, _MM_SHUFFLE(3, 1, 2, 0));
+                z           = _mm_shuffle_ps(yz01, c, _MM_SHUFFLE(3, 0, 3, 1));
+            }
+
+            // The 3 loads per stream are memory bound already, so there is no separate AVX2 path
+            static uint32_t ComputeTangentSignsSSE(const glm::vec3* normals, const glm::vec3* bitangents, const glm::vec3* tangents, float* signs, uint32_t count)
+            {
+                const float* n = &normals[0].x;
+                const float* b = &bitangents[0].x;
+                const float* t = &tangents[0].x;
+
+                const __m128 zero     = _mm_setzero_ps();
+                const __m128 one      = _mm_set1_ps(1.0f);
+                const __m128 signMask = _mm_set1_ps(-0.0f);
+
+                uint32_t i = 0;
+                for (; i + 4 <= count; i += 4) {
+                    const uint32_t offset = i * 3;
+
+                    __m128 nx, ny, nz, tx, ty, tz, bx, by, bz;
+                    TransposeToSoA(_mm_loadu_ps(n + offset), _mm_loadu_ps(n + offset + 4), _mm_loadu_ps(n + offset + 8), nx, ny, nz);
+                    TransposeToSoA(_mm_loadu_ps(t + offset), _mm_loadu_ps(t + offset + 4), _mm_loadu_ps(t + offset + 8), tx, ty, tz);
+                    TransposeToSoA(_mm_loadu_ps(b + offset), _mm_loadu_ps(b + offset + 4), _mm_loadu_ps(b + offset + 8), bx, by, bz);
+
+                    // dot(cross(n, t), b) in the same order as glm
+                    __m128 cx  = _mm_sub_ps(_mm_mul_ps(ny, tz), _mm_mul_ps(ty, nz));
+                    __m128 cy  = _mm_sub_ps(_mm_mul_ps(nz, tx), _mm_mul_ps(tz, nx));
+                    __m128 cz  = _mm_sub_ps(_mm_mul_ps(nx, ty), _mm_mul_ps(tx, ny));
+                    __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, bx), _mm_mul_ps(cy, by)), _mm_mul_ps(cz, bz));
+
+                    // The sign bit of the left handed frames on 1.0 gives -1.0, the signs are already one per lane
+                    __m128 sign = _mm_and_ps(_mm_cmplt_ps(dot, zero), signMask);
+                    _mm_storeu_ps(signs + i, _mm_or_ps(one, sign));
+                }
+                return i;
+            }
+#endif
+
+            void ComputeTangentSigns(const glm::vec3* normals, const glm::vec3* bitangents, const glm::vec3* tangents, float* signs, uint32_t count, SimdLevel level)
+            {
+                uint32_t done = 0;
+
+                level = ResolveSimdLevel(level);
+#if defined(RAZIX_ASSET_PACKER_X86)
+                if (level != SimdLevel::Scalar)
+                    done = ComputeTangentSignsSSE(normals, bitangents, tangents, signs, count);
+#endif
+                ComputeTangentSignsScalar(normals + done, bitangents + done, tangents + done, signs + done, count - done);
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            enum class SimdLevel
+            {
+                Auto,   /* Best level supported by the CPU, detected once at runtime */
+                Scalar, /* Portable fallback, also used on non x86 targets          */
+                SSE,    /* SSE2, the x64 baseline                                   */
+                AVX2    /* Only when the CPU and the OS support it                  */
+            };
+
+            /* Resolves SimdLevel::Auto, anything the CPU doesn't support is clamped down */
+            SimdLevel   ResolveSimdLevel(SimdLevel level = SimdLevel::Auto);
+            const char* GetSimdLevelName(SimdLevel level);
+
+            /**
+             * AABB of a position stream, with a zero sized box at the origin for an empty stream
+             * The packed xyz floats are reduced as a flat stream, so no shuffles are needed in the loop
+             */
+            void ComputeBounds(const glm::vec3* positions, uint32_t count, glm::vec3& min_extents, glm::vec3& max_extents, SimdLevel level = SimdLevel::Auto);
+
+            /**
+             * Handedness of every tangent frame, -1 when dot(cross(n, t), b) < 0 and +1 otherwise, the tangents are left as they are
+             * Vectorized 4 vertices at a time, the packed xyz streams are transposed to SoA in registers
+             */
+            void ComputeTangentSigns(const glm::vec3* normals, const glm::vec3* bitangents, const glm::vec3* tangents, float* signs, uint32_t count, SimdLevel level = SimdLevel::Auto);
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,136 @@
+#include "AnimationExporter.h"
+
+#include "common/log.h"
+#include "common/rzanim_format.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            // Assimp names clips after their take ("Armature|Walk"), keep them usable as file names
+            static std::string SanitizeFileName(const std::string& name)
+            {
+                std::string result = name;
+                for (char& c: result) {
+                    if (c == '/' || c == '\\' || c == ':' || c == '*' || c == '?' || c == '"' || c == '<' || c == '>' || c == '|')
+                        c = '_';
+                }
+                return result;
+            }
+
+            bool AnimationExporter::exportAnimations(const MeshImportResult& model, const std::vector<CompressedAnimationClip>& clips, const std::string& assetsOutputDirectory)
+            {
+                m_BytesWritten = 0;
+                m_OutputFiles.clear();
+
+                if (model.skeleton.bones.empty())
+                    return true;
+
+                std::string animations_path = assetsOutputDirectory + "Cache/Animations/" + model.name + "/";
+                std::filesystem::create_directories(animations_path);
+
+                if (!exportSkeleton(model.skeleton, animations_path + model.name + ".rzskel"))
+                    return false;
+
+                // Takes often share a name or have none, the clip index keeps every file apart
+                uint32_t                        bone_count = static_cast<uint32_t>(model.skeleton.bones.size());
+                std::unordered_set<std::string> clip_names;
+                for (size_t i = 0; i < clips.size(); i++) {
+                    std::string clip_name = SanitizeFileName(clips[i].name);
+                    if (clip_name.empty())
+                        clip_name = "clip_" + std::to_string(i);
+                    else if (clip_names.count(clip_name))
+                        clip_name += "_" + std::to_string(i);
+                    clip_names.insert(clip_name);
+
+                    if (!exportClip(clips[i], bone_count, animations_path + clip_name + ".rzanim"))
+                        return false;
+                }
+                return true;
+            }
+
+            bool AnimationExporter::exportSkeleton(const Skeleton& skeleton, const std::string& skeleton_path)
+            {
+                std::vector<BINSkeletonBone> bones(skeleton.bones.size());
+                std::vector<char>            strings;
+                for (size_t i = 0; i < skeleton.bones.size(); i++) {
+                    const Bone& bone  = skeleton.bones[i];
+                    auto&       entry = bones[i];
+
+                    entry.name_offset = static_cast<uint32_t>(strings.size());
+                    strings.insert(strings.end(), bone.name.begin(), bone.name.end());
+                    strings.push_back('\0');
+
+                    entry.parent = bone.parent;
+                    memcpy(entry.translation, &bone.translation.x, sizeof(float) * 3);
+                    entry.rotation[0] = bone.rotation.x;
+                    entry.rotation[1] = bone.rotation.y;
+                    entry.rotation[2] = bone.rotation.z;
+                    entry.rotation[3] = bone.rotation.w;
+                    memcpy(entry.scale, &bone.scale.x, sizeof(float) * 3);
+                    for (uint32_t column = 0; column < 4; column++) {
+                        for (uint32_t row = 0; row < 4; row++)
+                            entry.inverse_bind[column * 4 + row] = bone.inverseBind[column][row];
+                    }
+                }
+
+                BINSkeletonHeader header{};
+                header.bone_count        = static_cast<uint32_t>(bones.size());
+                header.string_table_size = static_cast<uint32_t>(strings.size());
+
+                std::ofstream f(skeleton_path, std::ios::out | std::ios::binary);
+                if (!f.is_open()) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to open : " << skeleton_path);
+                    return false;
+                }
+
+                f.write((const char*) &header, sizeof(BINSkeletonHeader));
+                f.write((const char*) bones.data(), sizeof(BINSkeletonBone) * bones.size());
+                f.write(strings.data(), strings.size());
+                if (!f.good())
+                    return false;
+
+                m_BytesWritten += sizeof(BINSkeletonHeader) + sizeof(BINSkeletonBone) * bones.size() + strings.size();
+                m_OutputFiles.push_back(std::filesystem::path(skeleton_path).lexically_normal().generic_string());
+                return true;
+            }
+
+            bool AnimationExporter::exportClip(const CompressedAnimationClip& clip, uint32_t bone_count, const std::string& clip_path)
+            {
+                BINAnimHeader header{};
+                strncpy(header.name, clip.name.c_str(), sizeof(header.name) - 1);
+                header.duration    = clip.duration;
+                header.bone_count  = bone_count;
+                header.track_count = static_cast<uint32_t>(clip.tracks.size());
+                header.data_size   = static_cast<uint32_t>(clip.data.size() * sizeof(uint16_t));
+
+                std::ofstream f(clip_path, std::ios::out | std::ios::binary);
+                if (!f.is_open()) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to open : " << clip_path);
+                    return false;
+                }
+
+                f.write((const char*) &header, sizeof(BINAnimHeader));
+                f.write((const char*) clip.tracks.data(), sizeof(BINAnimTrack) * clip.tracks.size());
+                f.write((const char*) clip.data.data(), header.data_size);
+                if (!f.good())
+                    return false;
+
+                uint64_t size = sizeof(BINAnimHeader) + sizeof(BINAnimTrack) * clip.tracks.size() + header.data_size;
+                m_BytesWritten += size;
+                m_OutputFiles.push_back(std::filesystem::path(clip_path).lexically_normal().generic_string());
+
+                double ratio = size > 0 ? static_cast<double>(clip.rawSize) / static_cast<double>(size) : 0.0;
+                RAZIX_PACKER_LOG_INFO("Exported Animation : " << clip.name << ", " << clip.duration << " s, " << clip.tracks.size() << " tracks, " << clip.rawKeys << " -> " << clip.keys << " keys, " << clip.rawSize << " -> " << size << " bytes (" << ratio << "x), max error "
+                                      << clip.maxPositionError << " position, " << clip.maxRotationError << " deg rotation, " << clip.maxScaleError << " scale");
+                return true;
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "common/intermediate_types.h"
+#include "processor/AnimationCompressor.h"
+
+#include <string>
+#include <vector>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Writes the skeleton of a model to a .rzskel and every compressed clip to it's own .rzanim, see common/rzanim_format.h
+             * Files go to <assetsOutputDirectory>/Cache/Animations/<model>/, clips are named after the clip with the characters that
+             * can't be in a file name replaced
+             */
+            class AnimationExporter
+            {
+            public:
+                AnimationExporter()  = default;
+                ~AnimationExporter() = default;
+
+                bool exportAnimations(const MeshImportResult& model, const std::vector<CompressedAnimationClip>& clips, const std::string& assetsOutputDirectory);
+
+                /* Total bytes written by the last exportAnimations call */
+                uint64_t getBytesWritten() const { return m_BytesWritten; }
+                /* Every .rzskel/.rzanim file written by the last exportAnimations call, recorded by the build cache */
+                const std::vector<std::string>& getOutputFiles() const { return m_OutputFiles; }
+
+            private:
+                bool exportSkeleton(const Skeleton& skeleton, const std::string& skeleton_path);
+                bool exportClip(const CompressedAnimationClip& clip, uint32_t bone_count, const std::string& clip_path);
+
+            private:
+                uint64_t                 m_BytesWritten = 0;
+                std::vector<std::string> m_OutputFiles;
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,35 @@
+#include "GeometryRegistry.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            bool GeometryRegistry::claim(uint64_t key, uint64_t streamBytes)
+            {
+                bool claimed = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    claimed = m_Keys.insert(key).second;
+                }
+
+                if (claimed)
+                    m_Unique++;
+                else {
+                    m_References++;
+                    m_SavedBytes += streamBytes;
+                }
+                return claimed;
+            }
+
+            void GeometryRegistry::clear()
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Keys.clear();
+                m_Unique     = 0;
+                m_References = 0;
+                m_SavedBytes = 0;
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Content addressed submesh geometry, shared by every model of a batch (see MeshExportOptions::deduplicate)
+             *
+             * A submesh is keyed by the hash of everything that ends up in the blobs of it's .rzmesh, the first exporter to claim a
+             * key writes the file and every other submesh with the same key only references it from it's .rzmodel. Thread safe, the
+             * models and their submeshes are exported in parallel
+             */
+            class GeometryRegistry
+            {
+            public:
+                GeometryRegistry()  = default;
+                ~GeometryRegistry() = default;
+
+                /* True for the first claim of key, that caller writes the file. streamBytes is the size of the raw streams of the submesh */
+                bool claim(uint64_t key, uint64_t streamBytes);
+                /* Forgets every key, so the next batch writes the files again */
+                void clear();
+
+                uint32_t getUniqueCount() const { return m_Unique; }
+                /* Submeshes that referenced geometry claimed before them */
+                uint32_t getReferenceCount() const { return m_References; }
+                /* Raw stream bytes of the referencing submeshes, what would have been written again without deduplication */
+                uint64_t getSavedBytes() const { return m_SavedBytes; }
+
+            private:
+                std::mutex                   m_Mutex;
+                std::unordered_set<uint64_t> m_Keys;
+                std::atomic<uint32_t>        m_Unique     = 0;
+                std::atomic<uint32_t>        m_References = 0;
+                std::atomic<uint64_t>        m_SavedBytes = 0;
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -1,9 +1,26 @@
 #include "MeshExporter.h"
 
+#include "common/blob_codec.h"
+#include "common/content_hash.h"
+#include "common/job_system.h"
+#include "common/log.h"
+#include "common/profiler.h"
+#include "common/rzmesh_format.h"
+#include "common/rzmodel_format.h"
+#include "common/rzpack_format.h"
+#include "common/scratch_arena.h"
+#include "common/span.h"
+#include "common/vertex_quantization.h"
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
-#include <iostream>
+#include <unordered_map>
 
 #include "Razix/AssetSystem/RZAssetFileSpec.h"
 
@@ -16,228 +33,1078 @@
 using namespace Razix::AssetSystem;
 
 #define WRITE_AND_OFFSET(stream, dest, size, offset) \
-    stream.write((char*) dest, size);                \
-    offset += size;                                  \
-    stream.seekg(offset);
+    do {                                             \
+        stream.write((char*) dest, size);            \
+        offset += size;                              \
+        stream.seekg(offset);                        \
+    } while (0)
 
 namespace Razix {
     namespace Tool {
         namespace AssetPacker {
 
+            static_assert(MESH_HIERARCHY_NO_PARENT == RAZIX_PACK_NULL_NODE && MESH_HIERARCHY_NO_PARENT == RAZIX_MODEL_NULL_NODE, "Node parents are exported as is");
+
+            // Cache line, every pair of sibling BVH nodes fills one
+            static constexpr uint32_t kBVHNodeAlignment = 64;
+
+            static uint64_t AlignUp(uint64_t offset, uint64_t alignment)
+            {
+                return (offset + alignment - 1) & ~(alignment - 1);
+            }
+
+            // Converts a range of meshlets to the file structs, offsets are made relative to the first meshlet
+            static void BuildMeshletTables(const MeshImportResult& import_result, uint32_t meshlet_offset, uint32_t meshlet_count, Span<BINMeshlet> descs, Span<BINMeshletBounds> bounds)
+            {
+                const Meshlet& first = import_result.meshlets[meshlet_offset];
+
+                for (uint32_t i = 0; i < meshlet_count; i++) {
+                    const Meshlet& meshlet = import_result.meshlets[meshlet_offset + i];
+
+                    descs[i].vertex_offset   = meshlet.vertex_offset - first.vertex_offset;
+                    descs[i].triangle_offset = meshlet.triangle_offset - first.triangle_offset;
+                    descs[i].vertex_count    = meshlet.vertex_count;
+                    descs[i].triangle_count  = meshlet.triangle_count;
+
+                    memcpy(bounds[i].center, &meshlet.center.x, sizeof(float) * 3);
+                    bounds[i].radius = meshlet.radius;
+                    memcpy(bounds[i].cone_apex, &meshlet.cone_apex.x, sizeof(float) * 3);
+                    bounds[i].cone_cutoff = meshlet.cone_cutoff;
+                    memcpy(bounds[i].cone_axis, &meshlet.cone_axis.x, sizeof(float) * 3);
+                }
+            }
+
+            // Converts a range of BVH nodes to the file structs, the child and triangle offsets are already relative to their submesh
+            static void BuildBVHNodes(const MeshImportResult& import_result, uint32_t bvh_offset, uint32_t node_count, Span<BINMeshBVHNode> nodes)
+            {
+                for (uint32_t i = 0; i < node_count; i++) {
+                    const BVHNode& node = import_result.bvh_nodes[bvh_offset + i];
+
+                    memcpy(nodes[i].min_extents, &node.min_extents.x, sizeof(float) * 3);
+                    nodes[i].first = node.first;
+                    memcpy(nodes[i].max_extents, &node.max_extents.x, sizeof(float) * 3);
+                    nodes[i].triangle_count = node.triangle_count;
+                }
+            }
+
+            // Raw blobs are not copied, the payload is then the source data instead of encoded
+            static bool EncodeBlobPayload(const void* data, uint32_t count, uint32_t stride, uint32_t encodingFlags, std::vector<uint8_t>& encoded, BINBlobEncoding& encoding)
+            {
+                if (encodingFlags != BLOB_ENCODING_RAW && data)
+                    return EncodeBlob(data, count, stride, encodingFlags, encoded, encoding);
+
+                encoding               = {};
+                encoding.element_count = data ? count : 0;
+                encoding.decoded_size  = encoding.element_count * stride;
+                encoding.codec_size    = encoding.decoded_size;
+                encoding.encoded_size  = encoding.decoded_size;
+                return true;
+            }
+
+            // Submesh names come from the source and are often repeated (ex. material splits), only the index is unique
+            static std::string GetSubMeshFileName(const std::string& model_name, uint32_t submesh_index)
+            {
+                return model_name + "_" + std::to_string(submesh_index) + ".rzmesh";
+            }
+
+            static uint32_t AddString(std::vector<char>& strings, const std::string& str)
+            {
+                uint32_t offset = static_cast<uint32_t>(strings.size());
+                strings.insert(strings.end(), str.begin(), str.end());
+                strings.push_back('\0');
+                return offset;
+            }
+
+            // The hierarchy is depth first already, only the names move to the string table of the file
+            static void BuildNodeTable(const MeshHierarchy& hierarchy, std::vector<BINPackNode>& nodes, std::vector<char>& strings)
+            {
+                nodes.resize(hierarchy.size());
+                for (uint32_t i = 0; i < hierarchy.size(); i++) {
+                    auto& node       = nodes[i];
+                    node.name_offset = AddString(strings, hierarchy.getName(i));
+                    node.parent      = hierarchy.parents[i];
+                    node.mesh_offset = hierarchy.meshOffsets[i];
+                    node.mesh_count  = hierarchy.meshCounts[i];
+                    memcpy(node.translation, &hierarchy.translations[i].x, sizeof(float) * 3);
+                    node.rotation[0] = hierarchy.rotations[i].x;
+                    node.rotation[1] = hierarchy.rotations[i].y;
+                    node.rotation[2] = hierarchy.rotations[i].z;
+                    node.rotation[3] = hierarchy.rotations[i].w;
+                    memcpy(node.scale, &hierarchy.scales[i].x, sizeof(float) * 3);
+                }
+            }
+
+            // Same order as BINMaterialTexture
+            static void GetMaterialTextures(const Graphics::MaterialData& material, const char* (&textures)[MATERIAL_TEXTURE_COUNT])
+            {
+                const auto& paths = material.m_MaterialTexturePaths;
+                const char* all[MATERIAL_TEXTURE_COUNT] = {paths.albedo, paths.normal, paths.metallic, paths.roughness, paths.specular, paths.emissive, paths.ao, paths.metallicRoughnessAO};
+                std::copy(all, all + MATERIAL_TEXTURE_COUNT, textures);
+            }
+
+            // Everything that goes to the library entry but the name
+            static bool IsSameLibraryMaterial(const Graphics::MaterialData& a, const Graphics::MaterialData& b)
+            {
+                const auto& propertiesA = a.m_MaterialProperties;
+                const auto& propertiesB = b.m_MaterialProperties;
+                if (propertiesA.workflow != propertiesB.workflow || propertiesA.albedoColor != propertiesB.albedoColor || propertiesA.roughnessColor != propertiesB.roughnessColor || propertiesA.metallicColor != propertiesB.metallicColor)
+                    return false;
+
+                const char* texturesA[MATERIAL_TEXTURE_COUNT];
+                const char* texturesB[MATERIAL_TEXTURE_COUNT];
+                GetMaterialTextures(a, texturesA);
+                GetMaterialTextures(b, texturesB);
+                for (uint32_t t = 0; t < MATERIAL_TEXTURE_COUNT; t++) {
+                    if (strcmp(texturesA[t], texturesB[t]) != 0)
+                        return false;
+                }
+                return true;
+            }
+
+            // Materials are deduplicated on everything but their name, a texture path used by several of them is stored once
+            static void BuildMaterialLibrary(const std::vector<Graphics::MaterialData>& materials, MaterialLibrary& library)
+            {
+                std::unordered_map<std::string, uint32_t> stringOffsets;
+                auto                                      addString = [&](const char* str) {
+                    auto it = stringOffsets.find(str);
+                    if (it != stringOffsets.end())
+                        return it->second;
+                    uint32_t offset = AddString(library.strings, str);
+                    stringOffsets.emplace(str, offset);
+                    return offset;
+                };
+
+                std::unordered_map<uint64_t, uint32_t> entries;
+                library.indices.resize(materials.size());
+                for (uint32_t i = 0; i < static_cast<uint32_t>(materials.size()); i++) {
+                    const auto& material   = materials[i];
+                    const auto& properties = material.m_MaterialProperties;
+
+                    const char* textures[MATERIAL_TEXTURE_COUNT];
+                    GetMaterialTextures(material, textures);
+
+                    BINMaterial entry{};
+                    entry.workflow = static_cast<uint32_t>(properties.workflow);
+                    memcpy(entry.albedo_color, &properties.albedoColor.x, sizeof(float) * 4);
+                    entry.roughness = properties.roughnessColor;
+                    entry.metallic  = properties.metallicColor;
+
+                    // Hashed before the string offsets are set, the texture paths are hashed by value instead
+                    uint64_t key = HashBytes(&entry, sizeof(BINMaterial));
+                    for (uint32_t t = 0; t < MATERIAL_TEXTURE_COUNT; t++)
+                        key = HashCombine(key, HashString(textures[t]));
+
+                    // A hit is only a match if the materials are equal, a colliding one probes the next key
+                    auto it = entries.find(key);
+                    while (it != entries.end() && !IsSameLibraryMaterial(material, materials[library.firsts[it->second]])) {
+                        key = HashCombine(key, 1);
+                        it  = entries.find(key);
+                    }
+                    if (it != entries.end()) {
+                        library.indices[i] = it->second;
+                        continue;
+                    }
+
+                    library.indices[i] = static_cast<uint32_t>(library.materials.size());
+                    entries.emplace(key, library.indices[i]);
+
+                    entry.name_offset = addString(material.m_Name);
+                    for (uint32_t t = 0; t < MATERIAL_TEXTURE_COUNT; t++)
+                        entry.textures[t] = textures[t][0] ? addString(textures[t]) : RAZIX_MATERIAL_NO_TEXTURE;
+
+                    library.materials.push_back(entry);
+                    library.firsts.push_back(i);
+                }
+            }
+
+            // A range of a stream, streams that don't cover it (ex. a model without skinning) hash as empty
+            template<typename T>
+            static uint64_t HashStreamRange(uint64_t hash, const std::vector<T>& stream, uint32_t offset, uint32_t count, uint64_t& streamBytes)
+            {
+                if (stream.size() < size_t(offset) + count)
+                    return HashCombine(hash, 0);
+
+                streamBytes += sizeof(T) * count;
+                return HashBytes(stream.data() + offset, sizeof(T) * count, hash);
+            }
+
+            uint64_t MeshExporter::HashSubMeshGeometry(const MeshImportResult& import_result, const SubMesh& submesh, const MeshExportOptions& options, uint64_t& streamBytes)
+            {
+                streamBytes = 0;
+
+                // How the blobs are stored, the same geometry exported with other formats or codecs is another file
+                uint64_t hash = HashCombine(0, (uint64_t(options.vertexFormat.position) << 24) | (uint64_t(options.vertexFormat.normal) << 16) | (uint64_t(options.vertexFormat.uv) << 8) | uint64_t(options.vertexFormat.color));
+                hash          = HashCombine(hash, (uint64_t(import_result.encodeVertices) << 2) | (uint64_t(import_result.encodeIndices) << 1) | uint64_t(options.useCompression));
+                hash          = HashCombine(hash, options.blobAlignment);
+                hash          = HashCombine(hash, (uint64_t(submesh.index_count) << 32) | submesh.vertex_count);
+
+                // The processor reorders and compacts the streams deterministically, so equal source geometry is bit identical here
+                const auto& vertices = import_result.vertices;
+                hash                 = HashStreamRange(hash, import_result.indices, submesh.base_index, submesh.index_count, streamBytes);
+                hash                 = HashStreamRange(hash, vertices.Position, submesh.base_vertex, submesh.vertex_count, streamBytes);
+                hash                 = HashStreamRange(hash, vertices.Color, submesh.base_vertex, submesh.vertex_count, streamBytes);
+                hash                 = HashStreamRange(hash, vertices.UV, submesh.base_vertex, submesh.vertex_count, streamBytes);
+                hash                 = HashStreamRange(hash, vertices.Normal, submesh.base_vertex, submesh.vertex_count, streamBytes);
+                hash                 = HashStreamRange(hash, vertices.Tangent, submesh.base_vertex, submesh.vertex_count, streamBytes);
+                hash                 = HashStreamRange(hash, import_result.tangent_signs, submesh.base_vertex, submesh.vertex_count, streamBytes);
+                if (submesh.skinned) {
+                    hash = HashStreamRange(hash, import_result.bone_indices, submesh.base_vertex, submesh.vertex_count, streamBytes);
+                    hash = HashStreamRange(hash, import_result.bone_weights, submesh.base_vertex, submesh.vertex_count, streamBytes);
+                }
+
+                hash = HashCombine(hash, (uint64_t(submesh.lod_count) << 32) | submesh.meshlet_count);
+                hash = HashCombine(hash, submesh.bvh_node_count);
+                for (uint32_t i = 0; i < submesh.lod_count; i++) {
+                    const auto& lod = import_result.lods[submesh.lod_offset + i];
+                    hash            = HashCombine(hash, lod.index_count);
+                    hash            = HashBytes(&lod.error, sizeof(lod.error), hash);
+                    hash            = HashStreamRange(hash, import_result.lod_indices, lod.base_index, lod.index_count, streamBytes);
+                }
+
+                // Meshlet offsets are rebased in the file, only the counts and what they point to matter. Bounds derive from the streams
+                for (uint32_t i = 0; i < submesh.meshlet_count; i++) {
+                    const auto& meshlet = import_result.meshlets[submesh.meshlet_offset + i];
+                    hash                = HashCombine(hash, (uint64_t(meshlet.vertex_count) << 32) | meshlet.triangle_count);
+                    hash                = HashStreamRange(hash, import_result.meshlet_vertices, meshlet.vertex_offset, meshlet.vertex_count, streamBytes);
+                    hash                = HashStreamRange(hash, import_result.meshlet_triangles, meshlet.triangle_offset, meshlet.triangle_count * 3, streamBytes);
+                }
+
+                // BVH nodes index their own submesh BVH, they are written as they are
+                if (submesh.bvh_node_count > 0) {
+                    hash = HashStreamRange(hash, import_result.bvh_nodes, submesh.bvh_offset, submesh.bvh_node_count, streamBytes);
+                    hash = HashStreamRange(hash, import_result.bvh_indices, submesh.base_index, submesh.index_count, streamBytes);
+                }
+                return hash;
+            }
+
             bool MeshExporter::exportMesh(const MeshImportResult& import_result, const MeshExportOptions& options)
             {
-                auto start = std::chrono::high_resolution_clock::now();
+                if (!beginExport(import_result, options))
+                    return false;
+
+                // The materials are final here, the .rzpack and the .rzmatlib share the library
+                MaterialLibrary library;
+                {
+                    RAZIX_PACKER_PROFILE_ZONE("Build Material Library");
+                    BuildMaterialLibrary(import_result.materials, library);
+                }
+
+                std::atomic<bool> success = true;
+                if (options.packModel) {
+                    std::string pack_path = options.assetsOutputDirectory + "/Cache/Meshes/" + import_result.name + ".rzpack";
+                    success               = exportPackedModel(import_result, library, pack_path, options);
+                } else {
+                    // Every submesh goes to it's own file, so they can be written in parallel
+                    uint32_t submeshesCount = static_cast<uint32_t>(import_result.submeshes.size());
+                    uint32_t materialsCount = static_cast<uint32_t>(import_result.materials.size());
+                    auto     exportSubMeshJob = [&](uint32_t i) {
+                        RAZIX_PACKER_PROFILE_ZONE("Export Submesh");
+                        if (!exportSubMesh(import_result, import_result.submeshes[i], i, m_MeshPath, options, submeshesCount, materialsCount))
+                            success = false;
+                    };
+
+                    if (options.jobSystem)
+                        options.jobSystem->parallelFor(submeshesCount, exportSubMeshJob);
+                    else {
+                        for (uint32_t i = 0; i < submeshesCount; i++)
+                            exportSubMeshJob(i);
+                    }
+                }
+
+                if (!success)
+                    return false;
+
+                return endExport(import_result, library);
+            }
+
+            bool MeshExporter::beginExport(const MeshImportResult& model, const MeshExportOptions& options)
+            {
+                m_ExportStart     = std::chrono::high_resolution_clock::now();
+                m_BytesWritten    = 0;
+                m_BlobBytesRaw    = 0;
+                m_BlobBytesStored = 0;
+                m_OutputFiles.clear();
+                m_SharedSubMeshPaths.clear();
+                m_ReferencedSubMeshes = 0;
+                m_LocalGeometry.clear();
+
+                if (options.blobAlignment & (options.blobAlignment - 1)) {
+                    RAZIX_PACKER_LOG_ERROR("Blob alignment must be a power of 2 : " << options.blobAlignment);
+                    return false;
+                }
 
                 // Create a directory in the name of the model scene
 
-                std::string materials_path = options.assetsOutputDirectory + "Materials/" + import_result.name + "/";
-                std::filesystem::create_directory(materials_path);
-                std::string mesh_path = options.assetsOutputDirectory + "/Cache/Meshes/" + import_result.name + "/";
-                std::filesystem::create_directory(mesh_path);
+                m_MaterialLibraryPath = options.assetsOutputDirectory + "Materials/" + model.name + ".rzmatlib";
+                m_MaterialsPath       = options.assetsOutputDirectory + "Materials/" + model.name + "/";
+                m_MaterialJSON        = options.materialJSON;
+                std::filesystem::create_directories(m_MaterialJSON ? m_MaterialsPath : options.assetsOutputDirectory + "Materials/");
 
-                for (size_t i = 0; i < import_result.submeshes.size(); i++) {
-                    const auto submesh = import_result.submeshes[i];
+                m_MeshPath = options.assetsOutputDirectory + "/Cache/Meshes/" + model.name + "/";
+                if (!options.packModel)
+                    std::filesystem::create_directory(m_MeshPath);
 
-                    std::string export_path = mesh_path + import_result.name + "_" + submesh.name + ".rzmesh";
+                m_ModelPath = options.assetsOutputDirectory + "/Cache/Meshes/" + model.name + ".rzmodel";
+                m_PackModel = options.packModel;
 
-                    // Don't export if file exists
-                    bool exist = std::filesystem::exists(export_path);
-                    if (exist)
-                        continue;
+                m_SharedMeshPath = options.assetsOutputDirectory + "/Cache/Meshes/Shared/";
+                if (options.deduplicate && !options.packModel)
+                    std::filesystem::create_directories(m_SharedMeshPath);
 
-                    // Export the Mesh
-                    std::fstream f(export_path, std::ios::out | std::ios::binary);
-
-                    if (f.is_open()) {
-                        BINFileHeader fh{};
-                        char*         magic = new char[18];
-
-                        magic[0]  = 'r';
-                        magic[1]  = 'a';
-                        magic[2]  = 'z';
-                        magic[3]  = 'i';
-                        magic[4]  = 'x';
-                        magic[5]  = '_';
-                        magic[6]  = 'e';
-                        magic[7]  = 'n';
-                        magic[8]  = 'g';
-                        magic[9]  = 'i';
-                        magic[10] = 'n';
-                        magic[11] = 'e';
-                        magic[12] = '_';
-                        magic[13] = 'a';
-                        magic[14] = 's';
-                        magic[15] = 's';
-                        magic[16] = 'e';
-                        magic[17] = 't';
-
-                        //fh.magic   = magic;
-                        memcpy(fh.magic, magic, sizeof(char) * 18);
-                        fh.version = RAZIX_ASSET_VERSION;
-                        fh.type    = ASSET_MESH;
-
-                        BINMeshFileHeader header{};
-
-                        // Copy Name
-                        strcpy_s(header.name, std::string(import_result.name + submesh.name).c_str());
-                        header.name[import_result.name.size()] = '\0';
-
-                        header.index_count           = submesh.index_count;
-                        header.vertex_count          = submesh.vertex_count;
-                        header.skeletal_vertex_count = static_cast<uint32_t>(submesh.vertex_count);
-                        header.material_count        = static_cast<uint32_t>(import_result.materials.size());
-                        header.mesh_count            = static_cast<uint32_t>(import_result.submeshes.size());
-                        header.blobs_count           = VERTEX_ATTRIBS_COUNT;
-                        header.max_extents           = submesh.max_extents;
-                        header.min_extents           = submesh.min_extents;
-                        header.base_index            = submesh.base_index;
-                        header.base_vertex           = submesh.base_vertex;
-                        header.material_index        = submesh.material_index;
-                        //header.materialName          = submesh.materialName;
-                        strcpy_s(header.materialName, &submesh.materialName[0]);
-
-                        std::cout << "Exporting Mesh... : " << import_result.name + submesh.name << std::endl;
-
-                        size_t offset = 0;
-
-                        // Write Asset File header
-                        WRITE_AND_OFFSET(f, (char*) &fh, sizeof(BINFileHeader), offset);
-
-                        // Write mesh header
-                        WRITE_AND_OFFSET(f, (char*) &header, sizeof(BINMeshFileHeader), offset);
+                return true;
+            }
 
-#if RAZIX_ASSET_VERSION == RAZIX_ASSET_VERSION_V1
-                        // Write vertices
-                        if (import_result.vertices.size() > 0) {
-                            uint32_t start_vtx_idx = submesh.base_vertex;
-                            auto&    data          = import_result.vertices;
-                            auto     subData       = std::vector<Graphics::RZVertex>(data.begin() + start_vtx_idx, data.begin() + start_vtx_idx + submesh.vertex_count);
+            bool MeshExporter::exportChunk(const MeshImportResult& model, const MeshImportResult& chunk, const MeshExportOptions& options)
+            {
+                if (options.packModel) {
+                    RAZIX_PACKER_LOG_ERROR("Packed models can't be exported a submesh at a time : " << model.name);
+                    return false;
+                }
 
-                            WRITE_AND_OFFSET(f, (char*) &subData[0], sizeof(Graphics::RZVertex) * submesh.vertex_count, offset);
-                        }
+                // The file header counts are the ones of the whole model, the chunk only has it's own submesh
+                uint32_t submeshesCount = static_cast<uint32_t>(model.submeshes.size());
+                uint32_t materialsCount = static_cast<uint32_t>(model.materials.size());
+                if (chunk.submeshes.size() != 1 || chunk.chunkIndex >= submeshesCount) {
+                    RAZIX_PACKER_LOG_ERROR("A chunk must hold a single submesh of the model : " << model.name);
+                    return false;
+                }
+                return exportSubMesh(chunk, chunk.submeshes[0], chunk.chunkIndex, m_MeshPath, options, submeshesCount, materialsCount);
+            }
+
+            bool MeshExporter::endExport(const MeshImportResult& model)
+            {
+                // Materials are only complete here (the texture processing rewrites their paths)
+                MaterialLibrary library;
+                BuildMaterialLibrary(model.materials, library);
+                return endExport(model, library);
+            }
+
+            bool MeshExporter::endExport(const MeshImportResult& model, const MaterialLibrary& library)
+            {
+                // Every unique material is written once
+                RAZIX_PACKER_PROFILE_ZONE("Export Materials");
+                if (!model.materials.empty()) {
+                    if (!exportMaterialLibrary(library, m_MaterialLibraryPath)) {
+                        RAZIX_PACKER_LOG_ERROR("Failed to export the material library : " << m_MaterialLibraryPath);
+                        return false;
+                    }
+
+                    if (m_MaterialJSON) {
+                        for (uint32_t first: library.firsts)
+                            exportMaterial(model.materials[first], model.materials[first].m_Name, m_MaterialsPath);
+                    }
+                }
+
+                if (!exportModel(model, library, m_ModelPath)) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to export the model hierarchy : " << m_ModelPath);
+                    return false;
+                }
+
+                if (m_ReferencedSubMeshes > 0)
+                    RAZIX_PACKER_LOG_INFO("Deduplicated submeshes : " << m_ReferencedSubMeshes << " of " << model.submeshes.size() << " reference geometry already exported");
+
+                if (m_BlobBytesStored > 0) {
+                    double ratio = static_cast<double>(m_BlobBytesRaw) / static_cast<double>(m_BlobBytesStored);
+                    RAZIX_PACKER_LOG_INFO("Encoded mesh blobs : " << m_BlobBytesRaw << " -> " << m_BlobBytesStored << " bytes (" << ratio << "x)");
+                }
+
+                auto                          finish = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> time   = finish - m_ExportStart;
+
+                RAZIX_PACKER_LOG_INFO("Successfully Exported mesh in " << time.count() << " seconds");
+                return true;
+            }
+
+            bool MeshExporter::exportMaterialLibrary(const MaterialLibrary& library, const std::string& library_path)
+            {
+                BINMaterialLibraryHeader header{};
+                header.material_count    = static_cast<uint32_t>(library.materials.size());
+                header.string_table_size = static_cast<uint32_t>(library.strings.size());
+                header.materials_offset  = sizeof(BINMaterialLibraryHeader);
+                header.strings_offset    = header.materials_offset + header.material_count * sizeof(BINMaterial);
+                header.file_size         = header.strings_offset + header.string_table_size;
+
+                std::ofstream f(library_path, std::ios::out | std::ios::binary);
+                if (!f.is_open())
+                    return false;
+
+                f.write((const char*) &header, sizeof(BINMaterialLibraryHeader));
+                f.write((const char*) library.materials.data(), sizeof(BINMaterial) * library.materials.size());
+                f.write(library.strings.data(), library.strings.size());
+                if (!f.good())
+                    return false;
+
+                RAZIX_PACKER_LOG_INFO("Exported material library : " << library.indices.size() << " materials, " << library.materials.size() << " unique, " << header.file_size << " bytes");
+
+                m_BytesWritten += header.file_size;
+                addOutputFile(library_path);
+                return true;
+            }
+
+            bool MeshExporter::exportModel(const MeshImportResult& model, const MaterialLibrary& library, const std::string& model_path)
+            {
+                const MeshHierarchy& hierarchy = model.hierarchy;
+                uint32_t             nodeCount = hierarchy.size();
+
+                BINModelHeader    header{};
+                std::vector<char> strings;
+                header.name_offset = AddString(strings, model.name);
+                if (m_PackModel)
+                    header.pack_path_offset = AddString(strings, "Cache/Meshes/" + model.name + ".rzpack");
+
+                // Node names are a string table already, they are only rebased after the other strings
+                uint32_t nodeStrings = static_cast<uint32_t>(strings.size());
+                strings.insert(strings.end(), hierarchy.strings.begin(), hierarchy.strings.end());
+
+                std::vector<uint32_t>          names(nodeCount);
+                std::vector<float>             rotations(nodeCount * 4);
+                std::vector<BINModelMeshRange> meshRanges(nodeCount);
+                for (uint32_t i = 0; i < nodeCount; i++) {
+                    names[i]             = nodeStrings + hierarchy.nameOffsets[i];
+                    rotations[i * 4 + 0] = hierarchy.rotations[i].x;
+                    rotations[i * 4 + 1] = hierarchy.rotations[i].y;
+                    rotations[i * 4 + 2] = hierarchy.rotations[i].z;
+                    rotations[i * 4 + 3] = hierarchy.rotations[i].w;
+                    meshRanges[i].offset = hierarchy.meshOffsets[i];
+                    meshRanges[i].count  = hierarchy.meshCounts[i];
+                }
+
+                std::vector<BINModelSubMesh> submeshes(model.submeshes.size());
+                for (size_t i = 0; i < model.submeshes.size(); i++) {
+                    const auto& submesh      = model.submeshes[i];
+                    submeshes[i].name_offset = AddString(strings, submesh.name);
+                    if (!m_PackModel) {
+                        auto shared              = m_SharedSubMeshPaths.find(static_cast<uint32_t>(i));
+                        submeshes[i].path_offset = AddString(strings, shared != m_SharedSubMeshPaths.end() ? shared->second : "Cache/Meshes/" + model.name + "/" + GetSubMeshFileName(model.name, static_cast<uint32_t>(i)));
+                    }
+                    submeshes[i].material_index = submesh.material_index;
+                    memcpy(submeshes[i].min_extents, &submesh.min_extents.x, sizeof(float) * 3);
+                    memcpy(submeshes[i].max_extents, &submesh.max_extents.x, sizeof(float) * 3);
+                }
+
+                std::vector<BINModelMaterial> materials(model.materials.size());
+                uint32_t                      libraryPath = materials.empty() ? 0 : AddString(strings, "Materials/" + model.name + ".rzmatlib");
+                for (size_t i = 0; i < model.materials.size(); i++) {
+                    materials[i].name_offset   = AddString(strings, model.materials[i].m_Name);
+                    materials[i].path_offset   = libraryPath;
+                    materials[i].library_index = library.indices[i];
+                }
 
-                        // Write skeletal vertices
-                        if (import_result.skeletal_vertices.size() > 0) {
-                            WRITE_AND_OFFSET(f, (char*) &import_result.skeletal_vertices[0], sizeof(Graphics::RZSkeletalVertex) * import_result.skeletal_vertices.size(), offset);
+                header.node_count        = nodeCount;
+                header.node_mesh_count   = static_cast<uint32_t>(hierarchy.meshes.size());
+                header.submesh_count     = static_cast<uint32_t>(submeshes.size());
+                header.material_count    = static_cast<uint32_t>(materials.size());
+                header.string_table_size = static_cast<uint32_t>(strings.size());
+                memcpy(header.min_extents, &model.min_extents.x, sizeof(float) * 3);
+                memcpy(header.max_extents, &model.max_extents.x, sizeof(float) * 3);
+
+                // Same order as BINModelArray
+                static_assert(sizeof(glm::vec3) == sizeof(float) * 3, "Translations and scales are written as float[3]");
+                const std::pair<const void*, size_t> arrays[MODEL_ARRAY_COUNT] = {
+                    {hierarchy.parents.data(), sizeof(uint32_t) * nodeCount},
+                    {hierarchy.translations.data(), sizeof(glm::vec3) * nodeCount},
+                    {rotations.data(), sizeof(float) * rotations.size()},
+                    {hierarchy.scales.data(), sizeof(glm::vec3) * nodeCount},
+                    {names.data(), sizeof(uint32_t) * names.size()},
+                    {meshRanges.data(), sizeof(BINModelMeshRange) * meshRanges.size()},
+                    {hierarchy.meshes.data(), sizeof(uint32_t) * hierarchy.meshes.size()},
+                    {submeshes.data(), sizeof(BINModelSubMesh) * submeshes.size()},
+                    {materials.data(), sizeof(BINModelMaterial) * materials.size()},
+                    {strings.data(), strings.size()},
+                };
+
+                uint64_t offset = sizeof(BINModelHeader);
+                for (uint32_t i = 0; i < MODEL_ARRAY_COUNT; i++) {
+                    offset            = AlignUp(offset, header.alignment);
+                    header.offsets[i] = static_cast<uint32_t>(offset);
+                    offset += arrays[i].second;
+                }
+                header.file_size = static_cast<uint32_t>(offset);
+
+                std::ofstream f(model_path, std::ios::out | std::ios::binary);
+                if (!f.is_open())
+                    return false;
+
+                f.write((const char*) &header, sizeof(BINModelHeader));
+
+                std::vector<char> padding(header.alignment, 0);
+                uint64_t          written = sizeof(BINModelHeader);
+                for (uint32_t i = 0; i < MODEL_ARRAY_COUNT; i++) {
+                    f.write(padding.data(), header.offsets[i] - written);
+                    if (arrays[i].second > 0)
+                        f.write((const char*) arrays[i].first, arrays[i].second);
+                    written = header.offsets[i] + arrays[i].second;
+                }
+
+                if (!f.good())
+                    return false;
+
+                m_BytesWritten += header.file_size;
+                addOutputFile(model_path);
+                return true;
+            }
+
+            bool MeshExporter::exportSubMesh(const MeshImportResult& import_result, const SubMesh& submesh, uint32_t submesh_index, const std::string& mesh_path, const MeshExportOptions& options, uint32_t mesh_count, uint32_t material_count)
+            {
+                std::string export_path = mesh_path + GetSubMeshFileName(import_result.name, submesh_index);
+
+                bool shared   = options.deduplicate && !options.packModel;
+                char hash[17] = {};
+                if (shared) {
+                    uint64_t streamBytes = 0;
+                    uint64_t key         = HashSubMeshGeometry(import_result, submesh, options, streamBytes);
+                    snprintf(hash, sizeof(hash), "%016" PRIx64, key);
+                    export_path = m_SharedMeshPath + hash + ".rzmesh";
+                    {
+                        std::lock_guard<std::mutex> lock(m_OutputFilesMutex);
+                        m_SharedSubMeshPaths[submesh_index] = std::string("Cache/Meshes/Shared/") + hash + ".rzmesh";
+                    }
+
+                    // Still an output of this model, so the build cache keeps it as long as any model references it
+                    GeometryRegistry& registry = options.geometry ? *options.geometry : m_LocalGeometry;
+                    if (!registry.claim(key, streamBytes)) {
+                        m_ReferencedSubMeshes++;
+                        addOutputFile(export_path);
+                        return true;
+                    }
+                }
+
+                // Up to date models are skipped by the build cache before they are imported, anything that gets here is rewritten
+                // Export the Mesh
+                std::fstream f(export_path, std::ios::out | std::ios::binary);
+
+                if (f.is_open()) {
+                    BINFileHeader fh{};
+                    memcpy(fh.magic, RAZIX_ASSET_MAGIC, RAZIX_ASSET_MAGIC_SIZE);
+                    // Any non raw stream needs the V3 extensions to describe how the blobs are stored
+                    uint32_t vertexEncoding = (import_result.encodeVertices ? static_cast<uint32_t>(BLOB_ENCODING_MESHOPT_VERTEX) : 0u) | (options.useCompression ? static_cast<uint32_t>(BLOB_ENCODING_DEFLATE) : 0u);
+                    uint32_t indexEncoding  = (import_result.encodeIndices ? static_cast<uint32_t>(BLOB_ENCODING_MESHOPT_INDEX) : 0u) | (options.useCompression ? static_cast<uint32_t>(BLOB_ENCODING_DEFLATE) : 0u);
+                    uint32_t tableEncoding  = options.useCompression ? static_cast<uint32_t>(BLOB_ENCODING_DEFLATE) : static_cast<uint32_t>(BLOB_ENCODING_RAW);
+                    bool     hasLODs        = submesh.lod_count > 0;
+                    bool     hasMeshlets    = submesh.meshlet_count > 0;
+                    bool     hasBVH         = submesh.bvh_node_count > 0;
+                    // The BVH nodes are used in place, so a pair of siblings must not straddle two cache lines, which only the aligned layout guarantees
+                    bool     alignBlobs     = options.blobAlignment > 0 || hasBVH;
+                    bool     hasSkin        = submesh.skinned && !import_result.bone_indices.empty();
+                    bool     useExtensions  = vertexEncoding || indexEncoding || hasLODs || hasMeshlets || hasBVH || alignBlobs || hasSkin;
+                    uint32_t blobAlignment  = hasBVH ? std::max(options.blobAlignment, kBVHNodeAlignment) : options.blobAlignment;
+
+                    fh.version = useExtensions ? RAZIX_ASSET_VERSION_V3 : RAZIX_ASSET_VERSION;
+                    fh.type    = ASSET_MESH;
+
+                    BINMeshFileHeader header{};
+
+                    // Copy Name
+                    strcpy_s(header.name, std::string(import_result.name + submesh.name).c_str());
+                    header.name[import_result.name.size()] = '\0';
+
+                    header.index_count           = submesh.index_count;
+                    header.vertex_count          = submesh.vertex_count;
+                    header.skeletal_vertex_count = hasSkin ? submesh.vertex_count : 0;
+                    header.material_count        = material_count;
+                    header.mesh_count            = mesh_count;
+                    header.blobs_count           = useExtensions ? VERTEX_ATTRIBS_COUNT + 1 : VERTEX_ATTRIBS_COUNT;
+                    if (hasLODs)
+                        header.blobs_count += 2;
+                    if (hasMeshlets)
+                        header.blobs_count += 4;
+                    if (hasBVH)
+                        header.blobs_count += 2;
+                    if (hasSkin)
+                        header.blobs_count += 2;
+                    header.max_extents           = submesh.max_extents;
+                    header.min_extents           = submesh.min_extents;
+                    header.base_index            = submesh.base_index;
+                    header.base_vertex           = submesh.base_vertex;
+                    header.material_index        = submesh.material_index;
+                    //header.materialName          = submesh.materialName;
+                    strcpy_s(header.materialName, &submesh.materialName[0]);
+
+                    // Shared geometry is referenced by any model, so nothing in the header can come from the one that wrote it
+                    if (shared) {
+                        memset(header.name, 0, sizeof(header.name));
+                        memset(header.materialName, 0, sizeof(header.materialName));
+                        strcpy_s(header.name, hash);
+                        header.material_count = 0;
+                        header.mesh_count     = 1;
+                        header.base_index     = 0;
+                        header.base_vertex    = 0;
+                        header.material_index = 0;
+                    }
+
+                    RAZIX_PACKER_LOG_VERBOSE("Exporting Mesh... : " << import_result.name + submesh.name);
+
+                    size_t offset = 0;
+
+                    // Write Asset File header
+                    WRITE_AND_OFFSET(f, (char*) &fh, sizeof(BINFileHeader), offset);
+
+                    // Write mesh header
+                    WRITE_AND_OFFSET(f, (char*) &header, sizeof(BINMeshFileHeader), offset);
+
+                    if (useExtensions) {
+                        BINMeshExtHeader ext_header{};
+                        ext_header.flags         = (vertexEncoding || indexEncoding) ? MESH_EXT_ENCODED_STREAMS : MESH_EXT_NONE;
+                        ext_header.lod_count     = submesh.lod_count;
+                        ext_header.meshlet_count  = submesh.meshlet_count;
+                        ext_header.bvh_node_count = submesh.bvh_node_count;
+                        if (hasLODs)
+                            ext_header.flags |= MESH_EXT_LODS;
+                        if (hasMeshlets)
+                            ext_header.flags |= MESH_EXT_MESHLETS;
+                        if (hasBVH)
+                            ext_header.flags |= MESH_EXT_BVH;
+                        if (hasSkin)
+                            ext_header.flags |= MESH_EXT_SKINNED;
+                        if (alignBlobs) {
+                            ext_header.flags |= MESH_EXT_ALIGNED_BLOBS;
+                            ext_header.blob_alignment = blobAlignment;
                         }
+                        WRITE_AND_OFFSET(f, (char*) &ext_header, sizeof(BINMeshExtHeader), offset);
+                    }
+
+#if RAZIX_ASSET_VERSION == RAZIX_ASSET_VERSION_V1
+                    // Write vertices
+                    if (import_result.vertices.size() > 0) {
+                        Span<const Graphics::RZVertex> subData = MakeSpan(import_result.vertices, submesh.base_vertex, submesh.vertex_count);
+
+                        WRITE_AND_OFFSET(f, (char*) subData.data(), subData.sizeBytes(), offset);
+                    }
+
+                    // Write skeletal vertices
+                    if (import_result.skeletal_vertices.size() > 0) {
+                        WRITE_AND_OFFSET(f, (char*) &import_result.skeletal_vertices[0], sizeof(Graphics::RZSkeletalVertex) * import_result.skeletal_vertices.size(), offset);
+                    }
 #endif
 
+                    // V3 stores the index buffer as the first blob, so it can be encoded like the attributes
+                    if (!useExtensions) {
                         // Write indices
-                        if (import_result.indices.size() > 0) {
-                            uint32_t start_idx_idx = submesh.base_index;
-                            auto     data          = import_result.indices;
-                            auto     subData       = std::vector<uint32_t>(data.begin() + start_idx_idx, data.begin() + start_idx_idx + submesh.index_count);
-
-                            WRITE_AND_OFFSET(f, (char*) &subData[0], sizeof(uint32_t) * submesh.index_count, offset);
-                        }
+                        Span<const uint32_t> subData = MakeSpan(import_result.indices, submesh.base_index, submesh.index_count);
+                        if (!subData.empty())
+                            WRITE_AND_OFFSET(f, (char*) subData.data(), subData.sizeBytes(), offset);
+                    }
 
 // Write vertex data attrib by attrib
 #if RAZIX_ASSET_VERSION == RAZIX_ASSET_VERSION_V2
+                    // Blobs point into the import result, tables and quantized streams live in the scratch arena of this worker until the file is written
+                    ScratchArena&         arena = GetThreadScratchArena();
+                    ScratchScope          scope(arena);
+                    std::vector<MeshBlob> blobs;
+                    if (useExtensions)
+                        blobs.push_back({"INDEX:R32_UINT", sizeof(uint32_t), MakeSpan(import_result.indices, submesh.base_index, submesh.index_count).data(), submesh.index_count, indexEncoding});
 
-                        // write positions
-                        BINBlobHeader h;
-                        h.stride = sizeof(glm::vec3);
-                        strcpy_s(h.typeName, "POSITION:R32G32B32");
-                        u32 writeSize = import_result.vertices.Position.size();
-                        h.size        = writeSize > 0 ? submesh.vertex_count * h.stride : 0;
-                        WRITE_AND_OFFSET(f, (char*) &h, sizeof(BINBlobHeader), offset);
-                        if (h.size > 0)
-                            WRITE_AND_OFFSET(f, (char*) &import_result.vertices.Position[submesh.base_vertex], h.size, offset);
-
-                        // Color
-                        h        = {};
-                        h.stride = sizeof(glm::vec4);
-                        strcpy_s(h.typeName, "COLOR:R32G32B32A32");
-                        writeSize = import_result.vertices.Color.size();
-                        h.size    = writeSize > 0 ? submesh.vertex_count * h.stride : 0;
-                        WRITE_AND_OFFSET(f, (char*) &h, sizeof(BINBlobHeader), offset);
-                        if (h.size > 0)
-                            WRITE_AND_OFFSET(f, (char*) &import_result.vertices.Color[submesh.base_vertex], h.size, offset);
-
-                        // UV
-                        h        = {};
-                        h.stride = sizeof(glm::vec2);
-                        strcpy_s(h.typeName, "TEXCOORD:R32G32");
-                        writeSize = import_result.vertices.UV.size();
-                        h.size    = writeSize > 0 ? submesh.vertex_count * h.stride : 0;
-                        WRITE_AND_OFFSET(f, (char*) &h, sizeof(BINBlobHeader), offset);
-                        if (h.size > 0)
-                            WRITE_AND_OFFSET(f, (char*) &import_result.vertices.UV[submesh.base_vertex], h.size, offset);
-
-                        // Normal
-                        h        = {};
-                        h.stride = sizeof(glm::vec3);
-                        strcpy_s(h.typeName, "NORMAL:R32G32B32");
-                        writeSize = import_result.vertices.Normal.size();
-                        h.size    = writeSize > 0 ? submesh.vertex_count * h.stride : 0;
-                        WRITE_AND_OFFSET(f, (char*) &h, sizeof(BINBlobHeader), offset);
-                        if (h.size > 0)
-                            WRITE_AND_OFFSET(f, (char*) &import_result.vertices.Normal[submesh.base_vertex], h.size, offset);
-
-                        // Tangent
-                        h        = {};
-                        h.stride = sizeof(glm::vec3);
-                        strcpy_s(h.typeName, "TANGENT:R32G32B32");
-                        writeSize = import_result.vertices.Tangent.size();
-                        h.size    = writeSize > 0 ? submesh.vertex_count * h.stride : 0;
-                        WRITE_AND_OFFSET(f, (char*) &h, sizeof(BINBlobHeader), offset);
-                        if (h.size > 0)
-                            WRITE_AND_OFFSET(f, (char*) &import_result.vertices.Tangent[submesh.base_vertex], h.size, offset);
+                    // Attributes are converted to the requested formats, the format ends up in the blob typeName and stride
+                    VertexStreamBlobs vertexBlobs;
+                    BuildVertexStreamBlobs(import_result, submesh, options.vertexFormat, arena, vertexBlobs);
+                    for (const auto& blob: vertexBlobs)
+                        blobs.push_back({blob.typeName, blob.stride, blob.data, submesh.vertex_count, vertexEncoding});
 
-#endif
+                    if (hasSkin) {
+                        VertexStreamBlob boneIndices, boneWeights;
+                        BuildSkinStreamBlobs(import_result, submesh, arena, boneIndices, boneWeights);
+                        blobs.push_back({boneIndices.typeName, boneIndices.stride, boneIndices.data, submesh.vertex_count, vertexEncoding});
+                        blobs.push_back({boneWeights.typeName, boneWeights.stride, boneWeights.data, submesh.vertex_count, vertexEncoding});
+                    }
 
-                        f.close();
-
-                        // TODO: Export material per submesh
-                        if (import_result.materials.size() > 0) {
-                            auto materialName = submesh.materialName;
-                            auto materialIdx  = submesh.material_index;
-                            auto materialData = import_result.materials[materialIdx];
-
-                            std::cout << "Exporting Material ... : " << materialName << std::endl;
-
-                            std::string mat_export_path = materials_path + materialName + ".rzmaterial";
-
-                            // Remove the Export Directory from material textures paths
-                            //uint32_t letters_size = static_cast<uint32_t>(materials_path.size());
-
-                            // Needs more improvements and VFS search mechanism
-                            //auto path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.albedo + letters_size);
-                            //memcpy(materialData.m_MaterialTexturePaths.albedo, path.c_str(), 250);
-                            //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.ao + letters_size);
-                            //memcpy(materialData.m_MaterialTexturePaths.ao, path.c_str(), 250);
-                            //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.emissive + letters_size);
-                            //memcpy(materialData.m_MaterialTexturePaths.emissive, path.c_str(), 250);
-                            //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.metallic + letters_size);
-                            //memcpy(materialData.m_MaterialTexturePaths.metallic, path.c_str(), 250);
-                            //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.normal + letters_size);
-                            //memcpy(materialData.m_MaterialTexturePaths.normal, path.c_str(), 250);
-                            //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.roughness + letters_size);
-                            //memcpy(materialData.m_MaterialTexturePaths.roughness, path.c_str(), 250);
-                            //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.specular + letters_size);
-                            //memcpy(materialData.m_MaterialTexturePaths.specular, path.c_str(), 250);
-
-                            uint32_t offset = 0;
-
-#ifdef EXPORT_BIN_MATERIAL
-                            std::fstream f_mat(mat_export_path, std::ios::out | std::ios::binary);
-                            if (f_mat.is_open()) {
-                                WRITE_AND_OFFSET(f_mat, (char*) &materialData, sizeof(Razix::Graphics::MaterialData), offset);
-                            }
-#endif    // EXPORT_BIN_MATERIAL
-                            std::ofstream             opAppStream(mat_export_path);
-                            cereal::JSONOutputArchive defArchive(opAppStream);
-                            defArchive(cereal::make_nvp(materialName, materialData));
+                    // LODs share the vertex blobs above, only the table and the index buffers are written
+                    Span<BINMeshLOD> lodTable;
+                    if (hasLODs) {
+                        lodTable = arena.allocate<BINMeshLOD>(submesh.lod_count);
+                        uint32_t lodBaseIndex  = import_result.lods[submesh.lod_offset].base_index;
+                        uint32_t lodIndexCount = 0;
+                        for (uint32_t i = 0; i < submesh.lod_count; i++) {
+                            const auto& lod          = import_result.lods[submesh.lod_offset + i];
+                            lodTable[i].index_offset = lod.base_index - lodBaseIndex;
+                            lodTable[i].index_count  = lod.index_count;
+                            lodTable[i].error        = lod.error;
+                            lodIndexCount += lod.index_count;
                         }
 
-                    } else
+                        blobs.push_back({"LOD:TABLE", sizeof(BINMeshLOD), lodTable.data(), submesh.lod_count, tableEncoding});
+                        blobs.push_back({"LOD:INDEX_R32_UINT", sizeof(uint32_t), MakeSpan(import_result.lod_indices, lodBaseIndex, lodIndexCount).data(), lodIndexCount, indexEncoding});
+                    }
+
+                    if (hasMeshlets) {
+                        const Meshlet& first = import_result.meshlets[submesh.meshlet_offset];
+                        const Meshlet& last  = import_result.meshlets[submesh.meshlet_offset + submesh.meshlet_count - 1];
+
+                        // Offsets are rebased so the blobs of every submesh file start at 0
+                        uint32_t vertexCount   = last.vertex_offset + last.vertex_count - first.vertex_offset;
+                        uint32_t triangleBytes = last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3u) - first.triangle_offset;
+                        Span<BINMeshlet>       meshletDescs  = arena.allocate<BINMeshlet>(submesh.meshlet_count);
+                        Span<BINMeshletBounds> meshletBounds = arena.allocate<BINMeshletBounds>(submesh.meshlet_count);
+                        BuildMeshletTables(import_result, submesh.meshlet_offset, submesh.meshlet_count, meshletDescs, meshletBounds);
+
+                        blobs.push_back({"MESHLET:DESC", sizeof(BINMeshlet), meshletDescs.data(), submesh.meshlet_count, tableEncoding});
+                        blobs.push_back({"MESHLET:VERTEX_R32_UINT", sizeof(uint32_t), &import_result.meshlet_vertices[first.vertex_offset], vertexCount, tableEncoding});
+                        blobs.push_back({"MESHLET:TRIANGLE_R8_UINT", sizeof(uint8_t), &import_result.meshlet_triangles[first.triangle_offset], triangleBytes, tableEncoding});
+                        blobs.push_back({"MESHLET:BOUNDS", sizeof(BINMeshletBounds), meshletBounds.data(), submesh.meshlet_count, tableEncoding});
+                    }
+
+                    if (hasBVH) {
+                        Span<BINMeshBVHNode> bvhNodes = arena.allocate<BINMeshBVHNode>(submesh.bvh_node_count);
+                        BuildBVHNodes(import_result, submesh.bvh_offset, submesh.bvh_node_count, bvhNodes);
+
+                        blobs.push_back({"BVH:NODE", sizeof(BINMeshBVHNode), bvhNodes.data(), submesh.bvh_node_count, tableEncoding});
+                        blobs.push_back({"BVH:INDEX_R32_UINT", sizeof(uint32_t), MakeSpan(import_result.bvh_indices, submesh.base_index, submesh.index_count).data(), submesh.index_count, indexEncoding});
+                    }
+
+                    bool written = true;
+                    if (alignBlobs)
+                        written = writeAlignedBlobs(f, offset, blobs, blobAlignment);
+                    else {
+                        for (const auto& blob: blobs)
+                            written &= writeBlob(f, offset, blob.typeName.c_str(), blob.stride, blob.data, blob.count, useExtensions, blob.encodingFlags);
+                    }
+
+                    if (!written) {
+                        RAZIX_PACKER_LOG_ERROR("Failed to encode mesh blobs : " << import_result.name + submesh.name);
                         return false;
+                    }
+
+#endif
+
+                    f.close();
+
+                    m_BytesWritten += offset;
+                    addOutputFile(export_path);
+                } else
+                    return false;
+
+                return true;
+            }
+
+            bool MeshExporter::writeBlob(std::fstream& f, size_t& offset, const char* typeName, uint32_t stride, const void* data, uint32_t count, bool writeEncoding, uint32_t encodingFlags)
+            {
+                BINBlobHeader h{};
+                h.stride = stride;
+                strcpy_s(h.typeName, typeName);
+
+                // V2, raw payload right after the header
+                if (!writeEncoding) {
+                    h.size = data ? count * stride : 0;
+                    WRITE_AND_OFFSET(f, (char*) &h, sizeof(BINBlobHeader), offset);
+                    if (h.size > 0)
+                        WRITE_AND_OFFSET(f, (char*) data, h.size, offset);
+                    return true;
                 }
 
-                auto                          finish = std::chrono::high_resolution_clock::now();
-                std::chrono::duration<double> time   = finish - start;
+                ScratchScope          scope(GetThreadScratchArena());
+                BINBlobEncoding       encoding{};
+                std::vector<uint8_t>& encoded = GetThreadScratchArena().acquireBuffer();
+                if (data && !EncodeBlob(data, count, stride, encodingFlags, encoded, encoding))
+                    return false;
+
+                h.size = encoding.encoded_size;
+                WRITE_AND_OFFSET(f, (char*) &h, sizeof(BINBlobHeader), offset);
+                WRITE_AND_OFFSET(f, (char*) &encoding, sizeof(BINBlobEncoding), offset);
+                if (h.size > 0)
+                    WRITE_AND_OFFSET(f, (char*) encoded.data(), h.size, offset);
+
+                m_BlobBytesRaw += encoding.decoded_size;
+                m_BlobBytesStored += encoding.encoded_size;
+                return true;
+            }
+
+            bool MeshExporter::exportPackedModel(const MeshImportResult& import_result, const MaterialLibrary& library, const std::string& pack_path, const MeshExportOptions& options)
+            {
+                uint32_t alignment = options.packAlignment;
+                if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+                    RAZIX_PACKER_LOG_ERROR("Pack alignment must be a power of 2 : " << alignment);
+                    return false;
+                }
+                if (!import_result.bvh_nodes.empty())
+                    alignment = std::max(alignment, kBVHNodeAlignment);
+
+                RAZIX_PACKER_LOG_VERBOSE("Packing Model... : " << import_result.name);
+
+                struct PackSection
+                {
+                    std::string          name;
+                    uint32_t             stride        = 0;
+                    const void*          data          = nullptr;
+                    uint32_t             count         = 0;
+                    uint32_t             encodingFlags = BLOB_ENCODING_RAW;
+                    BINBlobEncoding      encoding      = {};
+                    std::vector<uint8_t> encoded;
+                };
+
+                uint32_t tableEncoding  = options.useCompression ? static_cast<uint32_t>(BLOB_ENCODING_DEFLATE) : static_cast<uint32_t>(BLOB_ENCODING_RAW);
+                uint32_t vertexEncoding = (import_result.encodeVertices ? static_cast<uint32_t>(BLOB_ENCODING_MESHOPT_VERTEX) : 0u) | tableEncoding;
+                uint32_t indexEncoding  = (import_result.encodeIndices ? static_cast<uint32_t>(BLOB_ENCODING_MESHOPT_INDEX) : 0u) | tableEncoding;
+
+                std::vector<PackSection> sections;
+                auto                     addSection = [&sections](const std::string& name, uint32_t stride, const void* data, uint32_t count, uint32_t encodingFlags) {
+                    PackSection section;
+                    section.name          = name;
+                    section.stride        = stride;
+                    section.data          = count > 0 ? data : nullptr;
+                    section.count         = data ? count : 0;
+                    section.encodingFlags = encodingFlags;
+                    sections.push_back(std::move(section));
+                };
+
+                std::vector<char> strings;
+
+                // Submeshes
+                std::vector<BINPackSubMesh> submeshTable(import_result.submeshes.size());
+                for (size_t i = 0; i < import_result.submeshes.size(); i++) {
+                    const auto& submesh = import_result.submeshes[i];
+                    auto&       entry   = submeshTable[i];
+
+                    entry.name_offset    = AddString(strings, submesh.name);
+                    entry.material_index = submesh.material_index;
+                    entry.base_index     = submesh.base_index;
+                    entry.index_count    = submesh.index_count;
+                    entry.base_vertex    = submesh.base_vertex;
+                    entry.vertex_count   = submesh.vertex_count;
+                    entry.lod_offset     = submesh.lod_offset;
+                    entry.lod_count      = submesh.lod_count;
+                    entry.meshlet_offset = submesh.meshlet_offset;
+                    entry.meshlet_count  = submesh.meshlet_count;
+                    entry.bvh_offset     = submesh.bvh_offset;
+                    entry.bvh_node_count = submesh.bvh_node_count;
+                    memcpy(entry.min_extents, &submesh.min_extents.x, sizeof(float) * 3);
+                    memcpy(entry.max_extents, &submesh.max_extents.x, sizeof(float) * 3);
+                }
+                addSection("SUBMESH:TABLE", sizeof(BINPackSubMesh), submeshTable.data(), static_cast<uint32_t>(submeshTable.size()), tableEncoding);
+                addSection("INDEX:R32_UINT", sizeof(uint32_t), import_result.indices.data(), static_cast<uint32_t>(import_result.indices.size()), indexEncoding);
+
+                // Vertex streams of all the submeshes are contiguous already, convert them as a single range so every section has one format
+                SubMesh wholeMesh{};
+                wholeMesh.vertex_count = static_cast<uint32_t>(import_result.vertices.Position.size());
+                wholeMesh.min_extents  = import_result.min_extents;
+                wholeMesh.max_extents  = import_result.max_extents;
+
+                // The section encode jobs only read the scratch memory of this thread, it's released once the file is written
+                ScratchArena& arena = GetThreadScratchArena();
+                ScratchScope  scope(arena);
+
+                VertexStreamBlobs vertexBlobs;
+                BuildVertexStreamBlobs(import_result, wholeMesh, options.vertexFormat, arena, vertexBlobs);
+                for (const auto& blob: vertexBlobs)
+                    addSection(blob.typeName, blob.stride, blob.data, wholeMesh.vertex_count, vertexEncoding);
+
+                // The importer fills the skinning streams for every vertex as soon as one submesh is skinned
+                if (!import_result.bone_indices.empty()) {
+                    VertexStreamBlob boneIndices, boneWeights;
+                    BuildSkinStreamBlobs(import_result, wholeMesh, arena, boneIndices, boneWeights);
+                    addSection(boneIndices.typeName, boneIndices.stride, boneIndices.data, wholeMesh.vertex_count, vertexEncoding);
+                    addSection(boneWeights.typeName, boneWeights.stride, boneWeights.data, wholeMesh.vertex_count, vertexEncoding);
+                }
+
+                // LODs and meshlets keep the global offsets of the import result
+                Span<BINMeshLOD> lodTable = arena.allocate<BINMeshLOD>(import_result.lods.size());
+                for (size_t i = 0; i < import_result.lods.size(); i++) {
+                    lodTable[i].index_offset = import_result.lods[i].base_index;
+                    lodTable[i].index_count  = import_result.lods[i].index_count;
+                    lodTable[i].error        = import_result.lods[i].error;
+                }
+                if (!lodTable.empty()) {
+                    addSection("LOD:TABLE", sizeof(BINMeshLOD), lodTable.data(), static_cast<uint32_t>(lodTable.size()), tableEncoding);
+                    addSection("LOD:INDEX_R32_UINT", sizeof(uint32_t), import_result.lod_indices.data(), static_cast<uint32_t>(import_result.lod_indices.size()), indexEncoding);
+                }
+
+                if (!import_result.meshlets.empty()) {
+                    Span<BINMeshlet>       meshletDescs  = arena.allocate<BINMeshlet>(import_result.meshlets.size());
+                    Span<BINMeshletBounds> meshletBounds = arena.allocate<BINMeshletBounds>(import_result.meshlets.size());
+                    BuildMeshletTables(import_result, 0, static_cast<uint32_t>(import_result.meshlets.size()), meshletDescs, meshletBounds);
+                    addSection("MESHLET:DESC", sizeof(BINMeshlet), meshletDescs.data(), static_cast<uint32_t>(meshletDescs.size()), tableEncoding);
+                    addSection("MESHLET:VERTEX_R32_UINT", sizeof(uint32_t), import_result.meshlet_vertices.data(), static_cast<uint32_t>(import_result.meshlet_vertices.size()), tableEncoding);
+                    addSection("MESHLET:TRIANGLE_R8_UINT", sizeof(uint8_t), import_result.meshlet_triangles.data(), static_cast<uint32_t>(import_result.meshlet_triangles.size()), tableEncoding);
+                    addSection("MESHLET:BOUNDS", sizeof(BINMeshletBounds), meshletBounds.data(), static_cast<uint32_t>(meshletBounds.size()), tableEncoding);
+                }
+
+                if (!import_result.bvh_nodes.empty()) {
+                    Span<BINMeshBVHNode> bvhNodes = arena.allocate<BINMeshBVHNode>(import_result.bvh_nodes.size());
+                    BuildBVHNodes(import_result, 0, static_cast<uint32_t>(import_result.bvh_nodes.size()), bvhNodes);
+                    addSection("BVH:NODE", sizeof(BINMeshBVHNode), bvhNodes.data(), static_cast<uint32_t>(bvhNodes.size()), tableEncoding);
+                    addSection("BVH:INDEX_R32_UINT", sizeof(uint32_t), import_result.bvh_indices.data(), static_cast<uint32_t>(import_result.bvh_indices.size()), indexEncoding);
+                }
+
+                // Materials are entries of the .rzmatlib of the model, endExport writes it after the pack
+                std::vector<BINPackMaterial> materialTable(import_result.materials.size());
+                uint32_t                     libraryPath = materialTable.empty() ? 0 : AddString(strings, "Materials/" + import_result.name + ".rzmatlib");
+                for (size_t i = 0; i < import_result.materials.size(); i++) {
+                    materialTable[i].name_offset   = AddString(strings, import_result.materials[i].m_Name);
+                    materialTable[i].path_offset   = libraryPath;
+                    materialTable[i].library_index = library.indices[i];
+                }
+                addSection("MATERIAL:TABLE", sizeof(BINPackMaterial), materialTable.data(), static_cast<uint32_t>(materialTable.size()), tableEncoding);
+
+                const MeshHierarchy&     hierarchy = import_result.hierarchy;
+                std::vector<BINPackNode> nodeTable;
+                BuildNodeTable(hierarchy, nodeTable, strings);
+                addSection("NODE:TABLE", sizeof(BINPackNode), nodeTable.data(), static_cast<uint32_t>(nodeTable.size()), tableEncoding);
+                addSection("NODE:MESHES_R32_UINT", sizeof(uint32_t), hierarchy.meshes.data(), static_cast<uint32_t>(hierarchy.meshes.size()), tableEncoding);
+
+                addSection("STRING:TABLE", sizeof(char), strings.data(), static_cast<uint32_t>(strings.size()), tableEncoding);
+
+                // Encode the sections in parallel, raw sections are written straight from the import result
+                std::atomic<bool> encoded       = true;
+                uint32_t          sectionsCount = static_cast<uint32_t>(sections.size());
+                auto              encodeJob     = [&](uint32_t i) {
+                    RAZIX_PACKER_PROFILE_ZONE("Encode Section");
+                    auto& section = sections[i];
+                    if (!EncodeBlobPayload(section.data, section.count, section.stride, section.encodingFlags, section.encoded, section.encoding))
+                        encoded = false;
+                };
+
+                if (options.jobSystem)
+                    options.jobSystem->parallelFor(sectionsCount, encodeJob);
+                else {
+                    for (uint32_t i = 0; i < sectionsCount; i++)
+                        encodeJob(i);
+                }
+
+                if (!encoded) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to encode pack sections : " << import_result.name);
+                    return false;
+                }
+
+                // Lay out the payloads after the table of contents
+                BINFileHeader fh{};
+                memcpy(fh.magic, RAZIX_ASSET_MAGIC, RAZIX_ASSET_MAGIC_SIZE);
+                fh.version = RAZIX_ASSET_VERSION_V3;
+                fh.type    = ASSET_MESH;
+
+                BINPackHeader header{};
+                header.alignment      = alignment;
+                header.section_count  = sectionsCount;
+                header.submesh_count  = static_cast<uint32_t>(submeshTable.size());
+                header.material_count = static_cast<uint32_t>(materialTable.size());
+                header.node_count     = static_cast<uint32_t>(nodeTable.size());
+                memcpy(header.min_extents, &import_result.min_extents.x, sizeof(float) * 3);
+                memcpy(header.max_extents, &import_result.max_extents.x, sizeof(float) * 3);
+
+                std::vector<BINPackSection> toc(sectionsCount);
+                uint64_t                    offset = sizeof(BINFileHeader) + sizeof(BINPackHeader) + sizeof(BINPackSection) * sectionsCount;
+                for (uint32_t i = 0; i < sectionsCount; i++) {
+                    strncpy(toc[i].name, sections[i].name.c_str(), sizeof(toc[i].name) - 1);
+                    toc[i].stride   = sections[i].stride;
+                    toc[i].encoding = sections[i].encoding;
+                    toc[i].offset   = AlignUp(offset, alignment);
+                    offset          = toc[i].offset + sections[i].encoding.encoded_size;
+                }
+                header.file_size = offset;
+
+                std::ofstream f(pack_path, std::ios::out | std::ios::binary);
+                if (!f.is_open())
+                    return false;
+
+                f.write((const char*) &fh, sizeof(BINFileHeader));
+                f.write((const char*) &header, sizeof(BINPackHeader));
+                f.write((const char*) toc.data(), sizeof(BINPackSection) * sectionsCount);
+
+                // Sections are big and few, pad with zeros and write every payload with a single call
+                std::vector<char> padding(alignment, 0);
+                uint64_t          written = sizeof(BINFileHeader) + sizeof(BINPackHeader) + sizeof(BINPackSection) * sectionsCount;
+                for (uint32_t i = 0; i < sectionsCount; i++) {
+                    const auto& section = sections[i];
+                    f.write(padding.data(), toc[i].offset - written);
+
+                    const void* payload = section.encoded.empty() ? section.data : section.encoded.data();
+                    if (section.encoding.encoded_size > 0)
+                        f.write((const char*) payload, section.encoding.encoded_size);
+                    written = toc[i].offset + section.encoding.encoded_size;
+
+                    if (section.encodingFlags != BLOB_ENCODING_RAW) {
+                        m_BlobBytesRaw += section.encoding.decoded_size;
+                        m_BlobBytesStored += section.encoding.encoded_size;
+                    }
+                }
+
+                if (!f.good())
+                    return false;
+
+                m_BytesWritten += written;
+                addOutputFile(pack_path);
+
+                RAZIX_PACKER_LOG_INFO("Packed " << submeshTable.size() << " submeshes into " << sectionsCount << " sections (" << written << " bytes) : " << pack_path);
+                return true;
+            }
+
+            bool MeshExporter::writeAlignedBlobs(std::fstream& f, size_t& offset, const std::vector<MeshBlob>& blobs, uint32_t alignment)
+            {
+                // Encode everything first, the blob table needs the final sizes
+                ScratchArena&               arena = GetThreadScratchArena();
+                ScratchScope                scope(arena);
+                Span<BINBlobEntry>          entries = arena.allocate<BINBlobEntry>(blobs.size());
+                Span<std::vector<uint8_t>*> encoded = arena.allocate<std::vector<uint8_t>*>(blobs.size());
+                for (size_t i = 0; i < blobs.size(); i++) {
+                    const auto& blob = blobs[i];
+                    encoded[i]       = &arena.acquireBuffer();
+                    if (!EncodeBlobPayload(blob.data, blob.count, blob.stride, blob.encodingFlags, *encoded[i], entries[i].encoding))
+                        return false;
+
+                    strcpy_s(entries[i].header.typeName, blob.typeName.c_str());
+                    entries[i].header.stride = blob.stride;
+                    entries[i].header.size   = entries[i].encoding.encoded_size;
+                }
+
+                uint64_t payloadOffset = offset + sizeof(BINBlobEntry) * entries.size();
+                for (auto& entry: entries) {
+                    entry.offset  = AlignUp(payloadOffset, alignment);
+                    payloadOffset = entry.offset + entry.header.size;
+                }
+
+                WRITE_AND_OFFSET(f, (char*) entries.data(), entries.sizeBytes(), offset);
+
+                std::vector<char> padding(alignment, 0);
+                for (size_t i = 0; i < blobs.size(); i++) {
+                    const auto& entry = entries[i];
+                    if (entry.offset > offset)
+                        WRITE_AND_OFFSET(f, padding.data(), entry.offset - offset, offset);
+
+                    const void* payload = encoded[i]->empty() ? blobs[i].data : encoded[i]->data();
+                    if (entry.header.size > 0)
+                        WRITE_AND_OFFSET(f, (char*) payload, entry.header.size, offset);
+
+                    m_BlobBytesRaw += entry.encoding.decoded_size;
+                    m_BlobBytesStored += entry.encoding.encoded_size;
+                }
+                return true;
+            }
+
+            void MeshExporter::addOutputFile(const std::string& filePath)
+            {
+                std::lock_guard<std::mutex> lock(m_OutputFilesMutex);
+                m_OutputFiles.push_back(std::filesystem::path(filePath).lexically_normal().generic_string());
+            }
+
+            bool MeshExporter::exportMaterial(const Graphics::MaterialData& material, const std::string& materialName, const std::string& materials_path)
+            {
+                auto materialData = material;
+
+                RAZIX_PACKER_LOG_VERBOSE("Exporting Material ... : " << materialName);
+
+                std::string mat_export_path = materials_path + materialName + ".rzmaterial";
+
+                // Remove the Export Directory from material textures paths
+                //uint32_t letters_size = static_cast<uint32_t>(materials_path.size());
+
+                // Needs more improvements and VFS search mechanism
+                //auto path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.albedo + letters_size);
+                //memcpy(materialData.m_MaterialTexturePaths.albedo, path.c_str(), 250);
+                //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.ao + letters_size);
+                //memcpy(materialData.m_MaterialTexturePaths.ao, path.c_str(), 250);
+                //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.emissive + letters_size);
+                //memcpy(materialData.m_MaterialTexturePaths.emissive, path.c_str(), 250);
+                //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.metallic + letters_size);
+                //memcpy(materialData.m_MaterialTexturePaths.metallic, path.c_str(), 250);
+                //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.normal + letters_size);
+                //memcpy(materialData.m_MaterialTexturePaths.normal, path.c_str(), 250);
+                //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.roughness + letters_size);
+                //memcpy(materialData.m_MaterialTexturePaths.roughness, path.c_str(), 250);
+                //path = "//Assets/" + std::string(materialData.m_MaterialTexturePaths.specular + letters_size);
+                //memcpy(materialData.m_MaterialTexturePaths.specular, path.c_str(), 250);
+
+                std::ofstream             opAppStream(mat_export_path);
+                cereal::JSONOutputArchive defArchive(opAppStream);
+                defArchive(cereal::make_nvp(materialName, materialData));
 
-                std::cout << "Successfully Exported mesh in " << time.count() << " seconds" << std::endl;
+                addOutputFile(mat_export_path);
                 return true;
             }
         }    // namespace AssetPacker
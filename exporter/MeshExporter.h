@@ -2,17 +2,56 @@
 
 // Based on https://github.com/diharaw/asset-core
 
+#include "GeometryRegistry.h"
+
 #include "common/intermediate_types.h"
+#include "common/rzmaterial_format.h"
+#include "common/vertex_quantization.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
 
 namespace Razix {
     namespace Tool {
         namespace AssetPacker {
 
+            class JobSystem;
+
             struct MeshExportOptions
             {
-                std::string assetsOutputDirectory;
-                bool        useCompression = true;
-                bool        outputMetadata = false;
+                std::string         assetsOutputDirectory;
+                bool                useCompression = false;   /* Deflate every blob on top of the meshopt codecs (MeshImportOptions::encodeVertices/encodeIndices) */
+                bool                outputMetadata = false;
+                VertexFormatOptions vertexFormat;             /* Storage format of the vertex attributes, full floats by default                                  */
+                bool                packModel      = false;   /* Export a single .rzpack per model instead of a .rzmesh per submesh                              */
+                uint32_t            packAlignment  = 16;      /* Alignment of the .rzpack sections, power of 2                                                    */
+                uint32_t            blobAlignment  = 0;       /* Aligned .rzmesh layout for memory mapping when set (ex. 4096), power of 2                        */
+                JobSystem*          jobSystem      = nullptr; /* When set submeshes are exported in parallel on this pool                                         */
+                bool                deduplicate    = false;   /* Submeshes go to Cache/Meshes/Shared/<hash>.rzmesh, identical geometry is written once            */
+                GeometryRegistry*   geometry       = nullptr; /* Shares the deduplicated geometry across models, only within the model when not set               */
+                bool                materialJSON   = false;   /* Also write every unique material to a JSON .rzmaterial in Materials/<model>/, for debugging      */
+            };
+
+            /* A blob of a .rzmesh file waiting to be encoded and written */
+            struct MeshBlob
+            {
+                std::string typeName;
+                uint32_t    stride        = 0;
+                const void* data          = nullptr;
+                uint32_t    count         = 0;
+                uint32_t    encodingFlags = 0;
+            };
+
+            /* Unique materials of a model ready to be written to a .rzmatlib, see common/rzmaterial_format.h */
+            struct MaterialLibrary
+            {
+                std::vector<BINMaterial> materials;
+                std::vector<char>        strings;
+                std::vector<uint32_t>    indices; /* Material of the model -> entry of the library                */
+                std::vector<uint32_t>    firsts;  /* Entry of the library -> first material of the model using it */
             };
 
             class MeshExporter
@@ -22,7 +61,71 @@ namespace Razix {
                 ~MeshExporter() = default;
 
                 bool exportMesh(const MeshImportResult& import_result, const MeshExportOptions& options);
-                bool exportMaterial() {}
+                /**
+                 * Streaming export, exportMesh split in stages so a model can be written a submesh at a time
+                 * model is the import result without any geometry (name, materials and the submesh table) and every chunk is a
+                 * MeshImportResult holding a single submesh with it's own streams and it's index in chunkIndex. Chunks can be exported in parallel between
+                 * beginExport and endExport, endExport writes the materials and the .rzmodel. Packed models need all the submeshes and can't be streamed
+                 */
+                bool beginExport(const MeshImportResult& model, const MeshExportOptions& options);
+                bool exportChunk(const MeshImportResult& model, const MeshImportResult& chunk, const MeshExportOptions& options);
+                bool endExport(const MeshImportResult& model);
+                /* JSON .rzmaterial of a single material, only written as a debugging sidecar of the .rzmatlib (MeshExportOptions::materialJSON) */
+                bool exportMaterial(const Graphics::MaterialData& material, const std::string& materialName, const std::string& materials_path);
+
+                /**
+                 * Deduplicated submeshes are keyed by the hash of their streams, LODs, meshlets and the options that change how they
+                 * are stored, but not their name or material. Their .rzmesh is written once with a canonical header (named after the
+                 * hash, no material, base offsets of 0) and the .rzmodel of every model references it from the nodes drawing it, so
+                 * the node transforms are the per instance transforms. Not supported by packed models, a .rzpack is self contained
+                 */
+                static uint64_t HashSubMeshGeometry(const MeshImportResult& import_result, const SubMesh& submesh, const MeshExportOptions& options, uint64_t& streamBytes);
+
+                /* Total bytes written to .rzmesh/.rzpack/.rzmodel files by the last exportMesh call */
+                uint64_t getBytesWritten() const { return m_BytesWritten; }
+                /* Every .rzmesh/.rzpack/.rzmodel/.rzmaterial file written by the last exportMesh call, recorded by the build cache */
+                const std::vector<std::string>& getOutputFiles() const { return m_OutputFiles; }
+
+            private:
+                /**
+                 * submesh_index is the index of the submesh in the model, the one of the chunk when a chunk is exported
+                 * mesh_count and material_count go to the file header, they are the ones of the model when a chunk is exported
+                 */
+                bool exportSubMesh(const MeshImportResult& import_result, const SubMesh& submesh, uint32_t submesh_index, const std::string& mesh_path, const MeshExportOptions& options, uint32_t mesh_count, uint32_t material_count);
+                /* Writes the hierarchy, submesh and material references of the model to a .rzmodel, see common/rzmodel_format.h */
+                bool exportModel(const MeshImportResult& model, const MaterialLibrary& library, const std::string& model_path);
+                /* Writes the unique materials of a model and their string table to a .rzmatlib */
+                bool exportMaterialLibrary(const MaterialLibrary& library, const std::string& library_path);
+                /* Writes a blob header and it's payload, V3 files also store a BINBlobEncoding and the encoded payload */
+                bool writeBlob(std::fstream& f, size_t& offset, const char* typeName, uint32_t stride, const void* data, uint32_t count, bool writeEncoding, uint32_t encodingFlags);
+                /* Writes all the submeshes, their LODs/meshlets, material references and the hierarchy to a single .rzpack file */
+                bool exportPackedModel(const MeshImportResult& import_result, const MaterialLibrary& library, const std::string& pack_path, const MeshExportOptions& options);
+                /* endExport with the library exportMesh already built */
+                bool endExport(const MeshImportResult& model, const MaterialLibrary& library);
+                /* Writes the BINBlobEntry table and the payloads aligned to alignment, see MESH_EXT_ALIGNED_BLOBS */
+                bool writeAlignedBlobs(std::fstream& f, size_t& offset, const std::vector<MeshBlob>& blobs, uint32_t alignment);
+                /* Submeshes are exported in parallel, so the output list is guarded */
+                void addOutputFile(const std::string& filePath);
+
+            private:
+                std::atomic<uint64_t>    m_BytesWritten    = 0;
+                std::atomic<uint64_t>    m_BlobBytesRaw    = 0;
+                std::atomic<uint64_t>    m_BlobBytesStored = 0;
+                std::mutex               m_OutputFilesMutex;
+                std::vector<std::string> m_OutputFiles;
+                std::string              m_MeshPath;
+                std::string              m_MaterialsPath;
+                std::string              m_ModelPath;
+                std::string              m_SharedMeshPath;
+                std::string              m_MaterialLibraryPath;
+                bool                     m_PackModel    = false;
+                bool                     m_MaterialJSON = false;
+
+                GeometryRegistry                             m_LocalGeometry;       /* Used when MeshExportOptions::geometry isn't set              */
+                std::unordered_map<uint32_t, std::string>    m_SharedSubMeshPaths; /* Submesh index -> shared .rzmesh, relative to the assets directory */
+                std::atomic<uint32_t>                        m_ReferencedSubMeshes = 0;
+
+                std::chrono::high_resolution_clock::time_point m_ExportStart;
             };
 
         }    // namespace AssetPacker
@@ -0,0 +1,832 @@
+#include "GlTFImporterBackend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+
+#include "ImportUtils.h"
+#include "MeshImporter.h"
+
+#include "common/job_system.h"
+#include "common/log.h"
+#include "common/profiler.h"
+#include "common/vertex_simd.h"
+#include "loader/MappedFile.h"
+
+#define GLTF_GLB_MAGIC      0x46546C67 /* "glTF" */
+#define GLTF_GLB_CHUNK_JSON 0x4E4F534A /* "JSON" */
+#define GLTF_GLB_CHUNK_BIN  0x004E4942 /* "BIN\0" */
+
+#define GLTF_COMPONENT_BYTE           5120
+#define GLTF_COMPONENT_UNSIGNED_BYTE  5121
+#define GLTF_COMPONENT_SHORT          5122
+#define GLTF_COMPONENT_UNSIGNED_SHORT 5123
+#define GLTF_COMPONENT_UNSIGNED_INT   5125
+#define GLTF_COMPONENT_FLOAT          5126
+
+#define GLTF_MODE_TRIANGLES 4
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            struct GlTFBuffer
+            {
+                std::string                 uri;
+                std::unique_ptr<MappedFile> file;    /* External .bin buffers  */
+                std::vector<uint8_t>        decoded; /* base64 data URIs       */
+                const uint8_t*              data = nullptr;
+                uint64_t                    size = 0;
+            };
+
+            struct GlTFBufferView
+            {
+                uint32_t buffer     = 0;
+                uint64_t byteOffset = 0;
+                uint64_t byteLength = 0;
+                uint32_t byteStride = 0;
+            };
+
+            // An accessor resolved to it's first element in the buffer, validated against the buffer view
+            struct GlTFAccessor
+            {
+                const uint8_t* data          = nullptr;
+                uint32_t       stride        = 0;
+                uint32_t       count         = 0;
+                uint32_t       componentType = 0;
+                uint32_t       components    = 0;
+                bool           normalized    = false;
+            };
+
+            struct GlTFPrimitive
+            {
+                int         mesh     = 0;
+                int         position = -1;
+                int         normal   = -1;
+                int         tangent  = -1;
+                int         texcoord = -1;
+                int         indices  = -1;
+                int         material = -1;
+                std::string name;
+            };
+
+            static uint32_t GetComponentSize(uint32_t componentType)
+            {
+                switch (componentType) {
+                    case GLTF_COMPONENT_BYTE:
+                    case GLTF_COMPONENT_UNSIGNED_BYTE: return 1;
+                    case GLTF_COMPONENT_SHORT:
+                    case GLTF_COMPONENT_UNSIGNED_SHORT: return 2;
+                    case GLTF_COMPONENT_UNSIGNED_INT:
+                    case GLTF_COMPONENT_FLOAT: return 4;
+                }
+                return 0;
+            }
+
+            static uint32_t GetComponentsCount(const char* type)
+            {
+                if (!strcmp(type, "SCALAR"))
+                    return 1;
+                if (!strcmp(type, "VEC2"))
+                    return 2;
+                if (!strcmp(type, "VEC3"))
+                    return 3;
+                if (!strcmp(type, "VEC4"))
+                    return 4;
+                return 0;
+            }
+
+            static uint64_t GetUint(const rapidjson::Value& object, const char* key, uint64_t defaultValue)
+            {
+                auto it = object.FindMember(key);
+                return it != object.MemberEnd() && it->value.IsUint64() ? it->value.GetUint64() : defaultValue;
+            }
+
+            static int GetIndex(const rapidjson::Value& object, const char* key)
+            {
+                auto it = object.FindMember(key);
+                return it != object.MemberEnd() && it->value.IsInt() ? it->value.GetInt() : -1;
+            }
+
+            static float GetFloat(const rapidjson::Value& object, const char* key, float defaultValue)
+            {
+                auto it = object.FindMember(key);
+                return it != object.MemberEnd() && it->value.IsNumber() ? it->value.GetFloat() : defaultValue;
+            }
+
+            static const char* GetString(const rapidjson::Value& object, const char* key)
+            {
+                auto it = object.FindMember(key);
+                return it != object.MemberEnd() && it->value.IsString() ? it->value.GetString() : "";
+            }
+
+            static const rapidjson::Value* FindArray(const rapidjson::Value& object, const char* key)
+            {
+                auto it = object.FindMember(key);
+                return it != object.MemberEnd() && it->value.IsArray() ? &it->value : nullptr;
+            }
+
+            // Reads a fixed size array of numbers, false if it's missing, has another size or holds anything else
+            static bool GetNumbers(const rapidjson::Value& object, const char* key, uint32_t size, double* out)
+            {
+                const rapidjson::Value* array = FindArray(object, key);
+                if (!array || array->Size() != size)
+                    return false;
+                for (uint32_t i = 0; i < size; i++) {
+                    if (!(*array)[i].IsNumber())
+                        return false;
+                    out[i] = (*array)[i].GetDouble();
+                }
+                return true;
+            }
+
+            static const rapidjson::Value* FindObject(const rapidjson::Value& object, const char* key)
+            {
+                auto it = object.FindMember(key);
+                return it != object.MemberEnd() && it->value.IsObject() ? &it->value : nullptr;
+            }
+
+            // URIs are percent encoded, ex. spaces in file names are %20
+            static std::string DecodeUri(const std::string& uri)
+            {
+                auto hexValue = [](char c) {
+                    if (c >= '0' && c <= '9')
+                        return c - '0';
+                    if (c >= 'a' && c <= 'f')
+                        return c - 'a' + 10;
+                    if (c >= 'A' && c <= 'F')
+                        return c - 'A' + 10;
+                    return -1;
+                };
+
+                std::string decoded;
+                decoded.reserve(uri.size());
+                for (size_t i = 0; i < uri.size(); i++) {
+                    if (uri[i] == '%' && i + 2 < uri.size() && hexValue(uri[i + 1]) >= 0 && hexValue(uri[i + 2]) >= 0) {
+                        decoded += static_cast<char>(hexValue(uri[i + 1]) * 16 + hexValue(uri[i + 2]));
+                        i += 2;
+                    } else
+                        decoded += uri[i];
+                }
+                return decoded;
+            }
+
+            static bool DecodeBase64(const char* data, size_t length, std::vector<uint8_t>& out)
+            {
+                auto sextet = [](char c) {
+                    if (c >= 'A' && c <= 'Z')
+                        return c - 'A';
+                    if (c >= 'a' && c <= 'z')
+                        return c - 'a' + 26;
+                    if (c >= '0' && c <= '9')
+                        return c - '0' + 52;
+                    if (c == '+' || c == '-')
+                        return 62;
+                    if (c == '/' || c == '_')
+                        return 63;
+                    return -1;
+                };
+
+                out.clear();
+                out.reserve(length / 4 * 3);
+                uint32_t bits  = 0;
+                int      count = 0;
+                for (size_t i = 0; i < length && data[i] != '='; i++) {
+                    int value = sextet(data[i]);
+                    if (value < 0)
+                        return false;
+
+                    bits = (bits << 6) | uint32_t(value);
+                    count += 6;
+                    if (count >= 8) {
+                        count -= 8;
+                        out.push_back(static_cast<uint8_t>(bits >> count));
+                    }
+                }
+                return true;
+            }
+
+            static bool LoadBuffer(const std::string& directoryPath, GlTFBuffer& buffer)
+            {
+                if (buffer.uri.compare(0, 5, "data:") == 0) {
+                    size_t comma = buffer.uri.find(',');
+                    if (comma == std::string::npos || buffer.uri.rfind(";base64", comma) == std::string::npos)
+                        return false;
+                    if (!DecodeBase64(buffer.uri.c_str() + comma + 1, buffer.uri.size() - comma - 1, buffer.decoded))
+                        return false;
+                    buffer.data = buffer.decoded.data();
+                    buffer.size = buffer.decoded.size();
+                    return true;
+                }
+
+                buffer.file = std::make_unique<MappedFile>();
+                if (!buffer.file->open(directoryPath + DecodeUri(buffer.uri)))
+                    return false;
+                buffer.data = buffer.file->getData();
+                buffer.size = buffer.file->getSize();
+                return true;
+            }
+
+            static bool ResolveAccessor(const rapidjson::Value& accessors, const std::vector<GlTFBufferView>& bufferViews, const std::vector<GlTFBuffer>& buffers, int index, GlTFAccessor& accessor)
+            {
+                if (index < 0 || index >= int(accessors.Size()) || !accessors[index].IsObject())
+                    return false;
+
+                const rapidjson::Value& json = accessors[index];
+                if (json.HasMember("sparse"))
+                    return false;
+
+                int bufferView           = GetIndex(json, "bufferView");
+                accessor.count           = static_cast<uint32_t>(GetUint(json, "count", 0));
+                accessor.componentType   = static_cast<uint32_t>(GetUint(json, "componentType", 0));
+                accessor.components      = GetComponentsCount(GetString(json, "type"));
+                accessor.normalized      = json.HasMember("normalized") && json["normalized"].IsBool() && json["normalized"].GetBool();
+                uint32_t elementSize     = GetComponentSize(accessor.componentType) * accessor.components;
+                uint64_t byteOffset      = GetUint(json, "byteOffset", 0);
+                if (elementSize == 0 || bufferView < 0 || bufferView >= int(bufferViews.size()))
+                    return false;
+
+                const GlTFBufferView& view   = bufferViews[bufferView];
+                const GlTFBuffer&     buffer = buffers[view.buffer];
+                accessor.stride              = view.byteStride ? view.byteStride : elementSize;
+
+                // The last element has to fit in the view and the view in the buffer
+                uint64_t accessorSize = accessor.count ? uint64_t(accessor.count - 1) * accessor.stride + elementSize : 0;
+                if (byteOffset + accessorSize > view.byteLength || view.byteOffset + view.byteLength > buffer.size)
+                    return false;
+
+                accessor.data = buffer.data + view.byteOffset + byteOffset;
+                return true;
+            }
+
+            static float ReadComponent(const uint8_t* data, uint32_t componentType, bool normalized)
+            {
+                switch (componentType) {
+                    case GLTF_COMPONENT_FLOAT: {
+                        float value;
+                        memcpy(&value, data, sizeof(float));
+                        return value;
+                    }
+                    case GLTF_COMPONENT_BYTE: {
+                        float value = float(int8_t(data[0]));
+                        return normalized ? std::max(value / 127.0f, -1.0f) : value;
+                    }
+                    case GLTF_COMPONENT_UNSIGNED_BYTE: return normalized ? data[0] / 255.0f : float(data[0]);
+                    case GLTF_COMPONENT_SHORT: {
+                        int16_t value;
+                        memcpy(&value, data, sizeof(int16_t));
+                        return normalized ? std::max(value / 32767.0f, -1.0f) : float(value);
+                    }
+                    case GLTF_COMPONENT_UNSIGNED_SHORT: {
+                        uint16_t value;
+                        memcpy(&value, data, sizeof(uint16_t));
+                        return normalized ? value / 65535.0f : float(value);
+                    }
+                    case GLTF_COMPONENT_UNSIGNED_INT: {
+                        uint32_t value;
+                        memcpy(&value, data, sizeof(uint32_t));
+                        return float(value);
+                    }
+                }
+                return 0.0f;
+            }
+
+            // Reads the first `components` components of every element into a tightly packed float stream
+            static void ReadFloats(const GlTFAccessor& accessor, uint32_t components, float* out)
+            {
+                uint32_t componentSize = GetComponentSize(accessor.componentType);
+                if (accessor.componentType == GLTF_COMPONENT_FLOAT && accessor.components == components) {
+                    // Tightly packed floats, the common case, is a single block copy
+                    if (accessor.stride == components * sizeof(float)) {
+                        memcpy(out, accessor.data, size_t(accessor.count) * components * sizeof(float));
+                        return;
+                    }
+                    for (uint32_t i = 0; i < accessor.count; i++)
+                        memcpy(out + size_t(i) * components, accessor.data + size_t(i) * accessor.stride, components * sizeof(float));
+                    return;
+                }
+
+                for (uint32_t i = 0; i < accessor.count; i++) {
+                    const uint8_t* element = accessor.data + size_t(i) * accessor.stride;
+                    for (uint32_t c = 0; c < components; c++)
+                        out[size_t(i) * components + c] = c < accessor.components ? ReadComponent(element + c * componentSize, accessor.componentType, accessor.normalized) : 0.0f;
+                }
+            }
+
+            static void ReadIndices(const GlTFAccessor& accessor, uint32_t* out)
+            {
+                switch (accessor.componentType) {
+                    case GLTF_COMPONENT_UNSIGNED_INT:
+                        if (accessor.stride == sizeof(uint32_t)) {
+                            memcpy(out, accessor.data, size_t(accessor.count) * sizeof(uint32_t));
+                            return;
+                        }
+                        for (uint32_t i = 0; i < accessor.count; i++)
+                            memcpy(&out[i], accessor.data + size_t(i) * accessor.stride, sizeof(uint32_t));
+                        return;
+                    case GLTF_COMPONENT_UNSIGNED_SHORT:
+                        for (uint32_t i = 0; i < accessor.count; i++) {
+                            uint16_t index;
+                            memcpy(&index, accessor.data + size_t(i) * accessor.stride, sizeof(uint16_t));
+                            out[i] = index;
+                        }
+                        return;
+                    case GLTF_COMPONENT_UNSIGNED_BYTE:
+                        for (uint32_t i = 0; i < accessor.count; i++)
+                            out[i] = accessor.data[size_t(i) * accessor.stride];
+                        return;
+                }
+            }
+
+            // Texture references are resolved like the Assimp glTF importer does: the image URI, or "*<n>" for the n-th embedded image
+            static bool FindTexturePath(const std::string& materialsDirectory, const rapidjson::Value& document, const rapidjson::Value* textureInfo, char* path)
+            {
+                if (!textureInfo)
+                    return false;
+
+                const rapidjson::Value* textures = FindArray(document, "textures");
+                const rapidjson::Value* images   = FindArray(document, "images");
+                int                     texture  = GetIndex(*textureInfo, "index");
+                if (!textures || !images || texture < 0 || texture >= int(textures->Size()))
+                    return false;
+
+                int image = GetIndex((*textures)[texture], "source");
+                if (image < 0 || image >= int(images->Size()))
+                    return false;
+
+                std::string uri = GetString((*images)[image], "uri");
+                if (uri.empty() || uri.compare(0, 5, "data:") == 0) {
+                    uint32_t embeddedIndex = 0;
+                    for (int i = 0; i < image; i++) {
+                        std::string otherUri = GetString((*images)[i], "uri");
+                        if (otherUri.empty() || otherUri.compare(0, 5, "data:") == 0)
+                            embeddedIndex++;
+                    }
+                    uri = "*" + std::to_string(embeddedIndex);
+                } else
+                    uri = DecodeUri(uri);
+
+                strcpy_s(path, 250 * sizeof(char), ResolveTexturePath(materialsDirectory, uri).c_str());
+                return true;
+            }
+
+            // Same mapping as MeshImporter::readMaterial for glTF models
+            static void ReadMaterial(const std::string& materialsDirectory, const rapidjson::Value& document, const rapidjson::Value& gltfMat, Graphics::MaterialData& material)
+            {
+                const rapidjson::Value* pbr = FindObject(gltfMat, "pbrMetallicRoughness");
+
+                if (!FindTexturePath(materialsDirectory, document, pbr ? FindObject(*pbr, "baseColorTexture") : nullptr, material.m_MaterialTexturePaths.albedo)) {
+                    glm::vec4 albedo = glm::vec4(1.0f);
+                    double    baseColorFactor[4];
+                    if (pbr && GetNumbers(*pbr, "baseColorFactor", 4, baseColorFactor))
+                        albedo = glm::vec4(float(baseColorFactor[0]), float(baseColorFactor[1]), float(baseColorFactor[2]), float(baseColorFactor[3]));
+                    material.m_MaterialProperties.albedoColor = albedo;
+                }
+
+                material.m_MaterialProperties.workflow = (u32) Razix::Graphics::WorkFlow::WORLFLOW_PBR_METAL_ROUGHNESS_AO_COMBINED;
+
+                if (!FindTexturePath(materialsDirectory, document, pbr ? FindObject(*pbr, "metallicRoughnessTexture") : nullptr, material.m_MaterialTexturePaths.metallicRoughnessAO)) {
+                    // readMaterial stores the metallic factor as the roughness and vice versa, kept so both paths export the same materials
+                    material.m_MaterialProperties.roughnessColor = pbr ? GetFloat(*pbr, "metallicFactor", 1.0f) : 1.0f;
+                    material.m_MaterialProperties.metallicColor  = pbr ? GetFloat(*pbr, "roughnessFactor", 1.0f) : 1.0f;
+                }
+
+                FindTexturePath(materialsDirectory, document, FindObject(gltfMat, "normalTexture"), material.m_MaterialTexturePaths.normal);
+                FindTexturePath(materialsDirectory, document, FindObject(gltfMat, "emissiveTexture"), material.m_MaterialTexturePaths.emissive);
+            }
+
+            static void ReadNodeTransform(const rapidjson::Value& gltfNode, MeshHierarchy& hierarchy, uint32_t node)
+            {
+                // Malformed values keep the identity transform
+                double m[16];
+                if (GetNumbers(gltfNode, "matrix", 16, m)) {
+                    DecomposeTransform(m, hierarchy.translations[node], hierarchy.rotations[node], hierarchy.scales[node]);
+                    return;
+                }
+
+                double translation[3], rotation[4], scale[3];
+                if (GetNumbers(gltfNode, "translation", 3, translation))
+                    hierarchy.translations[node] = glm::vec3(float(translation[0]), float(translation[1]), float(translation[2]));
+                // glTF stores quaternions as xyzw
+                if (GetNumbers(gltfNode, "rotation", 4, rotation))
+                    hierarchy.rotations[node] = glm::quat(float(rotation[3]), float(rotation[0]), float(rotation[1]), float(rotation[2]));
+                if (GetNumbers(gltfNode, "scale", 3, scale))
+                    hierarchy.scales[node] = glm::vec3(float(scale[0]), float(scale[1]), float(scale[2]));
+            }
+
+            // Appends the children depth first after their parent
+            static void ExtractHierarchy(MeshHierarchy& hierarchy, uint32_t parent, const rapidjson::Value& nodes, const rapidjson::Value& children, const std::vector<std::vector<uint32_t>>& meshSubMeshes, uint32_t depthIndex)
+            {
+                // A valid glTF is a tree, the depth limit only guards against cycles in broken files
+                if (depthIndex >= 256)
+                    return;
+
+                for (uint32_t i = 0; i < children.Size(); i++) {
+                    int index = children[i].IsInt() ? children[i].GetInt() : -1;
+                    if (index < 0 || index >= int(nodes.Size()))
+                        continue;
+
+                    const rapidjson::Value& gltfNode = nodes[index];
+                    int                     mesh     = GetIndex(gltfNode, "mesh");
+
+                    std::string name = GetString(gltfNode, "name");
+                    if (name.empty())
+                        name = "node_" + std::to_string(index);
+
+                    const std::vector<uint32_t>* nodeMeshes = mesh >= 0 && mesh < int(meshSubMeshes.size()) ? &meshSubMeshes[mesh] : nullptr;
+                    uint32_t                     node       = hierarchy.addNode(name, parent, nodeMeshes ? nodeMeshes->data() : nullptr, nodeMeshes ? static_cast<uint32_t>(nodeMeshes->size()) : 0);
+                    ReadNodeTransform(gltfNode, hierarchy, node);
+
+                    if (const rapidjson::Value* grandChildren = FindArray(gltfNode, "children"))
+                        ExtractHierarchy(hierarchy, node, nodes, *grandChildren, meshSubMeshes, depthIndex + 1);
+                }
+            }
+
+            bool GlTFImporterBackend::importMesh(const std::string& meshFilePath, MeshImportResult& result, const MeshImportOptions& options)
+            {
+                RAZIX_PACKER_PROFILE_ZONE("glTF Import", meshFilePath.c_str());
+                RAZIX_PACKER_LOG_VERBOSE("Importing Mesh (glTF)...");
+
+                auto start = std::chrono::high_resolution_clock::now();
+
+                MappedFile file;
+                if (!file.open(meshFilePath)) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to read model : " << meshFilePath);
+                    return false;
+                }
+
+                // A .glb is a header followed by a JSON chunk and an optional binary chunk that is buffer 0
+                const char*    json       = reinterpret_cast<const char*>(file.getData());
+                uint64_t       jsonLength = file.getSize();
+                const uint8_t* binChunk   = nullptr;
+                uint64_t       binLength  = 0;
+                uint32_t       magic      = 0;
+                if (file.getSize() >= 4)
+                    memcpy(&magic, file.getData(), sizeof(uint32_t));
+                if (magic == GLTF_GLB_MAGIC) {
+                    uint32_t header[5] = {};
+                    if (file.getSize() >= sizeof(header))
+                        memcpy(header, file.getData(), sizeof(header));
+                    if (header[1] != 2 || header[4] != GLTF_GLB_CHUNK_JSON || uint64_t(header[3]) + sizeof(header) > file.getSize()) {
+                        RAZIX_PACKER_LOG_ERROR("Invalid GLB file : " << meshFilePath);
+                        return false;
+                    }
+                    json       = reinterpret_cast<const char*>(file.getData() + sizeof(header));
+                    jsonLength = header[3];
+
+                    uint64_t binOffset = sizeof(header) + ((uint64_t(header[3]) + 3) & ~uint64_t(3));
+                    uint32_t binHeader[2];
+                    if (binOffset + sizeof(binHeader) <= file.getSize()) {
+                        memcpy(binHeader, file.getData() + binOffset, sizeof(binHeader));
+                        if (binHeader[1] == GLTF_GLB_CHUNK_BIN && binOffset + sizeof(binHeader) + binHeader[0] <= file.getSize()) {
+                            binChunk  = file.getData() + binOffset + sizeof(binHeader);
+                            binLength = binHeader[0];
+                        }
+                    }
+                }
+
+                rapidjson::Document document;
+                document.Parse(json, jsonLength);
+                if (document.HasParseError() || !document.IsObject()) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to parse glTF : " << rapidjson::GetParseError_En(document.GetParseError()));
+                    return false;
+                }
+
+                if (const rapidjson::Value* extensionsRequired = FindArray(document, "extensionsRequired")) {
+                    if (extensionsRequired->Size()) {
+                        const rapidjson::Value& extension = (*extensionsRequired)[0];
+                        RAZIX_PACKER_LOG_ERROR("glTF requires extensions the native importer doesn't support : " << (extension.IsString() ? extension.GetString() : "<invalid>"));
+                        return false;
+                    }
+                }
+
+                size_t      slash         = meshFilePath.find_last_of('/');
+                std::string directoryPath = slash != std::string::npos ? meshFilePath.substr(0, slash + 1) : std::string();
+                std::string meshName      = slash != std::string::npos ? meshFilePath.substr(slash + 1) : meshFilePath;
+                meshName                  = meshName.substr(0, meshName.find_last_of('.'));
+
+                // Buffers: the GLB chunk is used in place, external files are mapped and data URIs decoded in parallel
+                static const rapidjson::Value emptyArray(rapidjson::kArrayType);
+                const rapidjson::Value*       jsonBuffers = FindArray(document, "buffers");
+                std::vector<GlTFBuffer>       buffers(jsonBuffers ? jsonBuffers->Size() : 0);
+                for (uint32_t i = 0; i < buffers.size(); i++)
+                    buffers[i].uri = GetString((*jsonBuffers)[i], "uri");
+
+                std::vector<uint8_t> loaded(buffers.size(), 0);
+                auto                 loadBufferJob = [&](uint32_t i) {
+                    if (buffers[i].uri.empty()) {
+                        loaded[i]       = i == 0 && binChunk;
+                        buffers[i].data = binChunk;
+                        buffers[i].size = binLength;
+                    } else
+                        loaded[i] = LoadBuffer(directoryPath, buffers[i]);
+                };
+                if (options.jobSystem)
+                    options.jobSystem->parallelFor(static_cast<uint32_t>(buffers.size()), loadBufferJob);
+                else {
+                    for (uint32_t i = 0; i < buffers.size(); i++)
+                        loadBufferJob(i);
+                }
+                for (uint32_t i = 0; i < buffers.size(); i++) {
+                    if (!loaded[i]) {
+                        RAZIX_PACKER_LOG_ERROR("Failed to load glTF buffer " << i << " : " << buffers[i].uri);
+                        return false;
+                    }
+                }
+
+                const rapidjson::Value*     jsonBufferViews = FindArray(document, "bufferViews");
+                std::vector<GlTFBufferView> bufferViews(jsonBufferViews ? jsonBufferViews->Size() : 0);
+                for (uint32_t i = 0; i < bufferViews.size(); i++) {
+                    const rapidjson::Value& json = (*jsonBufferViews)[i];
+                    bufferViews[i].buffer        = static_cast<uint32_t>(GetUint(json, "buffer", 0));
+                    bufferViews[i].byteOffset    = GetUint(json, "byteOffset", 0);
+                    bufferViews[i].byteLength    = GetUint(json, "byteLength", 0);
+                    bufferViews[i].byteStride    = static_cast<uint32_t>(GetUint(json, "byteStride", 0));
+                    if (bufferViews[i].buffer >= buffers.size()) {
+                        RAZIX_PACKER_LOG_ERROR("glTF buffer view " << i << " references a missing buffer");
+                        return false;
+                    }
+                }
+
+                result.name           = meshName;
+                result.encodeVertices = options.encodeVertices;
+                result.encodeIndices  = options.encodeIndices;
+
+                // Materials keep their glTF indices, primitives without one share a default material added at the end like Assimp does
+                const rapidjson::Value* materials = FindArray(document, "materials");
+                result.materials.resize(materials ? materials->Size() : 0);
+                for (uint32_t i = 0; i < result.materials.size(); i++) {
+                    auto&       material = result.materials[i];
+                    std::string mat_name = GetString((*materials)[i], "name");
+                    if (mat_name.empty())
+                        mat_name = "Mat_" + meshName + "_" + std::to_string(i);
+                    strcpy_s(material.m_Name, mat_name.c_str());
+
+                    ReadMaterial(directoryPath, document, (*materials)[i], material);
+                }
+
+                // Every triangle primitive is a submesh
+                const rapidjson::Value*    meshes = FindArray(document, "meshes");
+                std::vector<GlTFPrimitive> primitives;
+                int                        defaultMaterial = -1;
+                for (uint32_t m = 0; meshes && m < meshes->Size(); m++) {
+                    const rapidjson::Value* jsonPrimitives = FindArray((*meshes)[m], "primitives");
+                    std::string             name           = GetString((*meshes)[m], "name");
+                    if (name.empty())
+                        name = "submesh_" + std::to_string(m);
+
+                    for (uint32_t p = 0; jsonPrimitives && p < jsonPrimitives->Size(); p++) {
+                        const rapidjson::Value& jsonPrimitive = (*jsonPrimitives)[p];
+                        const rapidjson::Value* attributes    = FindObject(jsonPrimitive, "attributes");
+                        if (GetUint(jsonPrimitive, "mode", GLTF_MODE_TRIANGLES) != GLTF_MODE_TRIANGLES || !attributes) {
+                            RAZIX_PACKER_LOG_ERROR("Only triangle primitives are supported by the native glTF importer : " << name);
+                            return false;
+                        }
+
+                        GlTFPrimitive primitive;
+                        primitive.mesh     = m;
+                        primitive.position = GetIndex(*attributes, "POSITION");
+                        primitive.normal   = GetIndex(*attributes, "NORMAL");
+                        primitive.tangent  = GetIndex(*attributes, "TANGENT");
+                        primitive.texcoord = GetIndex(*attributes, "TEXCOORD_0");
+                        primitive.indices  = GetIndex(jsonPrimitive, "indices");
+                        primitive.material = GetIndex(jsonPrimitive, "material");
+                        // Tells the primitives apart in the .rzmodel and the logs, the .rzmesh files are named by index so the names may still collide
+                        primitive.name = p == 0 ? name : name + "_" + std::to_string(p);
+
+                        if (primitive.material < 0 || primitive.material >= int(result.materials.size())) {
+                            if (defaultMaterial < 0) {
+                                defaultMaterial = static_cast<int>(result.materials.size());
+                                result.materials.emplace_back();
+                                strcpy_s(result.materials.back().m_Name, "DefaultMaterial");
+                                ReadMaterial(directoryPath, document, rapidjson::Value(rapidjson::kObjectType), result.materials.back());
+                            }
+                            primitive.material = defaultMaterial;
+                        }
+                        primitives.push_back(std::move(primitive));
+                    }
+                }
+
+                if (primitives.empty()) {
+                    RAZIX_PACKER_LOG_ERROR("No meshes in model : " << meshFilePath);
+                    return false;
+                }
+
+                // Resolve every accessor first, so the streams can be sized once and filled in parallel
+                const rapidjson::Value&   accessors = FindArray(document, "accessors") ? document["accessors"] : emptyArray;
+                std::vector<GlTFAccessor> resolved(primitives.size() * 5);
+                uint32_t                  vertex_count = 0;
+                uint32_t                  index_count  = 0;
+                uint32_t                  kept         = 0;
+                result.submeshes.resize(primitives.size());
+                for (size_t i = 0; i < primitives.size(); i++) {
+                    const GlTFPrimitive& primitive = primitives[i];
+                    GlTFAccessor*        streams   = &resolved[size_t(kept) * 5];
+
+                    bool valid = ResolveAccessor(accessors, bufferViews, buffers, primitive.position, streams[0]) && streams[0].components == 3;
+                    valid      = valid && (primitive.normal < 0 || (ResolveAccessor(accessors, bufferViews, buffers, primitive.normal, streams[1]) && streams[1].count == streams[0].count && streams[1].components == 3));
+                    valid      = valid && (primitive.tangent < 0 || (ResolveAccessor(accessors, bufferViews, buffers, primitive.tangent, streams[2]) && streams[2].count == streams[0].count && streams[2].components == 4));
+                    valid      = valid && (primitive.texcoord < 0 || (ResolveAccessor(accessors, bufferViews, buffers, primitive.texcoord, streams[3]) && streams[3].count == streams[0].count && streams[3].components == 2));
+                    valid      = valid && (primitive.indices < 0 || (ResolveAccessor(accessors, bufferViews, buffers, primitive.indices, streams[4]) && streams[4].components == 1 && streams[4].componentType != GLTF_COMPONENT_FLOAT));
+                    if (!valid) {
+                        RAZIX_PACKER_LOG_ERROR("Invalid or unsupported accessors in primitive : " << primitive.name);
+                        return false;
+                    }
+                    // Triangle lists only, a partial triangle would read past the submesh's indices
+                    uint32_t primitiveIndexCount = primitive.indices < 0 ? streams[0].count : streams[4].count;
+                    if (primitiveIndexCount % 3 != 0) {
+                        RAZIX_PACKER_LOG_ERROR("Index count of primitive " << primitive.name << " is not a multiple of 3 : " << primitiveIndexCount);
+                        return false;
+                    }
+                    // Nothing to draw, it would only widen the bounds of the model
+                    if (streams[0].count == 0 || primitiveIndexCount == 0) {
+                        RAZIX_PACKER_LOG_WARNING("Skipping empty primitive : " << primitive.name);
+                        continue;
+                    }
+
+                    // The kept primitives are compacted, their accessors were resolved in place
+                    if (kept != i)
+                        primitives[kept] = primitives[i];
+                    auto& submesh = result.submeshes[kept++];
+                    strcpy_s(submesh.name, primitive.name.c_str());
+                    submesh.material_index = primitive.material;
+                    submesh.materialName   = result.materials[submesh.material_index].m_Name;
+                    submesh.vertex_count   = streams[0].count;
+                    submesh.index_count    = primitiveIndexCount;
+                    submesh.base_index     = index_count;
+
+                    index_count += submesh.index_count;
+                }
+
+                if (!kept) {
+                    RAZIX_PACKER_LOG_ERROR("No meshes in model : " << meshFilePath);
+                    return false;
+                }
+                primitives.resize(kept);
+                result.submeshes.resize(kept);
+
+                // Generated tangents split the vertices on mirrored UV seams, the copies are counted first so the streams are sized once
+                std::vector<uint32_t> mirroredVertices(primitives.size(), 0);
+                auto                  countMirroredJob = [&](uint32_t i) {
+                    if (primitives[i].tangent >= 0 || primitives[i].texcoord < 0)
+                        return;
+                    const auto&            submesh = result.submeshes[i];
+                    const GlTFAccessor*    streams = &resolved[size_t(i) * 5];
+                    std::vector<glm::vec2> uvs(submesh.vertex_count);
+                    std::vector<uint32_t>  indices(submesh.index_count);
+                    ReadFloats(streams[3], 2, &uvs[0].x);
+                    if (primitives[i].indices >= 0)
+                        ReadIndices(streams[4], indices.data());
+                    else {
+                        for (uint32_t k = 0; k < submesh.index_count; k++)
+                            indices[k] = k;
+                    }
+                    // Flipping V mirrors every triangle, so the count is the same either way
+                    mirroredVertices[i] = CountMirroredVertices(uvs.data(), submesh.vertex_count, indices.data(), submesh.index_count);
+                };
+                if (options.jobSystem)
+                    options.jobSystem->parallelFor(static_cast<uint32_t>(primitives.size()), countMirroredJob);
+                else {
+                    for (uint32_t i = 0; i < primitives.size(); i++)
+                        countMirroredJob(i);
+                }
+                for (size_t i = 0; i < primitives.size(); i++) {
+                    auto& submesh = result.submeshes[i];
+                    submesh.vertex_count += mirroredVertices[i];
+                    submesh.base_vertex = vertex_count;
+                    vertex_count += submesh.vertex_count;
+                }
+
+                result.vertices.setSize(vertex_count);
+                result.tangent_signs.resize(vertex_count);
+                result.indices.resize(index_count);
+
+                // Every primitive fills it's own range of the streams
+                std::vector<uint8_t> converted(primitives.size(), 0);
+                auto                 convertJob = [&](uint32_t i) {
+                    RAZIX_PACKER_PROFILE_ZONE("Convert Primitive");
+                    auto&               submesh   = result.submeshes[i];
+                    const GlTFAccessor* streams   = &resolved[size_t(i) * 5];
+                    glm::vec3*          positions = result.vertices.Position.data() + submesh.base_vertex;
+                    glm::vec3*          normals   = result.vertices.Normal.data() + submesh.base_vertex;
+                    glm::vec3*          tangents  = result.vertices.Tangent.data() + submesh.base_vertex;
+                    float*              signs     = result.tangent_signs.data() + submesh.base_vertex;
+                    glm::vec2*          uvs       = result.vertices.UV.data() + submesh.base_vertex;
+                    uint32_t*           indices   = result.indices.data() + submesh.base_index;
+                    uint32_t            count     = streams[0].count;
+
+                    ReadFloats(streams[0], 3, &positions[0].x);
+
+                    if (primitives[i].indices >= 0) {
+                        ReadIndices(streams[4], indices);
+                        for (uint32_t k = 0; k < submesh.index_count; k++) {
+                            if (indices[k] >= count)
+                                return;
+                        }
+                    } else {
+                        for (uint32_t k = 0; k < submesh.index_count; k++)
+                            indices[k] = k;
+                    }
+
+                    if (primitives[i].texcoord >= 0) {
+                        ReadFloats(streams[3], 2, &uvs[0].x);
+                        // The Assimp glTF importer flips V, flipUVs undoes it
+                        if (!options.flipUVs) {
+                            for (uint32_t k = 0; k < count; k++)
+                                uvs[k].y = 1.0f - uvs[k].y;
+                        }
+                    }
+
+                    if (primitives[i].normal >= 0)
+                        ReadFloats(streams[1], 3, &normals[0].x);
+                    else
+                        GenerateSmoothNormals(positions, count, indices, submesh.index_count, normals);
+
+                    // MikkTSpace needs a tangent space per UV orientation, the copies go after the vertices of the accessors
+                    if (primitives[i].tangent < 0 && primitives[i].texcoord >= 0) {
+                        std::vector<uint32_t> sources;
+                        SplitMirroredVertices(uvs, count, indices, submesh.index_count, sources);
+                        CopySplitVertices(result.vertices, submesh.base_vertex, count, sources);
+                    }
+
+                    if (primitives[i].tangent >= 0) {
+                        // xyz is the tangent and w the handedness of the bitangent, kept as the sign like the Assimp path
+                        std::vector<glm::vec4> tangents4(count);
+                        ReadFloats(streams[2], 4, reinterpret_cast<float*>(tangents4.data()));
+                        for (uint32_t k = 0; k < count; k++) {
+                            tangents[k] = glm::vec3(tangents4[k].x, tangents4[k].y, tangents4[k].z);
+                            signs[k]    = tangents4[k].w < 0.0f ? -1.0f : 1.0f;
+                        }
+                    } else
+                        GenerateTangents(positions, normals, primitives[i].texcoord >= 0 ? uvs : nullptr, submesh.vertex_count, indices, submesh.index_count, tangents, signs);
+
+                    ComputeBounds(positions, count, submesh.min_extents, submesh.max_extents);
+                    converted[i] = 1;
+                };
+                if (options.jobSystem)
+                    options.jobSystem->parallelFor(static_cast<uint32_t>(primitives.size()), convertJob);
+                else {
+                    for (uint32_t i = 0; i < primitives.size(); i++)
+                        convertJob(i);
+                }
+
+                for (size_t i = 0; i < primitives.size(); i++) {
+                    if (!converted[i]) {
+                        RAZIX_PACKER_LOG_ERROR("Out of range vertex index in primitive : " << primitives[i].name);
+                        return false;
+                    }
+
+                    const auto& submesh = result.submeshes[i];
+                    if (i == 0) {
+                        result.min_extents = submesh.min_extents;
+                        result.max_extents = submesh.max_extents;
+                    } else {
+                        result.min_extents = glm::min(result.min_extents, submesh.min_extents);
+                        result.max_extents = glm::max(result.max_extents, submesh.max_extents);
+                    }
+                }
+
+                // Hierarchy of the default scene, or of every node without a parent when the file has no scene
+                std::vector<std::vector<uint32_t>> meshSubMeshes(meshes ? meshes->Size() : 0);
+                for (uint32_t i = 0; i < primitives.size(); i++)
+                    meshSubMeshes[primitives[i].mesh].push_back(i);
+
+                const rapidjson::Value& nodes  = FindArray(document, "nodes") ? document["nodes"] : emptyArray;
+                const rapidjson::Value* scenes = FindArray(document, "scenes");
+                int                     scene  = std::max(GetIndex(document, "scene"), 0);
+
+                rapidjson::Document rootChildren(rapidjson::kArrayType);
+                if (scenes && scene < int(scenes->Size()) && FindArray((*scenes)[scene], "nodes"))
+                    rootChildren.CopyFrom((*scenes)[scene]["nodes"], rootChildren.GetAllocator());
+                else {
+                    std::vector<bool> isChild(nodes.Size(), false);
+                    for (uint32_t i = 0; i < nodes.Size(); i++) {
+                        const rapidjson::Value* children = FindArray(nodes[i], "children");
+                        for (uint32_t c = 0; children && c < children->Size(); c++) {
+                            if ((*children)[c].IsUint() && (*children)[c].GetUint() < nodes.Size())
+                                isChild[(*children)[c].GetUint()] = true;
+                        }
+                    }
+                    for (uint32_t i = 0; i < nodes.Size(); i++) {
+                        if (!isChild[i])
+                            rootChildren.PushBack(i, rootChildren.GetAllocator());
+                    }
+                }
+
+                result.hierarchy.reserve(nodes.Size() + 1);
+                uint32_t root = result.hierarchy.addNode(meshName, MESH_HIERARCHY_NO_PARENT);
+                ExtractHierarchy(result.hierarchy, root, nodes, rootChildren, meshSubMeshes, 0);
+
+                auto                          finish = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> time   = finish - start;
+
+                RAZIX_PACKER_LOG_INFO("Successfully Imported mesh (" << result.submeshes.size() << " submeshes, " << vertex_count << " vertices) in " << time.count() << " seconds");
+                return true;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
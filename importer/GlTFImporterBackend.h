@@ -0,0 +1,29 @@
+#pragma once
+
+#include "MeshImporterBackend.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Imports glTF 2.0 .gltf/.glb files without building an Assimp scene
+             *
+             * .glb files are memory mapped and the binary chunk is read in place, external .bin buffers are mapped and base64
+             * data URIs decoded in parallel on the MeshImportOptions job system. Every triangle primitive becomes a submesh and it's
+             * accessors are converted straight into the RZVertex streams, tightly packed float accessors with a single block copy.
+             * Materials get the combined metallic-roughness mapping of MeshImporter::readMaterial and UVs are flipped like the
+             * Assimp glTF importer does, so switching the backend doesn't change the exported assets.
+             * Sparse accessors, non triangle primitives and required extensions fail the import, Auto then falls back to Assimp
+             */
+            class GlTFImporterBackend final : public MeshImporterBackend
+            {
+            public:
+                const char* getName() const override { return "glTF"; }
+                bool        canImport(const std::string& extension) const override { return extension == "gltf" || extension == "glb"; }
+                bool        importMesh(const std::string& meshFilePath, MeshImportResult& result, const MeshImportOptions& options) override;
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,227 @@
+#include "ImportUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <meshoptimizer.h>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            std::string ResolveTexturePath(const std::string& modelDirectory, std::string texturePath)
+            {
+                std::replace(texturePath.begin(), texturePath.end(), '\\', '/');
+
+                if (texturePath.size() > 1 && texturePath[0] == '.' && texturePath[1] == '/')
+                    texturePath = texturePath.substr(2, texturePath.length() - 1);
+
+                return modelDirectory + texturePath;
+            }
+
+            void GenerateSmoothNormals(const glm::vec3* positions, uint32_t verticesCount, const uint32_t* indices, uint32_t indicesCount, glm::vec3* normals)
+            {
+                // Vertices split by a UV seam or another attribute share the position, they are smoothed together like Assimp's SpatialSort does
+                std::vector<uint32_t> shadow(indicesCount);
+                meshopt_generateShadowIndexBuffer(shadow.data(), indices, indicesCount, positions, verticesCount, sizeof(glm::vec3), sizeof(glm::vec3));
+
+                std::vector<uint32_t> representative(verticesCount);
+                for (uint32_t i = 0; i < verticesCount; i++)
+                    representative[i] = i;
+                for (uint32_t i = 0; i < indicesCount; i++)
+                    representative[indices[i]] = shadow[i];
+
+                std::fill(normals, normals + verticesCount, glm::vec3(0.0f));
+
+                // The cross product isn't normalized, so bigger triangles weight more
+                for (uint32_t i = 0; i + 2 < indicesCount; i += 3) {
+                    uint32_t  i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+                    glm::vec3 n  = glm::cross(positions[i1] - positions[i0], positions[i2] - positions[i0]);
+                    normals[shadow[i]] += n;
+                    normals[shadow[i + 1]] += n;
+                    normals[shadow[i + 2]] += n;
+                }
+
+                // A representative is the first vertex with the position in index order, it may come after the vertices copying it
+                for (uint32_t i = 0; i < verticesCount; i++) {
+                    if (representative[i] != i)
+                        continue;
+                    float l    = glm::length(normals[i]);
+                    normals[i] = l > 0.0f ? normals[i] / l : glm::vec3(0.0f, 1.0f, 0.0f);
+                }
+                for (uint32_t i = 0; i < verticesCount; i++) {
+                    if (representative[i] != i)
+                        normals[i] = normals[representative[i]];
+                }
+            }
+
+            // Unit vector orthogonal to n, the tangent of vertices whose triangles have no UV derivatives
+            static glm::vec3 AnyOrthogonal(const glm::vec3& n)
+            {
+                glm::vec3 axis = std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+                glm::vec3 t    = axis - n * glm::dot(n, axis);
+                float     l    = glm::length(t);
+                return l > 0.0f ? t / l : glm::vec3(1.0f, 0.0f, 0.0f);
+            }
+
+            int GetUVOrientation(const glm::vec2& uv0, const glm::vec2& uv1, const glm::vec2& uv2)
+            {
+                glm::vec2 d1  = uv1 - uv0;
+                glm::vec2 d2  = uv2 - uv0;
+                float     det = d1.x * d2.y - d2.x * d1.y;
+                return det > 0.0f ? 1 : det < 0.0f ? -1 : 0;
+            }
+
+            // Bit 0 for a preserving corner, bit 1 for a mirrored one, a vertex with both is split
+            static void MarkCornerOrientations(const glm::vec2* uvs, uint32_t verticesCount, const uint32_t* indices, uint32_t indicesCount, std::vector<uint8_t>& orientations)
+            {
+                orientations.assign(verticesCount, 0);
+                for (uint32_t i = 0; i + 2 < indicesCount; i += 3) {
+                    uint32_t i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+                    if (i0 >= verticesCount || i1 >= verticesCount || i2 >= verticesCount)
+                        continue;
+                    int orientation = GetUVOrientation(uvs[i0], uvs[i1], uvs[i2]);
+                    if (!orientation)
+                        continue;
+                    uint8_t bit = orientation > 0 ? 1 : 2;
+                    orientations[i0] |= bit;
+                    orientations[i1] |= bit;
+                    orientations[i2] |= bit;
+                }
+            }
+
+            uint32_t CountMirroredVertices(const glm::vec2* uvs, uint32_t verticesCount, const uint32_t* indices, uint32_t indicesCount)
+            {
+                std::vector<uint8_t> orientations;
+                MarkCornerOrientations(uvs, verticesCount, indices, indicesCount, orientations);
+                return static_cast<uint32_t>(std::count(orientations.begin(), orientations.end(), uint8_t(3)));
+            }
+
+            uint32_t SplitMirroredVertices(const glm::vec2* uvs, uint32_t verticesCount, uint32_t* indices, uint32_t indicesCount, std::vector<uint32_t>& sources)
+            {
+                std::vector<uint8_t> orientations;
+                MarkCornerOrientations(uvs, verticesCount, indices, indicesCount, orientations);
+
+                // The copies are numbered in vertex order, so the count matches CountMirroredVertices and the split is deterministic
+                sources.clear();
+                std::vector<uint32_t> copies(verticesCount, ~0u);
+                for (uint32_t v = 0; v < verticesCount; v++) {
+                    if (orientations[v] != 3)
+                        continue;
+                    copies[v] = verticesCount + static_cast<uint32_t>(sources.size());
+                    sources.push_back(v);
+                }
+                if (sources.empty())
+                    return verticesCount;
+
+                for (uint32_t i = 0; i + 2 < indicesCount; i += 3) {
+                    uint32_t* corners = indices + i;
+                    if (corners[0] >= verticesCount || corners[1] >= verticesCount || corners[2] >= verticesCount || GetUVOrientation(uvs[corners[0]], uvs[corners[1]], uvs[corners[2]]) >= 0)
+                        continue;
+                    for (uint32_t c = 0; c < 3; c++) {
+                        if (copies[corners[c]] != ~0u)
+                            corners[c] = copies[corners[c]];
+                    }
+                }
+                return verticesCount + static_cast<uint32_t>(sources.size());
+            }
+
+            void CopySplitVertices(Razix::Graphics::RZVertex& vertices, uint32_t offset, uint32_t verticesCount, const std::vector<uint32_t>& sources)
+            {
+                ForEachVertexStream(vertices, [&](auto& stream) {
+                    if (stream.size() < size_t(offset) + verticesCount + sources.size())
+                        return;
+                    for (size_t k = 0; k < sources.size(); k++)
+                        stream[offset + verticesCount + k] = stream[offset + sources[k]];
+                });
+            }
+
+            void GenerateTangents(const glm::vec3* positions, const glm::vec3* normals, const glm::vec2* uvs, uint32_t verticesCount, const uint32_t* indices, uint32_t indicesCount, glm::vec3* tangents, float* signs)
+            {
+                std::fill(tangents, tangents + verticesCount, glm::vec3(0.0f));
+                std::fill(signs, signs + verticesCount, 1.0f);
+
+                for (uint32_t i = 0; uvs && i + 2 < indicesCount; i += 3) {
+                    uint32_t  corners[3] = {indices[i], indices[i + 1], indices[i + 2]};
+                    glm::vec3 e1         = positions[corners[1]] - positions[corners[0]];
+                    glm::vec3 e2         = positions[corners[2]] - positions[corners[0]];
+                    glm::vec2 d1         = uvs[corners[1]] - uvs[corners[0]];
+                    glm::vec2 d2         = uvs[corners[2]] - uvs[corners[0]];
+
+                    int orientation = GetUVOrientation(uvs[corners[0]], uvs[corners[1]], uvs[corners[2]]);
+                    if (!orientation)
+                        continue;
+
+                    // Only the direction matters, MikkTSpace normalizes the triangle tangent before it's accumulated, so the UV area only gives the sign
+                    glm::vec3 t = (e1 * d2.y - e2 * d1.y) * float(orientation);
+
+                    for (uint32_t c = 0; c < 3; c++) {
+                        uint32_t         v = corners[c];
+                        const glm::vec3& n = normals[v];
+
+                        // Split vertices only have corners of one orientation, it's the handedness of their tangent space
+                        if (orientation < 0)
+                            signs[v] = -1.0f;
+
+                        // Every corner contributes the face tangent projected on the plane of it's vertex normal, weighted by the corner angle
+                        glm::vec3 edge0 = positions[corners[(c + 1) % 3]] - positions[v];
+                        glm::vec3 edge1 = positions[corners[(c + 2) % 3]] - positions[v];
+                        float     l0    = glm::length(edge0);
+                        float     l1    = glm::length(edge1);
+                        if (l0 <= 0.0f || l1 <= 0.0f)
+                            continue;
+                        float angle = std::acos(std::min(std::max(glm::dot(edge0, edge1) / (l0 * l1), -1.0f), 1.0f));
+
+                        glm::vec3 tp = t - n * glm::dot(n, t);
+                        float     lt = glm::length(tp);
+                        if (lt > 0.0f)
+                            tangents[v] += tp * (angle / lt);
+                    }
+                }
+
+                // The accumulated tangents are already in the tangent plane, projecting again only removes the rounding
+                for (uint32_t i = 0; i < verticesCount; i++) {
+                    const glm::vec3& n = normals[i];
+                    glm::vec3        t = tangents[i] - n * glm::dot(n, tangents[i]);
+                    float            l = glm::length(t);
+                    tangents[i]        = l > 1e-12f ? t / l : AnyOrthogonal(n);
+                }
+            }
+
+            // x, y and z are the unit axes of a rotation matrix
+            static glm::quat RotationFromAxes(const glm::vec3& x, const glm::vec3& y, const glm::vec3& z)
+            {
+                float trace = x.x + y.y + z.z;
+                if (trace > 0.0f) {
+                    float s = 0.5f / std::sqrt(trace + 1.0f);
+                    return glm::quat(0.25f / s, (y.z - z.y) * s, (z.x - x.z) * s, (x.y - y.x) * s);
+                } else if (x.x > y.y && x.x > z.z) {
+                    float s = 2.0f * std::sqrt(1.0f + x.x - y.y - z.z);
+                    return glm::quat((y.z - z.y) / s, 0.25f * s, (y.x + x.y) / s, (z.x + x.z) / s);
+                } else if (y.y > z.z) {
+                    float s = 2.0f * std::sqrt(1.0f + y.y - x.x - z.z);
+                    return glm::quat((z.x - x.z) / s, (y.x + x.y) / s, 0.25f * s, (z.y + y.z) / s);
+                } else {
+                    float s = 2.0f * std::sqrt(1.0f + z.z - x.x - y.y);
+                    return glm::quat((x.y - y.x) / s, (z.x + x.z) / s, (z.y + y.z) / s, 0.25f * s);
+                }
+            }
+
+            void DecomposeTransform(const double* matrix, glm::vec3& translation, glm::quat& rotation, glm::vec3& scale)
+            {
+                glm::vec3 x = glm::vec3(float(matrix[0]), float(matrix[1]), float(matrix[2]));
+                glm::vec3 y = glm::vec3(float(matrix[4]), float(matrix[5]), float(matrix[6]));
+                glm::vec3 z = glm::vec3(float(matrix[8]), float(matrix[9]), float(matrix[10]));
+
+                translation = glm::vec3(float(matrix[12]), float(matrix[13]), float(matrix[14]));
+                scale       = glm::vec3(glm::length(x), glm::length(y), glm::length(z));
+                if (glm::dot(glm::cross(x, y), z) < 0.0f)
+                    scale.x = -scale.x;
+
+                if (scale.x != 0.0f && scale.y != 0.0f && scale.z != 0.0f)
+                    rotation = RotationFromAxes(x / scale.x, y / scale.y, z / scale.z);
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
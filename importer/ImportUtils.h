@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "common/intermediate_types.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Helpers shared by the native importer backends to match what the Assimp post processing steps produce
+             */
+
+            /* Same resolution as MeshImporter::findTexurePath: back slashes become slashes, a leading ./ is dropped and the model directory is prepended */
+            std::string ResolveTexturePath(const std::string& modelDirectory, std::string texturePath);
+
+            /* Area weighted vertex normals of an indexed triangle list, vertices at the same position are smoothed together like aiProcess_GenSmoothNormals */
+            void GenerateSmoothNormals(const glm::vec3* positions, uint32_t verticesCount, const uint32_t* indices, uint32_t indicesCount, glm::vec3* normals);
+
+            /* Orientation of the UV mapping of a triangle like MikkTSpace: 1 if it's preserved, -1 if it's mirrored, 0 without UV area */
+            int GetUVOrientation(const glm::vec2& uv0, const glm::vec2& uv1, const glm::vec2& uv2);
+
+            /* Vertices referenced by triangles of both UV orientations (a mirrored UV seam), the copies SplitMirroredVertices appends */
+            uint32_t CountMirroredVertices(const glm::vec2* uvs, uint32_t verticesCount, const uint32_t* indices, uint32_t indicesCount);
+
+            /**
+             * A MikkTSpace tangent space has the handedness of the triangles using it, so a vertex shared by both UV orientations needs two
+             * The mirrored corners of such a vertex are moved to a copy appended after verticesCount, sources receives the vertex every copy
+             * was made from so the caller can duplicate the other streams. Returns the vertices count after the split
+             */
+            uint32_t SplitMirroredVertices(const glm::vec2* uvs, uint32_t verticesCount, uint32_t* indices, uint32_t indicesCount, std::vector<uint32_t>& sources);
+
+            /* Appends the copies made by SplitMirroredVertices to every stream of the range starting at offset, verticesCount is the count before the split */
+            void CopySplitVertices(Razix::Graphics::RZVertex& vertices, uint32_t offset, uint32_t verticesCount, const std::vector<uint32_t>& sources);
+
+            /**
+             * MikkTSpace tangents of an indexed triangle list, replaces aiProcess_CalcTangentSpace
+             * Every corner contributes the direction of increasing U of it's triangle projected on the plane of the vertex normal, weighted
+             * by the corner angle, and the vertex gets the handedness of the UV orientation of it's triangles (bitangent = sign * cross(normal,
+             * tangent)). The vertices must be split with SplitMirroredVertices first, triangles without UV area join any tangent space like
+             * MikkTSpace does. Vertices without UV derivatives (or uvs == nullptr) get any tangent orthogonal to their normal
+             */
+            void GenerateTangents(const glm::vec3* positions, const glm::vec3* normals, const glm::vec2* uvs, uint32_t verticesCount, const uint32_t* indices, uint32_t indicesCount, glm::vec3* tangents, float* signs);
+
+            /* Column major affine matrix to the TRS of a node, a mirroring matrix gets a negative x scale */
+            void DecomposeTransform(const double* matrix, glm::vec3& translation, glm::quat& rotation, glm::vec3& scale);
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -1,9 +1,13 @@
 #include "MeshImporter.h"
 
+#include <algorithm>
+#include <cctype>
 #include <chrono>
-#include <iostream>
+#include <cstring>
+#include <filesystem>
 
 #include <assimp/Importer.hpp>
+#include <assimp/config.h>
 #include <assimp/material.h>
 #include <assimp/pbrmaterial.h>
 #include <assimp/postprocess.h>
@@ -11,6 +15,15 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "common/job_system.h"
+#include "common/log.h"
+#include "common/profiler.h"
+#include "common/vertex_simd.h"
+
+#include "ImportUtils.h"
+
+static_assert(sizeof(aiVector3D) == sizeof(glm::vec3), "Vertex streams are block copied from assimp");
+
 std::string GetFilePathExtension(const std::string& FileName)
 {
     auto pos = FileName.find_last_of('.');
@@ -47,250 +60,710 @@ namespace Razix {
     namespace Tool {
         namespace AssetPacker {
 
+            static uint64_t GetElapsedNs(std::chrono::high_resolution_clock::time_point start)
+            {
+                auto finish = std::chrono::high_resolution_clock::now();
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+            }
+
+            // Constructing an importer registers every loader and post process step, a long running packer (see AssetWatcher)
+            // would pay it for every model. The scene is orphaned after the read, so the importer keeps nothing between models
+            static Assimp::Importer& GetThreadAssimpImporter()
+            {
+                thread_local Assimp::Importer importer;
+                return importer;
+            }
+
+            const char* GetMeshImportPresetName(MeshImportPreset preset)
+            {
+                switch (preset) {
+                    case MeshImportPreset::Fast: return "fast";
+                    case MeshImportPreset::Balanced: return "balanced";
+                    case MeshImportPreset::Full: return "full";
+                }
+                return "unknown";
+            }
+
+            // Generated tangents split the vertices on mirrored UV seams (see SplitMirroredVertices), authored ones are kept as they are
+            static bool GeneratesTangents(const aiMesh* mesh)
+            {
+                return !mesh->mTangents && mesh->HasTextureCoords(0);
+            }
+
+            // The copies ConvertMesh appends, so the layout can size the submesh before it's converted
+            static uint32_t CountMeshMirroredVertices(const aiMesh* mesh)
+            {
+                if (!GeneratesTangents(mesh))
+                    return 0;
+
+                std::vector<glm::vec2> uvs(mesh->mNumVertices);
+                for (uint32_t k = 0; k < mesh->mNumVertices; k++)
+                    uvs[k] = glm::vec2(mesh->mTextureCoords[0][k].x, mesh->mTextureCoords[0][k].y);
+                std::vector<uint32_t> indices(size_t(mesh->mNumFaces) * 3);
+                for (uint32_t j = 0; j < mesh->mNumFaces; j++) {
+                    indices[j * 3 + 0] = mesh->mFaces[j].mIndices[0];
+                    indices[j * 3 + 1] = mesh->mFaces[j].mIndices[1];
+                    indices[j * 3 + 2] = mesh->mFaces[j].mIndices[2];
+                }
+                return CountMirroredVertices(uvs.data(), mesh->mNumVertices, indices.data(), static_cast<uint32_t>(indices.size()));
+            }
+
+            // Copies the streams and the indices of an assimp mesh, vertices and indices point to the range of the submesh
+            // Normals and tangents the mesh doesn't have are generated here instead of by Assimp, so they run per submesh on the job system
+            // splitSources receives the source of every vertex appended after mNumVertices for the generated tangents
+            static void ConvertMesh(const aiMesh* mesh, Razix::Graphics::RZVertex& vertices, float* tangentSigns, uint32_t vertexOffset, uint32_t* indices, SubMesh& submesh, std::vector<uint32_t>& splitSources, MeshImportTimings& timings)
+            {
+                auto start = std::chrono::high_resolution_clock::now();
+
+                // Read vertex data
+                // aiVector3D and glm::vec3 are both packed floats, so the 3 component streams are block copied
+                uint32_t numVerts = mesh->mNumVertices;
+                memcpy(static_cast<void*>(vertices.Position.data() + vertexOffset), mesh->mVertices, numVerts * sizeof(glm::vec3));
+                if (mesh->mNormals)
+                    memcpy(static_cast<void*>(vertices.Normal.data() + vertexOffset), mesh->mNormals, numVerts * sizeof(glm::vec3));
+                if (mesh->mTangents)
+                    memcpy(static_cast<void*>(vertices.Tangent.data() + vertexOffset), mesh->mTangents, numVerts * sizeof(glm::vec3));
+
+                // UVs are 3 component in assimp, the loop is still a strided copy without any branch
+                if (mesh->HasTextureCoords(0)) {
+                    const aiVector3D* uvs = mesh->mTextureCoords[0];
+                    glm::vec2*        dst = vertices.UV.data() + vertexOffset;
+                    for (uint32_t k = 0; k < numVerts; k++)
+                        dst[k] = glm::vec2(uvs[k].x, uvs[k].y);
+                }
+
+                ComputeBounds(vertices.Position.data() + vertexOffset, numVerts, submesh.min_extents, submesh.max_extents);
+
+                // Read the index data
+                uint32_t* meshIndices = indices;
+                for (uint32_t j = 0; j < mesh->mNumFaces; j++) {
+                    *indices++ = mesh->mFaces[j].mIndices[0];
+                    *indices++ = mesh->mFaces[j].mIndices[1];
+                    *indices++ = mesh->mFaces[j].mIndices[2];
+                }
+                uint32_t numIndices = static_cast<uint32_t>(indices - meshIndices);
+
+                timings.convertNs += GetElapsedNs(start);
+
+                const glm::vec3* positions = vertices.Position.data() + vertexOffset;
+                glm::vec3*       normals   = vertices.Normal.data() + vertexOffset;
+                glm::vec3*       tangents  = vertices.Tangent.data() + vertexOffset;
+                float*           signs     = tangentSigns + vertexOffset;
+
+                if (!mesh->mNormals) {
+                    start = std::chrono::high_resolution_clock::now();
+                    GenerateSmoothNormals(positions, numVerts, meshIndices, numIndices, normals);
+                    timings.normalsNs += GetElapsedNs(start);
+                }
+
+                // MikkTSpace needs a tangent space per UV orientation, the layout reserved the copies after the mesh's vertices
+                // The normals are generated before, so both sides of a mirrored seam keep the same smooth normal
+                splitSources.clear();
+                if (GeneratesTangents(mesh)) {
+                    start    = std::chrono::high_resolution_clock::now();
+                    numVerts = SplitMirroredVertices(vertices.UV.data() + vertexOffset, numVerts, meshIndices, numIndices, splitSources);
+                    CopySplitVertices(vertices, vertexOffset, mesh->mNumVertices, splitSources);
+                    timings.tangentsNs += GetElapsedNs(start);
+                }
+
+                start = std::chrono::high_resolution_clock::now();
+                if (mesh->mTangents) {
+                    // @NOTE: Assuming right handed coordinate space
+                    const glm::vec3* bitangents = reinterpret_cast<const glm::vec3*>(mesh->mBitangents);
+                    if (bitangents)
+                        ComputeTangentSigns(normals, bitangents, tangents, signs, numVerts);
+                    else
+                        std::fill(signs, signs + numVerts, 1.0f);
+                } else
+                    GenerateTangents(positions, normals, mesh->HasTextureCoords(0) ? vertices.UV.data() + vertexOffset : nullptr, numVerts, meshIndices, numIndices, tangents, signs);
+                timings.tangentsNs += GetElapsedNs(start);
+            }
+
+            // Keeps the MAX_BONE_INFLUENCES biggest weights of every vertex and renormalizes them, returns how many vertices had more
+            // Vertices without any weight are bound to the root bone, so they follow the model instead of collapsing to the origin
+            static uint32_t ConvertBoneWeights(const aiMesh* mesh, const std::unordered_map<std::string, uint32_t>& boneLookup, glm::uvec4* boneIndices, glm::vec4* boneWeights)
+            {
+                uint32_t             numVerts = mesh->mNumVertices;
+                std::vector<uint8_t> influences(numVerts, 0);
+                for (uint32_t k = 0; k < numVerts; k++) {
+                    boneIndices[k] = glm::uvec4(0u);
+                    boneWeights[k] = glm::vec4(0.0f);
+                }
+
+                for (uint32_t b = 0; b < mesh->mNumBones; b++) {
+                    const aiBone* bone = mesh->mBones[b];
+                    auto          it   = boneLookup.find(bone->mName.C_Str());
+                    if (it == boneLookup.end())
+                        continue;
+
+                    for (uint32_t w = 0; w < bone->mNumWeights; w++) {
+                        const aiVertexWeight& weight = bone->mWeights[w];
+                        if (weight.mVertexId >= numVerts || weight.mWeight <= 0.0f)
+                            continue;
+
+                        if (influences[weight.mVertexId] < 255)
+                            influences[weight.mVertexId]++;
+
+                        // Insertion sort from the biggest weight, the smallest one falls off the end
+                        glm::uvec4& ids     = boneIndices[weight.mVertexId];
+                        glm::vec4&  weights = boneWeights[weight.mVertexId];
+                        if (weight.mWeight <= weights[MAX_BONE_INFLUENCES - 1])
+                            continue;
+
+                        uint32_t slot = MAX_BONE_INFLUENCES - 1;
+                        while (slot > 0 && weights[slot - 1] < weight.mWeight) {
+                            weights[slot] = weights[slot - 1];
+                            ids[slot]     = ids[slot - 1];
+                            slot--;
+                        }
+                        weights[slot] = weight.mWeight;
+                        ids[slot]     = it->second;
+                    }
+                }
+
+                uint32_t truncated = 0;
+                for (uint32_t k = 0; k < numVerts; k++) {
+                    if (influences[k] > MAX_BONE_INFLUENCES)
+                        truncated++;
+
+                    float sum = boneWeights[k].x + boneWeights[k].y + boneWeights[k].z + boneWeights[k].w;
+                    if (sum > 0.0f)
+                        boneWeights[k] /= sum;
+                    else {
+                        boneIndices[k] = glm::uvec4(0u);
+                        boneWeights[k] = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+                    }
+                }
+                return truncated;
+            }
+
+            // The vertices split for the generated tangents keep the weights of the vertex they were copied from
+            static void CopySplitBoneWeights(glm::uvec4* boneIndices, glm::vec4* boneWeights, uint32_t numVerts, const std::vector<uint32_t>& splitSources)
+            {
+                for (size_t k = 0; k < splitSources.size(); k++) {
+                    boneIndices[numVerts + k] = boneIndices[splitSources[k]];
+                    boneWeights[numVerts + k] = boneWeights[splitSources[k]];
+                }
+            }
+
+            static glm::mat4 ToGlmMatrix(const aiMatrix4x4& m)
+            {
+                // assimp is row major, glm column major
+                glm::mat4 result;
+                for (uint32_t row = 0; row < 4; row++) {
+                    for (uint32_t column = 0; column < 4; column++)
+                        result[column][row] = m[row][column];
+                }
+                return result;
+            }
+
+            // A node is part of the skeleton when it's a joint or one of it's descendants is
+            static bool MarkSkeletonNodes(const aiNode* node, const std::unordered_set<std::string>& jointNames, std::unordered_set<const aiNode*>& skeletonNodes)
+            {
+                bool used = jointNames.count(node->mName.C_Str()) > 0;
+                for (uint32_t i = 0; i < node->mNumChildren; i++)
+                    used |= MarkSkeletonNodes(node->mChildren[i], jointNames, skeletonNodes);
+
+                if (used)
+                    skeletonNodes.insert(node);
+                return used;
+            }
+
+            // Depth first, so parents always come before their children
+            // Weights and channels reference nodes by name, a duplicate name resolves to the first node like aiNode::FindNode does
+            static void AddSkeletonBones(const aiNode* node, int32_t parent, const aiMatrix4x4& parentTransform, const std::unordered_set<const aiNode*>& skeletonNodes, Skeleton& skeleton, std::unordered_map<std::string, uint32_t>& boneLookup, uint32_t& duplicateNames)
+            {
+                if (!skeletonNodes.count(node))
+                    return;
+
+                aiMatrix4x4 globalTransform = parentTransform * node->mTransformation;
+
+                aiVector3D   translation, scale;
+                aiQuaternion rotation;
+                node->mTransformation.Decompose(scale, rotation, translation);
+
+                Bone bone;
+                bone.name        = node->mName.C_Str();
+                bone.parent      = parent;
+                bone.translation = glm::vec3(translation.x, translation.y, translation.z);
+                bone.rotation    = glm::quat(rotation.w, rotation.x, rotation.y, rotation.z);
+                bone.scale       = glm::vec3(scale.x, scale.y, scale.z);
+                // Skinning bones get the offset matrix of the meshes afterwards, the rest use the inverse of their bind pose
+                bone.inverseBind = ToGlmMatrix(aiMatrix4x4(globalTransform).Inverse());
+
+                // The exported names stay unique, so the engine can still find every bone by name
+                int32_t index = static_cast<int32_t>(skeleton.bones.size());
+                if (!boneLookup.emplace(bone.name, static_cast<uint32_t>(index)).second) {
+                    bone.name += "_" + std::to_string(index);
+                    duplicateNames++;
+                }
+                skeleton.bones.push_back(std::move(bone));
+
+                for (uint32_t i = 0; i < node->mNumChildren; i++)
+                    AddSkeletonBones(node->mChildren[i], index, globalTransform, skeletonNodes, skeleton, boneLookup, duplicateNames);
+            }
+
+            // AABB of the whole model from the AABBs of it's submeshes
+            static void ComputeModelBounds(MeshImportResult& result)
+            {
+                if (result.submeshes.empty())
+                    return;
+
+                result.max_extents = result.submeshes[0].max_extents;
+                result.min_extents = result.submeshes[0].min_extents;
+
+                for (const auto& submesh: result.submeshes) {
+                    result.max_extents = glm::max(result.max_extents, submesh.max_extents);
+                    result.min_extents = glm::min(result.min_extents, submesh.min_extents);
+                }
+            }
+
+            void MeshImporter::CollectTextureFiles(const std::vector<Graphics::MaterialData>& materials, std::vector<std::string>& textureFiles)
+            {
+                for (const auto& material: materials) {
+                    const auto& paths   = material.m_MaterialTexturePaths;
+                    const char* slots[] = {paths.albedo, paths.normal, paths.metallic, paths.roughness, paths.specular, paths.emissive, paths.ao, paths.metallicRoughnessAO};
+                    for (const char* slot: slots) {
+                        if (slot[0] == '\0' || slot[0] == '*')
+                            continue;
+                        std::error_code ec;
+                        textureFiles.push_back(std::filesystem::absolute(slot, ec).lexically_normal().generic_string());
+                    }
+                }
+                std::sort(textureFiles.begin(), textureFiles.end());
+                textureFiles.erase(std::unique(textureFiles.begin(), textureFiles.end()), textureFiles.end());
+            }
+
             bool MeshImporter::importMesh(const std::string& meshFilePath, MeshImportResult& result, MeshImportOptions options)
             {
-                bool isGlTF = false;
+                m_Timings = MeshImportTimings();
+                switch (importWithBackend(meshFilePath, result, options)) {
+                    case BackendImport::Imported: return true;
+                    case BackendImport::Failed: return false;
+                    case BackendImport::UseAssimp: break;
+                }
 
-                if (meshFilePath[0] == '/' && meshFilePath[1] == '/') {
-                    std::cout << "[ERROR!] Using virtual path! Please check your path and try again." << std::endl;
+                RAZIX_PACKER_LOG_VERBOSE("Importing Mesh...");
+
+                auto start = std::chrono::high_resolution_clock::now();
+
+                std::unique_ptr<aiScene> scene = readScene(GetThreadAssimpImporter(), meshFilePath, options);
+                if (!scene) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to load model");
                     return false;
                 }
+                m_Timings.readNs = GetElapsedNs(start);
 
-                std::string extension     = GetFilePathExtension(meshFilePath);
-                std::string directoryPath = GetFileLocation(meshFilePath);
-                std::string meshName      = GetFileName(meshFilePath);
-                meshName                  = RemoveFilePathExtension(meshName);
+                auto layoutStart = std::chrono::high_resolution_clock::now();
+                readSceneLayout(scene.get(), meshFilePath, options, result);
+                m_Timings.layoutNs = GetElapsedNs(layoutStart);
+
+                uint32_t vertex_count = 0;
+                uint32_t index_count  = 0;
+                if (!result.submeshes.empty()) {
+                    vertex_count = result.submeshes.back().base_vertex + result.submeshes.back().vertex_count;
+                    index_count  = result.submeshes.back().base_index + result.submeshes.back().index_count;
+                }
+
+                result.vertices.setSize(vertex_count);
+                result.tangent_signs.resize(vertex_count);
+                result.indices.resize(index_count);
+
+                // The skinning streams cover every vertex as soon as one submesh is skinned, the rest are bound to the root bone
+                bool skinned = std::any_of(result.submeshes.begin(), result.submeshes.end(), [](const SubMesh& submesh) { return submesh.skinned; });
+                if (skinned) {
+                    result.bone_indices.assign(vertex_count, glm::uvec4(0u));
+                    result.bone_weights.assign(vertex_count, glm::vec4(1.0f, 0.0f, 0.0f, 0.0f));
+                }
+
+                // Every submesh writes it's own range of the streams, the timings and counts are per submesh and summed afterwards
+                std::vector<MeshImportTimings> meshTimings(scene->mNumMeshes);
+                std::vector<uint32_t>          meshTruncatedWeights(scene->mNumMeshes, 0);
+                auto                           convertMesh = [&](uint32_t i) {
+                    RAZIX_PACKER_PROFILE_ZONE("Convert Submesh");
+                    auto&                 submesh = result.submeshes[i];
+                    std::vector<uint32_t> splitSources;
+                    ConvertMesh(scene->mMeshes[i], result.vertices, result.tangent_signs.data(), submesh.base_vertex, result.indices.data() + submesh.base_index, submesh, splitSources, meshTimings[i]);
+                    if (submesh.skinned) {
+                        auto weightsStart       = std::chrono::high_resolution_clock::now();
+                        meshTruncatedWeights[i] = ConvertBoneWeights(scene->mMeshes[i], m_BoneLookup, result.bone_indices.data() + submesh.base_vertex, result.bone_weights.data() + submesh.base_vertex);
+                        CopySplitBoneWeights(result.bone_indices.data() + submesh.base_vertex, result.bone_weights.data() + submesh.base_vertex, scene->mMeshes[i]->mNumVertices, splitSources);
+                        meshTimings[i].convertNs += GetElapsedNs(weightsStart);
+                    }
+                };
 
+                if (options.jobSystem)
+                    options.jobSystem->parallelFor(scene->mNumMeshes, convertMesh);
+                else {
+                    for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+                        convertMesh(i);
+                }
+
+                uint32_t truncatedWeights = 0;
+                for (uint32_t i = 0; i < scene->mNumMeshes; i++) {
+                    m_Timings.convertNs += meshTimings[i].convertNs;
+                    m_Timings.normalsNs += meshTimings[i].normalsNs;
+                    m_Timings.tangentsNs += meshTimings[i].tangentsNs;
+                    truncatedWeights += meshTruncatedWeights[i];
+                }
+
+                if (truncatedWeights)
+                    RAZIX_PACKER_LOG_WARNING(truncatedWeights << " vertices have more than " << MAX_BONE_INFLUENCES << " bone influences, the biggest ones are kept and renormalized");
+
+                // Find AABB for entire result.
+                ComputeModelBounds(result);
+
+                auto                          finish = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> time   = finish - start;
+
+                RAZIX_PACKER_LOG_INFO("Successfully Imported mesh in " << time.count() << " seconds");
+                return true;
+            }
+
+            bool MeshImporter::importMeshStreamed(const std::string& meshFilePath, MeshImportResult& model, const MeshChunkCallback& onChunk, MeshImportOptions options)
+            {
+                // The native backends build the whole result before a submesh could be handed out, streaming would only add copies
+                if (options.backend == MeshImporterBackendType::OpenFBX || options.backend == MeshImporterBackendType::GlTF) {
+                    RAZIX_PACKER_LOG_ERROR("The " << GetMeshImporterBackendName(options.backend) << " importer reads the whole model and can't stream, use the Assimp importer : " << meshFilePath);
+                    return false;
+                }
+                options.backend = MeshImporterBackendType::Assimp;
+
+                MeshImportResult unused;
+                m_Timings = MeshImportTimings();
+                if (importWithBackend(meshFilePath, unused, options) == BackendImport::Failed)
+                    return false;
+
+                RAZIX_PACKER_LOG_VERBOSE("Importing Mesh (streamed)...");
+
+                auto start = std::chrono::high_resolution_clock::now();
+
+                std::unique_ptr<aiScene> scene = readScene(GetThreadAssimpImporter(), meshFilePath, options);
+                if (!scene) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to load model");
+                    return false;
+                }
+                m_Timings.readNs = GetElapsedNs(start);
+
+                // Everything but the geometry is known upfront, the exporter needs the materials and the submesh count for every chunk
+                auto layoutStart = std::chrono::high_resolution_clock::now();
+                readSceneLayout(scene.get(), meshFilePath, options, model);
+                m_Timings.layoutNs = GetElapsedNs(layoutStart);
+
+                uint32_t              truncatedWeights = 0;
+                std::vector<uint32_t> splitSources;
+                for (uint32_t i = 0; i < scene->mNumMeshes; i++) {
+                    MeshImportResult chunk;
+                    chunk.name           = model.name;
+                    chunk.encodeVertices = model.encodeVertices;
+                    chunk.encodeIndices  = model.encodeIndices;
+                    chunk.submeshes      = {model.submeshes[i]};
+                    chunk.chunkIndex     = i;
+
+                    SubMesh& submesh    = chunk.submeshes[0];
+                    submesh.base_vertex = 0;
+                    submesh.base_index  = 0;
+                    chunk.vertices.setSize(submesh.vertex_count);
+                    chunk.tangent_signs.resize(submesh.vertex_count);
+                    chunk.indices.resize(submesh.index_count);
+                    ConvertMesh(scene->mMeshes[i], chunk.vertices, chunk.tangent_signs.data(), 0, chunk.indices.data(), submesh, splitSources, m_Timings);
+                    if (submesh.skinned) {
+                        auto weightsStart = std::chrono::high_resolution_clock::now();
+                        chunk.bone_indices.resize(submesh.vertex_count);
+                        chunk.bone_weights.resize(submesh.vertex_count);
+                        truncatedWeights += ConvertBoneWeights(scene->mMeshes[i], m_BoneLookup, chunk.bone_indices.data(), chunk.bone_weights.data());
+                        CopySplitBoneWeights(chunk.bone_indices.data(), chunk.bone_weights.data(), scene->mMeshes[i]->mNumVertices, splitSources);
+                        m_Timings.convertNs += GetElapsedNs(weightsStart);
+                    }
+
+                    model.submeshes[i].min_extents = submesh.min_extents;
+                    model.submeshes[i].max_extents = submesh.max_extents;
+
+                    // The source mesh isn't needed anymore, the scene skips the released meshes when it's destroyed
+                    delete scene->mMeshes[i];
+                    scene->mMeshes[i] = nullptr;
+
+                    if (!onChunk(chunk))
+                        return false;
+                }
+
+                ComputeModelBounds(model);
+
+                if (truncatedWeights)
+                    RAZIX_PACKER_LOG_WARNING(truncatedWeights << " vertices have more than " << MAX_BONE_INFLUENCES << " bone influences, the biggest ones are kept and renormalized");
+
+                auto                          finish = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> time   = finish - start;
+
+                RAZIX_PACKER_LOG_INFO("Successfully Imported mesh in " << time.count() << " seconds (streamed)");
+                return true;
+            }
+
+            MeshImporter::BackendImport MeshImporter::importWithBackend(const std::string& meshFilePath, MeshImportResult& result, const MeshImportOptions& options)
+            {
+                if (meshFilePath[0] == '/' && meshFilePath[1] == '/') {
+                    RAZIX_PACKER_LOG_ERROR("Using virtual path! Please check your path and try again.");
+                    return BackendImport::Failed;
+                }
+
+                std::string extension = GetFilePathExtension(meshFilePath);
                 if (extension == "gltf" || extension == "glb")
                     m_IsGlTF = true;
 
+                // The native backends don't read skins and animations, so Auto goes straight to Assimp when they are requested
+                MeshImporterBackendType backendType = options.backend;
+                if (options.importSkinning) {
+                    if (backendType == MeshImporterBackendType::Auto)
+                        backendType = MeshImporterBackendType::Assimp;
+                    else if (backendType != MeshImporterBackendType::Assimp)
+                        RAZIX_PACKER_LOG_WARNING("The " << GetMeshImporterBackendName(backendType) << " importer doesn't import skinning and animations : " << meshFilePath);
+                }
+
+                // Formats with a native backend skip Assimp entirely, Auto falls back to Assimp if it fails
+                std::string lowerExtension = extension;
+                std::transform(lowerExtension.begin(), lowerExtension.end(), lowerExtension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                if (auto backend = CreateMeshImporterBackend(backendType, lowerExtension)) {
+                    auto start    = std::chrono::high_resolution_clock::now();
+                    bool imported = backend->importMesh(meshFilePath, result, options);
+                    m_Timings.readNs += GetElapsedNs(start);
+                    if (imported)
+                        return BackendImport::Imported;
+
+                    if (backendType != MeshImporterBackendType::Auto)
+                        return BackendImport::Failed;
+
+                    RAZIX_PACKER_LOG_WARNING(backend->getName() << " failed to import the model, falling back to Assimp");
+                    result = MeshImportResult();
+                }
+
+                return BackendImport::UseAssimp;
+            }
+
+            std::unique_ptr<aiScene> MeshImporter::readScene(Assimp::Importer& importer, const std::string& meshFilePath, const MeshImportOptions& options)
+            {
+                RAZIX_PACKER_PROFILE_ZONE("Assimp Read", meshFilePath.c_str());
+
                 // Let's make a bold assumption here if the model is of GLTF format it has WORLFLOW_PBR_METAL_ROUGHNESS_AO_COMBINED in BGR order
 
-                std::cout << "Importing Mesh...\n";
+                // No GenSmoothNormals/CalcTangentSpace, ConvertMesh generates what's missing per submesh in parallel and keeps the authored ones
+                uint32_t flags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices;
+                if (options.preset != MeshImportPreset::Fast) {
+                    flags |= aiProcess_GenUVCoords;
+                    // A mesh drawn by several nodes stays a single submesh, so deduplication and the hierarchy can instance it
+                    if (!options.keepInstances)
+                        flags |= aiProcess_OptimizeMeshes | aiProcess_OptimizeGraph;
+                }
+                // The importer is reused by the thread, every property is set again so the last import can't leak into this one
+                importer.SetPropertyBool(AI_CONFIG_PP_FD_REMOVE, options.preset == MeshImportPreset::Full);
+                if (options.preset == MeshImportPreset::Full) {
+                    // Degenerate triangles become lines and points otherwise, the conversion expects triangles only
+                    flags |= aiProcess_ImproveCacheLocality | aiProcess_FindDegenerates | aiProcess_FindInvalidData | aiProcess_ValidateDataStructure;
+                }
+                if (options.flipUVs)
+                    flags |= aiProcess_FlipUVs;
 
-                auto start = std::chrono::high_resolution_clock::now();
+                if (!importer.ReadFile(meshFilePath.c_str(), flags))
+                    return nullptr;
 
-                const aiScene*   scene = nullptr;
-                Assimp::Importer importer;
+                // Taking ownership lets the streamed import release the meshes one by one
+                return std::unique_ptr<aiScene>(importer.GetOrphanedScene());
+            }
 
-                scene = importer.ReadFile(meshFilePath.c_str(), aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_GenUVCoords | aiProcess_OptimizeMeshes | aiProcess_OptimizeGraph | aiProcess_ImproveCacheLocality | aiProcess_JoinIdenticalVertices);
+            void MeshImporter::readSceneLayout(const aiScene* scene, const std::string& meshFilePath, const MeshImportOptions& options, MeshImportResult& result)
+            {
+                std::string directoryPath = GetFileLocation(meshFilePath);
+                std::string meshName      = GetFileName(meshFilePath);
+                meshName                  = RemoveFilePathExtension(meshName);
 
-                if (scene) {
-                    result.name = meshName;
+                result.name           = meshName;
+                result.encodeVertices = options.encodeVertices;
+                result.encodeIndices  = options.encodeIndices;
 
-                    if (scene->mRootNode->mNumChildren) {
-                        // Now that the scene is loaded extract the Hierarchy for the Model
-                        // Print and Store in an intermediate DS
+                if (scene->mRootNode->mNumChildren) {
+                    // Now that the scene is loaded extract the Hierarchy for the Model
+                    // Print and Store in an intermediate DS
+                    if (IsLogEnabled(LogLevel::Verbose))
                         printHierarchy(scene->mRootNode, scene, 0);
 
-                        rootNode       = new Node;
-                        rootNode->name = meshName.c_str();
-                        extractHierarchy(rootNode, scene->mRootNode, scene, 0);
-                    } else {
-                        rootNode       = new Node;
-                        rootNode->name = meshName.c_str();
-                    }
+                    uint32_t root = result.hierarchy.addNode(meshName, MESH_HIERARCHY_NO_PARENT, scene->mRootNode->mMeshes, scene->mRootNode->mNumMeshes);
+                    extractHierarchy(result.hierarchy, root, scene->mRootNode);
+                } else {
+                    // Create a flat hierarchy if there's not hierarchy and a the Model has a bunch of submeshes
+                    result.hierarchy.reserve(scene->mNumMeshes + 1);
+                    uint32_t root = result.hierarchy.addNode(meshName, MESH_HIERARCHY_NO_PARENT);
+                    for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+                        result.hierarchy.addNode(scene->mMeshes[i]->mName.C_Str(), root, &i, 1);
+                }
 
-                    result.submeshes.resize(scene->mNumMeshes);
-                    result.materials.resize(scene->mNumMaterials);
+                result.submeshes.resize(scene->mNumMeshes);
+                result.materials.resize(scene->mNumMaterials);
+
+                // The skeleton is needed before the meshes are converted, their weights reference the bones by index
+                // The importer may be reused, bones of the last model must not skin this one
+                m_BoneLookup.clear();
+                if (options.importSkinning) {
+                    readSkeleton(scene, result);
+                    readAnimations(scene, result);
+                    if (!result.skeleton.bones.empty())
+                        RAZIX_PACKER_LOG_INFO("Skeleton : " << result.skeleton.bones.size() << " bones, " << result.animations.size() << " animation clips");
+                }
 
-                    uint32_t                 vertex_count = 0;
-                    uint32_t                 index_count  = 0;
-                    uint32_t                 unnamed_mats = 1;
-                    std::vector<uint32_t>    temp_indices;
-                    std::vector<std::string> texturePaths;
+                uint32_t vertex_count = 0;
+                uint32_t index_count  = 0;
 
-                    // Read the Materials
-                    for (uint32_t i = 0; i < scene->mNumMaterials; i++) {
-                        auto& material = result.materials[i];
+                // Read the Materials
+                for (uint32_t i = 0; i < scene->mNumMaterials; i++) {
+                    auto& material = result.materials[i];
 
-                        aiMaterial* assimp_material = scene->mMaterials[i];
+                    aiMaterial* assimp_material = scene->mMaterials[i];
 
-                        // Get the name of the material
-                        aiString aimat_name;
-                        assimp_material->Get(AI_MATKEY_NAME, aimat_name);
-                        std::string mat_name(aimat_name.C_Str());
+                    // Get the name of the material
+                    aiString aimat_name;
+                    assimp_material->Get(AI_MATKEY_NAME, aimat_name);
+                    std::string mat_name(aimat_name.C_Str());
 
-                        std::cout << "---------------------------------------\n";
-                        if (!mat_name.empty())
-                            std::cout << "Loading Material... : " << mat_name << std::endl;
-                        else {
-                            mat_name = "Mat_" + meshName + "_" + std::to_string(i);
-                            std::cout << "No Material...: " << mat_name << std::endl;
-                        }
+                    if (!mat_name.empty())
+                        RAZIX_PACKER_LOG_VERBOSE("Loading Material... : " << mat_name);
+                    else {
+                        mat_name = "Mat_" + meshName + "_" + std::to_string(i);
+                        RAZIX_PACKER_LOG_VERBOSE("No Material...: " << mat_name);
+                    }
 
-                        // Store the Name
-                        strcpy_s(material.m_Name, mat_name.c_str());
-                        // TODO: Set the Surface Type and Material Type
-                        readMaterial(directoryPath, assimp_material, material);
+                    // Store the Name
+                    strcpy_s(material.m_Name, mat_name.c_str());
+                    // TODO: Set the Surface Type and Material Type
+                    readMaterial(directoryPath, assimp_material, material);
+                }
 
-                        std::cout << "---------------------------------------\n";
-                    }
+                // Generated tangents split the vertices on mirrored UV seams, the streams are sized for the copies upfront
+                std::vector<uint32_t> mirroredVertices(scene->mNumMeshes, 0);
+                auto                  countMirroredJob = [&](uint32_t i) {
+                    mirroredVertices[i] = CountMeshMirroredVertices(scene->mMeshes[i]);
+                };
+                if (options.jobSystem)
+                    options.jobSystem->parallelFor(scene->mNumMeshes, countMirroredJob);
+                else {
+                    for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+                        countMirroredJob(i);
+                }
 
-                    // Read sub Meshes Data
-                    for (size_t i = 0; i < scene->mNumMeshes; i++) {
-                        std::string submesh_name = scene->mMeshes[i]->mName.C_Str();
+                // Read sub Meshes Data
+                for (size_t i = 0; i < scene->mNumMeshes; i++) {
+                    std::string submesh_name = scene->mMeshes[i]->mName.C_Str();
 
-                        if (submesh_name.length() == 0)
-                            submesh_name = "submesh_" + std::to_string(i);
+                    if (submesh_name.length() == 0)
+                        submesh_name = "submesh_" + std::to_string(i);
 
-                        strcpy_s(result.submeshes[i].name, submesh_name.c_str());
-                        result.submeshes[i].index_count  = scene->mMeshes[i]->mNumFaces * 3;
-                        result.submeshes[i].vertex_count = scene->mMeshes[i]->mNumVertices;
-                        result.submeshes[i].base_index   = index_count;
-                        result.submeshes[i].base_vertex  = vertex_count;
+                    strcpy_s(result.submeshes[i].name, submesh_name.c_str());
+                    result.submeshes[i].index_count  = scene->mMeshes[i]->mNumFaces * 3;
+                    result.submeshes[i].vertex_count = scene->mMeshes[i]->mNumVertices + mirroredVertices[i];
+                    result.submeshes[i].base_index   = index_count;
+                    result.submeshes[i].base_vertex  = vertex_count;
 
-                        vertex_count += scene->mMeshes[i]->mNumVertices;
-                        index_count += result.submeshes[i].index_count;
+                    vertex_count += result.submeshes[i].vertex_count;
+                    index_count += result.submeshes[i].index_count;
 
-                        // Assign the material to the submesh
-                        result.submeshes[i].material_index = scene->mMeshes[i]->mMaterialIndex;
-                        result.submeshes[i].materialName   = result.materials[result.submeshes[i].material_index].m_Name;
-                    }
+                    // Assign the material to the submesh
+                    result.submeshes[i].material_index = scene->mMeshes[i]->mMaterialIndex;
+                    result.submeshes[i].materialName   = result.materials[result.submeshes[i].material_index].m_Name;
+                    result.submeshes[i].skinned        = !result.skeleton.bones.empty() && scene->mMeshes[i]->HasBones();
+                }
+            }
 
-                    result.vertices.setSize(vertex_count);
-                    result.indices.resize(index_count);
-                    temp_indices.resize(index_count);
+            void MeshImporter::readSkeleton(const aiScene* scene, MeshImportResult& result)
+            {
+                // Skinning bones and animated nodes, the rest of the hierarchy is only kept when one of them is below it
+                std::unordered_set<std::string> jointNames;
+                for (uint32_t i = 0; i < scene->mNumMeshes; i++) {
+                    for (uint32_t b = 0; b < scene->mMeshes[i]->mNumBones; b++)
+                        jointNames.insert(scene->mMeshes[i]->mBones[b]->mName.C_Str());
+                }
+                for (uint32_t i = 0; i < scene->mNumAnimations; i++) {
+                    for (uint32_t c = 0; c < scene->mAnimations[i]->mNumChannels; c++)
+                        jointNames.insert(scene->mAnimations[i]->mChannels[c]->mNodeName.C_Str());
+                }
 
-                    aiMesh* temp_mesh;
-                    int     idx          = 0;
-                    int     vertex_index = 0;
+                if (jointNames.empty())
+                    return;
+
+                std::unordered_set<const aiNode*> skeletonNodes;
+                MarkSkeletonNodes(scene->mRootNode, jointNames, skeletonNodes);
+                uint32_t duplicateNames = 0;
+                AddSkeletonBones(scene->mRootNode, -1, aiMatrix4x4(), skeletonNodes, result.skeleton, m_BoneLookup, duplicateNames);
+                if (duplicateNames)
+                    RAZIX_PACKER_LOG_WARNING(duplicateNames << " skeleton nodes share their name with another one, they are renamed and weights and channels bind to the first node of that name");
+
+                // Bone indices are exported as 16 bit integers
+                if (result.skeleton.bones.size() > UINT16_MAX) {
+                    RAZIX_PACKER_LOG_WARNING("Skeleton has " << result.skeleton.bones.size() << " bones, more than " << UINT16_MAX << " can't be skinned, skipping it");
+                    result.skeleton.bones.clear();
+                    m_BoneLookup.clear();
+                    return;
+                }
 
-                    // Create a flat hierarchy if there's not hierarchy and a the Model has a bunch of submeshes
-                    if (!scene->mRootNode->mNumChildren) {
-                        rootNode->numChildren = scene->mNumMeshes;
-                        rootNode->children    = new Node[scene->mNumMeshes];
+                for (uint32_t i = 0; i < scene->mNumMeshes; i++) {
+                    for (uint32_t b = 0; b < scene->mMeshes[i]->mNumBones; b++) {
+                        const aiBone* bone = scene->mMeshes[i]->mBones[b];
+                        auto          it   = m_BoneLookup.find(bone->mName.C_Str());
+                        if (it != m_BoneLookup.end())
+                            result.skeleton.bones[it->second].inverseBind = ToGlmMatrix(bone->mOffsetMatrix);
                     }
+                }
+            }
 
-                    for (uint32_t i = 0; i < scene->mNumMeshes; i++) {
-                        temp_mesh = scene->mMeshes[i];
-
-                        // Create a flat hierarchy if there's not hierarchy and a the Model has a bunch of submeshes
-                        if (!scene->mRootNode->mNumChildren) {
-                            rootNode->children[i].nodeType = "$MESH";
-                            rootNode->children[i].name     = scene->mMeshes[i]->mName.C_Str();
+            void MeshImporter::readAnimations(const aiScene* scene, MeshImportResult& result)
+            {
+                if (result.skeleton.bones.empty())
+                    return;
+
+                for (uint32_t i = 0; i < scene->mNumAnimations; i++) {
+                    const aiAnimation* animation = scene->mAnimations[i];
+
+                    // Keys are in ticks, assimp leaves the rate at 0 when the file doesn't specify it
+                    double ticksPerSecond = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : 25.0;
+
+                    AnimationClip clip;
+                    clip.name     = animation->mName.length ? animation->mName.C_Str() : "clip_" + std::to_string(i);
+                    clip.duration = static_cast<float>(animation->mDuration / ticksPerSecond);
+
+                    for (uint32_t c = 0; c < animation->mNumChannels; c++) {
+                        const aiNodeAnim* channel = animation->mChannels[c];
+                        auto              it      = m_BoneLookup.find(channel->mNodeName.C_Str());
+                        if (it == m_BoneLookup.end())
+                            continue;
+
+                        AnimationTrack track;
+                        track.bone = it->second;
+
+                        track.positionTimes.resize(channel->mNumPositionKeys);
+                        track.positions.resize(channel->mNumPositionKeys);
+                        for (uint32_t k = 0; k < channel->mNumPositionKeys; k++) {
+                            const aiVectorKey& key = channel->mPositionKeys[k];
+                            track.positionTimes[k] = static_cast<float>(key.mTime / ticksPerSecond);
+                            track.positions[k]     = glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z);
                         }
 
-                        result.submeshes[i].max_extents = glm::vec3(temp_mesh->mVertices[0].x, temp_mesh->mVertices[0].y, temp_mesh->mVertices[0].z);
-                        result.submeshes[i].min_extents = glm::vec3(temp_mesh->mVertices[0].x, temp_mesh->mVertices[0].y, temp_mesh->mVertices[0].z);
-
-                        // Read vertex data
-                        //#if RAZIX_ASSET_VERSION == RAZIX_ASSET_VERSION_V1
-                        for (uint32_t k = 0; k < scene->mMeshes[i]->mNumVertices; k++) {
-                            result.vertices.Position[vertex_index] = glm::vec3(temp_mesh->mVertices[k].x, temp_mesh->mVertices[k].y, temp_mesh->mVertices[k].z);
-                            glm::vec3 n                            = glm::vec3(temp_mesh->mNormals[k].x, temp_mesh->mNormals[k].y, temp_mesh->mNormals[k].z);
-                            result.vertices.Normal[vertex_index]   = n;
-
-                            if (temp_mesh->mTangents) {
-                                glm::vec3 t = glm::vec3(temp_mesh->mTangents[k].x, temp_mesh->mTangents[k].y, temp_mesh->mTangents[k].z);
-                                glm::vec3 b = glm::vec3(temp_mesh->mBitangents[k].x, temp_mesh->mBitangents[k].y, temp_mesh->mBitangents[k].z);
-
-                                // @NOTE: Assuming right handed coordinate space
-                                if (glm::dot(glm::cross(n, t), b) < 0.0f)
-                                    t *= -1.0f;    // Flip tangent
-
-                                result.vertices.Tangent[vertex_index] = t;
-                                //result.vertices[vertex_index].BiTangent = b;
-                            }
-
-                            if (temp_mesh->HasTextureCoords(0))
-                                result.vertices.UV[vertex_index] = glm::vec2(temp_mesh->mTextureCoords[0][k].x, temp_mesh->mTextureCoords[0][k].y);
-
-                            if (result.vertices.Position[vertex_index].x > result.submeshes[i].max_extents.x)
-                                result.submeshes[i].max_extents.x = result.vertices.Position[vertex_index].x;
-                            if (result.vertices.Position[vertex_index].y > result.submeshes[i].max_extents.y)
-                                result.submeshes[i].max_extents.y = result.vertices.Position[vertex_index].y;
-                            if (result.vertices.Position[vertex_index].z > result.submeshes[i].max_extents.z)
-                                result.submeshes[i].max_extents.z = result.vertices.Position[vertex_index].z;
-
-                            if (result.vertices.Position[vertex_index].x < result.submeshes[i].min_extents.x)
-                                result.submeshes[i].min_extents.x = result.vertices.Position[vertex_index].x;
-                            if (result.vertices.Position[vertex_index].y < result.submeshes[i].min_extents.y)
-                                result.submeshes[i].min_extents.y = result.vertices.Position[vertex_index].y;
-                            if (result.vertices.Position[vertex_index].z < result.submeshes[i].min_extents.z)
-                                result.submeshes[i].min_extents.z = result.vertices.Position[vertex_index].z;
-
-                            vertex_index++;
+                        track.rotationTimes.resize(channel->mNumRotationKeys);
+                        track.rotations.resize(channel->mNumRotationKeys);
+                        for (uint32_t k = 0; k < channel->mNumRotationKeys; k++) {
+                            const aiQuatKey& key   = channel->mRotationKeys[k];
+                            track.rotationTimes[k] = static_cast<float>(key.mTime / ticksPerSecond);
+                            track.rotations[k]     = glm::quat(key.mValue.w, key.mValue.x, key.mValue.y, key.mValue.z);
                         }
-                        //#else
-                        // Copy all 3 component stuff directly
-                        //uint32_t numVerts = temp_mesh->mNumVertices;
-                        //memcpy(result.vertices.Position.data(), temp_mesh->mVertices, numVerts);
-                        //memcpy(result.vertices.Normal.data(), temp_mesh->mNormals, numVerts);
-                        //if (temp_mesh->mTangents) {
-                        //    memcpy(result.vertices.Tangent.data(), temp_mesh->mTangents, numVerts);
-                        //} else
-                        //    result.vertices.Tangent.resize(0);
-                        //// color: 4 component
-                        //if (temp_mesh->mColors[0]) {
-                        //    memcpy(result.vertices.Color.data(), temp_mesh->mColors[0], numVerts);
-                        //} else
-                        //    result.vertices.Color.resize(0);
-
-                        //// UV
-                        //for (uint32_t k = 0; k < temp_mesh->mNumVertices; k++) {
-                        //    if (temp_mesh->HasTextureCoords(0))
-                        //        result.vertices.UV[vertex_index] = glm::vec2(temp_mesh->mTextureCoords[0][k].x, temp_mesh->mTextureCoords[0][k].y);
-
-                        //    if (result.vertices.Position[vertex_index].x > result.submeshes[i].max_extents.x)
-                        //        result.submeshes[i].max_extents.x = result.vertices.Position[vertex_index].x;
-                        //    if (result.vertices.Position[vertex_index].y > result.submeshes[i].max_extents.y)
-                        //        result.submeshes[i].max_extents.y = result.vertices.Position[vertex_index].y;
-                        //    if (result.vertices.Position[vertex_index].z > result.submeshes[i].max_extents.z)
-                        //        result.submeshes[i].max_extents.z = result.vertices.Position[vertex_index].z;
-
-                        //    if (result.vertices.Position[vertex_index].x < result.submeshes[i].min_extents.x)
-                        //        result.submeshes[i].min_extents.x = result.vertices.Position[vertex_index].x;
-                        //    if (result.vertices.Position[vertex_index].y < result.submeshes[i].min_extents.y)
-                        //        result.submeshes[i].min_extents.y = result.vertices.Position[vertex_index].y;
-                        //    if (result.vertices.Position[vertex_index].z < result.submeshes[i].min_extents.z)
-                        //        result.submeshes[i].min_extents.z = result.vertices.Position[vertex_index].z;
-
-                        //    vertex_index++;
-                        //}
-
-                        //#endif
-                        // Read the index data
-                        for (uint32_t j = 0; j < temp_mesh->mNumFaces; j++) {
-                            result.indices[idx] = temp_mesh->mFaces[j].mIndices[0];
-                            idx++;
-                            result.indices[idx] = temp_mesh->mFaces[j].mIndices[1];
-                            idx++;
-                            result.indices[idx] = temp_mesh->mFaces[j].mIndices[2];
-                            idx++;
+
+                        track.scaleTimes.resize(channel->mNumScalingKeys);
+                        track.scales.resize(channel->mNumScalingKeys);
+                        for (uint32_t k = 0; k < channel->mNumScalingKeys; k++) {
+                            const aiVectorKey& key = channel->mScalingKeys[k];
+                            track.scaleTimes[k]    = static_cast<float>(key.mTime / ticksPerSecond);
+                            track.scales[k]        = glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z);
                         }
-                    }
 
-                    result.max_extents = result.submeshes[0].max_extents;
-                    result.min_extents = result.submeshes[0].min_extents;
-
-                    // Find AABB for entire result.
-                    for (int i = 0; i < result.submeshes.size(); i++) {
-                        if (result.submeshes[i].max_extents.x > result.max_extents.x)
-                            result.max_extents.x = result.submeshes[i].max_extents.x;
-                        if (result.submeshes[i].max_extents.y > result.max_extents.y)
-                            result.max_extents.y = result.submeshes[i].max_extents.y;
-                        if (result.submeshes[i].max_extents.z > result.max_extents.z)
-                            result.max_extents.z = result.submeshes[i].max_extents.z;
-
-                        if (result.submeshes[i].min_extents.x < result.min_extents.x)
-                            result.min_extents.x = result.submeshes[i].min_extents.x;
-                        if (result.submeshes[i].min_extents.y < result.min_extents.y)
-                            result.min_extents.y = result.submeshes[i].min_extents.y;
-                        if (result.submeshes[i].min_extents.z < result.min_extents.z)
-                            result.min_extents.z = result.submeshes[i].min_extents.z;
+                        clip.tracks.push_back(std::move(track));
                     }
 
-                    auto                          finish = std::chrono::high_resolution_clock::now();
-                    std::chrono::duration<double> time   = finish - start;
-
-                    std::cout << "Successfully Imported mesh in " << time.count() << " seconds" << std::endl;
-
-                } else {
-                    std::cout << "[ERROR!] Failed to load model\n";
-                    return false;
+                    result.animations.push_back(std::move(clip));
                 }
-                return true;
             }
 
             void MeshImporter::readMaterial(const std::string& materialsDirectory, aiMaterial* aiMat, Graphics::MaterialData& material)
@@ -301,7 +774,7 @@ namespace Razix {
 
                     bool base_color_texture_found = findTexurePath(materialsDirectory, aiMat, aiTextureType_DIFFUSE, 0, material.m_MaterialTexturePaths.albedo);
                     if (base_color_texture_found)
-                        std::cout << "Diffuse Texture : " << material.m_MaterialTexturePaths.albedo << std::endl;
+                        RAZIX_PACKER_LOG_VERBOSE("Diffuse Texture : " << material.m_MaterialTexturePaths.albedo);
                     else {
                         aiColor4D base_color = aiColor4D(1.0f, 0.0f, 1.0f, 1.0f);
 
@@ -322,7 +795,7 @@ namespace Razix {
 
                         bool metal_roughness_texture_found = findTexurePath(materialsDirectory, aiMat, AI_MATKEY_GLTF_PBRMETALLICROUGHNESS_METALLICROUGHNESS_TEXTURE, material.m_MaterialTexturePaths.metallicRoughnessAO);
                         if (metal_roughness_texture_found)
-                            std::cout << "MetallicRoughness Texture : " << material.m_MaterialTexturePaths.metallic << std::endl;
+                            RAZIX_PACKER_LOG_VERBOSE("MetallicRoughness Texture : " << material.m_MaterialTexturePaths.metallic);
 
                         if (!metal_roughness_texture_found) {
                             aiReturn roughness_factor_found = aiMat->Get(AI_MATKEY_GLTF_PBRMETALLICROUGHNESS_METALLIC_FACTOR, material.m_MaterialProperties.roughnessColor);
@@ -335,8 +808,8 @@ namespace Razix {
                             if (metallic_factor_found == aiReturn_FAILURE)
                                 material.m_MaterialProperties.metallicColor = 1.0f;
 
-                            printf("Roughness: %f \n", material.m_MaterialProperties.roughnessColor);
-                            printf("Metallic: %f \n", material.m_MaterialProperties.metallicColor);
+                            RAZIX_PACKER_LOG_VERBOSE("Roughness : " << material.m_MaterialProperties.roughnessColor);
+                            RAZIX_PACKER_LOG_VERBOSE("Metallic : " << material.m_MaterialProperties.metallicColor);
                         }
 
                     } else {
@@ -344,7 +817,7 @@ namespace Razix {
 
                         bool roughness_texture_found = findTexurePath(materialsDirectory, aiMat, aiTextureType_SHININESS, 0, material.m_MaterialTexturePaths.roughness);
                         if (roughness_texture_found)
-                            std::cout << "Roughness Texture : " << material.m_MaterialTexturePaths.roughness << std::endl;
+                            RAZIX_PACKER_LOG_VERBOSE("Roughness Texture : " << material.m_MaterialTexturePaths.roughness);
 
                         if (!roughness_texture_found)
                             material.m_MaterialProperties.roughnessColor = 0.25f;
@@ -352,7 +825,7 @@ namespace Razix {
                         bool metallic_texture_found = findTexurePath(materialsDirectory, aiMat, aiTextureType_AMBIENT, 0, material.m_MaterialTexturePaths.metallic);
 
                         if (metallic_texture_found)
-                            std::cout << "Metallic Texture : " << material.m_MaterialTexturePaths.metallic << std::endl;
+                            RAZIX_PACKER_LOG_VERBOSE("Metallic Texture : " << material.m_MaterialTexturePaths.metallic);
 
                         if (!metallic_texture_found)
                             material.m_MaterialProperties.metallicColor = 1.0f;
@@ -362,14 +835,14 @@ namespace Razix {
                     {
                         bool normal_texture_found = findTexurePath(materialsDirectory, aiMat, aiTextureType_NORMALS, 0, material.m_MaterialTexturePaths.normal);
                         if (normal_texture_found)
-                            std::cout << "Normal Texture : " << material.m_MaterialTexturePaths.normal << std::endl;
+                            RAZIX_PACKER_LOG_VERBOSE("Normal Texture : " << material.m_MaterialTexturePaths.normal);
                     }
 
                     // EMISSIVE
                     {
                         bool emissive_texture_found = findTexurePath(materialsDirectory, aiMat, aiTextureType_EMISSIVE, 0, material.m_MaterialTexturePaths.emissive);
                         if (emissive_texture_found)
-                            std::cout << "Emissive Texture : " << material.m_MaterialTexturePaths.emissive << std::endl;
+                            RAZIX_PACKER_LOG_VERBOSE("Emissive Texture : " << material.m_MaterialTexturePaths.emissive);
                     }
                 }
             }
@@ -397,7 +870,7 @@ namespace Razix {
             void MeshImporter::printHierarchy(const aiNode* node, const aiScene* scene, uint32_t depthIndex)
             {
                 if (depthIndex == 0) {
-                    std::cout << "|-" << node->mName.C_Str() << " \n";
+                    RAZIX_PACKER_LOG_VERBOSE("|-" << node->mName.C_Str());
                 }
 
                 std::string indent;
@@ -409,37 +882,29 @@ namespace Razix {
                     aiQuaternion rotation;
                     node->mChildren[i]->mTransformation.Decompose(scale, rotation, translation);
 
-                    std::cout << indent << "|-" << node->mChildren[i]->mName.C_Str() << " \n"
-                              << indent << "  Transform : (" << translation.x << ", " << translation.y << ", " << translation.z << ")" << std::endl
-                              << indent << "  Type : " << (node->mChildren[i]->mNumMeshes ? "Mesh" : "Transform") << std::endl;
+                    RAZIX_PACKER_LOG_VERBOSE(indent << "|-" << node->mChildren[i]->mName.C_Str() << "\n"
+                                             << indent << "  Transform : (" << translation.x << ", " << translation.y << ", " << translation.z << ")\n"
+                                             << indent << "  Type : " << (node->mChildren[i]->mNumMeshes ? "Mesh" : "Transform"));
                     printHierarchy(node->mChildren[i], scene, ++depthIndex);
                     depthIndex--;
                 }
             }
 
-            void MeshImporter::extractHierarchy(Node* hierarchyNode, const aiNode* node, const aiScene* scene, uint32_t depthIndex)
+            void MeshImporter::extractHierarchy(MeshHierarchy& hierarchy, uint32_t parent, const aiNode* node)
             {
-                hierarchyNode->numChildren = node->mNumChildren;
-                if (hierarchyNode->numChildren) {
-                    hierarchyNode->children = new Node[node->mNumChildren];
-
-                    for (uint32_t i = 0; i < node->mNumChildren; i++) {
-                        auto& child      = hierarchyNode->children[i];
-                        child.name       = node->mChildren[i]->mName.C_Str();
-                        const char* type = node->mChildren[i]->mNumMeshes ? "$MESH" : "$TRANSFORM";
-                        child.nodeType   = type;
-
-                        aiVector3D   translation, scale;
-                        aiQuaternion rotation;
-                        node->mChildren[i]->mTransformation.Decompose(scale, rotation, translation);
-
-                        child.translation = glm::vec3(translation.x, translation.y, translation.z);
-                        child.scale       = glm::vec3(scale.x, scale.y, scale.z);
-                        child.rotation    = glm::quat(rotation.w, rotation.x, rotation.y, rotation.z);
-
-                        extractHierarchy(&child, node->mChildren[i], scene, ++depthIndex);
-                        depthIndex--;
-                    }
+                for (uint32_t i = 0; i < node->mNumChildren; i++) {
+                    const aiNode* child = node->mChildren[i];
+                    uint32_t      index = hierarchy.addNode(child->mName.C_Str(), parent, child->mMeshes, child->mNumMeshes);
+
+                    aiVector3D   translation, scale;
+                    aiQuaternion rotation;
+                    child->mTransformation.Decompose(scale, rotation, translation);
+
+                    hierarchy.translations[index] = glm::vec3(translation.x, translation.y, translation.z);
+                    hierarchy.scales[index]       = glm::vec3(scale.x, scale.y, scale.z);
+                    hierarchy.rotations[index]    = glm::quat(rotation.w, rotation.x, rotation.y, rotation.z);
+
+                    extractHierarchy(hierarchy, index, child);
                 }
             }
         }    // namespace AssetPacker
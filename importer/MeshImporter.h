@@ -4,22 +4,62 @@
 
 #include "common/intermediate_types.h"
 
+#include "MeshImporterBackend.h"
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
 struct aiMaterial;
 struct aiScene;
 struct aiNode;
 
+namespace Assimp {
+    class Importer;
+}
+
 namespace Razix {
     namespace Tool {
         namespace AssetPacker {
 
+            class JobSystem;
+
+            /* Assimp post processing steps, whatever the preset normals and tangents are generated by the importer only for the meshes without them */
+            enum class MeshImportPreset
+            {
+                Fast,        /* Triangulate and JoinIdenticalVertices, nothing else                                                       */
+                Balanced,    /* + GenUVCoords and OptimizeMeshes/OptimizeGraph unless keepInstances                                         */
+                Full         /* + ImproveCacheLocality, FindDegenerates, FindInvalidData and ValidateDataStructure, for untrusted sources */
+            };
+
+            const char* GetMeshImportPresetName(MeshImportPreset preset);
+
+            /* Time spent in every step of an Assimp import, the conversion steps are summed across the submeshes converted in parallel */
+            struct MeshImportTimings
+            {
+                uint64_t readNs     = 0; /* ReadFile and the post processing, the whole import with the native backends */
+                uint64_t layoutNs   = 0; /* Hierarchy, materials, skeleton and clips                                      */
+                uint64_t convertNs  = 0; /* Copy of the streams, indices and bone weights                                 */
+                uint64_t normalsNs  = 0; /* Smooth normals of the meshes without normals                                  */
+                uint64_t tangentsNs = 0; /* Tangents of the meshes without tangents, handedness fix of the imported ones  */
+            };
+
             struct MeshImportOptions
             {
-                bool  flipUVs        = false;
-                bool  encodeVertices = false;
-                bool  encodeIndices  = false;
-                float mergeDistance  = 0.05f;
+                bool                    flipUVs        = false;
+                bool                    encodeVertices = false;
+                bool                    encodeIndices  = false;
+                float                   mergeDistance  = 0.05f;   /* Weld tolerance in model units, used when MeshProcessingOptions::weldVertices is set */
+                bool                    importSkinning = false;   /* Bone weights, skeleton and animation clips, Assimp only so Auto skips the native backends */
+                bool                    keepInstances  = false;   /* Skip Assimp's OptimizeMeshes/OptimizeGraph, they merge instanced meshes and bake their nodes */
+                MeshImportPreset        preset         = MeshImportPreset::Balanced;
+                MeshImporterBackendType backend        = MeshImporterBackendType::Auto;
+                JobSystem*              jobSystem      = nullptr; /* Used by the native backends to parse and weld in parallel and by Assimp to convert the submeshes */
             };
 
+            /* Receives a MeshImportResult holding a single submesh with it's own streams, returning false stops the import */
+            using MeshChunkCallback = std::function<bool(MeshImportResult& chunk)>;
+
             class MeshImporter
             {
             public:
@@ -27,18 +67,49 @@ namespace Razix {
                 ~MeshImporter() = default;
 
                 bool importMesh(const std::string& meshFilePath, MeshImportResult& result, MeshImportOptions options = MeshImportOptions());
+                /**
+                 * Streaming import, onChunk gets every submesh as soon as it's converted instead of the whole MeshImportResult
+                 * model gets everything but the geometry (name, materials and the submesh table) before the first chunk, the extents once
+                 * all of them are converted. Chunk submeshes start at vertex/index 0 of their own streams. Always goes through Assimp, which
+                 * releases every aiMesh once it's converted, the native backends build the whole model so an OpenFBX or glTF backend fails
+                 */
+                bool importMeshStreamed(const std::string& meshFilePath, MeshImportResult& model, const MeshChunkCallback& onChunk, MeshImportOptions options = MeshImportOptions());
 
-                const Node* getRootNode() const { return rootNode; }
+                /* Timings of the last import */
+                const MeshImportTimings& getTimings() const { return m_Timings; }
+
+                /**
+                 * Texture files the imported materials reference, absolute and normalized like the build cache paths
+                 * Call it before the TextureProcessor rewrites the paths, embedded textures ("*0") aren't files and are skipped
+                 */
+                static void CollectTextureFiles(const std::vector<Graphics::MaterialData>& materials, std::vector<std::string>& textureFiles);
+
+            private:
+                enum class BackendImport
+                {
+                    Imported,
+                    Failed,
+                    UseAssimp
+                };
 
             private:
+                BackendImport            importWithBackend(const std::string& meshFilePath, MeshImportResult& result, const MeshImportOptions& options);
+                std::unique_ptr<aiScene> readScene(Assimp::Importer& importer, const std::string& meshFilePath, const MeshImportOptions& options);
+                /* Hierarchy, materials and the submesh table, everything but the vertex and index streams */
+                void readSceneLayout(const aiScene* scene, const std::string& meshFilePath, const MeshImportOptions& options, MeshImportResult& result);
                 void readMaterial(const std::string& materialsDirectory, aiMaterial* aiMat, Graphics::MaterialData& material);
                 bool findTexurePath(const std::string& materialsDirectory, aiMaterial* aiMat, uint32_t textureType, uint32_t index, char* material);
                 void printHierarchy(const aiNode* node, const aiScene* scene, uint32_t depthIndex);
-                void extractHierarchy(Node* hierarchyNode, const aiNode* node, const aiScene* scene, uint32_t depthIndex);
+                /* Appends the children of node depth first after parent */
+                void extractHierarchy(MeshHierarchy& hierarchy, uint32_t parent, const aiNode* node);
+                /* Skeleton and animation clips, also fills m_BoneLookup for the weights of the meshes */
+                void readSkeleton(const aiScene* scene, MeshImportResult& result);
+                void readAnimations(const aiScene* scene, MeshImportResult& result);
 
             private:
-                bool  m_IsGlTF = false;
-                Node* rootNode = nullptr;
+                bool                                      m_IsGlTF = false;
+                std::unordered_map<std::string, uint32_t> m_BoneLookup; /* Node name -> index into Skeleton::bones */
+                MeshImportTimings                         m_Timings;
             };
         }    // namespace AssetPacker
     }        // namespace Tool
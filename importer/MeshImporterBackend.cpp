@@ -0,0 +1,47 @@
+#include "MeshImporterBackend.h"
+
+#include "GlTFImporterBackend.h"
+#include "OpenFBXImporterBackend.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            std::unique_ptr<MeshImporterBackend> CreateMeshImporterBackend(MeshImporterBackendType type, const std::string& extension)
+            {
+                std::unique_ptr<MeshImporterBackend> backend;
+                switch (type) {
+                    case MeshImporterBackendType::Auto:
+                        if (extension == "fbx")
+                            backend = std::make_unique<OpenFBXImporterBackend>();
+                        else if (extension == "gltf" || extension == "glb")
+                            backend = std::make_unique<GlTFImporterBackend>();
+                        break;
+                    case MeshImporterBackendType::OpenFBX:
+                        backend = std::make_unique<OpenFBXImporterBackend>();
+                        break;
+                    case MeshImporterBackendType::GlTF:
+                        backend = std::make_unique<GlTFImporterBackend>();
+                        break;
+                    case MeshImporterBackendType::Assimp:
+                        break;
+                }
+
+                if (backend && !backend->canImport(extension))
+                    backend.reset();
+                return backend;
+            }
+
+            const char* GetMeshImporterBackendName(MeshImporterBackendType type)
+            {
+                switch (type) {
+                    case MeshImporterBackendType::Auto: return "auto";
+                    case MeshImporterBackendType::Assimp: return "assimp";
+                    case MeshImporterBackendType::OpenFBX: return "openfbx";
+                    case MeshImporterBackendType::GlTF: return "gltf";
+                }
+                return "unknown";
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
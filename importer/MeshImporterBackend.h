@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "common/intermediate_types.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            struct MeshImportOptions;
+
+            enum class MeshImporterBackendType
+            {
+                Auto,    /* Native backend for the format when there is one, Assimp otherwise or if the native backend fails */
+                Assimp,  /* Always go through Assimp::Importer, handles every format                                          */
+                OpenFBX, /* .fbx only                                                                                         */
+                GlTF     /* .gltf and .glb only                                                                               */
+            };
+
+            /**
+             * A format specific importer that fills the MeshImportResult and it's hierarchy directly, without going through Assimp
+             * It must produce the same layout as the Assimp path: submeshes index their own vertices (relative to base_vertex),
+             * one submesh per material, extents computed and materials named. The hierarchy root is named after the model
+             */
+            class MeshImporterBackend
+            {
+            public:
+                virtual ~MeshImporterBackend() = default;
+
+                virtual const char* getName() const = 0;
+                /* extension is lower case and without the dot */
+                virtual bool canImport(const std::string& extension) const = 0;
+                virtual bool importMesh(const std::string& meshFilePath, MeshImportResult& result, const MeshImportOptions& options) = 0;
+            };
+
+            /* Returns nullptr when the file should go through the Assimp path */
+            std::unique_ptr<MeshImporterBackend> CreateMeshImporterBackend(MeshImporterBackendType type, const std::string& extension);
+
+            const char* GetMeshImporterBackendName(MeshImporterBackendType type);
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,413 @@
+#include "OpenFBXImporterBackend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#include <meshoptimizer.h>
+#include <ofbx.h>
+
+#include "ImportUtils.h"
+#include "MeshImporter.h"
+
+#include "common/job_system.h"
+#include "common/log.h"
+#include "common/profiler.h"
+#include "common/vertex_simd.h"
+#include "loader/MappedFile.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            // The triangles of an FBX mesh that use the same material, becomes a submesh
+            struct FBXSubMeshSource
+            {
+                const ofbx::Mesh*     mesh          = nullptr;
+                int                   materialSlot  = 0;  /* Index into the materials of the mesh */
+                uint32_t              materialIndex = 0;  /* Index into MeshImportResult::materials */
+                std::vector<uint32_t> triangles;          /* Empty when the whole mesh uses the same material */
+                std::string           name;
+            };
+
+            // Indexed vertices of a submesh after welding the triangle corners
+            struct FBXWeldedSubMesh
+            {
+                std::vector<glm::vec3> positions;
+                std::vector<glm::vec3> normals;
+                std::vector<glm::vec2> uvs;
+                std::vector<glm::vec3> tangents;
+                std::vector<float>     tangentSigns;
+                std::vector<uint32_t>  indices;
+            };
+
+            static void RunOpenFBXJobs(ofbx::JobFunction fn, void* user, void* data, ofbx::u32 size, ofbx::u32 count)
+            {
+                uint8_t*   jobs      = static_cast<uint8_t*>(data);
+                JobSystem* jobSystem = static_cast<JobSystem*>(user);
+                if (jobSystem)
+                    jobSystem->parallelFor(count, [&](uint32_t i) { fn(jobs + size_t(i) * size); });
+                else {
+                    for (uint32_t i = 0; i < count; i++)
+                        fn(jobs + size_t(i) * size);
+                }
+            }
+
+            static glm::vec3 TransformPoint(const ofbx::Matrix& m, const ofbx::Vec3& v)
+            {
+                return glm::vec3(float(m.m[0] * v.x + m.m[4] * v.y + m.m[8] * v.z + m.m[12]),
+                    float(m.m[1] * v.x + m.m[5] * v.y + m.m[9] * v.z + m.m[13]),
+                    float(m.m[2] * v.x + m.m[6] * v.y + m.m[10] * v.z + m.m[14]));
+            }
+
+            static glm::vec3 TransformDirection(const ofbx::Matrix& m, const ofbx::Vec3& v)
+            {
+                glm::vec3 d = glm::vec3(float(m.m[0] * v.x + m.m[4] * v.y + m.m[8] * v.z),
+                    float(m.m[1] * v.x + m.m[5] * v.y + m.m[9] * v.z),
+                    float(m.m[2] * v.x + m.m[6] * v.y + m.m[10] * v.z));
+                float length = glm::length(d);
+                return length > 0.0f ? d / length : d;
+            }
+
+            static bool IsIdentity(const ofbx::Matrix& m)
+            {
+                for (int i = 0; i < 16; i++) {
+                    if (m.m[i] != ((i % 5) == 0 ? 1.0 : 0.0))
+                        return false;
+                }
+                return true;
+            }
+
+            static bool FindTexturePath(const std::string& materialsDirectory, const ofbx::Material* material, ofbx::Texture::TextureType type, char* path)
+            {
+                const ofbx::Texture* texture = material->getTexture(type);
+                if (!texture)
+                    return false;
+
+                char fileName[250];
+                texture->getRelativeFileName().toString(fileName);
+                if (fileName[0] == '\0')
+                    texture->getFileName().toString(fileName);
+                if (fileName[0] == '\0')
+                    return false;
+
+                strcpy_s(path, 250 * sizeof(char), ResolveTexturePath(materialsDirectory, fileName).c_str());
+                return true;
+            }
+
+            // FBX materials are Phong/Lambert, mapped the same way MeshImporter::readMaterial does for non glTF models
+            static void ReadMaterial(const std::string& materialsDirectory, const ofbx::Material* fbxMat, Graphics::MaterialData& material)
+            {
+                if (!FindTexturePath(materialsDirectory, fbxMat, ofbx::Texture::DIFFUSE, material.m_MaterialTexturePaths.albedo)) {
+                    ofbx::Color color                         = fbxMat->getDiffuseColor();
+                    material.m_MaterialProperties.albedoColor = glm::vec4(color.r, color.g, color.b, 1.0f);
+                }
+
+                material.m_MaterialProperties.workflow = (u32) Razix::Graphics::WorkFlow::WORLFLOW_PBR_METAL_ROUGHNESS_AO_SEPARATE;
+
+                if (!FindTexturePath(materialsDirectory, fbxMat, ofbx::Texture::SHININESS, material.m_MaterialTexturePaths.roughness))
+                    material.m_MaterialProperties.roughnessColor = 0.25f;
+                if (!FindTexturePath(materialsDirectory, fbxMat, ofbx::Texture::AMBIENT, material.m_MaterialTexturePaths.metallic))
+                    material.m_MaterialProperties.metallicColor = 1.0f;
+
+                FindTexturePath(materialsDirectory, fbxMat, ofbx::Texture::NORMAL, material.m_MaterialTexturePaths.normal);
+                FindTexturePath(materialsDirectory, fbxMat, ofbx::Texture::EMISSIVE, material.m_MaterialTexturePaths.emissive);
+            }
+
+            static void WeldSubMesh(const FBXSubMeshSource& source, bool flipUVs, FBXWeldedSubMesh& welded)
+            {
+                const ofbx::Geometry* geometry  = source.mesh->getGeometry();
+                const ofbx::Vec3*     vertices  = geometry->getVertices();
+                const ofbx::Vec3*     normals   = geometry->getNormals();
+                const ofbx::Vec2*     uvs       = geometry->getUVs(0);
+                const ofbx::Vec3*     tangents  = geometry->getTangents();
+                ofbx::Matrix          transform = source.mesh->getGeometricMatrix();
+                bool                  identity  = IsIdentity(transform);
+
+                uint32_t trianglesCount = source.triangles.empty() ? uint32_t(geometry->getVertexCount() / 3) : uint32_t(source.triangles.size());
+                uint32_t cornersCount   = trianglesCount * 3;
+
+                // Expand the corners of the triangles of this submesh into float streams
+                // UVs are flipped here, the tangent handedness is taken from the winding of the exported UVs
+                std::vector<glm::vec3> positions(cornersCount), cornerNormals(normals ? cornersCount : 0), cornerTangents(tangents ? cornersCount : 0);
+                std::vector<glm::vec2> cornerUVs(uvs ? cornersCount : 0);
+                for (uint32_t t = 0; t < trianglesCount; t++) {
+                    uint32_t triangle = source.triangles.empty() ? t : source.triangles[t];
+                    for (uint32_t c = 0; c < 3; c++) {
+                        uint32_t src = triangle * 3 + c;
+                        uint32_t dst = t * 3 + c;
+
+                        positions[dst] = identity ? glm::vec3(float(vertices[src].x), float(vertices[src].y), float(vertices[src].z)) : TransformPoint(transform, vertices[src]);
+                        if (normals)
+                            cornerNormals[dst] = identity ? glm::vec3(float(normals[src].x), float(normals[src].y), float(normals[src].z)) : TransformDirection(transform, normals[src]);
+                        if (tangents)
+                            cornerTangents[dst] = identity ? glm::vec3(float(tangents[src].x), float(tangents[src].y), float(tangents[src].z)) : TransformDirection(transform, tangents[src]);
+                        if (uvs)
+                            cornerUVs[dst] = glm::vec2(float(uvs[src].x), flipUVs ? 1.0f - float(uvs[src].y) : float(uvs[src].y));
+                    }
+                }
+
+                // Weld corners that are identical in every stream, like aiProcess_JoinIdenticalVertices
+                std::vector<meshopt_Stream> streams = {{positions.data(), sizeof(glm::vec3), sizeof(glm::vec3)}};
+                if (normals)
+                    streams.push_back({cornerNormals.data(), sizeof(glm::vec3), sizeof(glm::vec3)});
+                if (uvs)
+                    streams.push_back({cornerUVs.data(), sizeof(glm::vec2), sizeof(glm::vec2)});
+                if (tangents)
+                    streams.push_back({cornerTangents.data(), sizeof(glm::vec3), sizeof(glm::vec3)});
+
+                std::vector<unsigned int> remap(cornersCount);
+                size_t                    verticesCount = meshopt_generateVertexRemapMulti(remap.data(), nullptr, cornersCount, cornersCount, streams.data(), streams.size());
+
+                welded.indices.resize(cornersCount);
+                meshopt_remapIndexBuffer(welded.indices.data(), nullptr, cornersCount, remap.data());
+
+                welded.positions.resize(verticesCount);
+                welded.normals.resize(verticesCount);
+                welded.tangents.resize(verticesCount);
+                welded.tangentSigns.resize(verticesCount);
+                meshopt_remapVertexBuffer(welded.positions.data(), positions.data(), cornersCount, sizeof(glm::vec3), remap.data());
+                if (uvs) {
+                    welded.uvs.resize(verticesCount);
+                    meshopt_remapVertexBuffer(welded.uvs.data(), cornerUVs.data(), cornersCount, sizeof(glm::vec2), remap.data());
+                }
+                if (tangents)
+                    meshopt_remapVertexBuffer(welded.tangents.data(), cornerTangents.data(), cornersCount, sizeof(glm::vec3), remap.data());
+
+                // Same smooth normals as the other importers when the file has none
+                if (normals)
+                    meshopt_remapVertexBuffer(welded.normals.data(), cornerNormals.data(), cornersCount, sizeof(glm::vec3), remap.data());
+                else
+                    GenerateSmoothNormals(welded.positions.data(), static_cast<uint32_t>(verticesCount), welded.indices.data(), cornersCount, welded.normals.data());
+
+                // MikkTSpace needs a tangent space per UV orientation, the copies are appended to the welded streams
+                if (uvs) {
+                    std::vector<uint32_t> splitSources;
+                    uint32_t              splitCount   = SplitMirroredVertices(welded.uvs.data(), static_cast<uint32_t>(verticesCount), welded.indices.data(), cornersCount, splitSources);
+                    auto                  appendCopies = [&](auto& stream) {
+                        stream.resize(splitCount);
+                        for (size_t k = 0; k < splitSources.size(); k++)
+                            stream[verticesCount + k] = stream[splitSources[k]];
+                    };
+                    appendCopies(welded.positions);
+                    appendCopies(welded.normals);
+                    appendCopies(welded.uvs);
+                    appendCopies(welded.tangents);
+                    welded.tangentSigns.resize(splitCount);
+                    verticesCount = splitCount;
+                }
+
+                if (!tangents) {
+                    GenerateTangents(welded.positions.data(), welded.normals.data(), uvs ? welded.uvs.data() : nullptr, static_cast<uint32_t>(verticesCount), welded.indices.data(), cornersCount, welded.tangents.data(), welded.tangentSigns.data());
+                    return;
+                }
+
+                // OpenFBX doesn't expose the binormals, the authored tangents keep their direction and get the handedness of their UV winding
+                if (uvs) {
+                    std::vector<glm::vec3> generated(verticesCount);
+                    GenerateTangents(welded.positions.data(), welded.normals.data(), welded.uvs.data(), static_cast<uint32_t>(verticesCount), welded.indices.data(), cornersCount, generated.data(), welded.tangentSigns.data());
+                } else
+                    std::fill(welded.tangentSigns.begin(), welded.tangentSigns.end(), 1.0f);
+            }
+
+            // Appends the children depth first after their parent
+            static void ExtractHierarchy(MeshHierarchy& hierarchy, uint32_t parent, const ofbx::Object* object, const std::unordered_map<const ofbx::Mesh*, std::vector<uint32_t>>& meshSubMeshes)
+            {
+                for (int i = 0; const ofbx::Object* child = object->resolveObjectLink(i); i++) {
+                    if (!child->isNode())
+                        continue;
+
+                    const std::vector<uint32_t>* nodeMeshes = nullptr;
+                    if (child->getType() == ofbx::Object::Type::MESH) {
+                        auto it = meshSubMeshes.find(static_cast<const ofbx::Mesh*>(child));
+                        if (it != meshSubMeshes.end())
+                            nodeMeshes = &it->second;
+                    }
+
+                    uint32_t node = hierarchy.addNode(child->name, parent, nodeMeshes ? nodeMeshes->data() : nullptr, nodeMeshes ? static_cast<uint32_t>(nodeMeshes->size()) : 0);
+                    DecomposeTransform(child->getLocalTransform().m, hierarchy.translations[node], hierarchy.rotations[node], hierarchy.scales[node]);
+
+                    ExtractHierarchy(hierarchy, node, child, meshSubMeshes);
+                }
+            }
+
+            bool OpenFBXImporterBackend::importMesh(const std::string& meshFilePath, MeshImportResult& result, const MeshImportOptions& options)
+            {
+                RAZIX_PACKER_PROFILE_ZONE("OpenFBX Import", meshFilePath.c_str());
+                RAZIX_PACKER_LOG_VERBOSE("Importing Mesh (OpenFBX)...");
+
+                auto start = std::chrono::high_resolution_clock::now();
+
+                MappedFile file;
+                if (!file.open(meshFilePath) || file.getSize() > INT_MAX) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to read model : " << meshFilePath);
+                    return false;
+                }
+
+                ofbx::u64     flags = (ofbx::u64) ofbx::LoadFlags::TRIANGULATE | (ofbx::u64) ofbx::LoadFlags::IGNORE_BLEND_SHAPES;
+                ofbx::IScene* scene = ofbx::load(file.getData(), static_cast<int>(file.getSize()), flags, RunOpenFBXJobs, options.jobSystem);
+                if (!scene) {
+                    RAZIX_PACKER_LOG_ERROR("OpenFBX failed to load model : " << ofbx::getError());
+                    return false;
+                }
+
+                size_t      slash         = meshFilePath.find_last_of('/');
+                std::string directoryPath = slash != std::string::npos ? meshFilePath.substr(0, slash + 1) : std::string();
+                std::string meshName      = slash != std::string::npos ? meshFilePath.substr(slash + 1) : meshFilePath;
+                meshName                  = meshName.substr(0, meshName.find_last_of('.'));
+
+                result.name           = meshName;
+                result.encodeVertices = options.encodeVertices;
+                result.encodeIndices  = options.encodeIndices;
+
+                // Materials are shared between meshes, every one of them is read once
+                std::unordered_map<const ofbx::Material*, uint32_t> materialIndices;
+                auto                                                getMaterialIndex = [&](const ofbx::Material* fbxMat) {
+                    auto it = materialIndices.find(fbxMat);
+                    if (it != materialIndices.end())
+                        return it->second;
+
+                    uint32_t index = static_cast<uint32_t>(result.materials.size());
+                    result.materials.emplace_back();
+                    auto& material = result.materials.back();
+
+                    std::string mat_name = fbxMat ? fbxMat->name : "";
+                    if (mat_name.empty())
+                        mat_name = "Mat_" + meshName + "_" + std::to_string(index);
+                    strcpy_s(material.m_Name, mat_name.c_str());
+
+                    if (fbxMat)
+                        ReadMaterial(directoryPath, fbxMat, material);
+                    else {
+                        material.m_MaterialProperties.albedoColor    = glm::vec4(1.0f, 0.0f, 1.0f, 1.0f);
+                        material.m_MaterialProperties.roughnessColor = 0.25f;
+                        material.m_MaterialProperties.metallicColor  = 1.0f;
+                    }
+
+                    materialIndices[fbxMat] = index;
+                    return index;
+                };
+
+                // Split the meshes by material
+                std::vector<FBXSubMeshSource> sources;
+                for (int i = 0; i < scene->getMeshCount(); i++) {
+                    const ofbx::Mesh*     mesh     = scene->getMesh(i);
+                    const ofbx::Geometry* geometry = mesh->getGeometry();
+                    if (!geometry || geometry->getVertexCount() < 3)
+                        continue;
+
+                    std::string name = mesh->name;
+                    if (name.empty())
+                        name = "submesh_" + std::to_string(i);
+
+                    const int* triangleMaterials = geometry->getMaterials();
+                    int        slotsCount        = std::max(mesh->getMaterialCount(), 1);
+                    if (!triangleMaterials || slotsCount == 1) {
+                        FBXSubMeshSource source;
+                        source.mesh          = mesh;
+                        source.materialIndex = getMaterialIndex(mesh->getMaterialCount() ? mesh->getMaterial(0) : nullptr);
+                        source.name          = name;
+                        sources.push_back(std::move(source));
+                        continue;
+                    }
+
+                    std::vector<FBXSubMeshSource> slots(slotsCount);
+                    uint32_t                      trianglesCount = uint32_t(geometry->getVertexCount() / 3);
+                    for (uint32_t t = 0; t < trianglesCount; t++) {
+                        int slot = std::min(std::max(triangleMaterials[t], 0), slotsCount - 1);
+                        slots[slot].triangles.push_back(t);
+                    }
+                    for (int slot = 0; slot < slotsCount; slot++) {
+                        if (slots[slot].triangles.empty())
+                            continue;
+                        slots[slot].mesh          = mesh;
+                        slots[slot].materialSlot  = slot;
+                        slots[slot].materialIndex = getMaterialIndex(mesh->getMaterial(slot));
+                        // Tells the splits apart in the .rzmodel and the logs, the .rzmesh files are named by index so the names may still collide
+                        slots[slot].name = slot == 0 ? name : name + "_" + std::to_string(slot);
+                        sources.push_back(std::move(slots[slot]));
+                    }
+                }
+
+                if (sources.empty()) {
+                    RAZIX_PACKER_LOG_ERROR("No meshes in model : " << meshFilePath);
+                    scene->destroy();
+                    return false;
+                }
+
+                // Every submesh is welded independently
+                std::vector<FBXWeldedSubMesh> welded(sources.size());
+                auto                          weldJob = [&](uint32_t i) {
+                    RAZIX_PACKER_PROFILE_ZONE("Weld Submesh");
+                    WeldSubMesh(sources[i], options.flipUVs, welded[i]);
+                };
+                if (options.jobSystem)
+                    options.jobSystem->parallelFor(static_cast<uint32_t>(sources.size()), weldJob);
+                else {
+                    for (uint32_t i = 0; i < sources.size(); i++)
+                        weldJob(i);
+                }
+
+                uint32_t vertex_count = 0;
+                uint32_t index_count  = 0;
+                result.submeshes.resize(sources.size());
+                for (size_t i = 0; i < sources.size(); i++) {
+                    auto& submesh = result.submeshes[i];
+                    strcpy_s(submesh.name, sources[i].name.c_str());
+                    submesh.material_index = sources[i].materialIndex;
+                    submesh.materialName   = result.materials[submesh.material_index].m_Name;
+                    submesh.vertex_count   = static_cast<uint32_t>(welded[i].positions.size());
+                    submesh.index_count    = static_cast<uint32_t>(welded[i].indices.size());
+                    submesh.base_vertex    = vertex_count;
+                    submesh.base_index     = index_count;
+
+                    vertex_count += submesh.vertex_count;
+                    index_count += submesh.index_count;
+                }
+
+                result.vertices.setSize(vertex_count);
+                result.tangent_signs.resize(vertex_count);
+                result.indices.resize(index_count);
+                for (size_t i = 0; i < sources.size(); i++) {
+                    auto&    submesh = result.submeshes[i];
+                    auto&    src     = welded[i];
+                    uint32_t base    = submesh.base_vertex;
+
+                    std::copy(src.positions.begin(), src.positions.end(), result.vertices.Position.begin() + base);
+                    std::copy(src.normals.begin(), src.normals.end(), result.vertices.Normal.begin() + base);
+                    std::copy(src.tangents.begin(), src.tangents.end(), result.vertices.Tangent.begin() + base);
+                    std::copy(src.tangentSigns.begin(), src.tangentSigns.end(), result.tangent_signs.begin() + base);
+                    std::copy(src.uvs.begin(), src.uvs.end(), result.vertices.UV.begin() + base);
+                    std::copy(src.indices.begin(), src.indices.end(), result.indices.begin() + submesh.base_index);
+
+                    ComputeBounds(result.vertices.Position.data() + base, submesh.vertex_count, submesh.min_extents, submesh.max_extents);
+                    if (i == 0) {
+                        result.min_extents = submesh.min_extents;
+                        result.max_extents = submesh.max_extents;
+                    } else {
+                        result.min_extents = glm::min(result.min_extents, submesh.min_extents);
+                        result.max_extents = glm::max(result.max_extents, submesh.max_extents);
+                    }
+                }
+
+                std::unordered_map<const ofbx::Mesh*, std::vector<uint32_t>> meshSubMeshes;
+                for (uint32_t i = 0; i < sources.size(); i++)
+                    meshSubMeshes[sources[i].mesh].push_back(i);
+
+                uint32_t root = result.hierarchy.addNode(meshName, MESH_HIERARCHY_NO_PARENT);
+                ExtractHierarchy(result.hierarchy, root, scene->getRoot(), meshSubMeshes);
+
+                scene->destroy();
+
+                auto                          finish = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> time   = finish - start;
+
+                RAZIX_PACKER_LOG_INFO("Successfully Imported mesh (" << result.submeshes.size() << " submeshes, " << vertex_count << " vertices) in " << time.count() << " seconds");
+                return true;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "MeshImporterBackend.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Imports .fbx files with OpenFBX, a lot faster and lighter than the Assimp FBX importer
+             *
+             * OpenFBX triangulates and expands every attribute per triangle corner, the corners of every submesh are welded back
+             * into indexed vertices with meshopt_generateVertexRemapMulti. Meshes are split by material like Assimp does,
+             * missing tangents are generated from the UVs. Geometry stays in the space of it's node, the node transforms
+             * go to the hierarchy. Geometry parsing and welding run on the MeshImportOptions job system when it's set
+             */
+            class OpenFBXImporterBackend final : public MeshImporterBackend
+            {
+            public:
+                const char* getName() const override { return "OpenFBX"; }
+                bool        canImport(const std::string& extension) const override { return extension == "fbx"; }
+                bool        importMesh(const std::string& meshFilePath, MeshImportResult& result, const MeshImportOptions& options) override;
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,108 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            MappedFile::~MappedFile()
+            {
+                close();
+            }
+
+#ifdef _WIN32
+            bool MappedFile::open(const std::string& filePath)
+            {
+                close();
+
+                HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+                if (file == INVALID_HANDLE_VALUE)
+                    return false;
+                m_File = file;
+
+                LARGE_INTEGER size;
+                if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+                    close();
+                    return false;
+                }
+
+                m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!m_Mapping) {
+                    close();
+                    return false;
+                }
+
+                m_Data = static_cast<const uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+                m_Size = static_cast<uint64_t>(size.QuadPart);
+                if (!m_Data) {
+                    close();
+                    return false;
+                }
+                return true;
+            }
+
+            void MappedFile::close()
+            {
+                if (m_Data)
+                    UnmapViewOfFile(m_Data);
+                if (m_Mapping)
+                    CloseHandle(m_Mapping);
+                if (m_File)
+                    CloseHandle(m_File);
+
+                m_Data    = nullptr;
+                m_Size    = 0;
+                m_Mapping = nullptr;
+                m_File    = nullptr;
+            }
+#else
+            bool MappedFile::open(const std::string& filePath)
+            {
+                close();
+
+                m_File = ::open(filePath.c_str(), O_RDONLY);
+                if (m_File < 0)
+                    return false;
+
+                struct stat st;
+                if (fstat(m_File, &st) != 0 || st.st_size == 0) {
+                    close();
+                    return false;
+                }
+
+                void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, m_File, 0);
+                if (data == MAP_FAILED) {
+                    close();
+                    return false;
+                }
+
+                m_Data = static_cast<const uint8_t*>(data);
+                m_Size = static_cast<uint64_t>(st.st_size);
+                return true;
+            }
+
+            void MappedFile::close()
+            {
+                if (m_Data)
+                    munmap(const_cast<uint8_t*>(m_Data), static_cast<size_t>(m_Size));
+                if (m_File >= 0)
+                    ::close(m_File);
+
+                m_Data = nullptr;
+                m_Size = 0;
+                m_File = -1;
+            }
+#endif
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Read only memory mapping of a whole file
+             */
+            class MappedFile
+            {
+            public:
+                MappedFile() = default;
+                ~MappedFile();
+
+                MappedFile(const MappedFile&)            = delete;
+                MappedFile& operator=(const MappedFile&) = delete;
+
+                bool open(const std::string& filePath);
+                void close();
+
+                const uint8_t* getData() const { return m_Data; }
+                uint64_t       getSize() const { return m_Size; }
+                bool           isOpen() const { return m_Data != nullptr; }
+
+            private:
+                const uint8_t* m_Data = nullptr;
+                uint64_t       m_Size = 0;
+#ifdef _WIN32
+                void* m_File    = nullptr;
+                void* m_Mapping = nullptr;
+#else
+                int m_File = -1;
+#endif
+            };
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,71 @@
+#include "MaterialLibraryReader.h"
+
+#include <cstring>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            bool MaterialLibraryReader::open(const std::string& filePath)
+            {
+                close();
+
+                if (!m_File.open(filePath))
+                    return fail("Failed to map " + filePath);
+
+                uint64_t fileSize = m_File.getSize();
+                if (fileSize < sizeof(BINMaterialLibraryHeader))
+                    return fail("File is smaller than the material library header");
+
+                memcpy(&m_Header, m_File.getData(), sizeof(BINMaterialLibraryHeader));
+
+                if (m_Header.fourcc != RAZIX_MATERIAL_LIBRARY_FOURCC)
+                    return fail("Not a .rzmatlib file");
+                if (m_Header.version != RAZIX_MATERIAL_LIBRARY_VERSION)
+                    return fail("Unsupported material library version " + std::to_string(m_Header.version));
+                if (m_Header.file_size != fileSize)
+                    return fail("File size doesn't match the header, the file is truncated");
+
+                uint64_t materialsSize = uint64_t(m_Header.material_count) * sizeof(BINMaterial);
+                if (m_Header.materials_offset < sizeof(BINMaterialLibraryHeader) || m_Header.materials_offset % alignof(BINMaterial) != 0 || m_Header.materials_offset > fileSize || fileSize - m_Header.materials_offset < materialsSize)
+                    return fail("Material table is out of the file bounds");
+                if (m_Header.strings_offset > fileSize || fileSize - m_Header.strings_offset < m_Header.string_table_size)
+                    return fail("String table is out of the file bounds");
+                if (m_Header.string_table_size > 0 && m_File.getData()[m_Header.strings_offset + m_Header.string_table_size - 1] != '\0')
+                    return fail("String table isn't null terminated");
+
+                const BINMaterial* materials = getMaterials();
+                for (uint32_t i = 0; i < m_Header.material_count; i++) {
+                    if (materials[i].name_offset >= m_Header.string_table_size)
+                        return fail("Material " + std::to_string(i) + " name is out of the string table");
+                    for (uint32_t t = 0; t < MATERIAL_TEXTURE_COUNT; t++) {
+                        uint32_t texture = materials[i].textures[t];
+                        if (texture != RAZIX_MATERIAL_NO_TEXTURE && texture >= m_Header.string_table_size)
+                            return fail("Material " + std::to_string(i) + " texture " + std::to_string(t) + " is out of the string table");
+                    }
+                }
+
+                return true;
+            }
+
+            void MaterialLibraryReader::close()
+            {
+                m_File.close();
+                m_Header = {};
+                m_Error.clear();
+            }
+
+            const char* MaterialLibraryReader::getString(uint32_t offset) const
+            {
+                return offset == RAZIX_MATERIAL_NO_TEXTURE ? nullptr : reinterpret_cast<const char*>(m_File.getData()) + m_Header.strings_offset + offset;
+            }
+
+            bool MaterialLibraryReader::fail(const std::string& error)
+            {
+                m_Error = error;
+                m_File.close();
+                return false;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "common/rzmaterial_format.h"
+
+#include "MappedFile.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Memory maps a .rzmatlib file, validates the material table and the string references and exposes the materials in place
+             */
+            class MaterialLibraryReader
+            {
+            public:
+                MaterialLibraryReader()  = default;
+                ~MaterialLibraryReader() = default;
+
+                /* Returns false and sets the error if the file can't be mapped, any offset or size is invalid or a string is out of the table */
+                bool open(const std::string& filePath);
+                void close();
+
+                const std::string& getError() const { return m_Error; }
+
+                const BINMaterialLibraryHeader& getHeader() const { return m_Header; }
+
+                const BINMaterial* getMaterials() const { return reinterpret_cast<const BINMaterial*>(m_File.getData() + m_Header.materials_offset); }
+                /* offset is a name_offset or a texture, nullptr for RAZIX_MATERIAL_NO_TEXTURE */
+                const char* getString(uint32_t offset) const;
+
+            private:
+                bool fail(const std::string& error);
+
+            private:
+                MappedFile               m_File;
+                BINMaterialLibraryHeader m_Header = {};
+                std::string              m_Error;
+            };
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
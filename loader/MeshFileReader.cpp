@@ -0,0 +1,205 @@
+#include "MeshFileReader.h"
+
+#include <cstring>
+
+#include "common/blob_codec.h"
+
+using namespace Razix::AssetSystem;
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            // Headers are copied out of the mapping, so they don't need to be aligned in the file
+            template<typename T>
+            static bool ReadStruct(const MappedFile& file, uint64_t offset, T& value)
+            {
+                if (offset > file.getSize() || file.getSize() - offset < sizeof(T))
+                    return false;
+                memcpy(&value, file.getData() + offset, sizeof(T));
+                return true;
+            }
+
+            bool BlobView::isNamed(const char* name) const
+            {
+                size_t length = strlen(name);
+                if (typeName.compare(0, length, name) != 0)
+                    return false;
+                return typeName.size() == length || typeName[length] == ':';
+            }
+
+            bool DecodeBlobView(const BlobView& blob, std::vector<uint8_t>& decoded)
+            {
+                decoded.resize(blob.encoding.decoded_size);
+                if (blob.encoding.decoded_size == 0)
+                    return true;
+
+                if (blob.isRaw()) {
+                    memcpy(decoded.data(), blob.data, blob.encoding.decoded_size);
+                    return true;
+                }
+                return DecodeBlob(blob.data, blob.encoding, blob.stride, decoded.data());
+            }
+
+            bool MeshFileReader::open(const std::string& filePath)
+            {
+                close();
+
+                if (!m_File.open(filePath))
+                    return fail("Failed to map " + filePath);
+
+                if (!ReadStruct(m_File, 0, m_FileHeader))
+                    return fail("File is smaller than the asset header");
+                if (memcmp(m_FileHeader.magic, RAZIX_ASSET_MAGIC, RAZIX_ASSET_MAGIC_SIZE) != 0)
+                    return fail("Not a razix asset");
+                if (m_FileHeader.type != ASSET_MESH)
+                    return fail("Not a mesh asset");
+                if (m_FileHeader.version != RAZIX_ASSET_VERSION_V2 && m_FileHeader.version != RAZIX_ASSET_VERSION_V3)
+                    return fail("Unsupported mesh version " + std::to_string(m_FileHeader.version));
+
+                uint64_t offset = sizeof(BINFileHeader);
+                if (!ReadStruct(m_File, offset, m_MeshHeader))
+                    return fail("Truncated mesh header");
+                offset += sizeof(BINMeshFileHeader);
+
+                if (m_FileHeader.version == RAZIX_ASSET_VERSION_V3) {
+                    if (!ReadStruct(m_File, offset, m_ExtHeader))
+                        return fail("Truncated mesh extension header");
+                    offset += sizeof(BINMeshExtHeader);
+                }
+
+                bool result = false;
+                if (isAligned()) {
+                    uint32_t alignment = m_ExtHeader.blob_alignment;
+                    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+                        return fail("Invalid blob alignment " + std::to_string(alignment));
+                    result = readAlignedBlobs(offset);
+                } else {
+                    // Without extensions the index buffer is stored raw before the blobs
+                    if (m_FileHeader.version == RAZIX_ASSET_VERSION_V2) {
+                        BlobView indices;
+                        indices.typeName               = "INDEX:R32_UINT";
+                        indices.stride                 = sizeof(uint32_t);
+                        indices.encoding.element_count = m_MeshHeader.index_count;
+                        indices.encoding.decoded_size  = m_MeshHeader.index_count * sizeof(uint32_t);
+                        indices.encoding.codec_size    = indices.encoding.decoded_size;
+                        indices.encoding.encoded_size  = indices.encoding.decoded_size;
+                        indices.offset                 = offset;
+                        if (!validateBlob(indices))
+                            return false;
+                        indices.data = m_File.getData() + offset;
+
+                        m_Blobs.push_back(indices);
+                        offset += indices.encoding.encoded_size;
+                    }
+                    result = readSequentialBlobs(offset, m_FileHeader.version == RAZIX_ASSET_VERSION_V3);
+                }
+
+                if (result && (m_Blobs.empty() || !m_Blobs[0].isNamed("INDEX")))
+                    return fail("Missing index buffer");
+
+                return result;
+            }
+
+            void MeshFileReader::close()
+            {
+                m_File.close();
+                m_FileHeader = {};
+                m_MeshHeader = {};
+                m_ExtHeader  = {};
+                m_Blobs.clear();
+                m_Error.clear();
+            }
+
+            const BlobView* MeshFileReader::findBlob(const char* name) const
+            {
+                for (const auto& blob: m_Blobs) {
+                    if (blob.isNamed(name))
+                        return &blob;
+                }
+                return nullptr;
+            }
+
+            bool MeshFileReader::fail(const std::string& error)
+            {
+                m_Error = error;
+                m_File.close();
+                m_Blobs.clear();
+                return false;
+            }
+
+            bool MeshFileReader::validateBlob(const BlobView& blob)
+            {
+                const auto& encoding = blob.encoding;
+                if (blob.offset > m_File.getSize() || m_File.getSize() - blob.offset < encoding.encoded_size)
+                    return fail("Blob " + blob.typeName + " is out of the file bounds");
+                if (uint64_t(encoding.element_count) * blob.stride != encoding.decoded_size)
+                    return fail("Blob " + blob.typeName + " has an invalid decoded size");
+                if (blob.isRaw() && encoding.encoded_size != encoding.decoded_size)
+                    return fail("Raw blob " + blob.typeName + " has an invalid size");
+                if (isAligned() && blob.offset % m_ExtHeader.blob_alignment != 0)
+                    return fail("Blob " + blob.typeName + " is not aligned to " + std::to_string(m_ExtHeader.blob_alignment));
+                return true;
+            }
+
+            bool MeshFileReader::readSequentialBlobs(uint64_t offset, bool hasEncoding)
+            {
+                for (uint32_t i = 0; i < m_MeshHeader.blobs_count; i++) {
+                    BINBlobHeader header{};
+                    if (!ReadStruct(m_File, offset, header))
+                        return fail("Truncated blob header");
+                    offset += sizeof(BINBlobHeader);
+
+                    BlobView blob;
+                    blob.typeName = std::string(header.typeName, strnlen(header.typeName, sizeof(header.typeName)));
+                    blob.stride   = header.stride;
+                    if (hasEncoding) {
+                        if (!ReadStruct(m_File, offset, blob.encoding))
+                            return fail("Truncated blob encoding");
+                        offset += sizeof(BINBlobEncoding);
+
+                        if (blob.encoding.encoded_size != header.size)
+                            return fail("Blob " + blob.typeName + " sizes don't match");
+                    } else {
+                        blob.encoding.element_count = header.stride ? header.size / header.stride : 0;
+                        blob.encoding.decoded_size  = header.size;
+                        blob.encoding.codec_size    = header.size;
+                        blob.encoding.encoded_size  = header.size;
+                    }
+                    blob.offset = offset;
+                    if (!validateBlob(blob))
+                        return false;
+                    blob.data = m_File.getData() + offset;
+
+                    offset += header.size;
+                    m_Blobs.push_back(blob);
+                }
+                return true;
+            }
+
+            bool MeshFileReader::readAlignedBlobs(uint64_t offset)
+            {
+                for (uint32_t i = 0; i < m_MeshHeader.blobs_count; i++) {
+                    BINBlobEntry entry{};
+                    if (!ReadStruct(m_File, offset + sizeof(BINBlobEntry) * i, entry))
+                        return fail("Truncated blob table");
+
+                    BlobView blob;
+                    blob.typeName = std::string(entry.header.typeName, strnlen(entry.header.typeName, sizeof(entry.header.typeName)));
+                    blob.stride   = entry.header.stride;
+                    blob.encoding = entry.encoding;
+                    blob.offset   = entry.offset;
+
+                    if (blob.encoding.encoded_size != entry.header.size)
+                        return fail("Blob " + blob.typeName + " sizes don't match");
+                    if (!validateBlob(blob))
+                        return false;
+                    blob.data = m_File.getData() + entry.offset;
+
+                    m_Blobs.push_back(blob);
+                }
+                return true;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
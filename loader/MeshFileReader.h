@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/rzmesh_format.h"
+
+#include "MappedFile.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * A blob (or .rzpack section) inside a mapped file, data points into the mapping and stays valid while the reader is open
+             * Raw blobs can be used in place, encoded ones have to go through decodeBlob first
+             */
+            struct BlobView
+            {
+                std::string     typeName;
+                uint32_t        stride   = 0;
+                BINBlobEncoding encoding = {};
+                uint64_t        offset   = 0;       /* From the start of the file */
+                const uint8_t*  data     = nullptr; /* encoding.encoded_size bytes */
+
+                bool isRaw() const { return encoding.flags == BLOB_ENCODING_RAW; }
+                /* Matches the full type name or only the attribute, ex. "POSITION" for "POSITION:R32G32B32" */
+                bool isNamed(const char* name) const;
+            };
+
+            /* Decodes any blob view to decoded (encoding.decoded_size bytes) */
+            bool DecodeBlobView(const BlobView& blob, std::vector<uint8_t>& decoded);
+
+            /**
+             * Memory maps a .rzmesh file (V2 or V3), validates it and exposes it's blobs without copying them
+             * V2 files and V3 files without extensions store the index buffer outside the blobs, it is exposed as a raw "INDEX:R32_UINT" view
+             * so all the versions look the same, the first view is always the index buffer
+             */
+            class MeshFileReader
+            {
+            public:
+                MeshFileReader()  = default;
+                ~MeshFileReader() = default;
+
+                /* Returns false and sets the error if the file can't be mapped or any header, offset or size is invalid */
+                bool open(const std::string& filePath);
+                void close();
+
+                const std::string& getError() const { return m_Error; }
+
+                const Razix::AssetSystem::BINFileHeader&     getFileHeader() const { return m_FileHeader; }
+                const Razix::AssetSystem::BINMeshFileHeader& getMeshHeader() const { return m_MeshHeader; }
+                /* All zero for V2 files */
+                const BINMeshExtHeader& getExtHeader() const { return m_ExtHeader; }
+                bool                    isAligned() const { return m_ExtHeader.flags & MESH_EXT_ALIGNED_BLOBS; }
+
+                const std::vector<BlobView>& getBlobs() const { return m_Blobs; }
+                const BlobView*              findBlob(const char* name) const;
+
+            private:
+                bool fail(const std::string& error);
+                bool validateBlob(const BlobView& blob);
+                bool readSequentialBlobs(uint64_t offset, bool hasEncoding);
+                bool readAlignedBlobs(uint64_t offset);
+
+            private:
+                MappedFile                            m_File;
+                Razix::AssetSystem::BINFileHeader     m_FileHeader = {};
+                Razix::AssetSystem::BINMeshFileHeader m_MeshHeader = {};
+                BINMeshExtHeader                      m_ExtHeader  = {};
+                std::vector<BlobView>                 m_Blobs;
+                std::string                           m_Error;
+            };
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
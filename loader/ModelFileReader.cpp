@@ -0,0 +1,124 @@
+#include "ModelFileReader.h"
+
+#include <cstring>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            bool ModelFileReader::open(const std::string& filePath)
+            {
+                close();
+
+                if (!m_File.open(filePath))
+                    return fail("Failed to map " + filePath);
+
+                uint64_t fileSize = m_File.getSize();
+                if (fileSize < sizeof(BINModelHeader))
+                    return fail("File is smaller than the model header");
+
+                memcpy(&m_Header, m_File.getData(), sizeof(BINModelHeader));
+
+                if (m_Header.fourcc != RAZIX_MODEL_FOURCC)
+                    return fail("Not a .rzmodel file");
+                if (m_Header.version != RAZIX_MODEL_VERSION)
+                    return fail("Unsupported model version " + std::to_string(m_Header.version));
+                if (m_Header.alignment < sizeof(float) || (m_Header.alignment & (m_Header.alignment - 1)) != 0)
+                    return fail("Invalid array alignment " + std::to_string(m_Header.alignment));
+                if (m_Header.file_size != fileSize)
+                    return fail("File size doesn't match the header, the file is truncated");
+
+                const uint64_t nodes        = m_Header.node_count;
+                const uint64_t arraySizes[] = {
+                    nodes * sizeof(uint32_t),
+                    nodes * sizeof(float) * 3,
+                    nodes * sizeof(float) * 4,
+                    nodes * sizeof(float) * 3,
+                    nodes * sizeof(uint32_t),
+                    nodes * sizeof(BINModelMeshRange),
+                    uint64_t(m_Header.node_mesh_count) * sizeof(uint32_t),
+                    uint64_t(m_Header.submesh_count) * sizeof(BINModelSubMesh),
+                    uint64_t(m_Header.material_count) * sizeof(BINModelMaterial),
+                    m_Header.string_table_size,
+                };
+                static_assert(sizeof(arraySizes) / sizeof(arraySizes[0]) == MODEL_ARRAY_COUNT, "Every array needs a size");
+
+                for (uint32_t i = 0; i < MODEL_ARRAY_COUNT; i++) {
+                    uint64_t offset = m_Header.offsets[i];
+                    if (offset < sizeof(BINModelHeader) || offset > fileSize || fileSize - offset < arraySizes[i])
+                        return fail("Array " + std::to_string(i) + " is out of the file bounds");
+                    if (offset % m_Header.alignment != 0)
+                        return fail("Array " + std::to_string(i) + " is not aligned to " + std::to_string(m_Header.alignment));
+                }
+
+                if (m_Header.string_table_size > 0 && getArray<char>(MODEL_ARRAY_STRINGS)[m_Header.string_table_size - 1] != '\0')
+                    return fail("String table isn't null terminated");
+                if (!validateString(m_Header.name_offset, false) || !validateString(m_Header.pack_path_offset, true))
+                    return fail("Model name or pack path is out of the string table");
+
+                // Parents before children is what makes the linear world transform pass valid
+                const uint32_t*          parents = getArray<uint32_t>(MODEL_ARRAY_PARENTS);
+                const uint32_t*          names   = getArray<uint32_t>(MODEL_ARRAY_NAMES);
+                const BINModelMeshRange* ranges  = getArray<BINModelMeshRange>(MODEL_ARRAY_MESH_RANGES);
+                for (uint32_t i = 0; i < m_Header.node_count; i++) {
+                    if (i == 0 ? parents[i] != RAZIX_MODEL_NULL_NODE : parents[i] >= i)
+                        return fail("Node " + std::to_string(i) + " isn't in depth first order");
+                    if (!validateString(names[i], false))
+                        return fail("Node " + std::to_string(i) + " name is out of the string table");
+                    if (ranges[i].offset > m_Header.node_mesh_count || m_Header.node_mesh_count - ranges[i].offset < ranges[i].count)
+                        return fail("Node " + std::to_string(i) + " meshes are out of range");
+                }
+
+                const uint32_t* meshes = getArray<uint32_t>(MODEL_ARRAY_MESHES);
+                for (uint32_t i = 0; i < m_Header.node_mesh_count; i++) {
+                    if (meshes[i] >= m_Header.submesh_count)
+                        return fail("Node mesh " + std::to_string(meshes[i]) + " is out of range");
+                }
+
+                // A submesh is either in the pack or in it's own .rzmesh
+                const BINModelSubMesh* submeshes = getArray<BINModelSubMesh>(MODEL_ARRAY_SUBMESHES);
+                bool                   packed    = m_Header.pack_path_offset != RAZIX_MODEL_NO_STRING;
+                for (uint32_t i = 0; i < m_Header.submesh_count; i++) {
+                    if (m_Header.material_count > 0 && submeshes[i].material_index >= m_Header.material_count)
+                        return fail("Submesh " + std::to_string(i) + " material is out of range");
+                    if (!validateString(submeshes[i].name_offset, false) || !validateString(submeshes[i].path_offset, packed))
+                        return fail("Submesh " + std::to_string(i) + " name or path is out of the string table");
+                }
+
+                const BINModelMaterial* materials = getArray<BINModelMaterial>(MODEL_ARRAY_MATERIALS);
+                for (uint32_t i = 0; i < m_Header.material_count; i++) {
+                    if (!validateString(materials[i].name_offset, false) || !validateString(materials[i].path_offset, false))
+                        return fail("Material " + std::to_string(i) + " name or path is out of the string table");
+                }
+
+                return true;
+            }
+
+            void ModelFileReader::close()
+            {
+                m_File.close();
+                m_Header = {};
+                m_Error.clear();
+            }
+
+            const char* ModelFileReader::getString(uint32_t offset) const
+            {
+                return offset == RAZIX_MODEL_NO_STRING ? nullptr : getArray<char>(MODEL_ARRAY_STRINGS) + offset;
+            }
+
+            bool ModelFileReader::validateString(uint32_t offset, bool optional)
+            {
+                if (offset == RAZIX_MODEL_NO_STRING)
+                    return optional;
+                return offset < m_Header.string_table_size;
+            }
+
+            bool ModelFileReader::fail(const std::string& error)
+            {
+                m_Error = error;
+                m_File.close();
+                return false;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
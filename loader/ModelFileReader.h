@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "common/rzmodel_format.h"
+
+#include "MappedFile.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Memory maps a .rzmodel file, validates the arrays and the node references and exposes the arrays in place
+             * Arrays are aligned in the file and the mapping, so they can be used as the SoA node data directly
+             */
+            class ModelFileReader
+            {
+            public:
+                ModelFileReader()  = default;
+                ~ModelFileReader() = default;
+
+                /* Returns false and sets the error if the file can't be mapped, any offset or size is invalid or a node reference is out of range */
+                bool open(const std::string& filePath);
+                void close();
+
+                const std::string& getError() const { return m_Error; }
+
+                const BINModelHeader& getHeader() const { return m_Header; }
+
+                template<typename T>
+                const T* getArray(BINModelArray array) const
+                {
+                    return reinterpret_cast<const T*>(m_File.getData() + m_Header.offsets[array]);
+                }
+                /* offset is a name_offset/path_offset, nullptr for RAZIX_MODEL_NO_STRING */
+                const char* getString(uint32_t offset) const;
+
+            private:
+                bool fail(const std::string& error);
+                bool validateString(uint32_t offset, bool optional);
+
+            private:
+                MappedFile     m_File;
+                BINModelHeader m_Header = {};
+                std::string    m_Error;
+            };
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,101 @@
+#include "PackFileReader.h"
+
+#include <cstring>
+
+using namespace Razix::AssetSystem;
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            bool PackFileReader::open(const std::string& filePath)
+            {
+                close();
+
+                if (!m_File.open(filePath))
+                    return fail("Failed to map " + filePath);
+
+                uint64_t fileSize    = m_File.getSize();
+                uint64_t headersSize = sizeof(BINFileHeader) + sizeof(BINPackHeader);
+                if (fileSize < headersSize)
+                    return fail("File is smaller than the pack headers");
+
+                BINFileHeader fh{};
+                memcpy(&fh, m_File.getData(), sizeof(BINFileHeader));
+                memcpy(&m_Header, m_File.getData() + sizeof(BINFileHeader), sizeof(BINPackHeader));
+
+                if (memcmp(fh.magic, RAZIX_ASSET_MAGIC, RAZIX_ASSET_MAGIC_SIZE) != 0 || fh.type != ASSET_MESH)
+                    return fail("Not a razix mesh asset");
+                if (m_Header.fourcc != RAZIX_PACK_FOURCC)
+                    return fail("Not a .rzpack file");
+                if (m_Header.version != RAZIX_PACK_VERSION)
+                    return fail("Unsupported pack version " + std::to_string(m_Header.version));
+                if (m_Header.alignment == 0 || (m_Header.alignment & (m_Header.alignment - 1)) != 0)
+                    return fail("Invalid section alignment " + std::to_string(m_Header.alignment));
+                if (m_Header.file_size != fileSize)
+                    return fail("File size doesn't match the header, the file is truncated");
+                if ((fileSize - headersSize) / sizeof(BINPackSection) < m_Header.section_count)
+                    return fail("Truncated table of contents");
+
+                for (uint32_t i = 0; i < m_Header.section_count; i++) {
+                    BINPackSection section{};
+                    memcpy(&section, m_File.getData() + headersSize + sizeof(BINPackSection) * i, sizeof(BINPackSection));
+
+                    BlobView view;
+                    view.typeName = std::string(section.name, strnlen(section.name, sizeof(section.name)));
+                    view.stride   = section.stride;
+                    view.encoding = section.encoding;
+                    view.offset   = section.offset;
+
+                    const auto& encoding = view.encoding;
+                    if (view.offset > fileSize || fileSize - view.offset < encoding.encoded_size)
+                        return fail("Section " + view.typeName + " is out of the file bounds");
+                    if (view.offset % m_Header.alignment != 0)
+                        return fail("Section " + view.typeName + " is not aligned to " + std::to_string(m_Header.alignment));
+                    if (uint64_t(encoding.element_count) * view.stride != encoding.decoded_size)
+                        return fail("Section " + view.typeName + " has an invalid decoded size");
+                    if (view.isRaw() && encoding.encoded_size != encoding.decoded_size)
+                        return fail("Raw section " + view.typeName + " has an invalid size");
+
+                    view.data = m_File.getData() + view.offset;
+                    m_Sections.push_back(view);
+                }
+
+                // The counts in the header have to agree with the tables
+                const BlobView* submeshes = findSection("SUBMESH:TABLE");
+                if (!submeshes || submeshes->encoding.element_count != m_Header.submesh_count)
+                    return fail("Submesh table doesn't match the header");
+                const BlobView* nodes = findSection("NODE:TABLE");
+                if (nodes && nodes->encoding.element_count != m_Header.node_count)
+                    return fail("Node table doesn't match the header");
+
+                return true;
+            }
+
+            void PackFileReader::close()
+            {
+                m_File.close();
+                m_Header = {};
+                m_Sections.clear();
+                m_Error.clear();
+            }
+
+            const BlobView* PackFileReader::findSection(const char* name) const
+            {
+                for (const auto& section: m_Sections) {
+                    if (section.isNamed(name))
+                        return &section;
+                }
+                return nullptr;
+            }
+
+            bool PackFileReader::fail(const std::string& error)
+            {
+                m_Error = error;
+                m_File.close();
+                m_Sections.clear();
+                return false;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
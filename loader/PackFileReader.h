@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/rzpack_format.h"
+
+#include "MappedFile.h"
+#include "MeshFileReader.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Memory maps a .rzpack file, validates the table of contents and exposes the sections without copying them
+             */
+            class PackFileReader
+            {
+            public:
+                PackFileReader()  = default;
+                ~PackFileReader() = default;
+
+                /* Returns false and sets the error if the file can't be mapped or any header, offset or size is invalid */
+                bool open(const std::string& filePath);
+                void close();
+
+                const std::string& getError() const { return m_Error; }
+
+                const BINPackHeader& getHeader() const { return m_Header; }
+
+                const std::vector<BlobView>& getSections() const { return m_Sections; }
+                const BlobView*              findSection(const char* name) const;
+
+            private:
+                bool fail(const std::string& error);
+
+            private:
+                MappedFile            m_File;
+                BINPackHeader         m_Header = {};
+                std::vector<BlobView> m_Sections;
+                std::string           m_Error;
+            };
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,618 @@
+#include "AssetPipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+#include <assimp/Importer.hpp>
+
+#include "common/bounded_queue.h"
+#include "common/content_hash.h"
+#include "common/job_system.h"
+#include "common/log.h"
+#include "common/path_utils.h"
+#include "common/process_memory.h"
+#include "common/profiler.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            static uint64_t GetElapsedNs(std::chrono::high_resolution_clock::time_point start)
+            {
+                auto finish = std::chrono::high_resolution_clock::now();
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+            }
+
+            AssetPipeline::AssetPipeline(JobSystem& jobSystem)
+                : m_JobSystem(jobSystem), m_TextureProcessor(jobSystem)
+            {
+            }
+
+            bool AssetPipeline::packModel(const std::string& modelFilePath, const AssetPipelineOptions& options)
+            {
+                RAZIX_PACKER_PROFILE_ZONE("Pack Model", modelFilePath.c_str());
+
+                // Checked before anything is imported, an unchanged model costs a stat per file when the hashes are memoized
+                bool                     useBuildCache = m_BuildCache.isLoaded();
+                std::string              sourcePath    = NormalizePath(modelFilePath);
+                uint64_t                 buildKey      = 0;
+                std::vector<std::string> dependencies;
+                if (useBuildCache) {
+                    useBuildCache = m_BuildCache.computeKey(sourcePath, hashOptions(options), buildKey, dependencies);
+                    if (useBuildCache && !options.forceRebuild && m_BuildCache.isUpToDate(sourcePath, buildKey)) {
+                        RAZIX_PACKER_LOG_INFO("Up to date : " << modelFilePath);
+                        m_Stats.modelsSkipped++;
+                        return true;
+                    }
+                    // Until it's exported again the old outputs don't match the source anymore
+                    m_BuildCache.invalidate(sourcePath);
+                }
+
+                // .rzpack files need every submesh at once, so packed models always go through the whole model path
+                std::vector<std::string> outputFiles;
+                std::vector<std::string> textureFiles;
+                bool                     result = false;
+                if (options.streaming && !options.exportOptions.packModel)
+                    result = packModelStreamed(modelFilePath, options, outputFiles, textureFiles);
+                else
+                    result = packModelWhole(modelFilePath, options, outputFiles, textureFiles);
+
+                if (!result) {
+                    m_Stats.modelsFailed++;
+                    return false;
+                }
+
+                std::error_code ec;
+                uint64_t        sourceSize = std::filesystem::file_size(modelFilePath, ec);
+                if (!ec)
+                    m_Stats.bytesRead += sourceSize;
+
+                // Only the importer knows the textures of binary formats (.glb, .fbx), the key is recomputed if they changed the list
+                std::vector<std::string> resolved;
+                if (useBuildCache || m_ModelPackedCallback) {
+                    resolved = BuildCache::CollectDependencies(sourcePath);
+                    resolved.insert(resolved.end(), textureFiles.begin(), textureFiles.end());
+                    std::sort(resolved.begin(), resolved.end());
+                    resolved.erase(std::unique(resolved.begin(), resolved.end()), resolved.end());
+                }
+
+                if (useBuildCache) {
+                    if (resolved == dependencies || m_BuildCache.computeKeyFor(sourcePath, hashOptions(options), resolved, buildKey))
+                        m_BuildCache.update(sourcePath, buildKey, resolved, outputFiles);
+                }
+
+                m_Stats.modelsPacked++;
+
+                if (m_ModelPackedCallback)
+                    m_ModelPackedCallback(modelFilePath, outputFiles, resolved);
+
+                // Counter tracks of the trace, sampled once per model
+                if (IsProfilingEnabled()) {
+                    RecordProfileCounter("Import Bytes Read", m_Stats.bytesRead.load());
+                    RecordProfileCounter("Export Bytes Written", m_Stats.bytesWritten.load());
+                    RecordProfileCounter("Animation Bytes Written", m_Stats.animBytes.load());
+                    RecordProfileCounter("Texture Bytes Written", m_TextureProcessor.getStats().bytesWritten.load());
+                    RecordProfileCounter("Resident Bytes", GetCurrentResidentBytes());
+                    RecordProfileCounter("Allocations", GetAllocationCount());
+                }
+                return true;
+            }
+
+            bool AssetPipeline::packModelWhole(const std::string& modelFilePath, const AssetPipelineOptions& options, std::vector<std::string>& outputFiles, std::vector<std::string>& textureFiles)
+            {
+                // Importer and exporter keep per model state, so every model gets it's own
+                MeshImportResult import_result;
+                MeshImporter     importer;
+                {
+                    RAZIX_PACKER_PROFILE_ZONE("Import");
+                    auto start = std::chrono::high_resolution_clock::now();
+
+                    MeshImportOptions importOptions = options.importOptions;
+                    importOptions.jobSystem         = &m_JobSystem;
+
+                    bool result = importer.importMesh(modelFilePath, import_result, importOptions);
+
+                    m_Stats.importTimeNs += GetElapsedNs(start);
+                    addImportTimings(importer.getTimings());
+
+                    if (!result) {
+                        RAZIX_PACKER_LOG_ERROR("Mesh Importing Failed : " << modelFilePath);
+                        return false;
+                    }
+                }
+
+                // Textures are compressed in the background while the mesh is processed
+                std::vector<std::string> textureOutputs;
+                MeshImporter::CollectTextureFiles(import_result.materials, textureFiles);
+                if (options.processTextures)
+                    m_TextureProcessor.processMaterials(import_result.materials, options.textureOptions, options.exportOptions.assetsOutputDirectory + "Cache/Textures/", options.forceRebuild, textureOutputs);
+
+                if (!processStages(import_result, options, modelFilePath))
+                    return false;
+
+                {
+                    RAZIX_PACKER_PROFILE_ZONE("Export");
+                    auto start = std::chrono::high_resolution_clock::now();
+
+                    MeshExportOptions export_options = options.exportOptions;
+                    export_options.jobSystem         = &m_JobSystem;
+                    export_options.geometry          = &m_Geometry;
+
+                    MeshExporter exporter;
+                    bool         result = exporter.exportMesh(import_result, export_options);
+
+                    m_Stats.exportTimeNs += GetElapsedNs(start);
+                    m_Stats.bytesWritten += exporter.getBytesWritten();
+
+                    if (!result) {
+                        RAZIX_PACKER_LOG_ERROR("Mesh Export Failed : " << modelFilePath);
+                        return false;
+                    }
+
+                    outputFiles = exporter.getOutputFiles();
+                    outputFiles.insert(outputFiles.end(), textureOutputs.begin(), textureOutputs.end());
+                }
+
+                return packAnimations(import_result, options, modelFilePath, outputFiles);
+            }
+
+            bool AssetPipeline::packModelStreamed(const std::string& modelFilePath, const AssetPipelineOptions& options, std::vector<std::string>& outputFiles, std::vector<std::string>& textureFiles)
+            {
+                MeshImportOptions importOptions = options.importOptions;
+                importOptions.jobSystem         = &m_JobSystem;
+
+                MeshExportOptions exportOptions = options.exportOptions;
+                exportOptions.jobSystem         = &m_JobSystem;
+                exportOptions.geometry          = &m_Geometry;
+
+                MeshImportResult  model;
+                MeshImporter      importer;
+                MeshExporter      exporter;
+                bool              exportStarted = false;
+                std::atomic<bool> success       = true;
+                uint64_t          producerNs    = 0; /* Time the importer spent packing chunks itself, it's not import time */
+
+                uint32_t                                        queueDepth = options.streamQueueDepth ? options.streamQueueDepth : m_JobSystem.getWorkersCount();
+                BoundedQueue<std::unique_ptr<MeshImportResult>> queue(queueDepth);
+                JobCounter                                      counter;
+
+                // Jobs pack whichever chunk is at the front, the importer may already have taken the one a job was submitted for
+                // A chunk is released as soon as it's written, so only the queued chunks and the ones being packed are resident
+                auto packChunkJob = [&]() {
+                    std::unique_ptr<MeshImportResult> chunk;
+                    if (!queue.tryPop(chunk) || !success)
+                        return;
+
+                    if (!processStages(*chunk, options, modelFilePath)) {
+                        success = false;
+                        return;
+                    }
+
+                    RAZIX_PACKER_PROFILE_ZONE("Export Chunk");
+                    auto start  = std::chrono::high_resolution_clock::now();
+                    bool result = exporter.exportChunk(model, *chunk, exportOptions);
+                    m_Stats.exportTimeNs += GetElapsedNs(start);
+
+                    if (!result) {
+                        RAZIX_PACKER_LOG_ERROR("Mesh Export Failed : " << modelFilePath << " (" << chunk->submeshes[0].name << ")");
+                        success = false;
+                    }
+                };
+
+                auto onChunk = [&](MeshImportResult& chunk) {
+                    auto start = std::chrono::high_resolution_clock::now();
+
+                    // The model layout is complete before the first chunk
+                    if (!exportStarted) {
+                        if (!exporter.beginExport(model, exportOptions))
+                            return false;
+                        exportStarted = true;
+                    }
+
+                    // A full queue means the workers are behind, the importer packs a chunk instead of converting more submeshes
+                    auto item = std::make_unique<MeshImportResult>(std::move(chunk));
+                    while (!queue.tryPush(item))
+                        packChunkJob();
+                    m_JobSystem.submit(packChunkJob, &counter);
+
+                    producerNs += GetElapsedNs(start);
+                    return success.load();
+                };
+
+                RAZIX_PACKER_PROFILE_ZONE("Import");
+                auto start    = std::chrono::high_resolution_clock::now();
+                bool imported = importer.importMeshStreamed(modelFilePath, model, onChunk, importOptions);
+                m_Stats.importTimeNs += GetElapsedNs(start) - producerNs;
+                addImportTimings(importer.getTimings());
+
+                // Queued chunks reference the model and the exporter
+                m_JobSystem.wait(counter);
+
+                if (!imported || !success) {
+                    // A failed chunk stops the import, it already printed why
+                    if (success)
+                        RAZIX_PACKER_LOG_ERROR("Mesh Importing Failed : " << modelFilePath);
+                    m_Stats.bytesWritten += exporter.getBytesWritten();
+                    return false;
+                }
+
+                // The materials are only written by endExport, the chunks don't reference the texture paths
+                std::vector<std::string> textureOutputs;
+                MeshImporter::CollectTextureFiles(model.materials, textureFiles);
+                if (options.processTextures)
+                    m_TextureProcessor.processMaterials(model.materials, options.textureOptions, options.exportOptions.assetsOutputDirectory + "Cache/Textures/", options.forceRebuild, textureOutputs);
+
+                RAZIX_PACKER_PROFILE_ZONE("Export");
+                start = std::chrono::high_resolution_clock::now();
+
+                bool result = (exportStarted || exporter.beginExport(model, exportOptions)) && exporter.endExport(model);
+
+                m_Stats.exportTimeNs += GetElapsedNs(start);
+                m_Stats.bytesWritten += exporter.getBytesWritten();
+
+                if (!result) {
+                    RAZIX_PACKER_LOG_ERROR("Mesh Export Failed : " << modelFilePath);
+                    return false;
+                }
+
+                outputFiles = exporter.getOutputFiles();
+                outputFiles.insert(outputFiles.end(), textureOutputs.begin(), textureOutputs.end());
+
+                // The skeleton and the clips are part of the model layout, the chunks only carry the weights
+                return packAnimations(model, options, modelFilePath, outputFiles);
+            }
+
+            bool AssetPipeline::processStages(MeshImportResult& import_result, const AssetPipelineOptions& options, const std::string& modelFilePath)
+            {
+                {
+                    RAZIX_PACKER_PROFILE_ZONE("Process");
+                    auto start = std::chrono::high_resolution_clock::now();
+
+                    // The weld tolerance is an import option, Assimp only joins the vertices that are exactly the same
+                    MeshProcessingOptions processingOptions = options.processingOptions;
+                    processingOptions.weldDistance          = options.importOptions.mergeDistance;
+
+                    MeshProcessor processor;
+                    bool          result = processor.processMesh(import_result, processingOptions, &m_JobSystem);
+
+                    m_Stats.processTimeNs += GetElapsedNs(start);
+
+                    if (!result) {
+                        RAZIX_PACKER_LOG_ERROR("Mesh Processing Failed : " << modelFilePath);
+                        return false;
+                    }
+                }
+
+                // LODs index the final vertex order, so they are built after the processor has remapped the vertices
+                if (options.generateLODs) {
+                    RAZIX_PACKER_PROFILE_ZONE("LODs");
+                    auto start = std::chrono::high_resolution_clock::now();
+
+                    LODGenerator generator;
+                    bool         result = generator.generateLODs(import_result, options.lodOptions, &m_JobSystem);
+
+                    m_Stats.lodTimeNs += GetElapsedNs(start);
+
+                    if (!result) {
+                        RAZIX_PACKER_LOG_ERROR("LOD Generation Failed : " << modelFilePath);
+                        return false;
+                    }
+                }
+
+                if (options.generateMeshlets) {
+                    RAZIX_PACKER_PROFILE_ZONE("Meshlets");
+                    auto start = std::chrono::high_resolution_clock::now();
+
+                    MeshletGenerator generator;
+                    bool             result = generator.generateMeshlets(import_result, options.meshletOptions, &m_JobSystem);
+
+                    m_Stats.meshletTimeNs += GetElapsedNs(start);
+
+                    if (!result) {
+                        RAZIX_PACKER_LOG_ERROR("Meshlet Generation Failed : " << modelFilePath);
+                        return false;
+                    }
+                }
+
+                if (options.generateBVH) {
+                    RAZIX_PACKER_PROFILE_ZONE("BVHs");
+                    auto start = std::chrono::high_resolution_clock::now();
+
+                    BVHBuilder builder;
+                    bool       result = builder.buildBVHs(import_result, options.bvhOptions, &m_JobSystem);
+
+                    m_Stats.bvhTimeNs += GetElapsedNs(start);
+
+                    if (!result) {
+                        RAZIX_PACKER_LOG_ERROR("BVH Build Failed : " << modelFilePath);
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            bool AssetPipeline::packAnimations(const MeshImportResult& model, const AssetPipelineOptions& options, const std::string& modelFilePath, std::vector<std::string>& outputFiles)
+            {
+                if (model.skeleton.bones.empty())
+                    return true;
+
+                RAZIX_PACKER_PROFILE_ZONE("Animations");
+                auto start = std::chrono::high_resolution_clock::now();
+
+                // Clips are independent, every one is reduced and quantized on it's own job
+                uint32_t                             clipsCount = static_cast<uint32_t>(model.animations.size());
+                std::vector<CompressedAnimationClip> clips(clipsCount);
+                std::atomic<bool>                    compressed = true;
+                auto                                 compressJob = [&](uint32_t i) {
+                    RAZIX_PACKER_PROFILE_ZONE("Compress Clip");
+                    AnimationCompressor compressor;
+                    if (!compressor.compressClip(model.animations[i], model.skeleton, options.animationOptions, clips[i]))
+                        compressed = false;
+                };
+                m_JobSystem.parallelFor(clipsCount, compressJob);
+
+                if (!compressed) {
+                    m_Stats.animTimeNs += GetElapsedNs(start);
+                    RAZIX_PACKER_LOG_ERROR("Animation Compression Failed : " << modelFilePath);
+                    return false;
+                }
+
+                AnimationExporter exporter;
+                bool              result = exporter.exportAnimations(model, clips, options.exportOptions.assetsOutputDirectory);
+
+                m_Stats.animTimeNs += GetElapsedNs(start);
+                m_Stats.bytesWritten += exporter.getBytesWritten();
+
+                if (!result) {
+                    RAZIX_PACKER_LOG_ERROR("Animation Export Failed : " << modelFilePath);
+                    return false;
+                }
+
+                for (const auto& clip: clips)
+                    m_Stats.animRawBytes += clip.rawSize;
+                m_Stats.animBytes += exporter.getBytesWritten();
+                m_Stats.animClips += clipsCount;
+
+                outputFiles.insert(outputFiles.end(), exporter.getOutputFiles().begin(), exporter.getOutputFiles().end());
+                return true;
+            }
+
+            bool AssetPipeline::packBatch(const std::vector<std::string>& modelFilePaths, const AssetPipelineOptions& options)
+            {
+                RAZIX_PACKER_PROFILE_ZONE("Pack Batch");
+
+                if (options.useBuildCache) {
+                    RAZIX_PACKER_PROFILE_ZONE("Load Build Cache");
+                    m_BuildCache.load(options.exportOptions.assetsOutputDirectory + "Cache/build_cache.txt");
+                }
+                m_Geometry.clear();
+
+                std::atomic<bool> success = true;
+                JobCounter        counter;
+
+                for (const auto& modelFilePath: modelFilePaths) {
+                    m_JobSystem.submit(
+                        [this, &success, &options, modelFilePath]() {
+                            if (!packModel(modelFilePath, options))
+                                success = false;
+                        },
+                        &counter);
+                }
+
+                m_JobSystem.wait(counter);
+
+                {
+                    RAZIX_PACKER_PROFILE_ZONE("Wait Textures");
+                    // The models were recorded before their textures finished, the ones referencing a failed texture are built again next time
+                    std::vector<std::string> failedTextures;
+                    if (!m_TextureProcessor.wait(failedTextures)) {
+                        success = false;
+                        m_BuildCache.invalidateOutputs(failedTextures);
+                    }
+                }
+
+                // Saved even if some models failed, the ones that succeeded don't have to be packed again
+                if (options.useBuildCache) {
+                    RAZIX_PACKER_PROFILE_ZONE("Save Build Cache");
+                    if (!m_BuildCache.save())
+                        success = false;
+                }
+
+                RecordProfileCounter("Peak Resident Bytes", GetPeakResidentBytes());
+                return success;
+            }
+
+            std::vector<std::string> AssetPipeline::getRecordedDependencies(const std::string& modelFilePath)
+            {
+                return m_BuildCache.getDependencies(NormalizePath(modelFilePath));
+            }
+
+            void AssetPipeline::addImportTimings(const MeshImportTimings& timings)
+            {
+                m_Stats.readTimeNs += timings.readNs;
+                m_Stats.layoutTimeNs += timings.layoutNs;
+                m_Stats.convertTimeNs += timings.convertNs;
+                m_Stats.normalsTimeNs += timings.normalsNs;
+                m_Stats.tangentTimeNs += timings.tangentsNs;
+            }
+
+            void AssetPipeline::printStats(double wallTime) const
+            {
+                constexpr double kNsToSeconds = 1e-9;
+                constexpr double kBytesToMB   = 1.0 / (1024.0 * 1024.0);
+
+                // The buffered log lines go first, the stats are the last thing of the batch
+                FlushLog();
+
+                uint32_t models = m_Stats.modelsPacked.load();
+                double   mbIn   = m_Stats.bytesRead.load() * kBytesToMB;
+                double   mbOut  = m_Stats.bytesWritten.load() * kBytesToMB;
+
+                std::cout << "---------------------------------------\n";
+                std::cout << "Packed " << models << " models (" << m_Stats.modelsFailed.load() << " failed, " << m_Stats.modelsSkipped.load() << " up to date) on " << m_JobSystem.getWorkersCount() << " workers in " << wallTime << " seconds\n";
+                std::cout << "  Import  : " << m_Stats.importTimeNs.load() * kNsToSeconds << " s (thread time), " << mbIn << " MB, read " << m_Stats.readTimeNs.load() * kNsToSeconds << " s, layout " << m_Stats.layoutTimeNs.load() * kNsToSeconds << " s, convert "
+                          << m_Stats.convertTimeNs.load() * kNsToSeconds << " s, normals " << m_Stats.normalsTimeNs.load() * kNsToSeconds << " s, tangents " << m_Stats.tangentTimeNs.load() * kNsToSeconds << " s\n";
+                std::cout << "  Process : " << m_Stats.processTimeNs.load() * kNsToSeconds << " s (thread time)\n";
+                std::cout << "  LODs    : " << m_Stats.lodTimeNs.load() * kNsToSeconds << " s (thread time)\n";
+                std::cout << "  Meshlets: " << m_Stats.meshletTimeNs.load() * kNsToSeconds << " s (thread time)\n";
+                if (m_Stats.bvhTimeNs)
+                    std::cout << "  BVHs    : " << m_Stats.bvhTimeNs.load() * kNsToSeconds << " s (thread time)\n";
+                std::cout << "  Export  : " << m_Stats.exportTimeNs.load() * kNsToSeconds << " s (thread time), " << mbOut << " MB written\n";
+                if (m_Stats.animClips || m_Stats.animBytes) {
+                    double ratio = m_Stats.animBytes ? static_cast<double>(m_Stats.animRawBytes.load()) / static_cast<double>(m_Stats.animBytes.load()) : 0.0;
+                    std::cout << "  Anims   : " << m_Stats.animTimeNs.load() * kNsToSeconds << " s (thread time), " << m_Stats.animClips.load() << " clips, " << m_Stats.animRawBytes.load() * kBytesToMB << " MB of keys -> " << m_Stats.animBytes.load() * kBytesToMB
+                              << " MB (" << ratio << "x)\n";
+                }
+                if (wallTime > 0.0) {
+                    std::cout << "  Throughput : " << models / wallTime << " models/s, " << mbIn / wallTime << " MB/s in (" << mbIn << " MB), " << mbOut / wallTime << " MB/s out (" << mbOut << " MB)\n";
+                }
+                if (m_Geometry.getReferenceCount()) {
+                    std::cout << "  Dedup   : " << m_Geometry.getUniqueCount() << " unique submeshes, " << m_Geometry.getReferenceCount() << " duplicates referenced instead of written (" << m_Geometry.getSavedBytes() * kBytesToMB
+                              << " MB of streams)\n";
+                }
+                const auto& textureStats = m_TextureProcessor.getStats();
+                if (textureStats.processed || textureStats.upToDate || textureStats.failed) {
+                    std::cout << "  Textures: " << textureStats.processTimeNs.load() * kNsToSeconds << " s (thread time), " << textureStats.processed.load() << " compressed (" << textureStats.bytesWritten.load() * kBytesToMB << " MB), "
+                              << textureStats.shared.load() << " shared, " << textureStats.upToDate.load() << " up to date, " << textureStats.failed.load() << " failed\n";
+                }
+                std::cout << "  Peak RSS   : " << GetPeakResidentBytes() * kBytesToMB << " MB\n";
+                if (GetAllocationCount())
+                    std::cout << "  Allocations: " << GetAllocationCount() << " (" << GetAllocatedBytes() * kBytesToMB << " MB)\n";
+                std::cout << "---------------------------------------" << std::endl;
+            }
+
+            uint64_t AssetPipeline::hashOptions(const AssetPipelineOptions& options)
+            {
+                // Field by field, hashing the structs would pick up their padding
+                std::string key;
+                auto        add = [&key](const auto& value) {
+                    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+                };
+
+                const auto& importOptions = options.importOptions;
+                add(importOptions.flipUVs);
+                add(importOptions.encodeVertices);
+                add(importOptions.encodeIndices);
+                add(importOptions.mergeDistance);
+                add(importOptions.backend);
+                add(importOptions.importSkinning);
+                add(importOptions.keepInstances);
+                add(importOptions.preset);
+                if (importOptions.importSkinning) {
+                    add(options.animationOptions.positionTolerance);
+                    add(options.animationOptions.rotationTolerance);
+                    add(options.animationOptions.scaleTolerance);
+                }
+
+                const auto& processingOptions = options.processingOptions;
+                add(processingOptions.weldVertices);
+                if (processingOptions.weldVertices) {
+                    add(processingOptions.weldNormalAngle);
+                    add(processingOptions.weldUVDistance);
+                }
+                add(processingOptions.optimizeVertexCache);
+                add(processingOptions.optimizeOverdraw);
+                add(processingOptions.overdrawThreshold);
+                add(processingOptions.optimizeVertexFetch);
+
+                add(options.generateLODs);
+                if (options.generateLODs) {
+                    add(options.lodOptions.maxLODs);
+                    add(options.lodOptions.targetRatio);
+                    add(options.lodOptions.maxError);
+                    add(options.lodOptions.minReduction);
+                    add(options.lodOptions.minTriangles);
+                }
+
+                add(options.generateMeshlets);
+                if (options.generateMeshlets) {
+                    add(options.meshletOptions.maxVertices);
+                    add(options.meshletOptions.maxTriangles);
+                    add(options.meshletOptions.coneWeight);
+                }
+
+                add(options.generateBVH);
+                if (options.generateBVH) {
+                    add(options.bvhOptions.maxLeafTriangles);
+                    add(options.bvhOptions.binsCount);
+                    add(options.bvhOptions.traversalCost);
+                }
+
+                const auto& exportOptions = options.exportOptions;
+                key += exportOptions.assetsOutputDirectory;
+                add(exportOptions.useCompression);
+                add(exportOptions.outputMetadata);
+                add(exportOptions.vertexFormat.position);
+                add(exportOptions.vertexFormat.normal);
+                add(exportOptions.vertexFormat.uv);
+                add(exportOptions.vertexFormat.color);
+                add(exportOptions.packModel);
+                add(exportOptions.packAlignment);
+                add(exportOptions.blobAlignment);
+                add(exportOptions.deduplicate && !exportOptions.packModel);
+                add(exportOptions.materialJSON);
+
+                add(options.processTextures);
+                if (options.processTextures) {
+                    add(options.textureOptions.generateMips);
+                    add(options.textureOptions.highQuality);
+                    add(options.textureOptions.maxSize);
+                }
+
+                // Streamed .rzmesh headers have base offsets of 0, every chunk has it's own streams
+                add(options.streaming && !exportOptions.packModel);
+
+                return HashString(key);
+            }
+
+            std::vector<std::string> AssetPipeline::collectModelPaths(const std::string& inputPath)
+            {
+                namespace fs = std::filesystem;
+
+                std::vector<std::string> modelFilePaths;
+
+                Assimp::Importer importer;
+                auto             isModelFile = [&importer](const fs::path& path) {
+                    std::string extension = path.extension().string();
+                    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+                    return !extension.empty() && importer.IsExtensionSupported(extension);
+                };
+
+                if (fs::is_directory(inputPath)) {
+                    for (const auto& entry: fs::recursive_directory_iterator(inputPath)) {
+                        if (entry.is_regular_file() && isModelFile(entry.path()))
+                            modelFilePaths.push_back(entry.path().generic_string());
+                    }
+                    // Keep the order stable across runs
+                    std::sort(modelFilePaths.begin(), modelFilePaths.end());
+                } else {
+                    fs::path    path      = inputPath;
+                    std::string extension = path.extension().string();
+                    if (extension == ".txt" || extension == ".manifest") {
+                        std::ifstream manifest(inputPath);
+                        std::string   line;
+                        while (std::getline(manifest, line)) {
+                            line.erase(0, line.find_first_not_of(" \t"));
+                            line.erase(line.find_last_not_of(" \t\r") + 1);
+                            if (line.empty() || line[0] == '#')
+                                continue;
+
+                            fs::path modelPath = line;
+                            if (modelPath.is_relative())
+                                modelPath = path.parent_path() / modelPath;
+                            modelFilePaths.push_back(modelPath.generic_string());
+                        }
+                    } else
+                        modelFilePaths.push_back(path.generic_string());
+                }
+
+                return modelFilePaths;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
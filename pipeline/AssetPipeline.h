@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "BuildCache.h"
+
+#include "exporter/AnimationExporter.h"
+#include "exporter/MeshExporter.h"
+#include "importer/MeshImporter.h"
+#include "processor/AnimationCompressor.h"
+#include "processor/BVHBuilder.h"
+#include "processor/LODGenerator.h"
+#include "processor/MeshProcessor.h"
+#include "processor/MeshletGenerator.h"
+#include "processor/TextureProcessor.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            class JobSystem;
+
+            struct AssetPipelineOptions
+            {
+                MeshImportOptions           importOptions;
+                MeshProcessingOptions       processingOptions;
+                bool                        generateLODs     = false;
+                LODGenerationOptions        lodOptions;
+                bool                        generateMeshlets = false;
+                MeshletGenerationOptions    meshletOptions;
+                bool                        generateBVH      = false; /* SAH BVH of LOD 0 per submesh, see BVHBuilder                               */
+                BVHBuildOptions             bvhOptions;
+                MeshExportOptions           exportOptions;
+                AnimationCompressionOptions animationOptions;         /* Clips of the models imported with importOptions.importSkinning             */
+                bool                        processTextures  = false; /* Compress the material textures to .dds, see TextureProcessor               */
+                TextureProcessingOptions    textureOptions;
+                bool                        useBuildCache    = true;  /* Skip the models that didn't change since the last packBatch, see BuildCache */
+                bool                        forceRebuild     = false; /* Rebuild every model but still update the build cache                        */
+                bool                        streaming        = false; /* Import, process and export a submesh at a time, see packModelStreamed      */
+                uint32_t                    streamQueueDepth = 0;     /* Converted submeshes waiting for the workers, 0 uses the workers count      */
+            };
+
+            /**
+             * Accumulated timings and sizes of all the models packed by a pipeline
+             * Stage times are summed across all the threads, compare them with the batch wall time to see how well it scales
+             */
+            struct AssetPipelineStats
+            {
+                std::atomic<uint64_t> importTimeNs  = 0;
+                std::atomic<uint64_t> readTimeNs    = 0; /* Import breakdown, see MeshImportTimings */
+                std::atomic<uint64_t> layoutTimeNs  = 0;
+                std::atomic<uint64_t> convertTimeNs = 0;
+                std::atomic<uint64_t> normalsTimeNs = 0;
+                std::atomic<uint64_t> tangentTimeNs = 0;
+                std::atomic<uint64_t> processTimeNs = 0;
+                std::atomic<uint64_t> lodTimeNs     = 0;
+                std::atomic<uint64_t> meshletTimeNs = 0;
+                std::atomic<uint64_t> bvhTimeNs     = 0;
+                std::atomic<uint64_t> exportTimeNs  = 0;
+                std::atomic<uint64_t> animTimeNs    = 0; /* Clip compression and the .rzskel/.rzanim export */
+                std::atomic<uint64_t> animRawBytes  = 0; /* Float keys of the imported clips                */
+                std::atomic<uint64_t> animBytes     = 0; /* Size of the exported .rzanim files              */
+                std::atomic<uint32_t> animClips     = 0;
+                std::atomic<uint64_t> bytesRead     = 0; /* Size of the source model files */
+                std::atomic<uint64_t> bytesWritten  = 0; /* Size of the exported .rzmesh files */
+                std::atomic<uint32_t> modelsPacked  = 0;
+                std::atomic<uint32_t> modelsFailed  = 0;
+                std::atomic<uint32_t> modelsSkipped = 0; /* Up to date in the build cache */
+            };
+
+            /**
+             * Drives import -> process -> LODs/meshlets/BVHs -> export for one or many models on a job system
+             * Every model is a job, the exporter then splits it further into a job per submesh
+             */
+            class AssetPipeline
+            {
+            public:
+                explicit AssetPipeline(JobSystem& jobSystem);
+                ~AssetPipeline() = default;
+
+                bool packModel(const std::string& modelFilePath, const AssetPipelineOptions& options);
+                /**
+                 * Packs all the models in parallel, returns false if any of them failed
+                 * The build cache is loaded from and saved to <assetsOutputDirectory>/Cache/build_cache.txt around the batch
+                 * Deduplicated geometry is shared by all the models of the batch
+                 * Textures scheduled by packModel finish before it returns
+                 */
+                bool packBatch(const std::vector<std::string>& modelFilePaths, const AssetPipelineOptions& options);
+
+                void printStats(double wallTime) const;
+
+                const AssetPipelineStats& getStats() const { return m_Stats; }
+
+                /**
+                 * Called on the worker that packed the model with every file it wrote and every file it's import depends on (see BuildCache::CollectDependencies)
+                 * the dependencies include the textures the importer resolved, which the binary formats (.glb, .fbx) only reveal once imported
+                 * Models skipped by the build cache aren't reported. The .dds files are complete once packBatch returns
+                 */
+                using ModelPackedCallback = std::function<void(const std::string& modelFilePath, const std::vector<std::string>& outputFiles, const std::vector<std::string>& dependencies)>;
+                void setModelPackedCallback(ModelPackedCallback callback) { m_ModelPackedCallback = std::move(callback); }
+
+                /* Dependencies recorded by the build cache for the last successful build of a model, empty without the build cache */
+                std::vector<std::string> getRecordedDependencies(const std::string& modelFilePath);
+
+                /**
+                 * Resolves the models to pack from the input path
+                 * A directory is searched recursively for supported model files, a .txt/.manifest file lists a model path per line
+                 * ('#' starts a comment, relative paths are relative to the manifest) and anything else is treated as a single model
+                 */
+                static std::vector<std::string> collectModelPaths(const std::string& inputPath);
+
+                /* Hash of every option that changes the exported files, part of the build cache key */
+                static uint64_t hashOptions(const AssetPipelineOptions& options);
+
+            private:
+                /* textureFiles receives the textures the importer resolved, they are build cache dependencies of the model */
+                bool packModelWhole(const std::string& modelFilePath, const AssetPipelineOptions& options, std::vector<std::string>& outputFiles, std::vector<std::string>& textureFiles);
+                /**
+                 * Streaming mode for models too big to be resident at once (ex. photogrammetry scans)
+                 * The importer converts a submesh at a time and releases it's source mesh, the chunks go through a bounded queue to the
+                 * job system where they are processed and written to their .rzmesh and released. When the queue is full the importer packs
+                 * a chunk itself, so at most streamQueueDepth + workers chunks are alive. .rzpack files need all the submeshes and can't stream
+                 */
+                bool packModelStreamed(const std::string& modelFilePath, const AssetPipelineOptions& options, std::vector<std::string>& outputFiles, std::vector<std::string>& textureFiles);
+                /* Processing, LODs, meshlets and BVHs, shared by both paths */
+                bool processStages(MeshImportResult& import_result, const AssetPipelineOptions& options, const std::string& modelFilePath);
+                /* Compresses the clips in parallel and writes them with the skeleton, nothing to do for models without a skeleton */
+                bool packAnimations(const MeshImportResult& model, const AssetPipelineOptions& options, const std::string& modelFilePath, std::vector<std::string>& outputFiles);
+                void addImportTimings(const MeshImportTimings& timings);
+
+            private:
+                JobSystem&          m_JobSystem;
+                AssetPipelineStats  m_Stats;
+                BuildCache          m_BuildCache;
+                TextureProcessor    m_TextureProcessor;
+                GeometryRegistry    m_Geometry; /* Deduplicated submeshes of the batch, see MeshExportOptions::deduplicate */
+                ModelPackedCallback m_ModelPackedCallback;
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,250 @@
+#include "AssetWatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <unordered_set>
+
+#include <assimp/Importer.hpp>
+
+#include "common/log.h"
+#include "common/path_utils.h"
+#include "common/profiler.h"
+
+namespace fs = std::filesystem;
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            static bool IsInDirectory(const std::string& path, const std::string& directory)
+            {
+                return path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0 && path[directory.size()] == '/';
+            }
+
+            // Only used by the watch loop, the importer is created once for the whole session
+            static bool IsModelFile(const std::string& filePath)
+            {
+                static Assimp::Importer importer;
+
+                std::string extension = fs::path(filePath).extension().string();
+                std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+                return !extension.empty() && importer.IsExtensionSupported(extension);
+            }
+
+            AssetWatcher::AssetWatcher(AssetPipeline& pipeline, const AssetPipelineOptions& options, const AssetWatchOptions& watchOptions)
+                : m_Pipeline(pipeline), m_Options(options), m_WatchOptions(watchOptions)
+            {
+                // The first batch already rebuilt everything, from now on only the changes are
+                m_Options.forceRebuild = false;
+
+                if (m_WatchOptions.notifyPort)
+                    m_Notifier.open(m_WatchOptions.notifyPort);
+
+                // Workers report their outputs, they are sent to the engine once the whole repack is done
+                m_Pipeline.setModelPackedCallback([this](const std::string& modelFilePath, const std::vector<std::string>& outputFiles, const std::vector<std::string>& dependencies) {
+                    std::lock_guard<std::mutex> lock(m_PackedMutex);
+                    for (const auto& outputFile: outputFiles)
+                        m_PackedFiles.push_back(NormalizePath(outputFile));
+                    m_ImportedDependencies[NormalizePath(modelFilePath)] = dependencies;
+                });
+            }
+
+            AssetWatcher::~AssetWatcher()
+            {
+                m_Pipeline.setModelPackedCallback(nullptr);
+            }
+
+            bool AssetWatcher::watch(const std::string& inputPath, const std::vector<std::string>& modelFilePaths)
+            {
+                m_InputPath      = NormalizePath(inputPath);
+                m_DiscoverModels = fs::is_directory(m_InputPath);
+
+                // A manifest is watched too, models added to it are packed
+                if (!watchDirectory(m_DiscoverModels ? m_InputPath : fs::path(m_InputPath).parent_path().generic_string()))
+                    return false;
+
+                for (const auto& modelFilePath: modelFilePaths)
+                    addModel(NormalizePath(modelFilePath));
+
+                RAZIX_PACKER_LOG_INFO("Watching " << m_Dependencies.size() << " models in " << m_Directories.size() << " directories");
+                return true;
+            }
+
+            void AssetWatcher::addModel(const std::string& modelFilePath)
+            {
+                if (m_Dependencies.count(modelFilePath))
+                    return;
+                m_Dependencies[modelFilePath];
+
+                watchDirectory(fs::path(modelFilePath).parent_path().generic_string());
+                refreshDependencies(modelFilePath);
+            }
+
+            void AssetWatcher::refreshDependencies(const std::string& modelFilePath)
+            {
+                auto& dependencies = m_Dependencies[modelFilePath];
+                for (const auto& dependency: dependencies) {
+                    auto& dependents = m_Dependents[dependency];
+                    dependents.erase(std::remove(dependents.begin(), dependents.end(), modelFilePath), dependents.end());
+                }
+
+                // Text formats are scanned, the textures of binary formats are only known from the last import, recorded by the
+                // build cache or reported by the pipeline when the model was packed in this session (ex. with --no-cache)
+                dependencies = BuildCache::CollectDependencies(modelFilePath);
+                for (auto& dependency: m_Pipeline.getRecordedDependencies(modelFilePath))
+                    dependencies.push_back(std::move(dependency));
+                {
+                    std::lock_guard<std::mutex> lock(m_PackedMutex);
+                    auto                        imported = m_ImportedDependencies.find(modelFilePath);
+                    if (imported != m_ImportedDependencies.end())
+                        dependencies.insert(dependencies.end(), imported->second.begin(), imported->second.end());
+                }
+                std::sort(dependencies.begin(), dependencies.end());
+                dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+
+                // A model may reference files outside of it's directory (ex. a shared texture folder), they are watched as well
+                for (const auto& dependency: dependencies) {
+                    m_Dependents[dependency].push_back(modelFilePath);
+                    watchDirectory(fs::path(dependency).parent_path().generic_string());
+                }
+            }
+
+            bool AssetWatcher::watchDirectory(const std::string& directory)
+            {
+                // Watches are recursive, a directory under a watched one is already covered
+                for (const auto& watched: m_Directories) {
+                    if (directory == watched || IsInDirectory(directory, watched))
+                        return true;
+                }
+
+                if (!m_FileWatcher.addDirectory(directory))
+                    return false;
+                m_Directories.push_back(directory);
+                return true;
+            }
+
+            std::vector<std::string> AssetWatcher::collectAffectedModels(const std::vector<std::string>& changedFiles)
+            {
+                std::vector<std::string>        models;
+                std::unordered_set<std::string> added;
+                auto                            addAffected = [&](const std::string& modelFilePath) {
+                    if (added.insert(modelFilePath).second)
+                        models.push_back(modelFilePath);
+                };
+
+                for (const auto& changedFile: changedFiles) {
+                    // Events were lost or a directory was moved in, every model under it is checked, the build cache skips the unchanged ones
+                    std::error_code ec;
+                    if (fs::is_directory(changedFile, ec)) {
+                        if (m_DiscoverModels) {
+                            for (const auto& modelFilePath: AssetPipeline::collectModelPaths(changedFile))
+                                addModel(NormalizePath(modelFilePath));
+                        }
+                        for (const auto& model: m_Dependencies) {
+                            if (IsInDirectory(model.first, changedFile))
+                                addAffected(model.first);
+                        }
+                        continue;
+                    }
+
+                    // The manifest changed, only the models added to it are new
+                    if (changedFile == m_InputPath && !m_Dependencies.count(changedFile)) {
+                        for (const auto& modelFilePath: AssetPipeline::collectModelPaths(m_InputPath)) {
+                            std::string model = NormalizePath(modelFilePath);
+                            if (!m_Dependencies.count(model)) {
+                                addModel(model);
+                                addAffected(model);
+                            }
+                        }
+                        continue;
+                    }
+
+                    if (m_Dependencies.count(changedFile))
+                        addAffected(changedFile);
+                    else if (m_DiscoverModels && IsInDirectory(changedFile, m_InputPath) && IsModelFile(changedFile)) {
+                        addModel(changedFile);
+                        addAffected(changedFile);
+                    }
+
+                    auto dependents = m_Dependents.find(changedFile);
+                    if (dependents != m_Dependents.end()) {
+                        for (const auto& model: dependents->second)
+                            addAffected(model);
+                    }
+                }
+                return models;
+            }
+
+            void AssetWatcher::repack(const std::vector<std::string>& modelFilePaths)
+            {
+                RAZIX_PACKER_PROFILE_ZONE("Repack");
+
+                const AssetPipelineStats& stats   = m_Pipeline.getStats();
+                uint32_t                  packed  = stats.modelsPacked.load();
+                uint32_t                  failed  = stats.modelsFailed.load();
+                uint32_t                  skipped = stats.modelsSkipped.load();
+
+                auto start = std::chrono::high_resolution_clock::now();
+                m_Pipeline.packBatch(modelFilePaths, m_Options);
+
+                std::vector<std::string> packedFiles;
+                {
+                    std::lock_guard<std::mutex> lock(m_PackedMutex);
+                    packedFiles.swap(m_PackedFiles);
+                }
+                // The engine hears about the new files before anything else is done
+                if (m_Notifier.isOpen() && !packedFiles.empty())
+                    m_Notifier.notify(packedFiles);
+
+                auto                                      finish = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double, std::milli> time   = finish - start;
+
+                // An edit may have changed the buffers or the material library a model references
+                for (const auto& modelFilePath: modelFilePaths)
+                    refreshDependencies(modelFilePath);
+
+                FlushLog();
+                std::cout << "Repacked " << stats.modelsPacked.load() - packed << " models (" << stats.modelsFailed.load() - failed << " failed, " << stats.modelsSkipped.load() - skipped << " up to date) in " << time.count() << " ms";
+                if (m_Notifier.isOpen())
+                    std::cout << ", " << packedFiles.size() << " files sent to port " << m_WatchOptions.notifyPort;
+                std::cout << std::endl;
+            }
+
+            bool AssetWatcher::run(const std::atomic<bool>& stop)
+            {
+                // Long enough to not spin, short enough to react to stop quickly
+                constexpr uint32_t kIdleTimeoutMs = 200;
+
+                std::vector<std::string> changedFiles;
+                auto                     lastChange = std::chrono::steady_clock::now();
+                while (!stop) {
+                    uint32_t timeoutMs = kIdleTimeoutMs;
+                    if (!changedFiles.empty()) {
+                        auto quietMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - lastChange).count();
+                        timeoutMs    = quietMs < m_WatchOptions.debounceMs ? static_cast<uint32_t>(m_WatchOptions.debounceMs - quietMs) : 0;
+                    }
+
+                    size_t changesCount = changedFiles.size();
+                    if (!m_FileWatcher.poll(changedFiles, timeoutMs))
+                        return false;
+                    if (changedFiles.size() != changesCount) {
+                        lastChange = std::chrono::steady_clock::now();
+                        continue;
+                    }
+
+                    // Nothing changed during the debounce time, the files are complete
+                    if (changedFiles.empty() || stop)
+                        continue;
+
+                    std::vector<std::string> models = collectAffectedModels(changedFiles);
+                    changedFiles.clear();
+                    if (!models.empty())
+                        repack(models);
+                }
+                return true;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetPipeline.h"
+#include "FileWatcher.h"
+#include "ReloadNotifier.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            struct AssetWatchOptions
+            {
+                uint32_t debounceMs = 100; /* Quiet time after the last change before repacking, editors write a file in several steps */
+                uint16_t notifyPort = 0;   /* UDP port the engine listens on for reloads, see ReloadNotifier. 0 doesn't notify     */
+            };
+
+            /**
+             * Keeps the packer resident and repacks the models whose sources change, until it's stopped
+             * The pipeline, it's job system, the build cache with it's memoized hashes and the Assimp importer of every worker stay
+             * warm between batches, so a repack only pays for the models that changed. A changed file maps to the models that are it
+             * or reference it (see BuildCache::CollectDependencies plus the textures the importer resolved, which is the only way to know
+             * the ones of .glb/.fbx models), new models are picked up when a whole directory is watched. An edited texture repacks it's
+             * models and the engine is sent the new .dds, see TextureProcessor
+             */
+            class AssetWatcher
+            {
+            public:
+                AssetWatcher(AssetPipeline& pipeline, const AssetPipelineOptions& options, const AssetWatchOptions& watchOptions);
+                ~AssetWatcher();
+
+                /**
+                 * Watches the models resolved from inputPath, see AssetPipeline::collectModelPaths
+                 * A directory is watched as a whole, otherwise the directories of the manifest, the models and their dependencies are
+                 */
+                bool watch(const std::string& inputPath, const std::vector<std::string>& modelFilePaths);
+                /* Repacks on every change until stop is set (ex. by a Ctrl+C handler), returns false if watching failed */
+                bool run(const std::atomic<bool>& stop);
+
+            private:
+                void                     addModel(const std::string& modelFilePath);
+                void                     refreshDependencies(const std::string& modelFilePath);
+                bool                     watchDirectory(const std::string& directory);
+                std::vector<std::string> collectAffectedModels(const std::vector<std::string>& changedFiles);
+                void                     repack(const std::vector<std::string>& modelFilePaths);
+
+            private:
+                AssetPipeline&                                            m_Pipeline;
+                AssetPipelineOptions                                      m_Options;
+                AssetWatchOptions                                         m_WatchOptions;
+                FileWatcher                                               m_FileWatcher;
+                ReloadNotifier                                            m_Notifier;
+                std::string                                               m_InputPath;
+                bool                                                      m_DiscoverModels = false; /* The input is a directory, new models in it are packed too */
+                std::vector<std::string>                                  m_Directories;
+                std::unordered_map<std::string, std::vector<std::string>> m_Dependencies; /* Every watched model to the files it references */
+                std::unordered_map<std::string, std::vector<std::string>> m_Dependents;   /* Every referenced file to the models using it   */
+                std::mutex                                                m_PackedMutex;
+                std::vector<std::string>                                  m_PackedFiles;        /* Written by the current repack, filled by the workers          */
+                std::unordered_map<std::string, std::vector<std::string>> m_ImportedDependencies; /* Dependencies the importer resolved when a model was last packed */
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,387 @@
+#include "BuildCache.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+#include "common/content_hash.h"
+#include "common/log.h"
+#include "loader/MappedFile.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            namespace fs = std::filesystem;
+
+            static const char kCacheSignature[] = "RZBUILDCACHE";
+
+            // Marks a dependency that doesn't exist, so creating it later changes the key
+            static constexpr uint64_t kMissingFileHash = ~0ull;
+
+            static std::string ResolveReference(const fs::path& directory, std::string reference)
+            {
+                // URIs may escape spaces
+                size_t pos;
+                while ((pos = reference.find("%20")) != std::string::npos)
+                    reference.replace(pos, 3, " ");
+                return (directory / reference).lexically_normal().generic_string();
+            }
+
+            static bool IsNumber(const std::string& token)
+            {
+                char* end = nullptr;
+                strtod(token.c_str(), &end);
+                return !token.empty() && end == token.c_str() + token.size();
+            }
+
+            // "map_Kd -s 1 1 1 -clamp on file name.png", the file is whatever follows the options and may contain spaces
+            static std::string ParseMaterialTextureFile(const std::string& arguments)
+            {
+                size_t pos = arguments.find_first_not_of(" \t");
+                while (pos != std::string::npos && arguments[pos] == '-') {
+                    size_t      end    = arguments.find_first_of(" \t", pos);
+                    std::string option = arguments.substr(pos, end - pos);
+                    pos                = arguments.find_first_not_of(" \t", end);
+
+                    // -o, -s and -t take 1 to 3 numbers, -mm 2 and the other options a single argument
+                    uint32_t minArguments = option == "-mm" ? 2 : 1;
+                    uint32_t maxArguments = option == "-o" || option == "-s" || option == "-t" ? 3 : minArguments;
+                    for (uint32_t i = 0; i < maxArguments && pos != std::string::npos; i++) {
+                        end = arguments.find_first_of(" \t", pos);
+                        if (i >= minArguments && !IsNumber(arguments.substr(pos, end - pos)))
+                            break;
+                        pos = arguments.find_first_not_of(" \t", end);
+                    }
+                }
+                if (pos == std::string::npos)
+                    return "";
+                return arguments.substr(pos, arguments.find_last_not_of(" \t\r") + 1 - pos);
+            }
+
+            // Every texture statement of a .mtl, relative to the .mtl
+            static void CollectMaterialLibraryTextures(const fs::path& libraryPath, std::vector<std::string>& dependencies)
+            {
+                std::ifstream file(libraryPath);
+                std::string   line;
+                while (std::getline(file, line)) {
+                    size_t begin = line.find_first_not_of(" \t");
+                    if (begin == std::string::npos)
+                        continue;
+                    size_t      end     = line.find_first_of(" \t", begin);
+                    std::string keyword = line.substr(begin, end - begin);
+                    std::transform(keyword.begin(), keyword.end(), keyword.begin(), ::tolower);
+                    if (end == std::string::npos || (keyword.compare(0, 4, "map_") != 0 && keyword != "bump" && keyword != "disp" && keyword != "decal" && keyword != "refl" && keyword != "norm"))
+                        continue;
+
+                    std::string texture = ParseMaterialTextureFile(line.substr(end));
+                    if (!texture.empty())
+                        dependencies.push_back(ResolveReference(libraryPath.parent_path(), texture));
+                }
+            }
+
+            std::vector<std::string> BuildCache::CollectDependencies(const std::string& sourcePath)
+            {
+                std::vector<std::string> dependencies;
+
+                fs::path    path      = sourcePath;
+                std::string extension = path.extension().string();
+                std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+                if (extension == ".gltf") {
+                    // Every "uri" that isn't embedded as a data URI is a buffer or an image next to the .gltf
+                    std::ifstream     file(sourcePath);
+                    std::stringstream stream;
+                    stream << file.rdbuf();
+                    std::string json = stream.str();
+
+                    size_t pos = 0;
+                    while ((pos = json.find("\"uri\"", pos)) != std::string::npos) {
+                        pos += 5;
+                        size_t colon = json.find_first_not_of(" \t\r\n", pos);
+                        if (colon == std::string::npos || json[colon] != ':')
+                            continue;
+                        size_t begin = json.find_first_not_of(" \t\r\n", colon + 1);
+                        if (begin == std::string::npos || json[begin] != '"')
+                            continue;
+                        size_t end = json.find('"', begin + 1);
+                        if (end == std::string::npos)
+                            break;
+
+                        std::string uri = json.substr(begin + 1, end - begin - 1);
+                        if (!uri.empty() && uri.compare(0, 5, "data:") != 0)
+                            dependencies.push_back(ResolveReference(path.parent_path(), uri));
+                        pos = end + 1;
+                    }
+                } else if (extension == ".obj") {
+                    std::ifstream file(sourcePath);
+                    std::string   line;
+                    while (std::getline(file, line)) {
+                        if (line.compare(0, 7, "mtllib ") != 0)
+                            continue;
+                        line.erase(0, line.find_first_not_of(" \t", 7));
+                        line.erase(line.find_last_not_of(" \t\r") + 1);
+                        if (line.empty())
+                            continue;
+
+                        // The textures of the materials are referenced by the .mtl, not by the .obj
+                        std::string library = ResolveReference(path.parent_path(), line);
+                        dependencies.push_back(library);
+                        CollectMaterialLibraryTextures(library, dependencies);
+                    }
+                }
+
+                std::sort(dependencies.begin(), dependencies.end());
+                dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+                return dependencies;
+            }
+
+            void BuildCache::load(const std::string& cacheFilePath)
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                // Nothing else writes the file while it's loaded, a resident packer keeps the memoized hashes between batches
+                if (m_FilePath == cacheFilePath)
+                    return;
+
+                m_FilePath = cacheFilePath;
+                m_Entries.clear();
+                m_Files.clear();
+                m_StaleOutputs.clear();
+                m_Dirty = false;
+
+                std::ifstream file(cacheFilePath);
+                if (!file.is_open())
+                    return;
+
+                // A cache written by another packer version is useless, every key would miss anyway
+                std::string signature;
+                uint32_t    version = 0;
+                file >> signature >> version;
+                if (signature != kCacheSignature || version != RAZIX_ASSET_PACKER_VERSION) {
+                    m_Dirty = true;
+                    return;
+                }
+
+                // Every record is a tag, fixed fields and the path as the rest of the line, D and O records belong to the last M
+                std::string line;
+                Entry*      entry = nullptr;
+                while (std::getline(file, line)) {
+                    if (line.size() < 2)
+                        continue;
+
+                    char     tag  = line[0];
+                    char     path[4096];
+                    uint64_t size = 0, hash = 0;
+                    int64_t  modified = 0;
+                    if (tag == 'F' && sscanf(line.c_str(), "F %" SCNu64 " %" SCNd64 " %" SCNx64 " %4095[^\n]", &size, &modified, &hash, path) == 4)
+                        m_Files[path] = FileStamp{size, modified, hash};
+                    else if (tag == 'M' && sscanf(line.c_str(), "M %" SCNx64 " %4095[^\n]", &hash, path) == 2) {
+                        entry      = &m_Entries[path];
+                        entry->key = hash;
+                    } else if (tag == 'D' && entry)
+                        entry->dependencies.push_back(line.substr(2));
+                    else if (tag == 'O' && entry)
+                        entry->outputs.push_back(line.substr(2));
+                }
+            }
+
+            bool BuildCache::save()
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                if (m_FilePath.empty() || !m_Dirty)
+                    return true;
+
+                // Ex. a submesh that was renamed or removed from the model. Only now every model of the batch has recorded it's outputs
+                if (!m_StaleOutputs.empty()) {
+                    std::unordered_set<std::string> referenced;
+                    for (const auto& [path, entry]: m_Entries)
+                        referenced.insert(entry.outputs.begin(), entry.outputs.end());
+
+                    std::error_code ec;
+                    for (const auto& output: m_StaleOutputs) {
+                        if (!referenced.count(output) && fs::remove(output, ec))
+                            RAZIX_PACKER_LOG_VERBOSE("Removed stale output : " << output);
+                    }
+                    m_StaleOutputs.clear();
+                }
+
+                std::error_code ec;
+                fs::create_directories(fs::path(m_FilePath).parent_path(), ec);
+
+                std::ofstream file(m_FilePath, std::ios::out | std::ios::trunc);
+                if (!file.is_open()) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to write the build cache : " << m_FilePath);
+                    return false;
+                }
+
+                file << kCacheSignature << " " << RAZIX_ASSET_PACKER_VERSION << "\n";
+
+                char record[96];
+                for (const auto& [path, stamp]: m_Files) {
+                    snprintf(record, sizeof(record), "F %" PRIu64 " %" PRId64 " %016" PRIx64 " ", stamp.size, stamp.modified, stamp.hash);
+                    file << record << path << "\n";
+                }
+                for (const auto& [path, entry]: m_Entries) {
+                    snprintf(record, sizeof(record), "M %016" PRIx64 " ", entry.key);
+                    file << record << path << "\n";
+                    for (const auto& dependency: entry.dependencies)
+                        file << "D " << dependency << "\n";
+                    for (const auto& output: entry.outputs)
+                        file << "O " << output << "\n";
+                }
+
+                m_Dirty = false;
+                return file.good();
+            }
+
+            bool BuildCache::computeKey(const std::string& sourcePath, uint64_t optionsHash, uint64_t& key, std::vector<std::string>& dependencies)
+            {
+                dependencies = CollectDependencies(sourcePath);
+                for (auto& dependency: getDependencies(sourcePath))
+                    dependencies.push_back(std::move(dependency));
+                std::sort(dependencies.begin(), dependencies.end());
+                dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+
+                return computeKeyFor(sourcePath, optionsHash, dependencies, key);
+            }
+
+            bool BuildCache::computeKeyFor(const std::string& sourcePath, uint64_t optionsHash, const std::vector<std::string>& dependencies, uint64_t& key)
+            {
+                uint64_t sourceHash = 0;
+                if (!hashFile(sourcePath, sourceHash))
+                    return false;
+
+                key = HashCombine(RAZIX_ASSET_PACKER_VERSION, optionsHash);
+                key = HashCombine(key, sourceHash);
+
+                for (const auto& dependency: dependencies) {
+                    uint64_t dependencyHash = kMissingFileHash;
+                    hashFile(dependency, dependencyHash);
+
+                    // The path is part of the key, a file moving to another reference changes the import too
+                    key = HashCombine(key, HashString(dependency));
+                    key = HashCombine(key, dependencyHash);
+                }
+                return true;
+            }
+
+            std::vector<std::string> BuildCache::getDependencies(const std::string& sourcePath)
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                auto                        it = m_Entries.find(sourcePath);
+                return it != m_Entries.end() ? it->second.dependencies : std::vector<std::string>();
+            }
+
+            bool BuildCache::isUpToDate(const std::string& sourcePath, uint64_t key)
+            {
+                std::vector<std::string> outputs;
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+
+                    auto it = m_Entries.find(sourcePath);
+                    if (it == m_Entries.end() || it->second.key != key)
+                        return false;
+                    outputs = it->second.outputs;
+                }
+
+                // Outputs deleted by hand have to be rebuilt even if nothing else changed
+                std::error_code ec;
+                for (const auto& output: outputs) {
+                    if (!fs::exists(output, ec))
+                        return false;
+                }
+                return true;
+            }
+
+            void BuildCache::update(const std::string& sourcePath, uint64_t key, const std::vector<std::string>& dependencies, const std::vector<std::string>& outputs)
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                // Deleted by save(), a model packed later in the batch may still write or reference them
+                Entry& entry = m_Entries[sourcePath];
+                for (const auto& output: entry.outputs) {
+                    if (std::find(outputs.begin(), outputs.end(), output) == outputs.end())
+                        m_StaleOutputs.push_back(output);
+                }
+
+                entry.key          = key;
+                entry.dependencies = dependencies;
+                entry.outputs      = outputs;
+                m_Dirty            = true;
+            }
+
+            void BuildCache::invalidate(const std::string& sourcePath)
+            {
+                // The outputs are kept, so the next successful build can still remove the ones it doesn't write again
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                auto                        it = m_Entries.find(sourcePath);
+                if (it != m_Entries.end() && it->second.key != 0) {
+                    it->second.key = 0;
+                    m_Dirty        = true;
+                }
+            }
+
+            void BuildCache::invalidateOutputs(const std::vector<std::string>& outputs)
+            {
+                if (outputs.empty())
+                    return;
+
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                for (auto& entry: m_Entries) {
+                    if (entry.second.key == 0)
+                        continue;
+                    for (const auto& output: outputs) {
+                        if (std::find(entry.second.outputs.begin(), entry.second.outputs.end(), output) != entry.second.outputs.end()) {
+                            entry.second.key = 0;
+                            m_Dirty          = true;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            bool BuildCache::hashFile(const std::string& filePath, uint64_t& hash)
+            {
+                std::error_code ec;
+                uint64_t        size = fs::file_size(filePath, ec);
+                if (ec)
+                    return false;
+                auto modifiedTime = fs::last_write_time(filePath, ec);
+                if (ec)
+                    return false;
+                int64_t modified = static_cast<int64_t>(modifiedTime.time_since_epoch().count());
+
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+
+                    auto it = m_Files.find(filePath);
+                    if (it != m_Files.end() && it->second.size == size && it->second.modified == modified) {
+                        hash = it->second.hash;
+                        return true;
+                    }
+                }
+
+                // Hashed outside the lock, models are hashed in parallel by the batch jobs
+                if (size > 0) {
+                    MappedFile file;
+                    if (!file.open(filePath))
+                        return false;
+                    hash = HashBytes(file.getData(), file.getSize());
+                } else
+                    hash = HashBytes(nullptr, 0);
+
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Files[filePath] = FileStamp{size, modified, hash};
+                m_Dirty           = true;
+                return true;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /* Bump whenever the exported files change for the same input and options, so every cached model gets rebuilt */
+            constexpr uint32_t RAZIX_ASSET_PACKER_VERSION = 23;
+
+            /**
+             * Persistent content-hash build cache, lets the pipeline skip models that haven't changed since the last run
+             *
+             * A model is keyed by the hash of it's source file, the files it depends on (.bin buffers and images of a .gltf, .mtl of an
+             * .obj and their textures, the textures the importer resolved in the last build), the pipeline options and the packer
+             * version. If the key matches the last build and all the files it wrote still exist, the model is skipped before it's
+             * imported. File hashes are memoized by size and modification time, so an unchanged tree is validated without reading the
+             * models again.
+             *
+             * The cache is a text file, it's safe to delete it to force a full rebuild. All methods are thread safe.
+             */
+            class BuildCache
+            {
+            public:
+                BuildCache()  = default;
+                ~BuildCache() = default;
+
+                /* A missing or unreadable cache file is not an error, the cache just starts empty. Loading the same file again keeps the state */
+                void load(const std::string& cacheFilePath);
+                /* Writes the cache back to the file it was loaded from and deletes the stale outputs, nothing is written if it didn't change */
+                bool save();
+                bool isLoaded() const { return !m_FilePath.empty(); }
+
+                /**
+                 * Hashes the source, it's dependencies and optionsHash into the build key of a model
+                 * dependencies are the ones CollectDependencies finds plus the ones recorded by the last build, binary formats (.glb, .fbx)
+                 * can't be scanned so their textures are only known once imported. Returns false if the source can't be read, a missing
+                 * dependency changes the key instead
+                 */
+                bool computeKey(const std::string& sourcePath, uint64_t optionsHash, uint64_t& key, std::vector<std::string>& dependencies);
+                /* Same as above with the given dependencies, ex. once the importer resolved the textures. dependencies must be sorted */
+                bool computeKeyFor(const std::string& sourcePath, uint64_t optionsHash, const std::vector<std::string>& dependencies, uint64_t& key);
+                /* True if the model was last built with the same key and all it's outputs still exist */
+                bool isUpToDate(const std::string& sourcePath, uint64_t key);
+                /**
+                 * Records a successful build, outputs of the previous build that weren't written again are deleted by save()
+                 * unless another model still lists them (ex. deduplicated geometry, see MeshExportOptions::deduplicate)
+                 */
+                void update(const std::string& sourcePath, uint64_t key, const std::vector<std::string>& dependencies, const std::vector<std::string>& outputs);
+                /* Clears the key of a model, so a failed build is never considered up to date */
+                void invalidate(const std::string& sourcePath);
+                /* Clears the key of every model listing one of the outputs, ex. a texture that failed after the model was recorded */
+                void invalidateOutputs(const std::vector<std::string>& outputs);
+
+                /* Files referenced by a model that change the import result, only text formats (.gltf, .obj and their .mtl) are scanned */
+                static std::vector<std::string> CollectDependencies(const std::string& sourcePath);
+                /* Dependencies recorded by the last build of a model, empty if it was never built */
+                std::vector<std::string> getDependencies(const std::string& sourcePath);
+
+            private:
+                struct FileStamp
+                {
+                    uint64_t size     = 0;
+                    int64_t  modified = 0;
+                    uint64_t hash     = 0;
+                };
+
+                struct Entry
+                {
+                    uint64_t                 key = 0;
+                    std::vector<std::string> dependencies;
+                    std::vector<std::string> outputs;
+                };
+
+                bool hashFile(const std::string& filePath, uint64_t& hash);
+
+            private:
+                std::mutex                                 m_Mutex;
+                std::string                                m_FilePath;
+                std::unordered_map<std::string, Entry>     m_Entries;
+                std::unordered_map<std::string, FileStamp> m_Files;
+                std::vector<std::string>                   m_StaleOutputs;
+                bool                                       m_Dirty = false;
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,283 @@
+#include "FileWatcher.h"
+
+#include <cstring>
+#include <filesystem>
+
+#include "common/log.h"
+#include "common/path_utils.h"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#elif defined(__linux__)
+    #include <cerrno>
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#else
+    #include <chrono>
+    #include <thread>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+#if defined(_WIN32)
+            struct FileWatcher::WatchedDirectory
+            {
+                std::string path;
+                HANDLE      handle     = INVALID_HANDLE_VALUE;
+                OVERLAPPED  overlapped = {};
+                alignas(DWORD) uint8_t buffer[64 * 1024];
+
+                bool read()
+                {
+                    constexpr DWORD kFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+                    return ReadDirectoryChangesW(handle, buffer, sizeof(buffer), TRUE, kFilter, nullptr, &overlapped, nullptr) != 0;
+                }
+            };
+
+            FileWatcher::FileWatcher() = default;
+
+            FileWatcher::~FileWatcher()
+            {
+                for (auto& directory: m_Directories) {
+                    CancelIo(directory->handle);
+                    // The cancelled read still owns the buffer until it completes
+                    DWORD bytes = 0;
+                    GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, TRUE);
+                    CloseHandle(directory->handle);
+                    CloseHandle(directory->overlapped.hEvent);
+                }
+            }
+
+            bool FileWatcher::addDirectory(const std::string& directory)
+            {
+                auto watched  = std::make_unique<WatchedDirectory>();
+                watched->path = NormalizePath(directory);
+
+                watched->handle = CreateFileW(fs::path(watched->path).wstring().c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+                if (watched->handle == INVALID_HANDLE_VALUE) {
+                    RAZIX_PACKER_LOG_ERROR("Can't watch " << watched->path << " : error " << GetLastError());
+                    return false;
+                }
+
+                watched->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+                if (!watched->overlapped.hEvent || !watched->read()) {
+                    RAZIX_PACKER_LOG_ERROR("Can't watch " << watched->path << " : error " << GetLastError());
+                    if (watched->overlapped.hEvent)
+                        CloseHandle(watched->overlapped.hEvent);
+                    CloseHandle(watched->handle);
+                    return false;
+                }
+
+                m_Directories.push_back(std::move(watched));
+                return true;
+            }
+
+            bool FileWatcher::poll(std::vector<std::string>& changedFiles, uint32_t timeoutMs)
+            {
+                if (m_Directories.empty()) {
+                    Sleep(timeoutMs);
+                    return true;
+                }
+
+                // Only the first MAXIMUM_WAIT_OBJECTS directories wake the wait, the others are still checked on every poll
+                std::vector<HANDLE> events;
+                for (size_t i = 0; i < m_Directories.size() && i < MAXIMUM_WAIT_OBJECTS; i++)
+                    events.push_back(m_Directories[i]->overlapped.hEvent);
+
+                if (WaitForMultipleObjects(static_cast<DWORD>(events.size()), events.data(), FALSE, timeoutMs) == WAIT_FAILED) {
+                    RAZIX_PACKER_LOG_ERROR("Waiting for file changes failed : error " << GetLastError());
+                    return false;
+                }
+
+                for (auto& directory: m_Directories) {
+                    DWORD bytes = 0;
+                    if (!GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, FALSE)) {
+                        if (GetLastError() == ERROR_IO_INCOMPLETE)
+                            continue;
+                        RAZIX_PACKER_LOG_ERROR("Watching " << directory->path << " failed : error " << GetLastError());
+                        return false;
+                    }
+
+                    // An empty notification means the buffer overflowed and the changes are lost
+                    if (bytes == 0)
+                        changedFiles.push_back(directory->path);
+
+                    const uint8_t* entry = directory->buffer;
+                    while (bytes > 0) {
+                        const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(entry);
+                        if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                            std::wstring    name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                            fs::path        path = (fs::path(directory->path) / name).lexically_normal();
+                            std::error_code ec;
+                            // A directory is modified whenever a file in it is, only new directories matter
+                            if (info->Action != FILE_ACTION_MODIFIED || !fs::is_directory(path, ec))
+                                changedFiles.push_back(path.generic_string());
+                        }
+                        if (info->NextEntryOffset == 0)
+                            break;
+                        entry += info->NextEntryOffset;
+                    }
+
+                    if (!directory->read()) {
+                        RAZIX_PACKER_LOG_ERROR("Watching " << directory->path << " failed : error " << GetLastError());
+                        return false;
+                    }
+                }
+                return true;
+            }
+#elif defined(__linux__)
+            // IN_CREATE is only used for the new directories, files are reported once they are closed after writing
+            static constexpr uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+
+            FileWatcher::FileWatcher()
+            {
+                m_Fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+                if (m_Fd < 0)
+                    RAZIX_PACKER_LOG_ERROR("Can't create the inotify instance : " << strerror(errno));
+            }
+
+            FileWatcher::~FileWatcher()
+            {
+                if (m_Fd >= 0)
+                    close(m_Fd);
+            }
+
+            bool FileWatcher::addDirectory(const std::string& directory)
+            {
+                if (m_Fd < 0)
+                    return false;
+
+                std::string root = NormalizePath(directory);
+                if (!addWatch(root, nullptr))
+                    return false;
+                m_Roots.push_back(root);
+                return true;
+            }
+
+            bool FileWatcher::addWatch(const std::string& directory, std::vector<std::string>* existingFiles)
+            {
+                int wd = inotify_add_watch(m_Fd, directory.c_str(), kWatchMask);
+                if (wd < 0) {
+                    RAZIX_PACKER_LOG_ERROR("Can't watch " << directory << " : " << strerror(errno));
+                    return false;
+                }
+                m_Watches[wd] = directory;
+
+                // inotify isn't recursive, every subdirectory gets it's own watch
+                std::error_code ec;
+                for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+                    std::string path = it->path().generic_string();
+                    if (it->is_directory(ec))
+                        addWatch(path, existingFiles);
+                    else if (existingFiles)
+                        existingFiles->push_back(path);
+                }
+                return true;
+            }
+
+            bool FileWatcher::poll(std::vector<std::string>& changedFiles, uint32_t timeoutMs)
+            {
+                if (m_Fd < 0)
+                    return false;
+
+                pollfd pollFd = {m_Fd, POLLIN, 0};
+                int    ready  = ::poll(&pollFd, 1, static_cast<int>(timeoutMs));
+                if (ready < 0) {
+                    // Ctrl+C interrupts the wait, the caller decides if it has to stop
+                    if (errno == EINTR)
+                        return true;
+                    RAZIX_PACKER_LOG_ERROR("Waiting for file changes failed : " << strerror(errno));
+                    return false;
+                }
+                if (ready == 0)
+                    return true;
+
+                alignas(inotify_event) char buffer[16 * 1024];
+                for (;;) {
+                    ssize_t length = read(m_Fd, buffer, sizeof(buffer));
+                    if (length <= 0)
+                        break;
+
+                    const inotify_event* event = nullptr;
+                    for (char* entry = buffer; entry < buffer + length; entry += sizeof(inotify_event) + event->len) {
+                        event = reinterpret_cast<const inotify_event*>(entry);
+
+                        if (event->mask & IN_Q_OVERFLOW) {
+                            changedFiles.insert(changedFiles.end(), m_Roots.begin(), m_Roots.end());
+                            continue;
+                        }
+                        if (event->mask & IN_IGNORED) {
+                            m_Watches.erase(event->wd);
+                            continue;
+                        }
+
+                        auto it = m_Watches.find(event->wd);
+                        if (it == m_Watches.end() || event->len == 0)
+                            continue;
+
+                        std::string path = it->second + "/" + event->name;
+                        if (event->mask & IN_ISDIR) {
+                            // Files written to a new directory before it's watch was added are reported with it
+                            if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                                addWatch(path, &changedFiles);
+                        } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                            changedFiles.push_back(path);
+                    }
+                }
+                return true;
+            }
+#else
+            FileWatcher::FileWatcher()  = default;
+            FileWatcher::~FileWatcher() = default;
+
+            bool FileWatcher::addDirectory(const std::string& directory)
+            {
+                std::string root = NormalizePath(directory);
+                if (!fs::is_directory(root)) {
+                    RAZIX_PACKER_LOG_ERROR("Can't watch " << root << " : not a directory");
+                    return false;
+                }
+                scan(root, nullptr);
+                m_Roots.push_back(root);
+                return true;
+            }
+
+            void FileWatcher::scan(const std::string& directory, std::vector<std::string>* changedFiles)
+            {
+                std::error_code ec;
+                for (fs::recursive_directory_iterator it(directory, fs::directory_options::skip_permission_denied, ec), end; !ec && it != end; it.increment(ec)) {
+                    if (!it->is_regular_file(ec))
+                        continue;
+
+                    int64_t modified = static_cast<int64_t>(it->last_write_time(ec).time_since_epoch().count());
+                    auto    result   = m_Modified.emplace(it->path().generic_string(), modified);
+                    if (result.second) {
+                        if (changedFiles)
+                            changedFiles->push_back(result.first->first);
+                    } else if (result.first->second != modified) {
+                        result.first->second = modified;
+                        if (changedFiles)
+                            changedFiles->push_back(result.first->first);
+                    }
+                }
+            }
+
+            // No change notifications here, the trees are compared after waiting for the timeout
+            bool FileWatcher::poll(std::vector<std::string>& changedFiles, uint32_t timeoutMs)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+                for (const auto& root: m_Roots)
+                    scan(root, &changedFiles);
+                return true;
+            }
+#endif
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
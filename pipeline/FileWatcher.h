@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Recursive watch of source directories, reports the files written, created or moved in since the last poll
+             * Linux uses inotify, Windows ReadDirectoryChangesW and other platforms compare the modification times of the whole
+             * trees on every poll. Deleted files aren't reported, there is nothing to pack for them. When the OS drops events
+             * (ex. the inotify queue overflowed) the watched directory itself is reported, everything under it has to be checked
+             */
+            class FileWatcher
+            {
+            public:
+                FileWatcher();
+                ~FileWatcher();
+
+                FileWatcher(const FileWatcher&)            = delete;
+                FileWatcher& operator=(const FileWatcher&) = delete;
+
+                /* Watches the directory and all it's subdirectories, including the ones created later */
+                bool addDirectory(const std::string& directory);
+                /**
+                 * Waits up to timeoutMs for changes and appends them to changedFiles, absolute with generic separators
+                 * A file can be reported several times while it's being written, returns false if the watch failed
+                 */
+                bool poll(std::vector<std::string>& changedFiles, uint32_t timeoutMs);
+
+            private:
+#if defined(_WIN32)
+                struct WatchedDirectory;
+                std::vector<std::unique_ptr<WatchedDirectory>> m_Directories;
+#elif defined(__linux__)
+                bool addWatch(const std::string& directory, std::vector<std::string>* existingFiles);
+
+                int                                  m_Fd = -1;
+                std::unordered_map<int, std::string> m_Watches; /* Watch descriptor to it's directory */
+                std::vector<std::string>             m_Roots;
+#else
+                void scan(const std::string& directory, std::vector<std::string>* changedFiles);
+
+                std::vector<std::string>                 m_Roots;
+                std::unordered_map<std::string, int64_t> m_Modified; /* Last modification time of every file under the roots */
+#endif
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,132 @@
+#include "ReloadNotifier.h"
+
+#include <cstring>
+
+#include "common/log.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <WinSock2.h>
+    #include <WS2tcpip.h>
+#else
+    #include <arpa/inet.h>
+    #include <cerrno>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            // Stays under the usual loopback MTU, so a batch is never fragmented
+            static constexpr size_t kMaxDatagramSize = 8 * 1024;
+
+            ReloadNotifier::~ReloadNotifier()
+            {
+                close();
+            }
+
+#ifdef _WIN32
+            bool ReloadNotifier::open(uint16_t port)
+            {
+                close();
+
+                WSADATA data;
+                if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+                    RAZIX_PACKER_LOG_ERROR("Can't initialize Winsock for the reload notifications");
+                    return false;
+                }
+
+                SOCKET sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+                if (sock == INVALID_SOCKET) {
+                    RAZIX_PACKER_LOG_ERROR("Can't create the reload notification socket : error " << WSAGetLastError());
+                    WSACleanup();
+                    return false;
+                }
+
+                m_Socket = static_cast<uintptr_t>(sock);
+                m_Port   = port;
+                return true;
+            }
+
+            void ReloadNotifier::close()
+            {
+                if (m_Port == 0)
+                    return;
+                closesocket(static_cast<SOCKET>(m_Socket));
+                WSACleanup();
+                m_Socket = ~uintptr_t(0);
+                m_Port   = 0;
+            }
+#else
+            bool ReloadNotifier::open(uint16_t port)
+            {
+                close();
+
+                m_Socket = socket(AF_INET, SOCK_DGRAM, 0);
+                if (m_Socket < 0) {
+                    RAZIX_PACKER_LOG_ERROR("Can't create the reload notification socket : " << strerror(errno));
+                    return false;
+                }
+
+                m_Port = port;
+                return true;
+            }
+
+            void ReloadNotifier::close()
+            {
+                if (m_Port == 0)
+                    return;
+                ::close(m_Socket);
+                m_Socket = -1;
+                m_Port   = 0;
+            }
+#endif
+
+            bool ReloadNotifier::send(const std::string& datagram)
+            {
+                sockaddr_in address     = {};
+                address.sin_family      = AF_INET;
+                address.sin_port        = htons(m_Port);
+                address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+#ifdef _WIN32
+                int sent = sendto(static_cast<SOCKET>(m_Socket), datagram.data(), static_cast<int>(datagram.size()), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+#else
+                ssize_t sent = sendto(m_Socket, datagram.data(), datagram.size(), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+#endif
+                return sent == static_cast<decltype(sent)>(datagram.size());
+            }
+
+            bool ReloadNotifier::notify(const std::vector<std::string>& files)
+            {
+                if (!isOpen())
+                    return false;
+
+                bool        success = true;
+                std::string datagram;
+                for (const auto& file: files) {
+                    std::string line = "reload " + file + "\n";
+                    if (line.size() > kMaxDatagramSize) {
+                        RAZIX_PACKER_LOG_WARNING("Path too long for a reload notification : " << file);
+                        continue;
+                    }
+                    if (datagram.size() + line.size() > kMaxDatagramSize) {
+                        success &= send(datagram);
+                        datagram.clear();
+                    }
+                    datagram += line;
+                }
+                if (!datagram.empty())
+                    success &= send(datagram);
+
+                if (!success)
+                    RAZIX_PACKER_LOG_WARNING("Some reload notifications couldn't be sent to port " << m_Port);
+                return success;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * Tells a running engine which packed files changed, so it can hot reload them
+             * Every file is a "reload <path>" line in UDP datagrams sent to 127.0.0.1:<port>, a line never spans two datagrams.
+             * Nothing has to be listening, datagrams without a receiver are dropped so the packer never waits on the engine
+             */
+            class ReloadNotifier
+            {
+            public:
+                ReloadNotifier() = default;
+                ~ReloadNotifier();
+
+                ReloadNotifier(const ReloadNotifier&)            = delete;
+                ReloadNotifier& operator=(const ReloadNotifier&) = delete;
+
+                bool open(uint16_t port);
+                void close();
+
+                bool isOpen() const { return m_Port != 0; }
+
+                /* Paths are sent as they are given, returns false if a datagram couldn't be sent */
+                bool notify(const std::vector<std::string>& files);
+
+            private:
+                bool send(const std::string& datagram);
+
+            private:
+                uint16_t m_Port = 0;
+#ifdef _WIN32
+                uintptr_t m_Socket = ~uintptr_t(0);
+#else
+                int m_Socket = -1;
+#endif
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
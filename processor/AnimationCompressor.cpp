@@ -0,0 +1,270 @@
+#include "AnimationCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/quaternion.hpp>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            static constexpr float kRadiansToDegrees = 57.2957795f;
+            static constexpr float kSmallestThreeMax = 0.70710678f; /* The 3 smallest components of a unit quaternion are within +-1/sqrt(2) */
+
+            static float PositionError(const glm::vec3& a, const glm::vec3& b)
+            {
+                return glm::length(a - b);
+            }
+
+            static float RotationError(const glm::quat& a, const glm::quat& b)
+            {
+                // |a - b| = 2 sin(angle / 4), unlike acos of the dot it's still precise for tiny angles
+                glm::quat c = glm::dot(a, b) < 0.0f ? -b : b;
+                float     x = a.x - c.x, y = a.y - c.y, z = a.z - c.z, w = a.w - c.w;
+                float     d = std::min(std::sqrt(x * x + y * y + z * z + w * w) * 0.5f, 1.0f);
+                return 4.0f * std::asin(d) * kRadiansToDegrees;
+            }
+
+            static glm::vec3 LerpValue(const glm::vec3& a, const glm::vec3& b, float t)
+            {
+                return glm::mix(a, b, t);
+            }
+
+            static glm::quat SlerpValue(const glm::quat& a, const glm::quat& b, float t)
+            {
+                return glm::slerp(a, b, t);
+            }
+
+            static float SegmentTime(const std::vector<float>& times, uint32_t first, uint32_t last, float time)
+            {
+                float span = times[last] - times[first];
+                return span > 0.0f ? (time - times[first]) / span : 0.0f;
+            }
+
+            // Indices of the keys to keep, a key is removed when interpolating the kept keys around it stays within tolerance
+            template<typename T, typename Interpolate, typename Error>
+            static std::vector<uint32_t> ReduceKeys(const std::vector<float>& times, const std::vector<T>& values, float tolerance, Interpolate interpolate, Error error)
+            {
+                std::vector<uint32_t> kept;
+                uint32_t              count = static_cast<uint32_t>(std::min(times.size(), values.size()));
+                if (count == 0)
+                    return kept;
+
+                kept.push_back(0);
+
+                bool constant = true;
+                for (uint32_t k = 1; k < count && constant; k++)
+                    constant = error(values[k], values[0]) <= tolerance;
+                if (constant)
+                    return kept;
+
+                // Grow the segment from the last kept key until one of the keys inside can't be rebuilt anymore
+                uint32_t anchor = 0;
+                for (uint32_t end = 2; end < count; end++) {
+                    for (uint32_t k = anchor + 1; k < end; k++) {
+                        T value = interpolate(values[anchor], values[end], SegmentTime(times, anchor, end, times[k]));
+                        if (error(value, values[k]) > tolerance) {
+                            anchor = end - 1;
+                            kept.push_back(anchor);
+                            break;
+                        }
+                    }
+                }
+                kept.push_back(count - 1);
+                return kept;
+            }
+
+            // Samples decoded keys like the runtime does, an empty channel is the bind pose
+            template<typename T, typename Interpolate>
+            static T SampleKeys(const std::vector<float>& times, const std::vector<T>& values, const T& bindValue, float time, Interpolate interpolate)
+            {
+                if (values.empty())
+                    return bindValue;
+                if (values.size() == 1 || time <= times.front())
+                    return values.front();
+                if (time >= times.back())
+                    return values.back();
+
+                uint32_t last  = static_cast<uint32_t>(std::upper_bound(times.begin(), times.end(), time) - times.begin());
+                uint32_t first = last - 1;
+                return interpolate(values[first], values[last], SegmentTime(times, first, last, time));
+            }
+
+            static uint16_t QuantizeTime(float time, float duration)
+            {
+                float t = duration > 0.0f ? std::min(std::max(time / duration, 0.0f), 1.0f) : 0.0f;
+                return static_cast<uint16_t>(t * 65535.0f + 0.5f);
+            }
+
+            static float DequantizeTime(uint16_t time, float duration)
+            {
+                return time / 65535.0f * duration;
+            }
+
+            // Appends the quantized times and values of a vec3 channel, min/extent is the range of the kept values
+            static void WriteVec3Channel(const std::vector<float>& times, const std::vector<glm::vec3>& values, const std::vector<uint32_t>& kept, float duration, std::vector<uint16_t>& data, BINAnimChannel& channel, float min[3], float extent[3], std::vector<float>& decodedTimes, std::vector<glm::vec3>& decodedValues)
+            {
+                channel.offset = static_cast<uint32_t>(data.size() * sizeof(uint16_t));
+                channel.count  = static_cast<uint32_t>(kept.size());
+                if (kept.empty())
+                    return;
+
+                glm::vec3 lo = values[kept[0]], hi = values[kept[0]];
+                for (uint32_t k: kept) {
+                    lo = glm::min(lo, values[k]);
+                    hi = glm::max(hi, values[k]);
+                }
+                glm::vec3 range = hi - lo;
+                for (uint32_t c = 0; c < 3; c++) {
+                    min[c]    = lo[c];
+                    extent[c] = range[c];
+                }
+
+                for (uint32_t k: kept) {
+                    data.push_back(QuantizeTime(times[k], duration));
+                    decodedTimes.push_back(DequantizeTime(data.back(), duration));
+                }
+
+                for (uint32_t k: kept) {
+                    glm::vec3 decoded;
+                    for (uint32_t c = 0; c < 3; c++) {
+                        float    n = range[c] > 0.0f ? (values[k][c] - lo[c]) / range[c] : 0.0f;
+                        uint16_t q = static_cast<uint16_t>(std::min(std::max(n, 0.0f), 1.0f) * 65535.0f + 0.5f);
+                        data.push_back(q);
+                        decoded[c] = lo[c] + q / 65535.0f * range[c];
+                    }
+                    decodedValues.push_back(decoded);
+                }
+            }
+
+            bool AnimationCompressor::compressClip(const AnimationClip& clip, const Skeleton& skeleton, const AnimationCompressionOptions& options, CompressedAnimationClip& compressed)
+            {
+                compressed          = CompressedAnimationClip();
+                compressed.name     = clip.name;
+                compressed.duration = clip.duration;
+
+                for (const auto& track: clip.tracks) {
+                    if (track.bone >= skeleton.bones.size())
+                        return false;
+
+                    const Bone& bone = skeleton.bones[track.bone];
+
+                    // Neighbouring rotations in the same hemisphere, so interpolating them takes the short path like the source did
+                    std::vector<glm::quat> rotations = track.rotations;
+                    for (size_t k = 1; k < rotations.size(); k++) {
+                        if (glm::dot(rotations[k - 1], rotations[k]) < 0.0f)
+                            rotations[k] = -rotations[k];
+                    }
+
+                    std::vector<uint32_t> positionKeys = ReduceKeys(track.positionTimes, track.positions, options.positionTolerance, LerpValue, PositionError);
+                    std::vector<uint32_t> rotationKeys = ReduceKeys(track.rotationTimes, rotations, options.rotationTolerance, SlerpValue, RotationError);
+                    std::vector<uint32_t> scaleKeys    = ReduceKeys(track.scaleTimes, track.scales, options.scaleTolerance, LerpValue, PositionError);
+
+                    // Constant channels in the bind pose don't need any key
+                    if (positionKeys.size() == 1 && PositionError(track.positions[0], bone.translation) <= options.positionTolerance)
+                        positionKeys.clear();
+                    if (rotationKeys.size() == 1 && RotationError(rotations[0], bone.rotation) <= options.rotationTolerance)
+                        rotationKeys.clear();
+                    if (scaleKeys.size() == 1 && PositionError(track.scales[0], bone.scale) <= options.scaleTolerance)
+                        scaleKeys.clear();
+
+                    compressed.rawKeys += static_cast<uint32_t>(track.positions.size() + track.rotations.size() + track.scales.size());
+                    compressed.rawSize += (track.positions.size() + track.scales.size()) * sizeof(float) * 4 + track.rotations.size() * sizeof(float) * 5;
+
+                    if (positionKeys.empty() && rotationKeys.empty() && scaleKeys.empty())
+                        continue;
+
+                    BINAnimTrack entry{};
+                    entry.bone = track.bone;
+
+                    std::vector<float>     positionTimes, rotationTimes, scaleTimes;
+                    std::vector<glm::vec3> positions, scales;
+                    std::vector<glm::quat> decodedRotations;
+
+                    WriteVec3Channel(track.positionTimes, track.positions, positionKeys, clip.duration, compressed.data, entry.position, entry.position_min, entry.position_extent, positionTimes, positions);
+
+                    entry.rotation.offset = static_cast<uint32_t>(compressed.data.size() * sizeof(uint16_t));
+                    entry.rotation.count  = static_cast<uint32_t>(rotationKeys.size());
+                    for (uint32_t k: rotationKeys) {
+                        compressed.data.push_back(QuantizeTime(track.rotationTimes[k], clip.duration));
+                        rotationTimes.push_back(DequantizeTime(compressed.data.back(), clip.duration));
+                    }
+                    for (uint32_t k: rotationKeys) {
+                        uint16_t quantized[3];
+                        QuantizeRotation(rotations[k], quantized);
+                        compressed.data.insert(compressed.data.end(), quantized, quantized + 3);
+                        decodedRotations.push_back(DequantizeRotation(quantized));
+                    }
+
+                    WriteVec3Channel(track.scaleTimes, track.scales, scaleKeys, clip.duration, compressed.data, entry.scale, entry.scale_min, entry.scale_extent, scaleTimes, scales);
+
+                    compressed.keys += entry.position.count + entry.rotation.count + entry.scale.count;
+                    compressed.tracks.push_back(entry);
+
+                    // Measured at every imported key against what the runtime will sample
+                    for (size_t k = 0; k < track.positions.size(); k++) {
+                        glm::vec3 sampled           = SampleKeys(positionTimes, positions, bone.translation, track.positionTimes[k], LerpValue);
+                        compressed.maxPositionError = std::max(compressed.maxPositionError, PositionError(sampled, track.positions[k]));
+                    }
+                    for (size_t k = 0; k < track.rotations.size(); k++) {
+                        glm::quat sampled           = SampleKeys(rotationTimes, decodedRotations, bone.rotation, track.rotationTimes[k], SlerpValue);
+                        compressed.maxRotationError = std::max(compressed.maxRotationError, RotationError(sampled, track.rotations[k]));
+                    }
+                    for (size_t k = 0; k < track.scales.size(); k++) {
+                        glm::vec3 sampled        = SampleKeys(scaleTimes, scales, bone.scale, track.scaleTimes[k], LerpValue);
+                        compressed.maxScaleError = std::max(compressed.maxScaleError, PositionError(sampled, track.scales[k]));
+                    }
+                }
+
+                return true;
+            }
+
+            void AnimationCompressor::QuantizeRotation(const glm::quat& rotation, uint16_t quantized[3])
+            {
+                glm::quat q             = glm::normalize(rotation);
+                float     components[4] = {q.x, q.y, q.z, q.w};
+
+                uint32_t largest = 0;
+                for (uint32_t i = 1; i < 4; i++) {
+                    if (std::abs(components[i]) > std::abs(components[largest]))
+                        largest = i;
+                }
+
+                // q and -q are the same rotation, flip it so the dropped component is positive
+                float    sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+                uint32_t j    = 0;
+                for (uint32_t i = 0; i < 4; i++) {
+                    if (i == largest)
+                        continue;
+
+                    float    n     = (components[i] * sign / kSmallestThreeMax) * 0.5f + 0.5f;
+                    uint32_t value = static_cast<uint32_t>(std::min(std::max(n, 0.0f), 1.0f) * 32767.0f + 0.5f);
+                    quantized[j++] = static_cast<uint16_t>(value << 1);
+                }
+
+                quantized[0] |= largest & 1;
+                quantized[1] |= (largest >> 1) & 1;
+            }
+
+            glm::quat AnimationCompressor::DequantizeRotation(const uint16_t quantized[3])
+            {
+                uint32_t largest = (quantized[0] & 1) | ((quantized[1] & 1) << 1);
+
+                float    components[4];
+                float    sum = 0.0f;
+                uint32_t j   = 0;
+                for (uint32_t i = 0; i < 4; i++) {
+                    if (i == largest)
+                        continue;
+
+                    components[i] = ((quantized[j++] >> 1) / 32767.0f * 2.0f - 1.0f) * kSmallestThreeMax;
+                    sum += components[i] * components[i];
+                }
+                components[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+
+                return glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "common/intermediate_types.h"
+#include "common/rzanim_format.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            struct AnimationCompressionOptions
+            {
+                float positionTolerance = 0.001f; /* Max error of a removed position key, model units */
+                float rotationTolerance = 0.1f;   /* Max error of a removed rotation key, degrees     */
+                float scaleTolerance    = 0.001f; /* Max error of a removed scale key                 */
+            };
+
+            /**
+             * A clip ready to be written as a .rzanim, tracks and key data are laid out like the file
+             * The errors are the worst local space deviation from the imported keys, measured after reduction and quantization
+             */
+            struct CompressedAnimationClip
+            {
+                std::string               name;
+                float                     duration = 0.0f;
+                std::vector<BINAnimTrack> tracks;
+                std::vector<uint16_t>     data;                    /* Key data, BINAnimChannel offsets are in bytes into it */
+                uint64_t                  rawSize          = 0;    /* Float keys (time + value) of the imported clip, bytes  */
+                uint32_t                  rawKeys          = 0;
+                uint32_t                  keys             = 0;
+                float                     maxPositionError = 0.0f;
+                float                     maxRotationError = 0.0f; /* Degrees */
+                float                     maxScaleError    = 0.0f;
+            };
+
+            /**
+             * Reduces and quantizes the keys of an animation clip, see common/rzanim_format.h for the layout
+             *
+             * Keys that lerp/slerp between their neighbours within the tolerances are removed greedily, channels that end up
+             * with a single value are collapsed to one key, or dropped when it's the bind pose. Translation and scale are quantized
+             * to 16 bits in the range of their track, rotations to 48 bits with the smallest three encoding and key times to 16 bits
+             * of the clip duration.
+             */
+            class AnimationCompressor
+            {
+            public:
+                AnimationCompressor()  = default;
+                ~AnimationCompressor() = default;
+
+                /* Constant channels that match the bind pose of skeleton are dropped, the bone then keeps it's bind pose */
+                bool compressClip(const AnimationClip& clip, const Skeleton& skeleton, const AnimationCompressionOptions& options, CompressedAnimationClip& compressed);
+
+                static void      QuantizeRotation(const glm::quat& rotation, uint16_t quantized[3]);
+                static glm::quat DequantizeRotation(const uint16_t quantized[3]);
+            };
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,267 @@
+#include "BVHBuilder.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+
+#include "common/job_system.h"
+#include "common/log.h"
+#include "common/profiler.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            static constexpr uint32_t kMaxBins = 64;
+
+            struct BVHBounds
+            {
+                glm::vec3 min = glm::vec3(FLT_MAX);
+                glm::vec3 max = glm::vec3(-FLT_MAX);
+
+                void grow(const glm::vec3& p)
+                {
+                    min = glm::min(min, p);
+                    max = glm::max(max, p);
+                }
+                void grow(const BVHBounds& bounds)
+                {
+                    min = glm::min(min, bounds.min);
+                    max = glm::max(max, bounds.max);
+                }
+                /* Half the surface area, the SAH only compares areas */
+                float area() const
+                {
+                    glm::vec3 extent = max - min;
+                    return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+                }
+            };
+
+            bool BVHBuilder::buildBVHs(MeshImportResult& import_result, const BVHBuildOptions& options, JobSystem* jobSystem)
+            {
+                import_result.bvh_nodes.clear();
+                import_result.bvh_indices.clear();
+
+                if (options.maxLeafTriangles == 0 || options.binsCount < 2 || options.binsCount > kMaxBins || options.traversalCost < 0.0f) {
+                    RAZIX_PACKER_LOG_ERROR("Invalid BVH options : " << options.maxLeafTriangles << " triangles per leaf, " << options.binsCount << " bins (at least 1 triangle per leaf and 2 to 64 bins)");
+                    return false;
+                }
+
+                auto start = std::chrono::high_resolution_clock::now();
+
+                uint32_t                submeshesCount = static_cast<uint32_t>(import_result.submeshes.size());
+                std::vector<SubMeshBVH> submeshBVHs(submeshesCount);
+
+                // Every submesh writes the reordered triangles to it's own range, parallel to the index buffer
+                import_result.bvh_indices.resize(import_result.indices.size());
+
+                auto buildJob = [&](uint32_t i) {
+                    RAZIX_PACKER_PROFILE_ZONE("Build Submesh BVH");
+                    const auto& submesh = import_result.submeshes[i];
+                    auto&       bvh     = submeshBVHs[i];
+                    buildSubMeshBVH(import_result, submesh, options, bvh);
+
+                    const uint32_t* indices    = &import_result.indices[submesh.base_index];
+                    uint32_t*       bvhIndices = &import_result.bvh_indices[submesh.base_index];
+                    for (size_t t = 0; t < bvh.triangles.size(); t++) {
+                        bvhIndices[t * 3 + 0] = indices[bvh.triangles[t] * 3 + 0];
+                        bvhIndices[t * 3 + 1] = indices[bvh.triangles[t] * 3 + 1];
+                        bvhIndices[t * 3 + 2] = indices[bvh.triangles[t] * 3 + 2];
+                    }
+                    bvh.triangles = std::vector<uint32_t>();
+                };
+
+                if (jobSystem)
+                    jobSystem->parallelFor(submeshesCount, buildJob);
+                else {
+                    for (uint32_t i = 0; i < submeshesCount; i++)
+                        buildJob(i);
+                }
+
+                // Concatenate in submesh order, the nodes index their own BVH so they are copied as they are
+                // A single leaf BVH has an odd node count, it's padded so every root and sibling pair stays on a cache line in a .rzpack
+                uint64_t leaves = 0, triangles = 0;
+                double   sahCost = 0.0;
+                for (uint32_t i = 0; i < submeshesCount; i++) {
+                    auto& submesh          = import_result.submeshes[i];
+                    auto& bvh              = submeshBVHs[i];
+                    submesh.bvh_offset     = static_cast<uint32_t>(import_result.bvh_nodes.size());
+                    submesh.bvh_node_count = static_cast<uint32_t>(bvh.nodes.size());
+                    import_result.bvh_nodes.insert(import_result.bvh_nodes.end(), bvh.nodes.begin(), bvh.nodes.end());
+                    if (bvh.nodes.size() % 2)
+                        import_result.bvh_nodes.push_back({glm::vec3(FLT_MAX), 0, glm::vec3(-FLT_MAX), 0});
+
+                    leaves += bvh.leavesCount;
+                    triangles += submesh.index_count / 3;
+                    sahCost += double(bvh.sahCost) * (submesh.index_count / 3);
+                }
+
+                auto                          finish = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> time   = finish - start;
+
+                if (leaves > 0) {
+                    RAZIX_PACKER_LOG_INFO("Built " << import_result.bvh_nodes.size() << " BVH nodes (" << options.maxLeafTriangles << " triangles per leaf at most), avg " << double(triangles) / leaves << " triangles per leaf, SAH cost " << sahCost / triangles << " in " << time.count() << " seconds");
+                }
+                return true;
+            }
+
+            void BVHBuilder::buildSubMeshBVH(const MeshImportResult& import_result, const SubMesh& submesh, const BVHBuildOptions& options, SubMeshBVH& result)
+            {
+                uint32_t trianglesCount = submesh.index_count / 3;
+                if (trianglesCount == 0 || submesh.vertex_count == 0)
+                    return;
+
+                const uint32_t*  indices   = &import_result.indices[submesh.base_index];
+                const glm::vec3* positions = &import_result.vertices.Position[submesh.base_vertex];
+
+                // The bounds move with the triangles when a node is partitioned, so every pass over a node reads them in order
+                struct BuildTriangle
+                {
+                    BVHBounds bounds;
+                    glm::vec3 centroid;
+                    uint32_t  index;
+                };
+                std::vector<BuildTriangle> buildTriangles(trianglesCount);
+                for (uint32_t t = 0; t < trianglesCount; t++) {
+                    BuildTriangle& triangle = buildTriangles[t];
+                    triangle.bounds.grow(positions[indices[t * 3 + 0]]);
+                    triangle.bounds.grow(positions[indices[t * 3 + 1]]);
+                    triangle.bounds.grow(positions[indices[t * 3 + 2]]);
+                    triangle.centroid = (triangle.bounds.min + triangle.bounds.max) * 0.5f;
+                    triangle.index    = t;
+                }
+
+                // A full binary tree with a leaf per triangle and the padding node is the worst case
+                result.nodes.reserve(size_t(trianglesCount) * 2);
+                result.nodes.emplace_back();
+
+                struct BuildTask
+                {
+                    uint32_t node;
+                    uint32_t start;
+                    uint32_t count;
+                };
+                std::vector<BuildTask> tasks;
+                tasks.push_back({0, 0, trianglesCount});
+
+                // Right sweep of a bin covers the bins from it to the last one
+                struct SAHBin
+                {
+                    BVHBounds bounds;
+                    uint32_t  count      = 0;
+                    uint32_t  rightCount = 0;
+                    float     rightCost  = 0.0f;
+                };
+                std::vector<SAHBin> bins(options.binsCount);
+
+                float  rootArea = 0.0f;
+                double sahCost  = 0.0;
+                while (!tasks.empty()) {
+                    BuildTask task = tasks.back();
+                    tasks.pop_back();
+
+                    BVHBounds bounds, centroidBounds;
+                    for (uint32_t i = task.start; i < task.start + task.count; i++) {
+                        bounds.grow(buildTriangles[i].bounds);
+                        centroidBounds.grow(buildTriangles[i].centroid);
+                    }
+                    result.nodes[task.node].min_extents = bounds.min;
+                    result.nodes[task.node].max_extents = bounds.max;
+
+                    float area = bounds.area();
+                    if (task.node == 0)
+                        rootArea = area;
+
+                    // Binned SAH on the centroids, the bins grow with the full triangle bounds
+                    float    bestCost = FLT_MAX;
+                    int32_t  bestAxis = -1;
+                    uint32_t bestBin  = 0;
+                    for (int32_t axis = 0; axis < 3 && task.count > 1; axis++) {
+                        float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+                        if (extent <= 0.0f)
+                            continue;
+
+                        std::fill(bins.begin(), bins.end(), SAHBin());
+                        float scale = options.binsCount / extent;
+                        for (uint32_t i = task.start; i < task.start + task.count; i++) {
+                            const BuildTriangle& triangle = buildTriangles[i];
+                            uint32_t             bin      = std::min(options.binsCount - 1, static_cast<uint32_t>((triangle.centroid[axis] - centroidBounds.min[axis]) * scale));
+                            bins[bin].count++;
+                            bins[bin].bounds.grow(triangle.bounds);
+                        }
+
+                        // Sweep from the right first, then evaluate every split from the left
+                        BVHBounds right;
+                        uint32_t  rightCount = 0;
+                        for (uint32_t bin = options.binsCount - 1; bin > 0; bin--) {
+                            right.grow(bins[bin].bounds);
+                            rightCount += bins[bin].count;
+                            bins[bin].rightCount = rightCount;
+                            bins[bin].rightCost  = rightCount ? right.area() * rightCount : 0.0f;
+                        }
+
+                        BVHBounds left;
+                        uint32_t  leftCount = 0;
+                        for (uint32_t bin = 1; bin < options.binsCount; bin++) {
+                            left.grow(bins[bin - 1].bounds);
+                            leftCount += bins[bin - 1].count;
+                            if (leftCount == 0 || bins[bin].rightCount == 0)
+                                continue;
+
+                            float cost = left.area() * leftCount + bins[bin].rightCost;
+                            if (cost < bestCost) {
+                                bestCost = cost;
+                                bestAxis = axis;
+                                bestBin  = bin;
+                            }
+                        }
+                    }
+
+                    // Flat or degenerate nodes have no area to compare, they are only split to respect the leaf size
+                    float splitCost = (bestAxis >= 0 && area > 0.0f) ? options.traversalCost + bestCost / area : FLT_MAX;
+                    if (task.count <= options.maxLeafTriangles && (bestAxis < 0 || area <= 0.0f || float(task.count) <= splitCost)) {
+                        result.nodes[task.node].first          = task.start;
+                        result.nodes[task.node].triangle_count = task.count;
+                        result.leavesCount++;
+                        sahCost += double(area) * task.count;
+                        continue;
+                    }
+
+                    BuildTriangle* begin  = &buildTriangles[task.start];
+                    BuildTriangle* end    = begin + task.count;
+                    BuildTriangle* middle = begin;
+                    if (bestAxis >= 0) {
+                        float scale = options.binsCount / (centroidBounds.max[bestAxis] - centroidBounds.min[bestAxis]);
+                        middle      = std::partition(begin, end, [&](const BuildTriangle& triangle) {
+                            return std::min(options.binsCount - 1, static_cast<uint32_t>((triangle.centroid[bestAxis] - centroidBounds.min[bestAxis]) * scale)) < bestBin;
+                        });
+                    }
+                    // Every centroid is at the same spot (or rounding put them in the same bin), any split is as good as another
+                    if (middle == begin || middle == end)
+                        middle = begin + task.count / 2;
+
+                    // Node 1 is skipped, so the siblings of every pair start on an even node and share a cache line
+                    if (result.nodes.size() == 1)
+                        result.nodes.push_back({glm::vec3(FLT_MAX), 0, glm::vec3(-FLT_MAX), 0});
+
+                    uint32_t leftNode = static_cast<uint32_t>(result.nodes.size());
+                    result.nodes.emplace_back();
+                    result.nodes.emplace_back();
+                    result.nodes[task.node].first          = leftNode;
+                    result.nodes[task.node].triangle_count = 0;
+                    sahCost += double(area) * options.traversalCost;
+
+                    uint32_t leftCount = static_cast<uint32_t>(middle - begin);
+                    tasks.push_back({leftNode + 1, task.start + leftCount, task.count - leftCount});
+                    tasks.push_back({leftNode, task.start, leftCount});
+                }
+
+                result.sahCost = rootArea > 0.0f ? static_cast<float>(sahCost / rootArea) : 0.0f;
+
+                result.triangles.resize(trianglesCount);
+                for (uint32_t t = 0; t < trianglesCount; t++)
+                    result.triangles[t] = buildTriangles[t].index;
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "common/intermediate_types.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            class JobSystem;
+
+            struct BVHBuildOptions
+            {
+                uint32_t maxLeafTriangles = 4;    /* Leaves never hold more triangles than this, the SAH may stop splitting before */
+                uint32_t binsCount        = 16;   /* SAH split candidates per axis, [2, 64]                                        */
+                float    traversalCost    = 1.0f; /* Cost of a node visit relative to a triangle test, higher gives fewer nodes    */
+            };
+
+            /**
+             * Builds a binned SAH BVH over the LOD 0 triangles of every submesh, so the runtime can load it instead of building it
+             * Triangles are reordered in MeshImportResult::bvh_indices so every leaf is a contiguous range, the render index buffer
+             * keeps the vertex cache order of the MeshProcessor. Run it after the MeshProcessor, the BVH indexes the final vertices
+             */
+            class BVHBuilder
+            {
+            public:
+                BVHBuilder()  = default;
+                ~BVHBuilder() = default;
+
+                bool buildBVHs(MeshImportResult& import_result, const BVHBuildOptions& options, JobSystem* jobSystem = nullptr);
+
+            private:
+                struct SubMeshBVH
+                {
+                    std::vector<BVHNode>  nodes;
+                    std::vector<uint32_t> triangles;          /* Submesh triangle of every BVH triangle       */
+                    uint32_t              leavesCount = 0;    /* Leaves of the BVH                            */
+                    float                 sahCost     = 0.0f; /* Relative to the root area, in triangle tests */
+                };
+
+                void buildSubMeshBVH(const MeshImportResult& import_result, const SubMesh& submesh, const BVHBuildOptions& options, SubMeshBVH& result);
+            };
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,107 @@
+#include "LODGenerator.h"
+
+#include <chrono>
+
+#include <meshoptimizer.h>
+
+#include "common/job_system.h"
+#include "common/log.h"
+#include "common/profiler.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            bool LODGenerator::generateLODs(MeshImportResult& import_result, const LODGenerationOptions& options, JobSystem* jobSystem)
+            {
+                import_result.lods.clear();
+                import_result.lod_indices.clear();
+
+                if (options.maxLODs == 0 || import_result.submeshes.empty())
+                    return true;
+
+                auto start = std::chrono::high_resolution_clock::now();
+
+                // Every submesh builds it's chain in isolation, they are concatenated in order afterwards
+                uint32_t                             submeshesCount = static_cast<uint32_t>(import_result.submeshes.size());
+                std::vector<std::vector<SubMeshLOD>> submeshLODs(submeshesCount);
+                std::vector<std::vector<uint32_t>>   submeshLODIndices(submeshesCount);
+
+                auto generateJob = [&](uint32_t i) {
+                    RAZIX_PACKER_PROFILE_ZONE("Generate Submesh LODs");
+                    generateSubMeshLODs(import_result, import_result.submeshes[i], options, submeshLODs[i], submeshLODIndices[i]);
+                };
+
+                if (jobSystem)
+                    jobSystem->parallelFor(submeshesCount, generateJob);
+                else {
+                    for (uint32_t i = 0; i < submeshesCount; i++)
+                        generateJob(i);
+                }
+
+                uint64_t lod0Triangles = 0, lodTriangles = 0;
+                for (uint32_t i = 0; i < submeshesCount; i++) {
+                    auto& submesh      = import_result.submeshes[i];
+                    submesh.lod_offset = static_cast<uint32_t>(import_result.lods.size());
+                    submesh.lod_count  = static_cast<uint32_t>(submeshLODs[i].size());
+
+                    uint32_t base_index = static_cast<uint32_t>(import_result.lod_indices.size());
+                    for (auto& lod: submeshLODs[i]) {
+                        lod.base_index += base_index;
+                        lodTriangles += lod.index_count / 3;
+                        import_result.lods.push_back(lod);
+                    }
+                    import_result.lod_indices.insert(import_result.lod_indices.end(), submeshLODIndices[i].begin(), submeshLODIndices[i].end());
+
+                    lod0Triangles += submesh.index_count / 3;
+                }
+
+                auto                          finish = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> time   = finish - start;
+
+                RAZIX_PACKER_LOG_INFO("Generated " << import_result.lods.size() << " LODs for " << submeshesCount << " submeshes (" << lod0Triangles << " LOD 0 triangles, " << lodTriangles << " LOD triangles) in " << time.count() << " seconds");
+                return true;
+            }
+
+            void LODGenerator::generateSubMeshLODs(const MeshImportResult& import_result, const SubMesh& submesh, const LODGenerationOptions& options, std::vector<SubMeshLOD>& lods, std::vector<uint32_t>& lod_indices)
+            {
+                if (submesh.index_count / 3 < options.minTriangles || submesh.vertex_count == 0)
+                    return;
+
+                const uint32_t* indices      = &import_result.indices[submesh.base_index];
+                const float*    positions    = &import_result.vertices.Position[submesh.base_vertex].x;
+                size_t          vertex_count = submesh.vertex_count;
+
+                // The simplifier error is relative to the mesh size, this converts it back to object space
+                float scale = meshopt_simplifyScale(positions, vertex_count, sizeof(glm::vec3));
+
+                std::vector<uint32_t> lod(submesh.index_count);
+                size_t                previous_index_count = submesh.index_count;
+
+                for (uint32_t level = 0; level < options.maxLODs; level++) {
+                    size_t target_index_count = static_cast<size_t>(previous_index_count * options.targetRatio) / 3 * 3;
+                    if (target_index_count / 3 < options.minTriangles)
+                        break;
+
+                    float  error       = 0.0f;
+                    size_t index_count = meshopt_simplify(lod.data(), indices, submesh.index_count, positions, vertex_count, sizeof(glm::vec3), target_index_count, options.maxError, &error);
+
+                    // The error budget is used up, more levels would look the same
+                    if (index_count == 0 || index_count > previous_index_count * (1.0f - options.minReduction))
+                        break;
+
+                    meshopt_optimizeVertexCache(lod.data(), lod.data(), index_count, vertex_count);
+
+                    SubMeshLOD entry{};
+                    entry.base_index  = static_cast<uint32_t>(lod_indices.size());
+                    entry.index_count = static_cast<uint32_t>(index_count);
+                    entry.error       = error * scale;
+                    lods.push_back(entry);
+
+                    lod_indices.insert(lod_indices.end(), lod.begin(), lod.begin() + index_count);
+                    previous_index_count = index_count;
+                }
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "common/intermediate_types.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            class JobSystem;
+
+            struct LODGenerationOptions
+            {
+                uint32_t maxLODs      = 4;     /* Maximum number of LODs generated per submesh on top of LOD 0                         */
+                float    targetRatio  = 0.5f;  /* Triangles of every LOD relative to the previous one                                   */
+                float    maxError     = 0.05f; /* Maximum deviation allowed relative to the submesh size, the chain stops once it's hit */
+                float    minReduction = 0.1f;  /* Stop the chain when a LOD can't remove at least this fraction of the triangles       */
+                uint32_t minTriangles = 64;    /* Submeshes/LODs smaller than this are not simplified any further                       */
+            };
+
+            /**
+             * Builds a LOD chain for every submesh with the meshoptimizer simplifier
+             * LODs reuse the vertices of their submesh, only new index buffers are generated, so run it after the MeshProcessor
+             * has remapped the vertices. Every LOD is simplified from LOD 0, so the stored error is exact and not accumulated.
+             */
+            class LODGenerator
+            {
+            public:
+                LODGenerator()  = default;
+                ~LODGenerator() = default;
+
+                bool generateLODs(MeshImportResult& import_result, const LODGenerationOptions& options, JobSystem* jobSystem = nullptr);
+
+            private:
+                void generateSubMeshLODs(const MeshImportResult& import_result, const SubMesh& submesh, const LODGenerationOptions& options, std::vector<SubMeshLOD>& lods, std::vector<uint32_t>& lod_indices);
+            };
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
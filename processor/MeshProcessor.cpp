@@ -0,0 +1,388 @@
+#include "MeshProcessor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+#include <meshoptimizer.h>
+
+#include "common/job_system.h"
+#include "common/log.h"
+#include "common/profiler.h"
+#include "common/vertex_simd.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            // Cache parameters used by the analyzers, matches a typical 16 entry post-transform cache
+            constexpr uint32_t kAnalyzerCacheSize = 16;
+            constexpr uint32_t kWeldNone          = ~0u;
+            constexpr float    kWeldColorDistance = 1.0f / 255.0f; /* Colors and bone weights are stored as unorm8 at best */
+
+            // A cell of the welding grid and the first of it's kept vertices, the others are linked through WeldGrid::next
+            struct WeldCell
+            {
+                int32_t  x = 0, y = 0, z = 0;
+                uint32_t head = kWeldNone;
+            };
+
+            // Open addressing hash of the occupied cells, at most a cell per vertex so it never gets more than half full
+            struct WeldGrid
+            {
+                std::vector<WeldCell> cells;
+                std::vector<uint32_t> next;
+                uint32_t              mask = 0;
+
+                explicit WeldGrid(uint32_t vertexCount)
+                    : next(vertexCount, kWeldNone)
+                {
+                    uint32_t capacity = 16;
+                    while (capacity < vertexCount * 2)
+                        capacity <<= 1;
+                    cells.resize(capacity);
+                    mask = capacity - 1;
+                }
+
+                // The slot of the cell, or the empty slot it would go to
+                WeldCell& find(int32_t x, int32_t y, int32_t z)
+                {
+                    uint32_t hash = (uint32_t(x) * 73856093u) ^ (uint32_t(y) * 19349663u) ^ (uint32_t(z) * 83492791u);
+                    hash ^= hash >> 16;
+                    hash *= 0x85EBCA6Bu;
+                    hash ^= hash >> 13;
+
+                    for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask) {
+                        WeldCell& cell = cells[slot];
+                        if (cell.head == kWeldNone || (cell.x == x && cell.y == y && cell.z == z))
+                            return cell;
+                    }
+                }
+            };
+
+            static int32_t WeldCellCoord(float position, float invCellSize)
+            {
+                // Clamped so far away or broken positions can't overflow, they only end up sharing a cell
+                float cell = std::floor(position * invCellSize);
+                return static_cast<int32_t>(std::min(std::max(cell, -1073741824.0f), 1073741824.0f));
+            }
+
+            template<typename T>
+            static const T* SubMeshStream(const std::vector<T>& stream, const SubMesh& submesh)
+            {
+                return stream.size() >= size_t(submesh.base_vertex) + submesh.vertex_count ? &stream[submesh.base_vertex] : nullptr;
+            }
+
+            bool MeshProcessor::processMesh(MeshImportResult& import_result, const MeshProcessingOptions& options, JobSystem* jobSystem)
+            {
+                if (import_result.submeshes.empty() || import_result.indices.empty())
+                    return true;
+
+                RAZIX_PACKER_LOG_VERBOSE("Processing Mesh... : " << import_result.name);
+
+                auto start = std::chrono::high_resolution_clock::now();
+
+                uint32_t                       submeshesCount = static_cast<uint32_t>(import_result.submeshes.size());
+                std::vector<SubMeshStatistics> before(submeshesCount), after(submeshesCount);
+                std::atomic<uint64_t>          weldVerticesIn  = 0;
+                std::atomic<uint64_t>          weldVerticesOut = 0;
+                std::atomic<uint64_t>          weldDroppedTris = 0;
+                bool                           weld            = options.weldVertices && options.weldDistance > 0.0f;
+                // The analysis simulates the caches and rasterizes every submesh, it's skipped when the stats wouldn't be printed
+                bool                           statistics      = options.printStatistics && IsLogEnabled(LogLevel::Info);
+
+                auto processSubMeshJob = [&](uint32_t i) {
+                    RAZIX_PACKER_PROFILE_ZONE("Process Submesh");
+
+                    auto& submesh = import_result.submeshes[i];
+                    if (submesh.index_count == 0 || submesh.vertex_count == 0)
+                        return;
+
+                    if (statistics)
+                        analyzeSubMesh(import_result, submesh, before[i]);
+
+                    if (weld) {
+                        weldVerticesIn += submesh.vertex_count;
+                        weldDroppedTris += weldSubMesh(import_result, submesh, options);
+                        weldVerticesOut += submesh.vertex_count;
+
+                        // Every triangle collapsed, there's nothing left to optimize
+                        if (submesh.index_count == 0)
+                            return;
+                    }
+
+                    optimizeSubMesh(import_result, submesh, options);
+
+                    if (statistics)
+                        analyzeSubMesh(import_result, submesh, after[i]);
+                };
+
+                if (jobSystem)
+                    jobSystem->parallelFor(submeshesCount, processSubMeshJob);
+                else {
+                    for (uint32_t i = 0; i < submeshesCount; i++)
+                        processSubMeshJob(i);
+                }
+
+                // Welding and vertex fetch optimization drop vertices, close the gaps they leave between the submeshes
+                if (weld)
+                    compactIndices(import_result);
+                if (weld || options.optimizeVertexFetch)
+                    compactVertices(import_result);
+
+                if (weld) {
+                    import_result.min_extents = import_result.submeshes[0].min_extents;
+                    import_result.max_extents = import_result.submeshes[0].max_extents;
+                    for (const auto& submesh: import_result.submeshes) {
+                        import_result.min_extents = glm::min(import_result.min_extents, submesh.min_extents);
+                        import_result.max_extents = glm::max(import_result.max_extents, submesh.max_extents);
+                    }
+
+                    double reduction = weldVerticesIn > 0 ? 100.0 * (1.0 - static_cast<double>(weldVerticesOut) / static_cast<double>(weldVerticesIn)) : 0.0;
+                    RAZIX_PACKER_LOG_INFO("Welded vertices within " << options.weldDistance << " : " << weldVerticesIn << " -> " << weldVerticesOut << " (-" << reduction << "%), " << weldDroppedTris << " degenerate triangles removed");
+                }
+
+                auto                          finish = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> time   = finish - start;
+
+                if (statistics)
+                    printStatistics(import_result, before, after);
+
+                RAZIX_PACKER_LOG_INFO("Successfully Processed mesh in " << time.count() << " seconds");
+                return true;
+            }
+
+            uint32_t MeshProcessor::weldSubMesh(MeshImportResult& import_result, SubMesh& submesh, const MeshProcessingOptions& options)
+            {
+                const glm::vec3*  positions   = SubMeshStream(import_result.vertices.Position, submesh);
+                const glm::vec3*  normals     = SubMeshStream(import_result.vertices.Normal, submesh);
+                const glm::vec2*  uvs         = SubMeshStream(import_result.vertices.UV, submesh);
+                const glm::vec4*  colors      = SubMeshStream(import_result.vertices.Color, submesh);
+                const glm::uvec4* boneIndices = SubMeshStream(import_result.bone_indices, submesh);
+                const glm::vec4*  boneWeights = SubMeshStream(import_result.bone_weights, submesh);
+                const float*      signs       = SubMeshStream(import_result.tangent_signs, submesh);
+                if (!positions)
+                    return 0;
+
+                uint32_t vertex_count   = submesh.vertex_count;
+                float    distance2      = options.weldDistance * options.weldDistance;
+                float    invCellSize    = 1.0f / options.weldDistance;
+                float    minNormalDot   = std::cos(glm::radians(options.weldNormalAngle));
+                auto     withinDistance = [](const auto& a, const auto& b, uint32_t components, float tolerance) {
+                    for (uint32_t c = 0; c < components; c++) {
+                        if (std::abs(a[c] - b[c]) > tolerance)
+                            return false;
+                    }
+                    return true;
+                };
+                auto canWeld = [&](uint32_t a, uint32_t b) {
+                    glm::vec3 d = positions[a] - positions[b];
+                    if (glm::dot(d, d) > distance2)
+                        return false;
+                    if (normals && normals[a] != normals[b] && glm::dot(normals[a], normals[b]) < minNormalDot)
+                        return false;
+                    // Mirrored UV islands meet at the same position and normal, only the handedness tells them apart
+                    if (signs && signs[a] != signs[b])
+                        return false;
+                    if (uvs && !withinDistance(uvs[a], uvs[b], 2, options.weldUVDistance))
+                        return false;
+                    if (colors && !withinDistance(colors[a], colors[b], 4, kWeldColorDistance))
+                        return false;
+                    if (boneIndices && (boneIndices[a] != boneIndices[b] || !withinDistance(boneWeights[a], boneWeights[b], 4, kWeldColorDistance)))
+                        return false;
+                    return true;
+                };
+
+                // The cells are as big as the weld distance, so any vertex close enough is in one of the 27 cells around
+                // Vertices are visited in order and merged into the first kept vertex they can weld to, or kept themselves
+                WeldGrid              grid(vertex_count);
+                std::vector<uint32_t> remap(vertex_count);
+                uint32_t              kept = 0;
+                for (uint32_t v = 0; v < vertex_count; v++) {
+                    int32_t x = WeldCellCoord(positions[v].x, invCellSize);
+                    int32_t y = WeldCellCoord(positions[v].y, invCellSize);
+                    int32_t z = WeldCellCoord(positions[v].z, invCellSize);
+
+                    uint32_t match = kWeldNone;
+                    for (int32_t dz = -1; dz <= 1 && match == kWeldNone; dz++) {
+                        for (int32_t dy = -1; dy <= 1 && match == kWeldNone; dy++) {
+                            for (int32_t dx = -1; dx <= 1 && match == kWeldNone; dx++) {
+                                for (uint32_t u = grid.find(x + dx, y + dy, z + dz).head; u != kWeldNone && match == kWeldNone; u = grid.next[u]) {
+                                    if (canWeld(u, v))
+                                        match = u;
+                                }
+                            }
+                        }
+                    }
+
+                    if (match != kWeldNone) {
+                        remap[v] = remap[match];
+                        continue;
+                    }
+
+                    remap[v]       = kept++;
+                    WeldCell& cell = grid.find(x, y, z);
+                    cell.x         = x;
+                    cell.y         = y;
+                    cell.z         = z;
+                    grid.next[v]   = cell.head;
+                    cell.head      = v;
+                }
+
+                if (kept == vertex_count)
+                    return 0;
+
+                // Kept vertices only move down and keep their order, so all the streams are compacted in place
+                ForEachVertexStream(import_result, [&](auto& stream) {
+                    if (stream.size() < submesh.base_vertex + vertex_count)
+                        return;
+                    auto*    data    = &stream[submesh.base_vertex];
+                    uint32_t written = 0;
+                    for (uint32_t v = 0; v < vertex_count; v++) {
+                        if (remap[v] == written)
+                            data[written++] = data[v];
+                    }
+                });
+
+                // Triangles with two corners welded together have no area anymore
+                uint32_t* indices     = &import_result.indices[submesh.base_index];
+                uint32_t  index_count = 0;
+                for (uint32_t t = 0; t + 2 < submesh.index_count; t += 3) {
+                    uint32_t a = remap[indices[t + 0]], b = remap[indices[t + 1]], c = remap[indices[t + 2]];
+                    if (a == b || b == c || a == c)
+                        continue;
+                    indices[index_count++] = a;
+                    indices[index_count++] = b;
+                    indices[index_count++] = c;
+                }
+
+                uint32_t dropped     = (submesh.index_count - index_count) / 3;
+                submesh.index_count  = index_count;
+                submesh.vertex_count = kept;
+
+                // The merged vertices may have been the extremes
+                ComputeBounds(&import_result.vertices.Position[submesh.base_vertex], kept, submesh.min_extents, submesh.max_extents);
+                return dropped;
+            }
+
+            void MeshProcessor::optimizeSubMesh(MeshImportResult& import_result, SubMesh& submesh, const MeshProcessingOptions& options)
+            {
+                uint32_t*    indices      = &import_result.indices[submesh.base_index];
+                size_t       index_count  = submesh.index_count;
+                size_t       vertex_count = submesh.vertex_count;
+                const float* positions    = &import_result.vertices.Position[submesh.base_vertex].x;
+
+                if (options.optimizeVertexCache)
+                    meshopt_optimizeVertexCache(indices, indices, index_count, vertex_count);
+
+                if (options.optimizeOverdraw)
+                    meshopt_optimizeOverdraw(indices, indices, index_count, positions, vertex_count, sizeof(glm::vec3), options.overdrawThreshold);
+
+                if (options.optimizeVertexFetch) {
+                    std::vector<uint32_t> remap(vertex_count);
+                    size_t                unique_vertex_count = meshopt_optimizeVertexFetchRemap(remap.data(), indices, index_count, vertex_count);
+
+                    meshopt_remapIndexBuffer(indices, indices, index_count, remap.data());
+
+                    // Same remap for all the attribute and skinning streams, they stay in sync as SoA
+                    ForEachVertexStream(import_result, [&](auto& stream) {
+                        if (stream.size() < submesh.base_vertex + vertex_count)
+                            return;
+                        meshopt_remapVertexBuffer(&stream[submesh.base_vertex], &stream[submesh.base_vertex], vertex_count, sizeof(stream[0]), remap.data());
+                    });
+
+                    submesh.vertex_count = static_cast<uint32_t>(unique_vertex_count);
+                }
+            }
+
+            void MeshProcessor::compactVertices(MeshImportResult& import_result)
+            {
+                // Submeshes are laid out in order in the vertex buffer, so moving them down never overwrites the next one
+                uint32_t total_vertex_count = 0;
+                for (auto& submesh: import_result.submeshes) {
+                    if (submesh.base_vertex != total_vertex_count) {
+                        ForEachVertexStream(import_result, [&](auto& stream) {
+                            if (stream.size() < submesh.base_vertex + submesh.vertex_count)
+                                return;
+                            std::copy(stream.begin() + submesh.base_vertex, stream.begin() + submesh.base_vertex + submesh.vertex_count, stream.begin() + total_vertex_count);
+                        });
+                        submesh.base_vertex = total_vertex_count;
+                    }
+                    total_vertex_count += submesh.vertex_count;
+                }
+
+                ForEachVertexStream(import_result, [&](auto& stream) {
+                    if (stream.size() > total_vertex_count)
+                        stream.resize(total_vertex_count);
+                });
+            }
+
+            void MeshProcessor::compactIndices(MeshImportResult& import_result)
+            {
+                // Same as the vertices, submeshes are laid out in order in the index buffer
+                uint32_t total_index_count = 0;
+                for (auto& submesh: import_result.submeshes) {
+                    if (submesh.base_index != total_index_count) {
+                        auto first = import_result.indices.begin() + submesh.base_index;
+                        std::copy(first, first + submesh.index_count, import_result.indices.begin() + total_index_count);
+                        submesh.base_index = total_index_count;
+                    }
+                    total_index_count += submesh.index_count;
+                }
+
+                import_result.indices.resize(total_index_count);
+            }
+
+            void MeshProcessor::analyzeSubMesh(const MeshImportResult& import_result, const SubMesh& submesh, SubMeshStatistics& stats)
+            {
+                const uint32_t* indices   = &import_result.indices[submesh.base_index];
+                const float*    positions = &import_result.vertices.Position[submesh.base_vertex].x;
+
+                meshopt_VertexCacheStatistics vcache   = meshopt_analyzeVertexCache(indices, submesh.index_count, submesh.vertex_count, kAnalyzerCacheSize, 0, 0);
+                meshopt_OverdrawStatistics    overdraw = meshopt_analyzeOverdraw(indices, submesh.index_count, positions, submesh.vertex_count, sizeof(glm::vec3));
+                meshopt_VertexFetchStatistics vfetch   = meshopt_analyzeVertexFetch(indices, submesh.index_count, submesh.vertex_count, sizeof(glm::vec3));
+
+                stats.trianglesCount      = submesh.index_count / 3;
+                stats.verticesCount       = submesh.vertex_count;
+                stats.verticesTransformed = vcache.vertices_transformed;
+                stats.pixelsCovered       = overdraw.pixels_covered;
+                stats.pixelsShaded        = overdraw.pixels_shaded;
+                stats.bytesFetched        = vfetch.bytes_fetched;
+            }
+
+            void MeshProcessor::printStatistics(const MeshImportResult& import_result, const std::vector<SubMeshStatistics>& before, const std::vector<SubMeshStatistics>& after)
+            {
+                // Sum up the raw counters so the ratios are weighted by the size of every submesh
+                struct Totals
+                {
+                    double triangles = 0, vertices = 0, transformed = 0, covered = 0, shaded = 0, fetched = 0;
+                };
+                auto accumulate = [](const std::vector<SubMeshStatistics>& stats) {
+                    Totals totals;
+                    for (const auto& s: stats) {
+                        totals.triangles += s.trianglesCount;
+                        totals.vertices += s.verticesCount;
+                        totals.transformed += s.verticesTransformed;
+                        totals.covered += s.pixelsCovered;
+                        totals.shaded += s.pixelsShaded;
+                        totals.fetched += s.bytesFetched;
+                    }
+                    return totals;
+                };
+                auto ratio = [](double a, double b) { return b > 0.0 ? a / b : 0.0; };
+
+                Totals b = accumulate(before);
+                Totals a = accumulate(after);
+
+                // A single log line, the block isn't interleaved with the other models
+                RAZIX_PACKER_LOG_INFO("Mesh Optimization Stats : " << import_result.name << " (" << import_result.submeshes.size() << " submeshes)\n"
+                                      << "  ACMR      : " << ratio(b.transformed, b.triangles) << " -> " << ratio(a.transformed, a.triangles) << "\n"
+                                      << "  ATVR      : " << ratio(b.transformed, b.vertices) << " -> " << ratio(a.transformed, a.vertices) << "\n"
+                                      << "  Overdraw  : " << ratio(b.shaded, b.covered) << " -> " << ratio(a.shaded, a.covered) << "\n"
+                                      << "  Overfetch : " << ratio(b.fetched, b.vertices * sizeof(glm::vec3)) << " -> " << ratio(a.fetched, a.vertices * sizeof(glm::vec3)) << "\n"
+                                      << "  Vertices  : " << b.vertices << " -> " << a.vertices);
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "common/intermediate_types.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            class JobSystem;
+
+            struct MeshProcessingOptions
+            {
+                bool  weldVertices        = false;   /* Merge the vertices within weldDistance that match their other attributes, see weldSubMesh  */
+                float weldDistance        = 0.05f;   /* Model units, the pipeline sets it to MeshImportOptions::mergeDistance                       */
+                float weldNormalAngle     = 5.0f;    /* Degrees, normals further apart are a hard edge and are never welded                         */
+                float weldUVDistance      = 0.0005f; /* Per component, UVs further apart are a UV seam and are never welded                         */
+                bool  optimizeVertexCache = true;    /* Reorder triangles for the post-transform vertex cache                                       */
+                bool  optimizeOverdraw    = true;    /* Reorder triangle clusters to reduce overdraw                                                 */
+                float overdrawThreshold   = 1.05f;   /* How much the ACMR can degrade to reduce overdraw, 1.0 keeps the vertex cache order           */
+                bool  optimizeVertexFetch = true;    /* Reorder vertices in the order they are used, also removes the unused vertices                */
+                bool  printStatistics     = true;    /* Analyze the submeshes before and after and print the ACMR/ATVR/overdraw/overfetch stats     */
+            };
+
+            /**
+             * Mesh processing stage that runs between import and export, it optimizes every submesh of the import result in-place
+             * Indices are relative to the submesh (base_vertex), so every submesh is processed independently and in parallel
+             */
+            class MeshProcessor
+            {
+            public:
+                MeshProcessor()  = default;
+                ~MeshProcessor() = default;
+
+                bool processMesh(MeshImportResult& import_result, const MeshProcessingOptions& options, JobSystem* jobSystem = nullptr);
+
+            private:
+                struct SubMeshStatistics
+                {
+                    uint32_t trianglesCount      = 0;
+                    uint32_t verticesCount       = 0;
+                    uint32_t verticesTransformed = 0;
+                    uint32_t pixelsCovered       = 0;
+                    uint32_t pixelsShaded        = 0;
+                    uint32_t bytesFetched        = 0;
+                };
+
+            private:
+                /**
+                 * Spatial hash welding, every vertex is merged into the first vertex within weldDistance of it that has the same
+                 * normal, UV, color and skinning within the tolerances, so hard edges and UV seams are kept. A submesh has a single
+                 * material, so material seams are never crossed. Triangles that collapse are dropped. Returns the dropped triangles
+                 */
+                uint32_t weldSubMesh(MeshImportResult& import_result, SubMesh& submesh, const MeshProcessingOptions& options);
+                void     optimizeSubMesh(MeshImportResult& import_result, SubMesh& submesh, const MeshProcessingOptions& options);
+                void     compactVertices(MeshImportResult& import_result);
+                /* Welding drops triangles, close the gaps it leaves in the index buffer */
+                void compactIndices(MeshImportResult& import_result);
+                void analyzeSubMesh(const MeshImportResult& import_result, const SubMesh& submesh, SubMeshStatistics& stats);
+                void printStatistics(const MeshImportResult& import_result, const std::vector<SubMeshStatistics>& before, const std::vector<SubMeshStatistics>& after);
+            };
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
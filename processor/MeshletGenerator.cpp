@@ -0,0 +1,123 @@
+#include "MeshletGenerator.h"
+
+#include <chrono>
+
+#include <meshoptimizer.h>
+
+#include "common/job_system.h"
+#include "common/log.h"
+#include "common/profiler.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            // Limits of the meshoptimizer clusterizer
+            static constexpr uint32_t kMaxMeshletVertices  = 255;
+            static constexpr uint32_t kMaxMeshletTriangles = 512;
+
+            bool MeshletGenerator::generateMeshlets(MeshImportResult& import_result, const MeshletGenerationOptions& options, JobSystem* jobSystem)
+            {
+                import_result.meshlets.clear();
+                import_result.meshlet_vertices.clear();
+                import_result.meshlet_triangles.clear();
+
+                if (options.maxVertices < 3 || options.maxVertices > kMaxMeshletVertices || options.maxTriangles == 0 || options.maxTriangles > kMaxMeshletTriangles || options.maxTriangles % 4 != 0) {
+                    RAZIX_PACKER_LOG_ERROR("Invalid meshlet limits : " << options.maxVertices << " vertices, " << options.maxTriangles << " triangles (at most 255 vertices and 512 triangles, triangles must be a multiple of 4)");
+                    return false;
+                }
+
+                auto start = std::chrono::high_resolution_clock::now();
+
+                uint32_t                     submeshesCount = static_cast<uint32_t>(import_result.submeshes.size());
+                std::vector<SubMeshMeshlets> submeshMeshlets(submeshesCount);
+
+                auto generateJob = [&](uint32_t i) {
+                    RAZIX_PACKER_PROFILE_ZONE("Generate Submesh Meshlets");
+                    generateSubMeshMeshlets(import_result, import_result.submeshes[i], options, submeshMeshlets[i]);
+                };
+
+                if (jobSystem)
+                    jobSystem->parallelFor(submeshesCount, generateJob);
+                else {
+                    for (uint32_t i = 0; i < submeshesCount; i++)
+                        generateJob(i);
+                }
+
+                // Concatenate in submesh order, the offsets become global
+                uint64_t meshletTriangles = 0, meshletVertices = 0;
+                for (uint32_t i = 0; i < submeshesCount; i++) {
+                    auto& submesh          = import_result.submeshes[i];
+                    auto& generated        = submeshMeshlets[i];
+                    submesh.meshlet_offset = static_cast<uint32_t>(import_result.meshlets.size());
+                    submesh.meshlet_count  = static_cast<uint32_t>(generated.meshlets.size());
+
+                    uint32_t vertexOffset   = static_cast<uint32_t>(import_result.meshlet_vertices.size());
+                    uint32_t triangleOffset = static_cast<uint32_t>(import_result.meshlet_triangles.size());
+                    for (auto& meshlet: generated.meshlets) {
+                        meshlet.vertex_offset += vertexOffset;
+                        meshlet.triangle_offset += triangleOffset;
+                        meshletVertices += meshlet.vertex_count;
+                        meshletTriangles += meshlet.triangle_count;
+                        import_result.meshlets.push_back(meshlet);
+                    }
+                    import_result.meshlet_vertices.insert(import_result.meshlet_vertices.end(), generated.vertices.begin(), generated.vertices.end());
+                    import_result.meshlet_triangles.insert(import_result.meshlet_triangles.end(), generated.triangles.begin(), generated.triangles.end());
+                }
+
+                auto                          finish = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> time   = finish - start;
+
+                size_t meshletsCount = import_result.meshlets.size();
+                if (meshletsCount > 0) {
+                    RAZIX_PACKER_LOG_INFO("Generated " << meshletsCount << " meshlets (" << options.maxVertices << "v/" << options.maxTriangles << "t), avg " << double(meshletVertices) / meshletsCount << " vertices and " << double(meshletTriangles) / meshletsCount << " triangles per meshlet in " << time.count() << " seconds");
+                }
+                return true;
+            }
+
+            void MeshletGenerator::generateSubMeshMeshlets(const MeshImportResult& import_result, const SubMesh& submesh, const MeshletGenerationOptions& options, SubMeshMeshlets& result)
+            {
+                if (submesh.index_count == 0 || submesh.vertex_count == 0)
+                    return;
+
+                const uint32_t* indices      = &import_result.indices[submesh.base_index];
+                const float*    positions    = &import_result.vertices.Position[submesh.base_vertex].x;
+                size_t          vertex_count = submesh.vertex_count;
+
+                size_t                       maxMeshlets = meshopt_buildMeshletsBound(submesh.index_count, options.maxVertices, options.maxTriangles);
+                std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
+                result.vertices.resize(maxMeshlets * options.maxVertices);
+                result.triangles.resize(maxMeshlets * options.maxTriangles * 3);
+
+                size_t meshletsCount = meshopt_buildMeshlets(meshlets.data(), result.vertices.data(), result.triangles.data(), indices, submesh.index_count, positions, vertex_count, sizeof(glm::vec3), options.maxVertices, options.maxTriangles, options.coneWeight);
+                if (meshletsCount == 0) {
+                    result.vertices.clear();
+                    result.triangles.clear();
+                    return;
+                }
+
+                // Trim the worst case allocations, the triangles of every meshlet are padded to 4 bytes
+                const meshopt_Meshlet& last = meshlets[meshletsCount - 1];
+                result.vertices.resize(last.vertex_offset + last.vertex_count);
+                result.triangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3u));
+
+                result.meshlets.resize(meshletsCount);
+                for (size_t i = 0; i < meshletsCount; i++) {
+                    const meshopt_Meshlet& m      = meshlets[i];
+                    meshopt_Bounds         bounds = meshopt_computeMeshletBounds(&result.vertices[m.vertex_offset], &result.triangles[m.triangle_offset], m.triangle_count, positions, vertex_count, sizeof(glm::vec3));
+
+                    Meshlet& meshlet        = result.meshlets[i];
+                    meshlet.vertex_offset   = m.vertex_offset;
+                    meshlet.triangle_offset = m.triangle_offset;
+                    meshlet.vertex_count    = m.vertex_count;
+                    meshlet.triangle_count  = m.triangle_count;
+                    meshlet.center          = glm::vec3(bounds.center[0], bounds.center[1], bounds.center[2]);
+                    meshlet.radius          = bounds.radius;
+                    meshlet.cone_apex       = glm::vec3(bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]);
+                    meshlet.cone_axis       = glm::vec3(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]);
+                    meshlet.cone_cutoff     = bounds.cone_cutoff;
+                }
+            }
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
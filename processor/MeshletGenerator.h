@@ -0,0 +1,42 @@
+#pragma once
+
+#include "common/intermediate_types.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            class JobSystem;
+
+            struct MeshletGenerationOptions
+            {
+                uint32_t maxVertices  = 64;    /* Maximum vertices per meshlet, at most 255                                                 */
+                uint32_t maxTriangles = 124;   /* Maximum triangles per meshlet, at most 512 and a multiple of 4                            */
+                float    coneWeight   = 0.25f; /* [0, 1] trades cluster compactness for tighter normal cones, 0 when cone culling is unused */
+            };
+
+            /**
+             * Splits LOD 0 of every submesh into meshlets with the meshoptimizer clusterizer and computes their culling bounds
+             * Run it after the MeshProcessor, the meshlet vertices reference the final vertex order of the submesh
+             */
+            class MeshletGenerator
+            {
+            public:
+                MeshletGenerator()  = default;
+                ~MeshletGenerator() = default;
+
+                bool generateMeshlets(MeshImportResult& import_result, const MeshletGenerationOptions& options, JobSystem* jobSystem = nullptr);
+
+            private:
+                struct SubMeshMeshlets
+                {
+                    std::vector<Meshlet>  meshlets;
+                    std::vector<uint32_t> vertices;
+                    std::vector<uint8_t>  triangles;
+                };
+
+                void generateSubMeshMeshlets(const MeshImportResult& import_result, const SubMesh& submesh, const MeshletGenerationOptions& options, SubMeshMeshlets& result);
+            };
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,395 @@
+#include "TextureProcessor.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "common/content_hash.h"
+#include "common/dds_format.h"
+#include "common/log.h"
+#include "common/profiler.h"
+
+// The engine links it's own copy, keep the symbols of this one private
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            namespace fs = std::filesystem;
+
+            // Block rows encoded by a single job, big enough to amortize the job and small enough to balance BC7 levels
+            static constexpr uint32_t kBlockRowsPerJob = 8;
+
+            struct TextureLevel
+            {
+                uint32_t             width  = 0;
+                uint32_t             height = 0;
+                std::vector<uint8_t> rgba;
+                std::vector<uint8_t> blocks;
+            };
+
+            static float SRGBToLinear(float value)
+            {
+                return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+            }
+
+            static float LinearToSRGB(float value)
+            {
+                return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+            }
+
+            static uint8_t ToUNorm8(float value)
+            {
+                return static_cast<uint8_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+            }
+
+            // 2x2 box filter, odd sides clamp the last texel. sRGB colors are averaged in linear space and normals renormalized
+            static void DownsampleLevel(const TextureLevel& src, TextureLevel& dst, TextureRole role)
+            {
+                dst.width  = std::max(1u, src.width / 2);
+                dst.height = std::max(1u, src.height / 2);
+                dst.rgba.resize(size_t(dst.width) * dst.height * 4);
+
+                static const std::array<float, 256> srgbToLinear = [] {
+                    std::array<float, 256> table;
+                    for (uint32_t i = 0; i < 256; i++)
+                        table[i] = SRGBToLinear(i / 255.0f);
+                    return table;
+                }();
+
+                bool srgb = role == TextureRole::Albedo || role == TextureRole::Emissive;
+
+                for (uint32_t y = 0; y < dst.height; y++) {
+                    uint32_t y0 = std::min(y * 2, src.height - 1);
+                    uint32_t y1 = std::min(y * 2 + 1, src.height - 1);
+                    for (uint32_t x = 0; x < dst.width; x++) {
+                        uint32_t       x0        = std::min(x * 2, src.width - 1);
+                        uint32_t       x1        = std::min(x * 2 + 1, src.width - 1);
+                        const uint8_t* texels[4] = {
+                            &src.rgba[(size_t(y0) * src.width + x0) * 4],
+                            &src.rgba[(size_t(y0) * src.width + x1) * 4],
+                            &src.rgba[(size_t(y1) * src.width + x0) * 4],
+                            &src.rgba[(size_t(y1) * src.width + x1) * 4]};
+                        uint8_t* out = &dst.rgba[(size_t(y) * dst.width + x) * 4];
+
+                        float sum[4] = {};
+                        for (uint32_t t = 0; t < 4; t++) {
+                            for (uint32_t c = 0; c < 4; c++) {
+                                if (role == TextureRole::Normal && c < 3)
+                                    sum[c] += texels[t][c] / 255.0f * 2.0f - 1.0f;
+                                else if (srgb && c < 3)
+                                    sum[c] += srgbToLinear[texels[t][c]];
+                                else
+                                    sum[c] += texels[t][c] / 255.0f;
+                            }
+                        }
+
+                        if (role == TextureRole::Normal) {
+                            float length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+                            if (length < 1e-6f) {
+                                sum[0] = sum[1] = 0.0f;
+                                sum[2] = length = 1.0f;
+                            }
+                            for (uint32_t c = 0; c < 3; c++)
+                                out[c] = ToUNorm8(sum[c] / length * 0.5f + 0.5f);
+                            out[3] = ToUNorm8(sum[3] * 0.25f);
+                        } else {
+                            for (uint32_t c = 0; c < 4; c++) {
+                                float value = sum[c] * 0.25f;
+                                out[c]      = ToUNorm8(srgb && c < 3 ? LinearToSRGB(value) : value);
+                            }
+                        }
+                    }
+                }
+            }
+
+            static uint32_t GetDXGIFormat(BlockFormat format, bool srgb)
+            {
+                switch (format) {
+                    case BlockFormat::BC1: return srgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+                    case BlockFormat::BC3: return srgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+                    case BlockFormat::BC5: return DXGI_FORMAT_BC5_UNORM;
+                    case BlockFormat::BC7: return srgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+                }
+                return 0;
+            }
+
+            static const char* GetRoleName(TextureRole role)
+            {
+                switch (role) {
+                    case TextureRole::Albedo: return "albedo";
+                    case TextureRole::Normal: return "normal";
+                    case TextureRole::MetallicRoughnessAO: return "mrao";
+                    case TextureRole::Mask: return "mask";
+                    case TextureRole::Emissive: return "emissive";
+                }
+                return "texture";
+            }
+
+            static bool IsGPUTextureFile(const std::string& extension)
+            {
+                return extension == ".dds" || extension == ".ktx" || extension == ".ktx2" || extension == ".basis";
+            }
+
+            TextureProcessor::TextureProcessor(JobSystem& jobSystem)
+                : m_JobSystem(jobSystem)
+            {
+            }
+
+            TextureProcessor::~TextureProcessor()
+            {
+                // Jobs reference the processor
+                m_JobSystem.wait(m_Counter);
+            }
+
+            BlockFormat TextureProcessor::SelectBlockFormat(TextureRole role, const TextureProcessingOptions& options, bool hasAlpha, bool& srgb)
+            {
+                srgb = role == TextureRole::Albedo || role == TextureRole::Emissive;
+                switch (role) {
+                    case TextureRole::Albedo:
+                        if (options.highQuality)
+                            return BlockFormat::BC7;
+                        return hasAlpha ? BlockFormat::BC3 : BlockFormat::BC1;
+                    case TextureRole::Normal: return BlockFormat::BC5;
+                    case TextureRole::MetallicRoughnessAO:
+                    case TextureRole::Emissive: return options.highQuality ? BlockFormat::BC7 : BlockFormat::BC1;
+                    case TextureRole::Mask: return BlockFormat::BC1;
+                }
+                return BlockFormat::BC7;
+            }
+
+            void TextureProcessor::processMaterials(std::vector<Graphics::MaterialData>& materials, const TextureProcessingOptions& options, const std::string& outputDirectory, bool forceRebuild, std::vector<std::string>& outputFiles)
+            {
+                RAZIX_PACKER_PROFILE_ZONE("Schedule Textures");
+
+                std::error_code ec;
+                fs::create_directories(outputDirectory, ec);
+
+                for (auto& material: materials) {
+                    auto& paths = material.m_MaterialTexturePaths;
+
+                    struct TextureSlot
+                    {
+                        char*       path;
+                        TextureRole role;
+                    };
+                    TextureSlot slots[] = {
+                        {paths.albedo, TextureRole::Albedo},
+                        {paths.normal, TextureRole::Normal},
+                        {paths.metallic, TextureRole::Mask},
+                        {paths.roughness, TextureRole::Mask},
+                        {paths.specular, TextureRole::Mask},
+                        {paths.emissive, TextureRole::Emissive},
+                        {paths.ao, TextureRole::Mask},
+                        {paths.metallicRoughnessAO, TextureRole::MetallicRoughnessAO}};
+
+                    for (auto& slot: slots) {
+                        if (slot.path[0] == '\0')
+                            continue;
+
+                        std::string outputPath = requestTexture(slot.path, slot.role, options, outputDirectory, forceRebuild);
+                        if (outputPath != slot.path && std::find(outputFiles.begin(), outputFiles.end(), outputPath) == outputFiles.end())
+                            outputFiles.push_back(outputPath);
+                        if (outputPath.size() >= 250) {
+                            RAZIX_PACKER_LOG_WARNING("Processed texture path is too long for the material, keeping the source : " << slot.path);
+                            continue;
+                        }
+                        strcpy_s(slot.path, 250 * sizeof(char), outputPath.c_str());
+                    }
+                }
+            }
+
+            bool TextureProcessor::wait(std::vector<std::string>& failedOutputs)
+            {
+                m_JobSystem.wait(m_Counter);
+
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Requested.clear();
+                failedOutputs.swap(m_FailedOutputs);
+                m_FailedOutputs.clear();
+                return m_Success.exchange(true);
+            }
+
+            std::string TextureProcessor::requestTexture(const std::string& sourcePath, TextureRole role, const TextureProcessingOptions& options, const std::string& outputDirectory, bool forceRebuild)
+            {
+                fs::path    path      = fs::path(sourcePath).lexically_normal();
+                std::string extension = path.extension().string();
+                std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+                // Embedded textures can't be read from disk and GPU formats are already what the engine wants
+                std::error_code ec;
+                if (IsGPUTextureFile(extension) || !fs::is_regular_file(path, ec))
+                    return sourcePath;
+
+                // The options are part of the name, so changing them never picks up a stale .dds
+                std::string source = path.generic_string();
+                uint64_t    key    = HashString(source);
+                key                = HashCombine(key, static_cast<uint64_t>(role));
+                key                = HashCombine(key, (uint64_t(options.generateMips) << 1) | uint64_t(options.highQuality));
+                key                = HashCombine(key, options.maxSize);
+
+                char hash[17];
+                snprintf(hash, sizeof(hash), "%016" PRIx64, key);
+                std::string outputPath = outputDirectory + path.stem().string() + "_" + GetRoleName(role) + "_" + std::string(hash, 8) + ".dds";
+
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                    if (!m_Requested.emplace(hash, outputPath).second) {
+                        m_Stats.shared++;
+                        return outputPath;
+                    }
+                }
+
+                if (!forceRebuild) {
+                    auto outputTime = fs::last_write_time(outputPath, ec);
+                    if (!ec) {
+                        auto sourceTime = fs::last_write_time(path, ec);
+                        if (!ec && outputTime >= sourceTime) {
+                            m_Stats.upToDate++;
+                            return outputPath;
+                        }
+                    }
+                }
+
+                m_JobSystem.submit(
+                    [this, source, outputPath, role, options]() {
+                        if (!processTexture(source, outputPath, role, options)) {
+                            m_Stats.failed++;
+                            m_Success = false;
+
+                            std::lock_guard<std::mutex> lock(m_Mutex);
+                            m_FailedOutputs.push_back(outputPath);
+                        }
+                    },
+                    &m_Counter);
+
+                return outputPath;
+            }
+
+            bool TextureProcessor::processTexture(const std::string& sourcePath, const std::string& outputPath, TextureRole role, const TextureProcessingOptions& options)
+            {
+                RAZIX_PACKER_PROFILE_ZONE("Process Texture", sourcePath.c_str());
+
+                auto start = std::chrono::high_resolution_clock::now();
+
+                int      width = 0, height = 0, channels = 0;
+                stbi_uc* pixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, 4);
+                if (!pixels) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to decode texture : " << sourcePath << " (" << stbi_failure_reason() << ")");
+                    return false;
+                }
+
+                std::vector<TextureLevel> levels(1);
+                levels[0].width  = static_cast<uint32_t>(width);
+                levels[0].height = static_cast<uint32_t>(height);
+                levels[0].rgba.assign(pixels, pixels + size_t(width) * height * 4);
+                stbi_image_free(pixels);
+
+                bool hasAlpha = false;
+                for (size_t i = 3; i < levels[0].rgba.size() && !hasAlpha; i += 4)
+                    hasAlpha = levels[0].rgba[i] != 255;
+
+                // Levels above maxSize are only built to filter the ones below
+                while (options.maxSize && (levels[0].width > options.maxSize || levels[0].height > options.maxSize) && (levels[0].width > 1 || levels[0].height > 1)) {
+                    TextureLevel smaller;
+                    DownsampleLevel(levels[0], smaller, role);
+                    levels[0] = std::move(smaller);
+                }
+
+                while (options.generateMips && (levels.back().width > 1 || levels.back().height > 1)) {
+                    TextureLevel next;
+                    DownsampleLevel(levels.back(), next, role);
+                    levels.push_back(std::move(next));
+                }
+
+                bool        srgb   = false;
+                BlockFormat format = SelectBlockFormat(role, options, hasAlpha, srgb);
+
+                // Every level is split in groups of block rows, all of them are encoded in one go
+                struct EncodeRange
+                {
+                    uint32_t level;
+                    uint32_t firstRow;
+                    uint32_t rowsCount;
+                };
+                std::vector<EncodeRange> ranges;
+                for (uint32_t l = 0; l < levels.size(); l++) {
+                    auto& level = levels[l];
+                    level.blocks.resize(GetCompressedSize(format, level.width, level.height));
+
+                    uint32_t blockRows = (level.height + 3) / 4;
+                    for (uint32_t row = 0; row < blockRows; row += kBlockRowsPerJob)
+                        ranges.push_back({l, row, std::min(kBlockRowsPerJob, blockRows - row)});
+                }
+
+                m_JobSystem.parallelFor(static_cast<uint32_t>(ranges.size()), [&](uint32_t i) {
+                    const auto& range = ranges[i];
+                    auto&       level = levels[range.level];
+                    CompressBlockRows(format, level.rgba.data(), level.width, level.height, range.firstRow, range.rowsCount, level.blocks.data());
+                });
+
+                DDSHeader header{};
+                header.flags              = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+                header.height             = levels[0].height;
+                header.width              = levels[0].width;
+                header.pitchOrLinearSize  = static_cast<uint32_t>(levels[0].blocks.size());
+                header.mipMapCount        = static_cast<uint32_t>(levels.size());
+                header.pixelFormat.flags  = DDPF_FOURCC;
+                header.pixelFormat.fourCC = DDS_FOURCC_DX10;
+                header.caps               = DDSCAPS_TEXTURE | (levels.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+                DDSHeaderDX10 headerDX10{};
+                headerDX10.dxgiFormat        = GetDXGIFormat(format, srgb);
+                headerDX10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+                headerDX10.arraySize         = 1;
+
+                // Renamed once complete, the .dds from the last build stays valid until then
+                std::string   tempPath = outputPath + ".tmp";
+                std::ofstream file(tempPath, std::ios::out | std::ios::binary);
+                if (!file.is_open()) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to write texture : " << outputPath);
+                    return false;
+                }
+
+                uint32_t magic = DDS_MAGIC;
+                file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+                file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                file.write(reinterpret_cast<const char*>(&headerDX10), sizeof(headerDX10));
+
+                uint64_t bytesWritten = sizeof(magic) + sizeof(header) + sizeof(headerDX10);
+                for (const auto& level: levels) {
+                    file.write(reinterpret_cast<const char*>(level.blocks.data()), level.blocks.size());
+                    bytesWritten += level.blocks.size();
+                }
+
+                file.close();
+                std::error_code ec;
+                if (file.good())
+                    fs::rename(tempPath, outputPath, ec);
+                if (!file.good() || ec) {
+                    RAZIX_PACKER_LOG_ERROR("Failed to write texture : " << outputPath);
+                    fs::remove(tempPath, ec);
+                    return false;
+                }
+
+                auto finish = std::chrono::high_resolution_clock::now();
+                m_Stats.processTimeNs += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+                m_Stats.bytesWritten += bytesWritten;
+                m_Stats.processed++;
+
+                RAZIX_PACKER_LOG_VERBOSE("Processed Texture... : " << sourcePath << " -> " << fs::path(outputPath).filename().string() << " (" << levels[0].width << "x" << levels[0].height << ", " << levels.size() << " mips)");
+                return true;
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/intermediate_types.h"
+#include "common/job_system.h"
+#include "common/texture_compression.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /* What a texture is used for, decides the block format, the color space and how the mips are filtered */
+            enum class TextureRole
+            {
+                Albedo,              /* sRGB, BC7 or BC1/BC3 depending on alpha        */
+                Normal,              /* Tangent space XY in BC5, mips are renormalized */
+                MetallicRoughnessAO, /* Linear packed channels, BC7 or BC1             */
+                Mask,                /* Single linear channel (metallic, roughness...) */
+                Emissive             /* sRGB, BC7 or BC1                               */
+            };
+
+            struct TextureProcessingOptions
+            {
+                bool     generateMips = true; /* Full mip chain down to 1x1                                                        */
+                bool     highQuality  = true; /* BC7 for albedo, emissive and packed maps, BC1/BC3 (faster to encode) when false */
+                uint32_t maxSize      = 0;    /* The top mips are dropped until both sides fit, 0 keeps the source size          */
+            };
+
+            struct TextureProcessorStats
+            {
+                std::atomic<uint64_t> processTimeNs = 0; /* Decode, mips and encode, summed across the threads            */
+                std::atomic<uint64_t> bytesWritten  = 0;
+                std::atomic<uint32_t> processed     = 0;
+                std::atomic<uint32_t> upToDate      = 0; /* The .dds was newer than the source                           */
+                std::atomic<uint32_t> shared        = 0; /* Referenced again by another material, processed only once    */
+                std::atomic<uint32_t> failed        = 0;
+            };
+
+            /**
+             * Turns the source images referenced by the materials into GPU ready .dds files on the job system
+             *
+             * Every texture is decoded, it's mip chain generated (in linear space for sRGB roles, renormalized for normal maps) and
+             * block compressed according to it's role, the block rows of every level are encoded in parallel. The materials paths
+             * are rewritten to the .dds files right away, the textures finish in the background until wait(). A .dds is written to a
+             * temporary file and renamed once complete, so a failed or interrupted texture never replaces a valid one. A texture is processed
+             * once per source, role and options however many materials and models reference it. Embedded textures ("*0") and files
+             * that already are GPU formats keep their original path.
+             */
+            class TextureProcessor
+            {
+            public:
+                explicit TextureProcessor(JobSystem& jobSystem);
+                ~TextureProcessor();
+
+                /**
+                 * outputDirectory is where the .dds files go, forceRebuild processes textures even if their .dds is up to date
+                 * outputFiles receives every .dds the materials now reference, including the ones that are shared or up to date
+                 */
+                void processMaterials(std::vector<Graphics::MaterialData>& materials, const TextureProcessingOptions& options, const std::string& outputDirectory, bool forceRebuild, std::vector<std::string>& outputFiles);
+                /**
+                 * Waits for every scheduled texture, returns false if any of them failed and fills failedOutputs with their .dds paths
+                 * Textures scheduled after wait are processed again
+                 */
+                bool wait(std::vector<std::string>& failedOutputs);
+
+                const TextureProcessorStats& getStats() const { return m_Stats; }
+
+                static BlockFormat SelectBlockFormat(TextureRole role, const TextureProcessingOptions& options, bool hasAlpha, bool& srgb);
+
+            private:
+                /* Returns the path the material should reference, schedules the texture the first time it's requested */
+                std::string requestTexture(const std::string& sourcePath, TextureRole role, const TextureProcessingOptions& options, const std::string& outputDirectory, bool forceRebuild);
+                bool        processTexture(const std::string& sourcePath, const std::string& outputPath, TextureRole role, const TextureProcessingOptions& options);
+
+            private:
+                JobSystem&                                   m_JobSystem;
+                JobCounter                                   m_Counter;
+                std::mutex                                   m_Mutex;
+                std::unordered_map<std::string, std::string> m_Requested; /* Source, role and options key -> output path */
+                std::vector<std::string>                     m_FailedOutputs;
+                std::atomic<bool>                            m_Success = true;
+                TextureProcessorStats                        m_Stats;
+            };
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
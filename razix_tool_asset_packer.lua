@@ -15,12 +15,20 @@ project "RazixAssetPacker"
          "./common",
          "./importer",
          "./exporter",
+         "./loader",
+         "./pipeline",
+         "./processor",
          "./vendor/assimp/include",
+         "./vendor/meshoptimizer/src",
+         "./vendor/OpenFBX",
+         "./vendor/assimp/contrib/rapidjson/include",
          -- Razix
          "%{IncludeDir.Razix}",
          -- GLM
         "%{IncludeDir.glm}",
-        "%{IncludeDir.cereal}"
+        "%{IncludeDir.cereal}",
+        -- stb_image, decodes the material textures
+        "%{IncludeDir.stb}"
     }
 
     files
@@ -33,7 +41,13 @@ project "RazixAssetPacker"
         "./importer/**.cpp",
         "./exporter/**.h",
         "./exporter/**.c",
-        "./exporter/**.cpp"
+        "./exporter/**.cpp",
+        "./loader/**.h",
+        "./loader/**.cpp",
+        "./pipeline/**.h",
+        "./pipeline/**.cpp",
+        "./processor/**.h",
+        "./processor/**.cpp"
     }
 
     removefiles
@@ -44,7 +58,8 @@ project "RazixAssetPacker"
     links
     {
         "assimp",
-        "meshoptimizer"
+        "meshoptimizer",
+        "OpenFBX"
     }
 
     filter "system:windows"
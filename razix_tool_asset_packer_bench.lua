@@ -0,0 +1,72 @@
+-- Razix Engine vendor Common Inlcudes 
+include 'Scripts/premake/common/vendor_includes.lua'
+-- Internal libraies include dirs
+include 'Scripts/premake/common/internal_includes.lua'
+
+project "RazixAssetPacker_Bench"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect (engine_global_config.cpp_dialect)
+    staticruntime "off"
+
+    includedirs
+    {
+         "./",
+         "./common",
+         "./importer",
+         "./exporter",
+         "./loader",
+         "./pipeline",
+         "./processor",
+         "./vendor/assimp/include",
+         "./vendor/meshoptimizer/src",
+         "./vendor/OpenFBX",
+         -- Razix
+         "%{IncludeDir.Razix}",
+         -- GLM
+        "%{IncludeDir.glm}",
+        "%{IncludeDir.cereal}"
+    }
+
+    files
+    {
+        "./bench/**.h",
+        "./bench/**.c",
+        "./bench/**.cpp"
+    }
+
+    links
+    {
+        "assimp",
+        "meshoptimizer",
+        "OpenFBX",
+        "RazixAssetPacker"
+    }
+
+    filter "system:linux"
+        links { "pthread" }
+
+    filter "system:windows"
+        systemversion "latest"
+        -- Reload notifications of the watch mode, see ReloadNotifier
+        links { "ws2_32" }
+        cppdialect (engine_global_config.cpp_dialect)
+        staticruntime "off"
+
+    filter "configurations:Debug"
+        defines { "RAZIX_DEBUG", "_DEBUG" }
+        symbols "On"
+        runtime "Debug"
+        optimize "Off"
+
+    filter "configurations:Release"
+        defines { "RAZIX_RELEASE", "NDEBUG" }
+        optimize "Speed"
+        symbols "On"
+        runtime "Release"
+
+    filter "configurations:Distribution"
+        defines { "RAZIX_DISTRIBUTION", "NDEBUG" }
+        symbols "Off"
+        optimize "Full"
+        runtime "Release"
@@ -15,7 +15,12 @@ project "RazixAssetPacker_CLI"
          "./common",
          "./importer",
          "./exporter",
+         "./loader",
+         "./pipeline",
+         "./processor",
          "./vendor/assimp/include",
+         "./vendor/meshoptimizer/src",
+         "./vendor/OpenFBX",
          -- Razix
          "%{IncludeDir.Razix}",
          -- GLM
@@ -33,11 +38,18 @@ project "RazixAssetPacker_CLI"
     links
     {
         "assimp",
+        "meshoptimizer",
+        "OpenFBX",
         "RazixAssetPacker"
     }
 
+    filter "system:linux"
+        links { "pthread" }
+
     filter "system:windows"
         systemversion "latest"
+        -- Reload notifications of the watch mode, see ReloadNotifier
+        links { "ws2_32" }
         cppdialect (engine_global_config.cpp_dialect)
         staticruntime "off"
 
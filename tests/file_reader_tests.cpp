@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "test_suites.h"
+
+#include "common/job_system.h"
+#include "exporter/MeshExporter.h"
+#include "loader/MeshFileReader.h"
+#include "loader/ModelFileReader.h"
+#include "loader/PackFileReader.h"
+
+namespace fs = std::filesystem;
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            struct ReaderTestVariant
+            {
+                const char* name;
+                bool        packModel;
+                bool        encode;      /* meshopt codecs, makes the .rzmesh V3      */
+                bool        compression; /* Deflate on top                            */
+                uint32_t    alignment;   /* blobAlignment of a .rzmesh or packAlignment */
+            };
+
+            static const ReaderTestVariant kVariants[] = {
+                {"rzmesh V2", false, false, false, 0},
+                {"rzmesh V3 encoded", false, true, true, 0},
+                {"rzmesh V3 aligned", false, false, false, 4096},
+                {"rzpack", true, false, false, 16},
+                {"rzpack encoded", true, true, true, 64},
+            };
+
+            // Two boxes of 24 vertices and 36 indices, one material, a node per box
+            static MeshImportResult MakeTestModel()
+            {
+                MeshImportResult model;
+                model.name = "reader_test";
+
+                const uint32_t boxes = 2;
+                model.vertices.setSize(boxes * 24);
+                model.tangent_signs.assign(boxes * 24, 1.0f);
+                for (uint32_t b = 0; b < boxes; b++) {
+                    SubMesh submesh{};
+                    submesh.base_vertex  = b * 24;
+                    submesh.base_index   = b * 36;
+                    submesh.vertex_count = 24;
+                    submesh.index_count  = 36;
+                    submesh.min_extents  = glm::vec3(float(b) * 3.0f - 1.0f, -1.0f, -1.0f);
+                    submesh.max_extents  = glm::vec3(float(b) * 3.0f + 1.0f, 1.0f, 1.0f);
+                    snprintf(submesh.name, sizeof(submesh.name), "box_%u", b);
+
+                    for (uint32_t face = 0; face < 6; face++) {
+                        glm::vec3 normal(0.0f);
+                        normal[face / 2] = face % 2 ? -1.0f : 1.0f;
+                        glm::vec3 tangent(0.0f);
+                        tangent[(face / 2 + 1) % 3] = 1.0f;
+                        glm::vec3 bitangent         = glm::cross(normal, tangent);
+
+                        for (uint32_t corner = 0; corner < 4; corner++) {
+                            uint32_t  v  = submesh.base_vertex + face * 4 + corner;
+                            glm::vec2 uv = glm::vec2(float(corner & 1), float(corner >> 1));
+
+                            model.vertices.Position[v] = glm::vec3(float(b) * 3.0f, 0.0f, 0.0f) + normal + tangent * (uv.x * 2.0f - 1.0f) + bitangent * (uv.y * 2.0f - 1.0f);
+                            model.vertices.Color[v]    = glm::vec4(uv.x, uv.y, float(face) / 6.0f, 1.0f);
+                            model.vertices.UV[v]       = uv;
+                            model.vertices.Normal[v]   = normal;
+                            model.vertices.Tangent[v]  = tangent;
+                            model.tangent_signs[v]     = face % 2 ? -1.0f : 1.0f;
+                        }
+
+                        const uint32_t quad[] = {0, 1, 3, 0, 3, 2};
+                        for (uint32_t q: quad)
+                            model.indices.push_back(face * 4 + q);
+                    }
+                    model.submeshes.push_back(submesh);
+                    model.hierarchy.addNode(submesh.name, b ? 0 : MESH_HIERARCHY_NO_PARENT, &b, 1);
+                }
+                model.min_extents = model.submeshes[0].min_extents;
+                model.max_extents = model.submeshes[1].max_extents;
+
+                Graphics::MaterialData material{};
+                strcpy(material.m_Name, "reader_test_material");
+                material.m_MaterialProperties.albedoColor = glm::vec4(1.0f);
+                model.materials.push_back(material);
+                return model;
+            }
+
+            static bool ReadFileBytes(const std::string& filePath, std::vector<uint8_t>& bytes)
+            {
+                std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+                if (!file.is_open())
+                    return false;
+                bytes.resize(static_cast<size_t>(file.tellg()));
+                file.seekg(0);
+                return bool(file.read(reinterpret_cast<char*>(bytes.data()), bytes.size()));
+            }
+
+            static bool WriteFileBytes(const std::string& filePath, const uint8_t* bytes, size_t size)
+            {
+                std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+                return file.write(reinterpret_cast<const char*>(bytes), size).good();
+            }
+
+            // Opens any kind of file with the matching reader and decodes every blob, the views must stay inside the mapping
+            static bool OpenAndDecode(const std::string& filePath, bool pack)
+            {
+                MeshFileReader meshReader;
+                PackFileReader packReader;
+                if (pack ? !packReader.open(filePath) : !meshReader.open(filePath))
+                    return false;
+
+                std::vector<uint8_t> decoded;
+                for (const auto& blob: pack ? packReader.getSections() : meshReader.getBlobs())
+                    DecodeBlobView(blob, decoded);
+                return true;
+            }
+
+            template<typename T>
+            static bool BlobEquals(const BlobView* blob, const T* expected, size_t count)
+            {
+                std::vector<uint8_t> decoded;
+                if (!blob || !DecodeBlobView(*blob, decoded) || decoded.size() != count * sizeof(T))
+                    return false;
+                return count == 0 || memcmp(decoded.data(), expected, decoded.size()) == 0;
+            }
+
+            // The meshopt index codec may rotate the vertices of a triangle, the winding and the triangle order are kept
+            static bool IndicesEqual(const BlobView* blob, const uint32_t* expected, size_t count)
+            {
+                std::vector<uint8_t> decoded;
+                if (!blob || !DecodeBlobView(*blob, decoded) || decoded.size() != count * sizeof(uint32_t) || count % 3 != 0)
+                    return false;
+
+                const uint32_t* indices = reinterpret_cast<const uint32_t*>(decoded.data());
+                for (size_t i = 0; i < count; i += 3) {
+                    bool same = false;
+                    for (uint32_t r = 0; r < 3 && !same; r++)
+                        same = indices[i] == expected[i + r] && indices[i + 1] == expected[i + (r + 1) % 3] && indices[i + 2] == expected[i + (r + 2) % 3];
+                    if (!same)
+                        return false;
+                }
+                return true;
+            }
+
+            static int CheckRoundTrip(const MeshImportResult& model, const ReaderTestVariant& variant, const std::string& filePath)
+            {
+                int failures = 0;
+                if (variant.packModel) {
+                    PackFileReader reader;
+                    RAZIX_TEST_CHECK(reader.open(filePath));
+                    if (!reader.getError().empty()) {
+                        std::cout << "  " << variant.name << " : " << reader.getError() << std::endl;
+                        return failures;
+                    }
+
+                    RAZIX_TEST_CHECK(reader.getHeader().alignment == variant.alignment);
+                    RAZIX_TEST_CHECK(reader.getHeader().submesh_count == model.submeshes.size());
+                    RAZIX_TEST_CHECK(IndicesEqual(reader.findSection("INDEX"), model.indices.data(), model.indices.size()));
+                    RAZIX_TEST_CHECK(BlobEquals(reader.findSection("POSITION"), model.vertices.Position.data(), model.vertices.Position.size()));
+                    RAZIX_TEST_CHECK(BlobEquals(reader.findSection("NORMAL"), model.vertices.Normal.data(), model.vertices.Normal.size()));
+                    RAZIX_TEST_CHECK(BlobEquals(reader.findSection("TEXCOORD"), model.vertices.UV.data(), model.vertices.UV.size()));
+                    RAZIX_TEST_CHECK(BlobEquals(reader.findSection("TANGENT"), model.vertices.Tangent.data(), model.vertices.Tangent.size()));
+
+                    for (const auto& section: reader.getSections())
+                        RAZIX_TEST_CHECK(section.offset % variant.alignment == 0);
+                    return failures;
+                }
+
+                // Every submesh is it's own .rzmesh holding only it's range of the streams
+                MeshFileReader reader;
+                RAZIX_TEST_CHECK(reader.open(filePath));
+                if (!reader.getError().empty()) {
+                    std::cout << "  " << variant.name << " : " << reader.getError() << std::endl;
+                    return failures;
+                }
+
+                const auto& header = reader.getMeshHeader();
+                RAZIX_TEST_CHECK(header.vertex_count == 24 && header.index_count == 36);
+                RAZIX_TEST_CHECK(header.mesh_count == model.submeshes.size());
+                RAZIX_TEST_CHECK(reader.isAligned() == (variant.alignment != 0));
+                RAZIX_TEST_CHECK(!reader.getBlobs().empty() && reader.getBlobs()[0].isNamed("INDEX"));
+
+                // The header keeps the offsets of the submesh in the model
+                const SubMesh* submesh = nullptr;
+                for (const auto& candidate: model.submeshes) {
+                    if (candidate.base_vertex == header.base_vertex && candidate.base_index == header.base_index)
+                        submesh = &candidate;
+                }
+                RAZIX_TEST_CHECK(submesh != nullptr);
+                if (!submesh)
+                    return failures;
+
+                RAZIX_TEST_CHECK(IndicesEqual(reader.findBlob("INDEX"), model.indices.data() + submesh->base_index, submesh->index_count));
+                RAZIX_TEST_CHECK(BlobEquals(reader.findBlob("POSITION"), model.vertices.Position.data() + submesh->base_vertex, submesh->vertex_count));
+                RAZIX_TEST_CHECK(BlobEquals(reader.findBlob("COLOR"), model.vertices.Color.data() + submesh->base_vertex, submesh->vertex_count));
+                RAZIX_TEST_CHECK(BlobEquals(reader.findBlob("NORMAL"), model.vertices.Normal.data() + submesh->base_vertex, submesh->vertex_count));
+                if (variant.alignment) {
+                    for (const auto& blob: reader.getBlobs())
+                        RAZIX_TEST_CHECK(blob.offset % variant.alignment == 0);
+                }
+                return failures;
+            }
+
+            // Every truncation has to be rejected, no header or blob can be read past the end of the mapping
+            static int CheckTruncated(const std::vector<uint8_t>& bytes, const ReaderTestVariant& variant, const std::string& scratchPath)
+            {
+                int                 failures = 0;
+                std::vector<size_t> sizes    = {0, 1, sizeof(Razix::AssetSystem::BINFileHeader) - 1, sizeof(Razix::AssetSystem::BINFileHeader), bytes.size() / 2, bytes.size() - 1};
+                for (size_t size = 0; size < bytes.size() && size < 1024; size += 7)
+                    sizes.push_back(size);
+
+                for (size_t size: sizes) {
+                    if (size >= bytes.size())
+                        continue;
+                    WriteFileBytes(scratchPath, bytes.data(), size);
+                    bool opened = OpenAndDecode(scratchPath, variant.packModel);
+                    RAZIX_TEST_CHECK(!opened);
+                    if (opened)
+                        std::cout << "  " << variant.name << " : a truncation to " << size << " of " << bytes.size() << " bytes was accepted" << std::endl;
+                }
+                return failures;
+            }
+
+            // A wrong magic is always rejected, other corruptions either fail to open or only yield views inside the mapping
+            static int CheckCorrupted(const std::vector<uint8_t>& bytes, const ReaderTestVariant& variant, const std::string& scratchPath)
+            {
+                int                  failures = 0;
+                std::vector<uint8_t> corrupted;
+
+                corrupted = bytes;
+                corrupted[0] ^= 0xFF;
+                WriteFileBytes(scratchPath, corrupted.data(), corrupted.size());
+                RAZIX_TEST_CHECK(!OpenAndDecode(scratchPath, variant.packModel));
+
+                // Every byte of the headers and the blob tables, then a deterministic scatter over the payloads
+                std::vector<size_t> offsets;
+                for (size_t offset = 0; offset < bytes.size() && offset < 1024; offset++)
+                    offsets.push_back(offset);
+                uint32_t seed = 0x9E3779B9u;
+                for (uint32_t i = 0; i < 256; i++) {
+                    seed = seed * 1664525u + 1013904223u;
+                    offsets.push_back(seed % bytes.size());
+                }
+
+                for (size_t offset: offsets) {
+                    for (uint8_t value: {uint8_t(bytes[offset] ^ 0xFF), uint8_t(0x7F)}) {
+                        corrupted         = bytes;
+                        corrupted[offset] = value;
+                        WriteFileBytes(scratchPath, corrupted.data(), corrupted.size());
+                        OpenAndDecode(scratchPath, variant.packModel);
+                    }
+                }
+                return failures;
+            }
+
+            // Submeshes sharing a name (ex. material splits) are exported in parallel, each one still needs it's own .rzmesh
+            static int CheckDuplicateSubMeshNames(const MeshImportResult& model, const std::string& directory)
+            {
+                int             failures = 0;
+                std::error_code ec;
+                fs::remove_all(directory, ec);
+                fs::create_directories(directory + "Cache/Meshes", ec);
+
+                MeshImportResult duplicated = model;
+                for (auto& submesh: duplicated.submeshes)
+                    strcpy(submesh.name, "box");
+
+                JobSystem         jobSystem(2);
+                MeshExportOptions options;
+                options.assetsOutputDirectory = directory;
+                options.jobSystem             = &jobSystem;
+
+                MeshExporter exporter;
+                RAZIX_TEST_CHECK(exporter.exportMesh(duplicated, options));
+
+                std::vector<std::string> meshFiles;
+                std::string              modelFile;
+                for (const auto& outputFile: exporter.getOutputFiles()) {
+                    std::string extension = fs::path(outputFile).extension().string();
+                    if (extension == ".rzmesh")
+                        meshFiles.push_back(outputFile);
+                    else if (extension == ".rzmodel")
+                        modelFile = outputFile;
+                }
+                RAZIX_TEST_CHECK(meshFiles.size() == duplicated.submeshes.size());
+
+                // Every file holds a different submesh
+                std::vector<uint32_t> baseVertices;
+                for (const auto& meshFile: meshFiles) {
+                    MeshFileReader reader;
+                    RAZIX_TEST_CHECK(reader.open(meshFile));
+                    if (reader.getError().empty())
+                        baseVertices.push_back(reader.getMeshHeader().base_vertex);
+                }
+                std::sort(baseVertices.begin(), baseVertices.end());
+                RAZIX_TEST_CHECK(std::unique(baseVertices.begin(), baseVertices.end()) == baseVertices.end() && baseVertices.size() == duplicated.submeshes.size());
+
+                // And the model points every submesh at it's own file
+                ModelFileReader modelReader;
+                RAZIX_TEST_CHECK(modelReader.open(modelFile));
+                if (!modelReader.getError().empty())
+                    return failures;
+                const auto*              submeshes = modelReader.getArray<BINModelSubMesh>(MODEL_ARRAY_SUBMESHES);
+                std::vector<std::string> paths;
+                for (uint32_t i = 0; i < modelReader.getHeader().submesh_count; i++) {
+                    const char* path = modelReader.getString(submeshes[i].path_offset);
+                    RAZIX_TEST_CHECK(path != nullptr);
+                    if (path)
+                        paths.push_back(path);
+                }
+                std::sort(paths.begin(), paths.end());
+                RAZIX_TEST_CHECK(std::unique(paths.begin(), paths.end()) == paths.end() && paths.size() == duplicated.submeshes.size());
+                return failures;
+            }
+
+            int RunFileReaderTests()
+            {
+                int              failures  = 0;
+                std::string      directory = (fs::temp_directory_path() / "razix_packer_reader_tests").generic_string() + "/";
+                MeshImportResult model     = MakeTestModel();
+
+                for (const auto& variant: kVariants) {
+                    std::error_code ec;
+                    fs::remove_all(directory, ec);
+                    fs::create_directories(directory + "Cache/Meshes", ec);
+
+                    MeshImportResult imported = model;
+                    imported.encodeVertices   = variant.encode;
+                    imported.encodeIndices    = variant.encode;
+
+                    MeshExportOptions options;
+                    options.assetsOutputDirectory = directory;
+                    options.useCompression        = variant.compression;
+                    options.packModel             = variant.packModel;
+                    if (variant.packModel)
+                        options.packAlignment = variant.alignment;
+                    else
+                        options.blobAlignment = variant.alignment;
+
+                    MeshExporter exporter;
+                    bool         exported = exporter.exportMesh(imported, options);
+                    RAZIX_TEST_CHECK(exported);
+                    if (!exported)
+                        continue;
+
+                    std::vector<std::string> meshFiles;
+                    for (const auto& outputFile: exporter.getOutputFiles()) {
+                        std::string extension = fs::path(outputFile).extension().string();
+                        if (extension == ".rzmesh" || extension == ".rzpack")
+                            meshFiles.push_back(outputFile);
+                    }
+                    RAZIX_TEST_CHECK(meshFiles.size() == (variant.packModel ? 1 : model.submeshes.size()));
+
+                    std::string scratchPath = directory + "scratch.bin";
+                    for (const auto& meshFile: meshFiles) {
+                        failures += CheckRoundTrip(model, variant, meshFile);
+
+                        std::vector<uint8_t> bytes;
+                        RAZIX_TEST_CHECK(ReadFileBytes(meshFile, bytes) && !bytes.empty());
+                        if (bytes.empty())
+                            continue;
+                        failures += CheckTruncated(bytes, variant, scratchPath);
+                        failures += CheckCorrupted(bytes, variant, scratchPath);
+                    }
+                }
+
+                failures += CheckDuplicateSubMeshNames(model, directory);
+
+                std::error_code ec;
+                fs::remove_all(directory, ec);
+                return failures;
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
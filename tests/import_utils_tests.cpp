@@ -0,0 +1,138 @@
+#include <cmath>
+#include <vector>
+
+#include "test_suites.h"
+
+#include "importer/ImportUtils.h"
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            static bool IsUnit(const glm::vec3& v)
+            {
+                return std::abs(glm::length(v) - 1.0f) < 1e-5f;
+            }
+
+            static bool IsNear(const glm::vec3& a, const glm::vec3& b)
+            {
+                return glm::length(a - b) < 1e-5f;
+            }
+
+            // Vertex 2 is a seam copy of vertex 0 and is referenced first, so it's the representative of a smaller vertex
+            static int TestSmoothNormalsSeamOrder()
+            {
+                int failures = 0;
+
+                const glm::vec3 positions[] = {
+                    glm::vec3(0.0f, 0.0f, 0.0f),
+                    glm::vec3(1.0f, 0.0f, 0.0f),
+                    glm::vec3(0.0f, 0.0f, 0.0f),
+                    glm::vec3(0.0f, 1.0f, 0.0f),
+                    glm::vec3(1.0f, 1.0f, 0.0f)};
+                const uint32_t indices[] = {2, 1, 3, 0, 1, 4};
+
+                glm::vec3 normals[5];
+                GenerateSmoothNormals(positions, 5, indices, 6, normals);
+                for (const auto& normal: normals) {
+                    RAZIX_TEST_CHECK(IsUnit(normal));
+                    RAZIX_TEST_CHECK(IsNear(normal, glm::vec3(0.0f, 0.0f, 1.0f)));
+                }
+                RAZIX_TEST_CHECK(normals[0] == normals[2]);
+                return failures;
+            }
+
+            // Two triangles sharing an edge, the second one has it's U mirrored
+            static int TestTangentSigns()
+            {
+                int failures = 0;
+
+                const glm::vec3 positions[] = {
+                    glm::vec3(0.0f, 0.0f, 0.0f),
+                    glm::vec3(1.0f, 0.0f, 0.0f),
+                    glm::vec3(0.0f, 1.0f, 0.0f),
+                    glm::vec3(-1.0f, 0.0f, 0.0f),
+                    glm::vec3(0.0f, 0.0f, 0.0f),
+                    glm::vec3(0.0f, 1.0f, 0.0f)};
+                const glm::vec2 uvs[] = {
+                    glm::vec2(0.0f, 0.0f),
+                    glm::vec2(1.0f, 0.0f),
+                    glm::vec2(0.0f, 1.0f),
+                    glm::vec2(1.0f, 0.0f),
+                    glm::vec2(0.0f, 0.0f),
+                    glm::vec2(0.0f, 1.0f)};
+                const uint32_t  indices[] = {0, 1, 2, 3, 4, 5};
+                const glm::vec3 normals[] = {
+                    glm::vec3(0.0f, 0.0f, 1.0f),
+                    glm::vec3(0.0f, 0.0f, 1.0f),
+                    glm::vec3(0.0f, 0.0f, 1.0f),
+                    glm::vec3(0.0f, 0.0f, 1.0f),
+                    glm::vec3(0.0f, 0.0f, 1.0f),
+                    glm::vec3(0.0f, 0.0f, 1.0f)};
+
+                glm::vec3 tangents[6];
+                float     signs[6];
+                GenerateTangents(positions, normals, uvs, 6, indices, 6, tangents, signs);
+                for (uint32_t i = 0; i < 6; i++) {
+                    RAZIX_TEST_CHECK(IsUnit(tangents[i]));
+                    RAZIX_TEST_CHECK(std::abs(glm::dot(tangents[i], normals[i])) < 1e-5f);
+                    RAZIX_TEST_CHECK(signs[i] == (i < 3 ? 1.0f : -1.0f));
+                }
+                return failures;
+            }
+
+            // Same triangles sharing vertices 0 and 2, the mirrored one gets copies of them so each side keeps it's own tangent space
+            static int TestSplitMirroredVertices()
+            {
+                int failures = 0;
+
+                std::vector<glm::vec3> positions = {
+                    glm::vec3(0.0f, 0.0f, 0.0f),
+                    glm::vec3(1.0f, 0.0f, 0.0f),
+                    glm::vec3(0.0f, 1.0f, 0.0f),
+                    glm::vec3(-1.0f, 0.0f, 0.0f)};
+                std::vector<glm::vec2> uvs = {
+                    glm::vec2(0.0f, 0.0f),
+                    glm::vec2(1.0f, 0.0f),
+                    glm::vec2(0.0f, 1.0f),
+                    glm::vec2(1.0f, 0.0f)};
+                uint32_t indices[] = {0, 1, 2, 3, 0, 2};
+
+                RAZIX_TEST_CHECK(CountMirroredVertices(uvs.data(), 4, indices, 6) == 2);
+
+                std::vector<uint32_t> sources;
+                uint32_t              count = SplitMirroredVertices(uvs.data(), 4, indices, 6, sources);
+                RAZIX_TEST_CHECK(count == 6);
+                RAZIX_TEST_CHECK(sources == std::vector<uint32_t>({0, 2}));
+                RAZIX_TEST_CHECK(indices[0] == 0 && indices[1] == 1 && indices[2] == 2);
+                RAZIX_TEST_CHECK(indices[3] == 3 && indices[4] == 4 && indices[5] == 5);
+                if (count != 6 || sources.size() != 2)
+                    return failures;
+
+                for (uint32_t source: sources) {
+                    positions.push_back(positions[source]);
+                    uvs.push_back(uvs[source]);
+                }
+                std::vector<glm::vec3> normals(count, glm::vec3(0.0f, 0.0f, 1.0f));
+                std::vector<glm::vec3> tangents(count);
+                std::vector<float>     signs(count);
+                GenerateTangents(positions.data(), normals.data(), uvs.data(), count, indices, 6, tangents.data(), signs.data());
+                for (uint32_t i = 0; i < count; i++) {
+                    RAZIX_TEST_CHECK(IsNear(tangents[i], glm::vec3(i < 3 ? 1.0f : -1.0f, 0.0f, 0.0f)));
+                    RAZIX_TEST_CHECK(signs[i] == (i < 3 ? 1.0f : -1.0f));
+                }
+                return failures;
+            }
+
+            int RunImportUtilsTests()
+            {
+                int failures = 0;
+                failures += TestSmoothNormalsSeamOrder();
+                failures += TestTangentSigns();
+                failures += TestSplitMirroredVertices();
+                return failures;
+            }
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <iostream>
+
+namespace Razix {
+    namespace Tool {
+        namespace AssetPacker {
+
+            /**
+             * A test suite of RazixAssetPacker_Tests, run by name from the command line
+             * run returns the number of failed checks, a suite keeps going after a failed check so every failure is reported
+             */
+            struct TestSuite
+            {
+                const char* name;
+                const char* description;
+                int (*run)();
+            };
+
+            int RunFileReaderTests();
+            int RunImportUtilsTests();
+
+        }    // namespace AssetPacker
+    }        // namespace Tool
+}    // namespace Razix
+
+/* Counts a failure in the failures variable of the calling test and prints the condition, doesn't return */
+#define RAZIX_TEST_CHECK(condition)                                                                       \
+    do {                                                                                                  \
+        if (!(condition)) {                                                                               \
+            std::cout << "[FAILED!] " << __FILE__ << ":" << __LINE__ << " : " << #condition << std::endl; \
+            failures++;                                                                                   \
+        }                                                                                                 \
+    } while (0)
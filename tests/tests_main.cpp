@@ -0,0 +1,55 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "test_suites.h"
+
+#include "common/log.h"
+
+using namespace Razix::Tool::AssetPacker;
+
+static const TestSuite kSuites[] = {
+    {"file_readers", "Exported .rzmesh/.rzpack files read back through the loaders, truncated and corrupted copies are rejected", RunFileReaderTests},
+    {"import_utils", "Smooth normals and tangent signs generated for the meshes that don't have them", RunImportUtilsTests},
+};
+
+static void PrintUsage()
+{
+    std::cout << "Usage: RazixAssetPacker_Tests [suite]\n";
+    for (const auto& suite: kSuites)
+        std::cout << "  " << suite.name << " " << suite.description << "\n";
+    std::cout << std::flush;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && (!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help"))) {
+        PrintUsage();
+        return EXIT_SUCCESS;
+    }
+
+    // The corrupted files are expected to fail, only the failed checks are worth printing
+    SetLogLevel(LogLevel::Error);
+
+    bool found    = false;
+    int  failures = 0;
+    for (const auto& suite: kSuites) {
+        if (argc > 1 && strcmp(argv[1], suite.name) != 0)
+            continue;
+
+        found             = true;
+        int suiteFailures = suite.run();
+        failures += suiteFailures;
+        std::cout << (suiteFailures ? "[FAILED!] " : "[PASSED] ") << suite.name;
+        if (suiteFailures)
+            std::cout << " (" << suiteFailures << " failed checks)";
+        std::cout << std::endl;
+    }
+
+    if (!found) {
+        std::cout << "[ERROR!] Unknown suite : " << argv[1] << std::endl;
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}